@@ -0,0 +1,98 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "bitstream_compressor.hpp"
+#include "rapidjson/document.h"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+
+using orkhestrafs::dbmstodspi::BitstreamCompressor;
+
+/**
+ * @brief Tool to compress the partial bitstreams of a PR module library.
+ *
+ * Every bitstream of the library found in the working directory gets a
+ * compressed copy and the library is written with the compressed file names
+ * added to the bitstream entries. The uncompressed bitstreams can be removed
+ * afterwards.
+ */
+auto main(int argc, char* argv[]) -> int {
+  if (argc < 2) {
+    std::cout << "Usage: compress_bitstreams <library JSON> [output JSON]"
+              << std::endl;
+    return 1;
+  }
+  const std::string library_filename = argv[1];
+  const std::string output_filename = argc > 2 ? argv[2] : library_filename;
+
+  std::ifstream library_file(library_filename);
+  if (!library_file) {
+    throw std::runtime_error("Couldn't open " + library_filename);
+  }
+  std::stringstream library_data;
+  library_data << library_file.rdbuf();
+  rapidjson::Document library;
+  library.Parse(library_data.str().c_str());
+  if (library.HasParseError() || !library.IsObject()) {
+    throw std::runtime_error(library_filename + " isn't a valid library!");
+  }
+
+  uintmax_t original_size = 0;
+  uintmax_t compressed_size = 0;
+  for (auto& operation : library.GetObject()) {
+    for (auto& bitstream : operation.value["bitstreams"].GetObject()) {
+      std::string bitstream_name = bitstream.name.GetString();
+      if (!std::filesystem::exists(bitstream_name)) {
+        std::cout << "Skipping missing bitstream: " << bitstream_name
+                  << std::endl;
+        continue;
+      }
+      auto compressed_name =
+          bitstream_name + BitstreamCompressor::kCompressedExtension;
+      original_size += std::filesystem::file_size(bitstream_name);
+      compressed_size +=
+          BitstreamCompressor::CompressFile(bitstream_name, compressed_name);
+      rapidjson::Value compressed_value(compressed_name.c_str(),
+                                        library.GetAllocator());
+      if (bitstream.value.HasMember("compressed")) {
+        bitstream.value["compressed"] = compressed_value;
+      } else {
+        bitstream.value.AddMember("compressed", compressed_value,
+                                  library.GetAllocator());
+      }
+    }
+  }
+
+  rapidjson::StringBuffer output_buffer;
+  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(output_buffer);
+  library.Accept(writer);
+  std::ofstream output_file(output_filename);
+  output_file << output_buffer.GetString() << std::endl;
+  if (!output_file) {
+    throw std::runtime_error("Couldn't write " + output_filename);
+  }
+  std::cout << "Compressed " << original_size << " bytes to "
+            << compressed_size << " bytes" << std::endl;
+  return 0;
+}
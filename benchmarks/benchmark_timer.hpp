@@ -0,0 +1,55 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace orkhestrafs::benchmarks {
+
+/**
+ * @brief Measure the average runtime of the given function.
+ * @param iterations How many times the function should be called.
+ * @param function Function to measure.
+ * @return Average runtime in nanoseconds.
+ */
+template <typename Function>
+auto MeasureAverageNanoseconds(int iterations, Function function) -> double {
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    function();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return static_cast<double>(
+             std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin)
+                 .count()) /
+         iterations;
+}
+
+/**
+ * @brief Print a single benchmark result line.
+ * @param name Benchmark name.
+ * @param nanoseconds Measured time.
+ */
+inline void PrintResult(const std::string& name, double nanoseconds) {
+  std::cout << std::left << std::setw(48) << name << std::right
+            << std::setw(14) << std::fixed << std::setprecision(1)
+            << nanoseconds << " ns" << std::endl;
+}
+
+}  // namespace orkhestrafs::benchmarks
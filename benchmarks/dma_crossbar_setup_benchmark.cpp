@@ -0,0 +1,77 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "benchmark_timer.hpp"
+#include "dma_crossbar_setup.hpp"
+#include "dma_setup_data.hpp"
+#include "stream_parameter_calculator.hpp"
+
+using orkhestrafs::benchmarks::MeasureAverageNanoseconds;
+using orkhestrafs::benchmarks::PrintResult;
+using orkhestrafs::dbmstodspi::DMACrossbarSetup;
+using orkhestrafs::dbmstodspi::DMASetupData;
+using orkhestrafs::dbmstodspi::StreamParameterCalculator;
+
+namespace {
+const int kIterations = 10000;
+
+auto CreateStreamSetupData(bool is_input_stream, int record_size)
+    -> DMASetupData {
+  DMASetupData stream_setup_data;
+  stream_setup_data.is_input_stream = is_input_stream;
+  stream_setup_data.active_channel_count = -1;
+  stream_setup_data.chunks_per_record =
+      StreamParameterCalculator::CalculateChunksPerRecord(record_size);
+  stream_setup_data.records_per_ddr_burst =
+      StreamParameterCalculator::FindMinViableRecordsPerDDRBurst(record_size);
+  return stream_setup_data;
+}
+
+void BenchmarkRecordSize(bool is_input_stream, int record_size) {
+  std::vector<int> selected_columns(record_size);
+  std::iota(selected_columns.begin(), selected_columns.end(), 0);
+  const std::string name = (is_input_stream ? "input" : "output") +
+                           std::string(" record size ") +
+                           std::to_string(record_size);
+
+  auto computed_time = MeasureAverageNanoseconds(kIterations, [&]() {
+    auto stream_setup_data = CreateStreamSetupData(is_input_stream, record_size);
+    DMACrossbarSetup::ComputeCrossbarSetupData(stream_setup_data, record_size,
+                                               selected_columns);
+  });
+  DMACrossbarSetup::GetConfigurationCache().Clear();
+  auto cached_time = MeasureAverageNanoseconds(kIterations, [&]() {
+    auto stream_setup_data = CreateStreamSetupData(is_input_stream, record_size);
+    DMACrossbarSetup::CalculateCrossbarSetupData(stream_setup_data, record_size,
+                                                 selected_columns);
+  });
+  PrintResult(name + " computed", computed_time);
+  PrintResult(name + " cached", cached_time);
+}
+}  // namespace
+
+auto main() -> int {
+  // Same record sizes as the crossbar setup tests.
+  for (const auto record_size : {4, 18, 46, 57}) {
+    BenchmarkRecordSize(true, record_size);
+    BenchmarkRecordSize(false, record_size);
+  }
+  return 0;
+}
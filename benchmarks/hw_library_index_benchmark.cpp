@@ -0,0 +1,216 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "benchmark_timer.hpp"
+#include "hw_library_index.hpp"
+#include "pr_module_data.hpp"
+#include "query_scheduling_data.hpp"
+#include "rapidjson_reader.hpp"
+
+using orkhestrafs::benchmarks::MeasureAverageNanoseconds;
+using orkhestrafs::benchmarks::PrintResult;
+using orkhestrafs::core_interfaces::hw_library::OperationPRModules;
+using orkhestrafs::core_interfaces::hw_library::PRModuleData;
+using orkhestrafs::core_interfaces::operation_types::QueryOperationType;
+using orkhestrafs::core_interfaces::query_scheduling_data::kSupportedFunctions;
+using orkhestrafs::dbmstodspi::HWLibraryIndex;
+using orkhestrafs::dbmstodspi::RapidJSONReader;
+
+namespace {
+const int kIterations = 10000;
+const std::pair<int, int> kTakenPosition = {10, 15};
+
+auto ReadHWLibrary(const std::string& filename)
+    -> std::map<QueryOperationType, OperationPRModules> {
+  RapidJSONReader json_reader;
+  std::map<QueryOperationType, OperationPRModules> hw_library;
+  for (const auto& [operation_string, operation_data] :
+       json_reader.ReadHWLibraryData(filename)) {
+    OperationPRModules operation_modules;
+    for (const auto& [bitstream_name, parameters] : operation_data.first) {
+      PRModuleData module_data;
+      module_data.capacity =
+          std::get<std::vector<int>>(parameters.at("capacity"));
+      module_data.fitting_locations =
+          std::get<std::vector<int>>(parameters.at("locations"));
+      module_data.length = std::get<int>(parameters.at("length"));
+      module_data.resource_string =
+          std::get<std::string>(parameters.at("string"));
+      module_data.is_backwards =
+          std::get<int>(parameters.at("is_backwards")) != 0;
+      operation_modules.bitstream_map.insert({bitstream_name, module_data});
+    }
+    operation_modules.starting_locations = operation_data.second;
+    hw_library.insert(
+        {kSupportedFunctions.at(operation_string), operation_modules});
+  }
+  return hw_library;
+}
+
+// Library scan done by the scheduler before the index.
+auto ScanFittingBitstreams(const OperationPRModules& operation_modules,
+                           const std::vector<int>& min_capacity)
+    -> std::vector<std::vector<std::string>> {
+  std::unordered_set<std::string> fitting_bitstreams;
+  for (const auto& [bitstream_name, module_data] :
+       operation_modules.bitstream_map) {
+    bool is_fitting = true;
+    for (int capacity_index = 0; capacity_index < module_data.capacity.size();
+         capacity_index++) {
+      if (module_data.capacity.at(capacity_index) <
+          min_capacity.at(capacity_index)) {
+        is_fitting = false;
+        break;
+      }
+    }
+    if (is_fitting) {
+      fitting_bitstreams.insert(bitstream_name);
+    }
+  }
+  auto fitting_locations = operation_modules.starting_locations;
+  for (auto& column_bitstreams : fitting_locations) {
+    column_bitstreams.erase(
+        std::remove_if(column_bitstreams.begin(), column_bitstreams.end(),
+                       [&](const std::string& bitstream_name) {
+                         return fitting_bitstreams.find(bitstream_name) ==
+                                fitting_bitstreams.end();
+                       }),
+        column_bitstreams.end());
+  }
+  return fitting_locations;
+}
+
+// Placement lookup done by the scheduler before the index.
+auto ScanAvailablePlacements(const OperationPRModules& operation_modules)
+    -> int {
+  int available_placements = 0;
+  for (int column = 0; column < operation_modules.starting_locations.size();
+       column++) {
+    const auto& column_bitstreams =
+        operation_modules.starting_locations.at(column);
+    for (const auto& bitstream_name : column_bitstreams) {
+      int location_index =
+          std::find(column_bitstreams.begin(), column_bitstreams.end(),
+                    bitstream_name) -
+          column_bitstreams.begin();
+      int end = column +
+                operation_modules.bitstream_map.at(bitstream_name).length - 1;
+      if (end < kTakenPosition.first || column > kTakenPosition.second) {
+        available_placements += location_index + 1;
+      }
+    }
+  }
+  return available_placements;
+}
+
+auto FindAvailablePlacements(const HWLibraryIndex& index,
+                             QueryOperationType operation,
+                             const OperationPRModules& operation_modules)
+    -> int {
+  int available_placements = 0;
+  auto taken_modules = index.GetOverlappingModules(
+      operation, kTakenPosition.first, kTakenPosition.second);
+  for (int column = 0; column < operation_modules.starting_locations.size();
+       column++) {
+    for (const auto& bitstream_name :
+         operation_modules.starting_locations.at(column)) {
+      auto module_id = index.GetModuleId(operation, column, bitstream_name);
+      if (!HWLibraryIndex::IsInSet(taken_modules, module_id)) {
+        available_placements += index.GetModule(module_id).location_index + 1;
+      }
+    }
+  }
+  return available_placements;
+}
+
+auto GetMinCapacity(const OperationPRModules& operation_modules)
+    -> std::vector<int> {
+  std::vector<int> min_capacity;
+  for (const auto& [bitstream_name, module_data] :
+       operation_modules.bitstream_map) {
+    if (min_capacity.empty()) {
+      min_capacity = module_data.capacity;
+    }
+    for (int capacity_index = 0; capacity_index < min_capacity.size();
+         capacity_index++) {
+      min_capacity[capacity_index] =
+          std::min(min_capacity[capacity_index],
+                   module_data.capacity.at(capacity_index));
+    }
+  }
+  return min_capacity;
+}
+
+auto GetOperationName(QueryOperationType operation) -> std::string {
+  for (const auto& [operation_name, operation_type] : kSupportedFunctions) {
+    if (operation_type == operation) {
+      return operation_name;
+    }
+  }
+  return "unknown";
+}
+}  // namespace
+
+auto main(int argc, char* argv[]) -> int {
+  const std::string library_filename =
+      argc > 1 ? argv[1] : "resources/pr_hw_library.json";
+  auto hw_library = ReadHWLibrary(library_filename);
+
+  PrintResult("index build", MeasureAverageNanoseconds(100, [&]() {
+                HWLibraryIndex index(hw_library);
+              }));
+  HWLibraryIndex index(hw_library);
+
+  long checksum = 0;
+  for (const auto& [operation, operation_modules] : hw_library) {
+    const std::string name = GetOperationName(operation) + " ";
+    auto min_capacity = GetMinCapacity(operation_modules);
+    PrintResult(name + "fitting bitstreams scan",
+                MeasureAverageNanoseconds(kIterations, [&]() {
+                  checksum +=
+                      ScanFittingBitstreams(operation_modules, min_capacity)
+                          .size();
+                }));
+    PrintResult(name + "fitting bitstreams index",
+                MeasureAverageNanoseconds(kIterations, [&]() {
+                  checksum += index
+                                  .GetBitstreamLocations(
+                                      operation, index.GetFittingModules(
+                                                     operation, min_capacity))
+                                  .size();
+                }));
+    PrintResult(name + "available placements scan",
+                MeasureAverageNanoseconds(kIterations, [&]() {
+                  checksum += ScanAvailablePlacements(operation_modules);
+                }));
+    PrintResult(name + "available placements index",
+                MeasureAverageNanoseconds(kIterations, [&]() {
+                  checksum += FindAvailablePlacements(index, operation,
+                                                      operation_modules);
+                }));
+  }
+  std::cout << "checksum: " << checksum << std::endl;
+  return 0;
+}
@@ -0,0 +1,218 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "addition.hpp"
+#include "aggregation_sum.hpp"
+#include "benchmark_timer.hpp"
+#include "black_white.hpp"
+#include "dma.hpp"
+#include "filter.hpp"
+#include "join.hpp"
+#include "linear_sort.hpp"
+#include "memory_manager_interface.hpp"
+#include "merge_sort.hpp"
+#include "module_config_values.hpp"
+#include "multiplication.hpp"
+#include "register_access.hpp"
+#include "sobel.hpp"
+
+using orkhestrafs::benchmarks::MeasureAverageNanoseconds;
+using orkhestrafs::benchmarks::PrintResult;
+using orkhestrafs::dbmstodspi::Addition;
+using orkhestrafs::dbmstodspi::AggregationSum;
+using orkhestrafs::dbmstodspi::BlackWhite;
+using orkhestrafs::dbmstodspi::DMA;
+using orkhestrafs::dbmstodspi::Filter;
+using orkhestrafs::dbmstodspi::Join;
+using orkhestrafs::dbmstodspi::LinearSort;
+using orkhestrafs::dbmstodspi::MemoryManagerInterface;
+using orkhestrafs::dbmstodspi::MergeSort;
+using orkhestrafs::dbmstodspi::Multiplication;
+using orkhestrafs::dbmstodspi::RegisterAccess;
+using orkhestrafs::dbmstodspi::Sobel;
+using orkhestrafs::dbmstodspi::module_config_values::
+    DMACrossbarDirectionSelection;
+using orkhestrafs::dbmstodspi::module_config_values::FilterCompareFunctions;
+using orkhestrafs::dbmstodspi::module_config_values::LiteralTypes;
+
+namespace {
+const int kIterations = 1000;
+const int kModulePosition = 1;
+
+/**
+ * @brief Memory manager with a plain register array to measure the driver
+ * overhead without any hardware.
+ */
+class BenchmarkMemoryManager : public MemoryManagerInterface {
+ public:
+  BenchmarkMemoryManager() : register_space_(4 * 1024 * 1024, 0) {}
+  auto GetTime() -> long override { return 0; }
+  auto MeasureConfigurationSpeed(
+      const std::set<std::string>& /*bitstreams_to_measure*/)
+      -> std::map<std::string, double> override {
+    return {};
+  }
+  void LoadBitstreamIfNew(const std::string& /*bitstream_name*/,
+                          int /*register_space_size*/) override {}
+  auto GetVirtualRegisterAddress(int offset) -> volatile uint32_t* override {
+    return &register_space_[offset / RegisterAccess::kAddressesPerRegister];
+  }
+  auto GetAvailableMemoryBlock() -> MemoryBlockInterface* override {
+    return nullptr;
+  }
+  void FreeMemoryBlock(MemoryBlockInterface* /*memory_block_pointer*/) override {
+  }
+  void LoadStatic(int /*clock_speed*/) override {}
+  void LoadPartialBitstream(const std::vector<std::string>& /*bitstream_name*/,
+                            DMAInterface& /*dma_engine*/) override {}
+  void LoadPartialBitstreamWhileStreaming(
+      const std::vector<std::string>& /*bitstream_name*/) override {}
+
+ private:
+  std::vector<uint32_t> register_space_;
+  auto AllocateMemoryBlock() -> MemoryBlockInterface* override {
+    return nullptr;
+  }
+};
+
+void SetupFilter(MemoryManagerInterface* memory_manager) {
+  Filter filter(memory_manager, kModulePosition);
+  filter.FilterSetStreamIDs(0, 0, 1);
+  filter.FilterSetMode(false, false, false, true, true);
+  filter.FilterSetCompareTypes(0, 14, FilterCompareFunctions::kLessThan32Bit,
+                               FilterCompareFunctions::kLessThan32Bit,
+                               FilterCompareFunctions::kLessThan32Bit,
+                               FilterCompareFunctions::kLessThan32Bit);
+  filter.FilterSetCompareReferenceValue(0, 14, 0, 12000);
+  filter.FilterSetDNFClauseLiteral(0, 0, 0, 14,
+                                   LiteralTypes::kLiteralPositive);
+  filter.WriteDNFClauseLiteralsToFilter_4CMP_32DNF(16);
+}
+
+void SetupDMA(MemoryManagerInterface* memory_manager) {
+  DMA dma(memory_manager);
+  dma.SetControllerParams(true, 0, 32, 8, 0, 15);
+  dma.SetControllerStreamAddress(true, 0, 0);
+  dma.SetControllerStreamSize(true, 0, 1000);
+  dma.SetRecordSize(0, 4);
+  for (int interface_cycle = 0; interface_cycle < 4; interface_cycle++) {
+    dma.SetRecordChunkIDs(0, interface_cycle, interface_cycle);
+  }
+  for (int clock_cycle = 0; clock_cycle < 32; clock_cycle++) {
+    for (int offset = 0; offset < 4; offset++) {
+      dma.SetCrossbarValues(
+          DMACrossbarDirectionSelection::kBufferToInterfaceChunk, 0,
+          clock_cycle, offset, {3, 2, 1, 0});
+      dma.SetCrossbarValues(
+          DMACrossbarDirectionSelection::kBufferToInterfacePosition, 0,
+          clock_cycle, offset, {3, 2, 1, 0});
+    }
+  }
+  dma.StartController(true, std::bitset<16>(1));
+}
+
+void SetupJoin(MemoryManagerInterface* memory_manager) {
+  Join join(memory_manager, kModulePosition);
+  join.Reset();
+  join.DefineOutputStream(2, 0, 1, 0);
+  join.SetFirstInputStreamChunkCount(1);
+  join.SetSecondInputStreamChunkCount(1);
+  for (int data_position = 0; data_position < 16; data_position++) {
+    join.SelectOutputDataElement(0, 0, data_position, false);
+    join.SelectOutputDataElement(1, 0, data_position, true);
+  }
+  join.StartPrefetchingData();
+}
+
+void SetupMergeSort(MemoryManagerInterface* memory_manager) {
+  MergeSort merge_sort(memory_manager, kModulePosition);
+  merge_sort.SetStreamParams(0, 1);
+  merge_sort.SetBufferSize(64);
+  merge_sort.SetRecordCountPerFetch(8);
+  merge_sort.SetFetchCount(8);
+  merge_sort.SetFetchOffset(64);
+  merge_sort.StartPrefetchingData(0, false);
+}
+
+void SetupLinearSort(MemoryManagerInterface* memory_manager) {
+  LinearSort linear_sort(memory_manager, kModulePosition);
+  linear_sort.SetStreamParams(0, 4);
+  linear_sort.StartPrefetchingData();
+}
+
+void SetupAggregationSum(MemoryManagerInterface* memory_manager) {
+  AggregationSum aggregation_sum(memory_manager, kModulePosition);
+  aggregation_sum.ResetSumRegisters();
+  aggregation_sum.DefineInput(0, 0);
+  aggregation_sum.StartPrefetching(false, false, false);
+}
+
+void SetupAddition(MemoryManagerInterface* memory_manager) {
+  Addition addition(memory_manager, kModulePosition);
+  addition.DefineInput(0, 0);
+  addition.SetInputSigns(std::bitset<8>(0));
+  std::array<std::pair<uint32_t, uint32_t>, 8> literal_values{};
+  addition.SetLiteralValues(literal_values);
+}
+
+void SetupMultiplication(MemoryManagerInterface* memory_manager) {
+  Multiplication multiplication(memory_manager, kModulePosition);
+  multiplication.DefineActiveStreams(std::bitset<16>(1));
+  for (int chunk_id = 0; chunk_id < 32; chunk_id++) {
+    multiplication.ChooseMultiplicationResults(chunk_id, std::bitset<8>(1));
+  }
+}
+
+void SetupSobel(MemoryManagerInterface* memory_manager) {
+  Sobel sobel(memory_manager, kModulePosition);
+  sobel.SetStreamParams(0, 4, 1080);
+}
+
+void SetupBlackWhite(MemoryManagerInterface* memory_manager) {
+  BlackWhite black_white(memory_manager, kModulePosition);
+  black_white.SetStreamParams(0);
+}
+}  // namespace
+
+auto main() -> int {
+  BenchmarkMemoryManager memory_manager;
+  const std::vector<std::pair<std::string, void (*)(MemoryManagerInterface*)>>
+      module_setups = {{"Filter", SetupFilter},
+                       {"MergeSort", SetupMergeSort},
+                       {"Join", SetupJoin},
+                       {"LinearSort", SetupLinearSort},
+                       {"AggregationSum", SetupAggregationSum},
+                       {"Addition", SetupAddition},
+                       {"Multiplication", SetupMultiplication},
+                       {"Sobel", SetupSobel},
+                       {"BlackWhite", SetupBlackWhite},
+                       {"DMA", SetupDMA}};
+  for (const auto& [name, setup_function] : module_setups) {
+    PrintResult(name + " setup",
+                MeasureAverageNanoseconds(
+                    kIterations, [&]() { setup_function(&memory_manager); }));
+  }
+  return 0;
+}
@@ -0,0 +1,309 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "core.hpp"
+#include "rapidjson_reader.hpp"
+
+using orkhestrafs::core::Core;
+using orkhestrafs::dbmstodspi::RapidJSONReader;
+
+namespace {
+const std::string kStatsFilename = "benchmark_stats.json";
+const std::string kBenchmarkKey = "BENCHMARK_SCHEDULER";
+const std::string kHeuristicKey = "HEURISTIC";
+const std::string kTranspositionTableKey =
+    "SCHEDULER_TRANSPOSITION_TABLE_SIZE";
+const std::string kBranchAndBoundKey = "SCHEDULER_BRANCH_AND_BOUND";
+const std::string kAnytimeKey = "SCHEDULER_ANYTIME";
+const std::string kBeamWidthKey = "SCHEDULER_BEAM_WIDTH";
+const std::string kExactNodeLimitKey = "SCHEDULER_EXACT_NODE_LIMIT";
+// Choices of ElasticResourceNodeScheduler::GetDefaultHeuristics. Choices 0 and
+// 2 to 5 only place operations which support incomplete modules. They can't
+// schedule the default inputs and are kept as failed runs.
+const int kHeuristicChoices[] = {0, 1, 2, 3, 4, 5, 6};
+const std::string kDefaultInputs[] = {
+    "scheduling_input_defs/Q6/Q6_SF001.json",
+    "scheduling_input_defs/Q14/Q14_SF001.json",
+    "scheduling_input_defs/Q19/Q19_SF001.json",
+    "scheduling_input_defs/all/all_SF001.json"};
+
+struct SchedulerMode {
+  std::string name;
+  int transposition_table_size;
+  bool use_branch_and_bound;
+  bool use_anytime_scheduling;
+  int beam_width;
+  int exact_node_limit;
+};
+
+// Every mode sets all of the search keys such that the given config can't
+// change what is compared.
+const SchedulerMode kModes[] = {
+    {"exhaustive", 0, false, false, 0, 0},
+    {"transposition_table", 100000, false, false, 0, 0},
+    {"branch_and_bound", 100000, true, false, 0, 0},
+    {"anytime", 100000, true, true, 0, 0},
+    {"greedy", 0, false, false, 1, 0},
+    {"beam", 0, false, false, 16, 0},
+    {"exact", 0, false, false, 0, std::numeric_limits<int>::max()}};
+
+auto GetConfigKey(const std::string& line) -> std::string {
+  auto key = line.substr(0, line.find('='));
+  key.erase(key.find_last_not_of(" \t") + 1);
+  return key;
+}
+
+// Copy of the given config with the scheduler benchmark enabled and the
+// search keys of the given mode.
+auto WriteModeConfig(const std::string& config_filename,
+                     const SchedulerMode& mode, int heuristic_choice)
+    -> std::string {
+  std::map<std::string, std::string> mode_values = {
+      {kBenchmarkKey, "true"},
+      {kHeuristicKey, std::to_string(heuristic_choice)},
+      {kTranspositionTableKey, std::to_string(mode.transposition_table_size)},
+      {kBranchAndBoundKey, mode.use_branch_and_bound ? "true" : "false"},
+      {kAnytimeKey, mode.use_anytime_scheduling ? "true" : "false"},
+      {kBeamWidthKey, std::to_string(mode.beam_width)},
+      {kExactNodeLimitKey, std::to_string(mode.exact_node_limit)}};
+  std::ifstream config_file(config_filename);
+  if (!config_file) {
+    throw std::runtime_error("Can't open " + config_filename);
+  }
+  auto new_config_filename = config_filename + "." + mode.name;
+  std::ofstream new_config_file(new_config_filename);
+  std::string line;
+  while (std::getline(config_file, line)) {
+    if (mode_values.find(GetConfigKey(line)) == mode_values.end()) {
+      new_config_file << line << std::endl;
+    }
+  }
+  for (const auto& [key, value] : mode_values) {
+    new_config_file << key << " = " << value << std::endl;
+  }
+  return new_config_filename;
+}
+
+// Runs in a child process such that the peak memory of each run is known.
+// Returns -1 if the run failed.
+auto RunAndGetPeakMemory(const std::string& input_filename,
+                         const std::string& config_filename) -> long {
+  std::cout.flush();
+  auto process_id = fork();
+  if (process_id == -1) {
+    throw std::runtime_error("Can't start a run for " + input_filename);
+  }
+  if (process_id == 0) {
+    int exit_status = 0;
+    try {
+      Core::Run(input_filename, config_filename);
+    } catch (const std::exception& exception) {
+      std::cerr << exception.what() << std::endl;
+      exit_status = 1;
+    }
+    std::cout.flush();
+    _exit(exit_status);
+  }
+  int status = 0;
+  rusage usage = {};
+  if (wait4(process_id, &status, 0, &usage) == -1) {
+    throw std::runtime_error("Can't wait for the run of " + input_filename);
+  }
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    return -1;
+  }
+  // Kilobytes on Linux.
+  return usage.ru_maxrss;
+}
+
+auto GetInputName(const std::string& input_filename) -> std::string {
+  auto input_name = input_filename.substr(input_filename.rfind('/') + 1);
+  return input_name.substr(0, input_name.rfind(".json"));
+}
+
+auto GetMedian(std::vector<double> values) -> double {
+  std::sort(values.begin(), values.end());
+  return values.size() % 2 == 1
+             ? values.at(values.size() / 2)
+             : (values.at(values.size() / 2 - 1) +
+                values.at(values.size() / 2)) /
+                   2;
+}
+
+auto EndsWith(const std::string& text, const std::string& suffix) -> bool {
+  return text.size() >= suffix.size() &&
+         text.compare(text.size() - suffix.size(), suffix.size(), suffix) ==
+             0;
+}
+
+// Explored branches stand in for the planning time as they don't depend on
+// the machine. Runs which failed or timed out are regressions only if they
+// didn't in the baseline. Results which aren't in the baseline yet are skipped.
+auto FindRegressions(const std::map<std::string, double>& baseline,
+                     const std::map<std::string, double>& results,
+                     double branch_threshold, double cost_threshold)
+    -> std::vector<std::string> {
+  std::vector<std::string> regressions;
+  for (const auto& [key, baseline_value] : baseline) {
+    auto search = results.find(key);
+    if (search == results.end()) {
+      continue;
+    }
+    double threshold = 0;
+    if (EndsWith(key, "/explored_branches")) {
+      threshold = branch_threshold;
+    } else if (EndsWith(key, "/plan_cost")) {
+      threshold = cost_threshold;
+    } else if (!EndsWith(key, "/failed") && !EndsWith(key, "/timeout")) {
+      continue;
+    }
+    if (search->second > baseline_value * (1 + threshold)) {
+      regressions.push_back(key + ": " + std::to_string(baseline_value) +
+                            " -> " + std::to_string(search->second));
+    }
+  }
+  return regressions;
+}
+
+// Planning times depend on the machine so they are only compared against a
+// baseline from the same machine.
+auto FindTimingRegressions(const std::map<std::string, double>& baseline,
+                           const std::map<std::string, double>& timings,
+                           double time_ratio) -> std::vector<std::string> {
+  std::vector<std::string> regressions;
+  for (const auto& [key, baseline_value] : baseline) {
+    auto search = timings.find(key);
+    if (search == timings.end() || !EndsWith(key, "/schedule_time")) {
+      continue;
+    }
+    if (search->second > baseline_value * time_ratio) {
+      regressions.push_back(key + ": " + std::to_string(baseline_value) +
+                            " -> " + std::to_string(search->second));
+    }
+  }
+  return regressions;
+}
+}  // namespace
+
+// Has to be run from the resources directory. TIME_LIMIT in the given config
+// should be large enough for the searches to finish. The results file only
+// gets results which don't depend on the machine or on TIME_LIMIT, such that
+// it can be used as the baseline. Planning times and peak memory go to the
+// timings file. Exits with 1 if the explored branches or the plan cost of any
+// run got worse than the baseline by more than the given ratio or if a run
+// failed which didn't fail in the baseline. The results of the default config
+// are kept in benchmark/scheduler_regression_baseline.json. If a timings file
+// of an earlier run on the same machine is given as the timing baseline, it
+// also exits with 1 if the median planning time of any run got slower than
+// the baseline by more than the given factor.
+auto main(int argc, char* argv[]) -> int {
+  const std::string config_filename =
+      argc > 1 ? argv[1] : "scheduler_benchmark_config.ini";
+  const std::string results_filename =
+      argc > 2 ? argv[2] : "scheduler_benchmark_results.json";
+  const int repetitions = argc > 3 ? std::stoi(argv[3]) : 3;
+  const std::string baseline_filename = argc > 4 ? argv[4] : "";
+  const double branch_threshold = argc > 5 ? std::stod(argv[5]) : 0.01;
+  const double cost_threshold = argc > 6 ? std::stod(argv[6]) : 0.01;
+  const std::string timings_filename =
+      argc > 7 ? argv[7] : "scheduler_benchmark_timings.json";
+  const std::string timing_baseline_filename = argc > 8 ? argv[8] : "";
+  const double time_ratio = argc > 9 ? std::stod(argv[9]) : 1.5;
+
+  RapidJSONReader json_reader;
+  std::map<std::string, double> results;
+  std::map<std::string, double> timings;
+  for (const auto& input_filename : kDefaultInputs) {
+    for (const auto& mode : kModes) {
+      for (const auto heuristic_choice : kHeuristicChoices) {
+        auto name = GetInputName(input_filename) + "/" + mode.name +
+                    "/heuristic_" + std::to_string(heuristic_choice);
+        auto mode_config_filename =
+            WriteModeConfig(config_filename, mode, heuristic_choice);
+        std::vector<double> schedule_times;
+        long peak_memory = 0;
+        std::map<std::string, double> stats;
+        for (int repetition = 0; repetition < repetitions; repetition++) {
+          auto run_peak_memory =
+              RunAndGetPeakMemory(input_filename, mode_config_filename);
+          if (run_peak_memory == -1) {
+            schedule_times.clear();
+            break;
+          }
+          peak_memory = std::max(peak_memory, run_peak_memory);
+          stats = json_reader.ReadValueMap(kStatsFilename);
+          schedule_times.push_back(stats.at("schedule_time"));
+        }
+        std::remove(mode_config_filename.c_str());
+
+        results[name + "/failed"] = static_cast<double>(schedule_times.empty());
+        if (schedule_times.empty()) {
+          std::cout << name << ": failed" << std::endl;
+          continue;
+        }
+        // Microseconds spent scheduling, measured by the scheduler itself.
+        timings[name + "/schedule_time"] = GetMedian(schedule_times);
+        timings[name + "/peak_memory_kb"] = peak_memory;
+        auto plan_cost =
+            stats.at("data_amount") + stats.at("configuration_amount");
+        std::cout << name << ": " << timings[name + "/schedule_time"]
+                  << " us, " << plan_cost << " cost" << std::endl;
+        // The anytime search and searches which hit TIME_LIMIT stop after a
+        // time which depends on the machine.
+        results[name + "/timeout"] = stats.at("timeout");
+        if (!mode.use_anytime_scheduling && stats.at("timeout") == 0) {
+          results[name + "/explored_branches"] = stats.at("explored_branches");
+          results[name + "/plan_count"] = stats.at("plan_count");
+          results[name + "/plan_cost"] = plan_cost;
+        }
+      }
+    }
+  }
+  json_reader.WriteValueMap(results, results_filename);
+  json_reader.WriteValueMap(timings, timings_filename);
+
+  std::vector<std::string> regressions;
+  if (!baseline_filename.empty()) {
+    regressions =
+        FindRegressions(json_reader.ReadValueMap(baseline_filename), results,
+                        branch_threshold, cost_threshold);
+  }
+  if (!timing_baseline_filename.empty()) {
+    auto timing_regressions = FindTimingRegressions(
+        json_reader.ReadValueMap(timing_baseline_filename), timings,
+        time_ratio);
+    regressions.insert(regressions.end(), timing_regressions.begin(),
+                       timing_regressions.end());
+  }
+  for (const auto& regression : regressions) {
+    std::cout << "Regression: " << regression << std::endl;
+  }
+  return regressions.empty() ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark_timer.hpp"
+#include "core.hpp"
+#include "rapidjson_reader.hpp"
+
+using orkhestrafs::benchmarks::MeasureAverageNanoseconds;
+using orkhestrafs::benchmarks::PrintResult;
+using orkhestrafs::core::Core;
+using orkhestrafs::dbmstodspi::RapidJSONReader;
+
+namespace {
+const std::string kThreadsKey = "SCHEDULER_THREADS";
+const std::string kBenchmarkKey = "BENCHMARK_SCHEDULER";
+const std::string kMaxRunsKey = "MAX_RUNS";
+const std::string kStatsFilename = "benchmark_stats.json";
+const std::string kDefaultInputs[] = {
+    "scheduling_input_defs/Q6/Q6_SF001.json",
+    "scheduling_input_defs/Q14/Q14_SF001.json",
+    "scheduling_input_defs/Q19/Q19_SF001.json",
+    "scheduling_input_defs/all/all_SF001.json"};
+
+// Copy of the given config with the scheduler benchmark enabled and the given
+// amount of scheduling threads. The runs cap is turned off as the parallel
+// search can't be used with it.
+auto WriteThreadConfig(const std::string& config_filename, int thread_count)
+    -> std::string {
+  std::ifstream config_file(config_filename);
+  if (!config_file) {
+    throw std::runtime_error("Can't open " + config_filename);
+  }
+  auto new_config_filename =
+      config_filename + ".threads_" + std::to_string(thread_count);
+  std::ofstream new_config_file(new_config_filename);
+  std::string line;
+  while (std::getline(config_file, line)) {
+    if (line.rfind(kThreadsKey, 0) != 0 && line.rfind(kBenchmarkKey, 0) != 0 &&
+        line.rfind(kMaxRunsKey, 0) != 0) {
+      new_config_file << line << std::endl;
+    }
+  }
+  new_config_file << kThreadsKey << " = " << thread_count << std::endl;
+  new_config_file << kBenchmarkKey << " = true" << std::endl;
+  new_config_file << kMaxRunsKey << " = false" << std::endl;
+  return new_config_filename;
+}
+}  // namespace
+
+// Has to be run from the resources directory. TIME_LIMIT in the given config
+// should be large enough for the search to finish for the times to compare.
+auto main(int argc, char* argv[]) -> int {
+  const std::string config_filename =
+      argc > 1 ? argv[1] : "default_config.ini";
+  const int max_thread_count =
+      argc > 2 ? std::stoi(argv[2])
+               : std::max(1U, std::thread::hardware_concurrency());
+  std::vector<std::string> input_filenames(std::begin(kDefaultInputs),
+                                           std::end(kDefaultInputs));
+  if (argc > 3) {
+    input_filenames.assign(argv + 3, argv + argc);
+  }
+
+  RapidJSONReader json_reader;
+  for (const auto& input_filename : input_filenames) {
+    double sequential_time = 0;
+    for (int thread_count = 1; thread_count <= max_thread_count;
+         thread_count *= 2) {
+      auto thread_config_filename =
+          WriteThreadConfig(config_filename, thread_count);
+      auto overall_time = MeasureAverageNanoseconds(
+          1, [&]() { Core::Run(input_filename, thread_config_filename); });
+      std::remove(thread_config_filename.c_str());
+      // Microseconds spent scheduling, measured by the scheduler itself.
+      auto schedule_time =
+          json_reader.ReadValueMap(kStatsFilename).at("schedule_time") * 1000;
+      if (thread_count == 1) {
+        sequential_time = schedule_time;
+      }
+      auto name = input_filename + " " + std::to_string(thread_count) + "T";
+      PrintResult(name + " overall", overall_time);
+      PrintResult(name + " schedule", schedule_time);
+      std::cout << "speedup: " << sequential_time / schedule_time << std::endl;
+    }
+  }
+  return 0;
+}
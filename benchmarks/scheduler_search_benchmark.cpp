@@ -0,0 +1,218 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "benchmark_timer.hpp"
+#include "elastic_scheduling_graph_parser.hpp"
+#include "fpga_driver_factory.hpp"
+#include "plan_cost_estimator.hpp"
+#include "pr_module_data.hpp"
+#include "reconfiguration_cost_model.hpp"
+#include "scheduling_query_node.hpp"
+#include "table_data.hpp"
+
+using orkhestrafs::benchmarks::MeasureAverageNanoseconds;
+using orkhestrafs::benchmarks::PrintResult;
+using orkhestrafs::core_interfaces::hw_library::OperationPRModules;
+using orkhestrafs::core_interfaces::operation_types::QueryOperationType;
+using orkhestrafs::core_interfaces::table_data::TableMetadata;
+using orkhestrafs::dbmstodspi::ElasticSchedulingGraphParser;
+using orkhestrafs::dbmstodspi::FPGADriverFactory;
+using orkhestrafs::dbmstodspi::ModuleSelection;
+using orkhestrafs::dbmstodspi::PlanCostEstimator;
+using orkhestrafs::dbmstodspi::ReconfigurationCostModel;
+using orkhestrafs::dbmstodspi::SchedulingQueryNode;
+using orkhestrafs::dbmstodspi::TranspositionTable;
+
+namespace {
+const int kIterations = 5;
+const std::string kResourceString = "MMDMDBMMDBMMDMDBMMDBMMDMDBMMDBM";
+const double kStreamingSpeed = 4800;
+
+auto CreateCostEstimator(
+    const std::map<QueryOperationType, OperationPRModules>& hw_library)
+    -> std::unique_ptr<PlanCostEstimator> {
+  return std::make_unique<PlanCostEstimator>(
+      hw_library, kResourceString, kStreamingSpeed,
+      ReconfigurationCostModel({}, kResourceString,
+                               {{'M', 216 * 372}, {'D', 200 * 372},
+                                {'B', 196 * 372}},
+                               66),
+      std::vector<ScheduledModule>{}, std::map<std::string, double>{},
+      std::set<std::string>{});
+}
+
+// Every operation can be placed at every column with the given lengths.
+auto CreateOperationModules(const std::string& name, int column_count,
+                            const std::vector<std::vector<int>>& capacities)
+    -> OperationPRModules {
+  OperationPRModules operation_modules;
+  operation_modules.starting_locations.resize(column_count);
+  for (int module_index = 0; module_index < capacities.size();
+       module_index++) {
+    int length = module_index + 1;
+    for (int column = 0; column + length <= column_count; column++) {
+      auto bitstream_name = name + "_" + std::to_string(module_index) + "_" +
+                            std::to_string(column) + ".bin";
+      operation_modules.starting_locations.at(column).push_back(
+          bitstream_name);
+      operation_modules.bitstream_map.insert(
+          {bitstream_name,
+           {{column},
+            length,
+            capacities.at(module_index),
+            std::string(length, 'M'),
+            false}});
+    }
+  }
+  return operation_modules;
+}
+
+// Independent filter -> multiplication -> aggregation chains.
+void AddChain(
+    const std::string& name,
+    const std::map<QueryOperationType, OperationPRModules>& hw_library,
+    std::unordered_map<std::string, SchedulingQueryNode>& graph,
+    std::map<std::string, TableMetadata>& tables) {
+  auto table_name = name + "_table";
+  tables.insert({table_name, {4, 1000, {}}});
+  graph.insert(
+      {name + "_filter",
+       {QueryOperationType::kFilter,
+        {24, 2},
+        {},
+        {name + "_multiplication"},
+        {table_name},
+        hw_library.at(QueryOperationType::kFilter).starting_locations,
+        nullptr}});
+  graph.insert(
+      {name + "_multiplication",
+       {QueryOperationType::kMultiplication,
+        {},
+        {{name + "_filter", 0}},
+        {name + "_aggregation"},
+        {""},
+        hw_library.at(QueryOperationType::kMultiplication).starting_locations,
+        nullptr}});
+  graph.insert(
+      {name + "_aggregation",
+       {QueryOperationType::kAggregationSum,
+        {},
+        {{name + "_multiplication", 0}},
+        {""},
+        {""},
+        hw_library.at(QueryOperationType::kAggregationSum).starting_locations,
+        nullptr}});
+}
+}  // namespace
+
+auto main(int argc, char* argv[]) -> int {
+  const int chain_count = argc > 1 ? std::stoi(argv[1]) : 1;
+  const int column_count = argc > 2 ? std::stoi(argv[2]) : 10;
+  const int transposition_table_size = argc > 3 ? std::stoi(argv[3]) : 0;
+  const bool use_branch_and_bound = argc > 4 && std::stoi(argv[4]) != 0;
+  // Beam search instead of the exhaustive search if positive.
+  const int beam_width = argc > 5 ? std::stoi(argv[5]) : 0;
+  // Dynamic programming instead of the exhaustive search if set.
+  const bool use_dynamic_programming = argc > 6 && std::stoi(argv[6]) != 0;
+
+  std::map<QueryOperationType, OperationPRModules> hw_library = {
+      {QueryOperationType::kFilter,
+       CreateOperationModules("filter", column_count, {{16, 2}, {32, 4}})},
+      {QueryOperationType::kMultiplication,
+       CreateOperationModules("multiplication", column_count, {{}})},
+      {QueryOperationType::kAggregationSum,
+       CreateOperationModules("aggregation", column_count, {{}})}};
+  std::unordered_map<std::string, SchedulingQueryNode> graph;
+  std::map<std::string, TableMetadata> tables;
+  std::unordered_set<std::string> available_nodes;
+  for (int chain_index = 0; chain_index < chain_count; chain_index++) {
+    auto name = "chain" + std::to_string(chain_index);
+    AddChain(name, hw_library, graph, tables);
+    available_nodes.insert(name + "_filter");
+  }
+  auto drivers = FPGADriverFactory().CreateAcceleratorLibrary(nullptr);
+
+  long explored_branch_count = 0;
+  long pruned_branch_count = 0;
+  std::map<std::vector<std::vector<ScheduledModule>>,
+           ExecutionPlanSchedulingData>
+      resulting_plans;
+  TranspositionTable::Statistics table_statistics;
+  auto search_time = MeasureAverageNanoseconds(kIterations, [&]() {
+    ElasticSchedulingGraphParser parser(
+        hw_library, {{{ModuleSelection("ALL_AVAILABLE")}}, {}}, {}, *drivers,
+        true, false, false, false, 1, transposition_table_size);
+    if (use_branch_and_bound || beam_width > 0 || use_dynamic_programming) {
+      parser.SetPlanCostEstimator(CreateCostEstimator(hw_library),
+                                  use_branch_and_bound);
+    }
+    parser.SetTimeLimit(std::chrono::system_clock::time_point::max());
+    if (beam_width > 0) {
+      parser.PlaceNodesWithBeamSearch(beam_width, available_nodes, {}, graph,
+                                      {}, {}, tables, {}, {}, 0);
+    } else if (use_dynamic_programming) {
+      parser.PlaceNodesWithDynamicProgramming(available_nodes, {}, graph, {},
+                                              {}, tables, {}, {}, 0);
+    } else {
+      parser.PlaceNodesRecursively(available_nodes, {}, graph, {}, {}, tables,
+                                   {}, {}, 0);
+    }
+    explored_branch_count = parser.GetExploredBranchCount();
+    pruned_branch_count = parser.GetPrunedBranchCount();
+    resulting_plans = parser.GetResultingPlan();
+    table_statistics = parser.GetTranspositionTableStatistics();
+  });
+
+  PrintResult("search", search_time);
+  PrintResult("search per explored branch",
+              search_time / explored_branch_count);
+  auto cost_estimator = CreateCostEstimator(hw_library);
+  std::vector<PlanCostEstimator::ConfiguredRun> configured_runs;
+  double best_plan_cost = std::numeric_limits<double>::max();
+  for (const auto& [plan, scheduling_data] : resulting_plans) {
+    best_plan_cost = std::min(
+        best_plan_cost,
+        cost_estimator->GetPlanCost(plan, scheduling_data.streamed_data_size,
+                                    configured_runs));
+  }
+  std::cout << "plans: " << resulting_plans.size() << std::endl;
+  std::cout << "best plan cost: " << best_plan_cost << std::endl;
+  std::cout << "explored branches: " << explored_branch_count << std::endl;
+  std::cout << "explored branches per second: "
+            << static_cast<long>(explored_branch_count * 1e9 / search_time)
+            << std::endl;
+  if (transposition_table_size > 0) {
+    std::cout << "transposition table hits: " << table_statistics.hits << "/"
+              << table_statistics.lookups << std::endl;
+  }
+  if (use_branch_and_bound) {
+    std::cout << "pruned branches: " << pruned_branch_count << std::endl;
+  }
+  return 0;
+}
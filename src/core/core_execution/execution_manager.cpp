@@ -21,10 +21,16 @@ limitations under the License.
 #include <iostream>
 #include <memory>
 
+#include "logger.hpp"
 #include "query_scheduling_helper.hpp"
+#include "speculative_configurator.hpp"
 
 using orkhestrafs::core::core_execution::ExecutionManager;
+using orkhestrafs::dbmstodspi::ILA;
+using orkhestrafs::dbmstodspi::logging::Log;
+using orkhestrafs::dbmstodspi::logging::LogLevel;
 using orkhestrafs::dbmstodspi::QuerySchedulingHelper;
+using orkhestrafs::dbmstodspi::SpeculativeConfigurator;
 
 auto ExecutionManager::IsSWBackupEnabled() -> bool {
   return config_.enable_sw_backup;
@@ -32,8 +38,10 @@ auto ExecutionManager::IsSWBackupEnabled() -> bool {
 auto ExecutionManager::IsHWPrintEnabled() -> bool { return print_hw_; }
 
 void ExecutionManager::LoadBitstream(ScheduledModule new_module) {
-  auto dma_module = accelerator_library_->GetDMAModule();
-  memory_manager_->LoadPartialBitstream({new_module.bitstream}, *dma_module);
+  auto bitstreams_to_load = reconfiguration_planner_.GetMinimalLoadSequence(
+      {new_module.bitstream}, {new_module});
+  LoadAndRecordBitstreams(bitstreams_to_load, {new_module},
+                          LoadCause::kManual);
   query_manager_->GetPRBitstreamsToLoadWithPassthroughModules(
       current_configuration_, {new_module}, current_routing_);
 }
@@ -107,7 +115,30 @@ void ExecutionManager::PrintHWState() {
 
 auto ExecutionManager::GetFPGASpeed() -> int { return config_.clock_speed; }
 
-void ExecutionManager::SetFinishedFlag() { busy_flag_ = false; }
+void ExecutionManager::SetFinishedFlag() {
+  busy_flag_ = false;
+  if (!config_.performance_counters_file.empty() &&
+      !performance_report_.GetRecords().empty()) {
+    performance_report_.WriteJSON(config_.performance_counters_file + ".json");
+    performance_report_.WriteCSV(config_.performance_counters_file + ".csv");
+  }
+  if (!config_.reconfiguration_timeline_file.empty() &&
+      !reconfiguration_timeline_.GetLoads().empty()) {
+    reconfiguration_timeline_.WriteCSV(config_.reconfiguration_timeline_file +
+                                       ".csv");
+    reconfiguration_timeline_.WriteSummaryJSON(
+        config_.reconfiguration_timeline_file + "_summary.json");
+  }
+}
+
+void ExecutionManager::FinishQuery() {
+  residency_manager_.FinishQuery();
+  auto stats = residency_manager_.GetStats();
+  Log(LogLevel::kInfo,
+      "Configuration bytes loaded: " + std::to_string(stats.loaded_bytes) +
+          "; saved by reuse: " + std::to_string(stats.saved_bytes) +
+          "; queries: " + std::to_string(stats.query_count));
+}
 
 void ExecutionManager::UpdateAvailableNodesGraph() {
   current_available_node_pointers_.clear();
@@ -421,6 +452,8 @@ auto ExecutionManager::IsRunReadyForExecution() -> bool {
 }
 
 void ExecutionManager::ScheduleUnscheduledNodes() {
+  scheduler_->SetModuleReuseWeights(residency_manager_.GetReuseWeights());
+  scheduler_->SetPinnedModules(residency_manager_.GetPinnedModules());
   query_node_runs_queue_ = query_manager_->ScheduleNextSetOfNodes(
       current_available_node_pointers_, nodes_constrained_to_first_,
       current_available_node_names_, current_query_graph_,
@@ -492,10 +525,26 @@ void ExecutionManager::SetupNextRunData() {
   /*query_manager_->LoadInitialStaticBitstream(memory_manager_.get());
   query_manager_->LoadEmptyRoutingPRRegion(memory_manager_.get(),
                                            *accelerator_library_.get());*/
+  // Prefetched modules were loaded for this run so they don't count as reuse.
+  std::vector<ScheduledModule> configuration_before;
+  for (const auto& module : current_configuration_) {
+    if (std::find(prefetched_modules_.begin(), prefetched_modules_.end(),
+                  module) == prefetched_modules_.end()) {
+      configuration_before.push_back(module);
+    }
+  }
+  prefetched_modules_.clear();
+  if (configuration_verifier_ && configuration_verifier_->IsVerificationDue()) {
+    VerifyConfiguration();
+  }
+  residency_manager_.RecordRun(query_node_runs_queue_.front().first,
+                               configuration_before);
   auto [bitstreams_to_load, empty_modules] =
       query_manager_->GetPRBitstreamsToLoadWithPassthroughModules(
           current_configuration_, query_node_runs_queue_.front().first,
           current_routing_);
+  bitstreams_to_load = reconfiguration_planner_.GetMinimalLoadSequence(
+      bitstreams_to_load, query_node_runs_queue_.front().first);
   /*bitstreams_to_load = {"binPartial_Static1_0_96.bin"};
   empty_modules = {
       {QueryOperationType::kFilter, false},
@@ -514,8 +563,9 @@ void ExecutionManager::SetupNextRunData() {
   // bitstreams_to_load = {"byteman_BWplusSobel_67_96.bin"};
   /*query_manager_->LoadPRBitstreams(memory_manager_.get(), bitstreams_to_load,
    *accelerator_library_);*/
-  config_time_ += query_manager_->LoadPRBitstreams(
-      memory_manager_.get(), bitstreams_to_load, *accelerator_library_);
+  current_run_modules_ = query_node_runs_queue_.front().first;
+  config_time_ += LoadAndRecordBitstreams(
+      bitstreams_to_load, current_run_modules_, LoadCause::kRun);
   if (print_hw_) {
     std::cout << "Loading: ";
     for (const auto& bitstream : bitstreams_to_load) {
@@ -534,6 +584,55 @@ void ExecutionManager::SetupNextRunData() {
   /*query_manager_->LoadPRBitstreams(memory_manager_.get(),config_.debug_forced_pr_bitstreams,
    *accelerator_library_.get()); exit(0);*/
   auto next_scheduled_run_nodes = PopNextScheduledRun();
+  prefetch_bitstreams_.clear();
+  if (config_.enable_speculative_prefetch && !query_node_runs_queue_.empty()) {
+    auto first_idle_column =
+        SpeculativeConfigurator::GetFirstIdleColumn(current_routing_);
+    prefetched_modules_ = SpeculativeConfigurator::GetPrefetchableModules(
+        current_configuration_, query_node_runs_queue_.front().first,
+        current_routing_);
+    auto configuration_before_prefetch = current_configuration_;
+    auto routing_before_prefetch = current_routing_;
+    auto load_sequence = reconfiguration_planner_.GetMinimalLoadSequence(
+        SpeculativeConfigurator::ReserveModules(
+            current_configuration_, prefetched_modules_, current_routing_),
+        prefetched_modules_);
+    // Prefetching doesn't decouple the PR region so the running data path
+    // mustn't get touched. Such bitstreams get loaded with the next run.
+    bool is_prefetch_reduced = false;
+    for (const auto& bitstream : load_sequence) {
+      auto columns = reconfiguration_planner_.GetBitstreamColumns(
+          bitstream, prefetched_modules_);
+      if (columns.first < first_idle_column) {
+        Log(LogLevel::kDebug,
+            "Not prefetching into the data path: " + bitstream);
+        reconfiguration_planner_.InvalidateColumns(columns);
+        prefetched_modules_.erase(
+            std::remove_if(prefetched_modules_.begin(),
+                           prefetched_modules_.end(),
+                           [&](const auto& module) {
+                             return module.bitstream == bitstream;
+                           }),
+            prefetched_modules_.end());
+        is_prefetch_reduced = true;
+      } else {
+        prefetch_bitstreams_.push_back(bitstream);
+      }
+    }
+    if (is_prefetch_reduced) {
+      current_configuration_ = std::move(configuration_before_prefetch);
+      current_routing_ = std::move(routing_before_prefetch);
+      SpeculativeConfigurator::ReserveModules(
+          current_configuration_, prefetched_modules_, current_routing_);
+    }
+    if (print_hw_ && !prefetch_bitstreams_.empty()) {
+      std::cout << "Prefetching: ";
+      for (const auto& bitstream : prefetch_bitstreams_) {
+        std::cout << bitstream << ", ";
+      }
+      std::cout << std::endl;
+    }
+  }
   scheduled_node_names_.clear();
   for (const auto& node : next_scheduled_run_nodes) {
     scheduled_node_names_.push_back(node->node_name);
@@ -585,10 +684,54 @@ void ExecutionManager::SetupNextRunData() {
   result_parameters_ = std::move(execution_nodes_and_result_params.second);
 }
 void ExecutionManager::ExecuteAndProcessResults() {
-  query_manager_->ExecuteAndProcessResults(
+  if (std::any_of(scheduled_node_names_.begin(), scheduled_node_names_.end(),
+                  [&](const auto& node_name) {
+                    return std::find(config_.ila_capture_nodes.begin(),
+                                     config_.ila_capture_nodes.end(),
+                                     node_name) !=
+                           config_.ila_capture_nodes.end();
+                  })) {
+    fpga_manager_->CaptureILAOfNextRun(
+        std::make_unique<ILA>(memory_manager_.get()),
+        config_.ila_capture_file + "_" +
+            std::to_string(performance_report_.GetRecords().size()) + ".vcd",
+        config_.clock_speed);
+  }
+  auto run_start = GetTimelineTime();
+  auto run_times = query_manager_->ExecuteAndProcessResults(
       memory_manager_.get(), fpga_manager_.get(), data_manager_.get(),
       table_memory_blocks_, result_parameters_, query_nodes_,
-      current_tables_metadata_, table_counter_, config_.execution_timeout);
+      current_tables_metadata_, table_counter_, config_.execution_timeout,
+      prefetch_bitstreams_);
+  reconfiguration_timeline_.RecordRun(current_run_modules_, run_start,
+                                      run_times.execution_time);
+  if (configuration_verifier_) {
+    configuration_verifier_->RecordRun();
+  }
+  // Prefetched loads overlap with the run but are timed separately.
+  for (int bitstream_i = 0; bitstream_i < prefetch_bitstreams_.size();
+       bitstream_i++) {
+    const auto& bitstream = prefetch_bitstreams_.at(bitstream_i);
+    const auto& [load_start, load_time] =
+        run_times.prefetch_times.at(bitstream_i);
+    auto columns = reconfiguration_planner_.GetBitstreamColumns(
+        bitstream, prefetched_modules_);
+    reconfiguration_timeline_.RecordLoad(bitstream, columns,
+                                         LoadCause::kPrefetch,
+                                         run_start + load_start, load_time);
+    if (configuration_verifier_) {
+      configuration_verifier_->RecordLoad(bitstream, columns);
+    }
+  }
+  prefetch_bitstreams_.clear();
+  const auto& run_record = performance_report_.AddRun(
+      scheduled_node_names_, fpga_manager_->GetLastRunPerformanceCounters(),
+      config_.clock_speed);
+  Log(LogLevel::kDebug,
+      "Run " + std::to_string(run_record.run_index) +
+          " input bandwidth = " + std::to_string(run_record.input_bandwidth) +
+          "[GB/s]; output bandwidth = " +
+          std::to_string(run_record.output_bandwidth) + "[GB/s]");
   // TODO(Kaspar): Remove this
   scheduled_node_names_.clear();
 }
@@ -602,6 +745,59 @@ auto ExecutionManager::PopNextScheduledRun() -> std::vector<QueryNode*> {
   return executable_query_nodes;
 }
 
+auto ExecutionManager::GetTimelineTime() const -> long {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - timeline_begin_)
+      .count();
+}
+
+auto ExecutionManager::LoadAndRecordBitstreams(
+    const std::vector<std::string>& bitstreams,
+    const std::vector<ScheduledModule>& new_modules, LoadCause cause)
+    -> long {
+  std::vector<std::pair<int, int>> columns;
+  for (const auto& bitstream : bitstreams) {
+    columns.push_back(
+        reconfiguration_planner_.GetBitstreamColumns(bitstream, new_modules));
+  }
+  std::vector<bool> is_configured(bitstreams.size(), false);
+  if (configuration_verifier_) {
+    is_configured =
+        configuration_verifier_->FindConfiguredBitstreams(bitstreams, columns);
+  }
+
+  long config_time = 0;
+  // Every load request has a fixed overhead so bitstreams are only loaded one
+  // by one when each of them has to be timed for the timeline.
+  bool is_timeline_enabled = !config_.reconfiguration_timeline_file.empty();
+  std::vector<std::string> bitstreams_to_load;
+  for (int bitstream_i = 0; bitstream_i < bitstreams.size(); bitstream_i++) {
+    const auto& bitstream = bitstreams.at(bitstream_i);
+    if (is_configured.at(bitstream_i)) {
+      Log(LogLevel::kDebug, "Readback matches already: " + bitstream);
+      continue;
+    }
+    if (is_timeline_enabled) {
+      auto load_start = GetTimelineTime();
+      config_time += query_manager_->LoadPRBitstreams(
+          memory_manager_.get(), {bitstream}, *accelerator_library_);
+      reconfiguration_timeline_.RecordLoad(bitstream, columns.at(bitstream_i),
+                                           cause, load_start,
+                                           GetTimelineTime() - load_start);
+    } else {
+      bitstreams_to_load.push_back(bitstream);
+    }
+    if (configuration_verifier_) {
+      configuration_verifier_->RecordLoad(bitstream, columns.at(bitstream_i));
+    }
+  }
+  if (!bitstreams_to_load.empty()) {
+    config_time += query_manager_->LoadPRBitstreams(
+        memory_manager_.get(), bitstreams_to_load, *accelerator_library_);
+  }
+  return config_time;
+}
+
 void ExecutionManager::PrintCurrentStats() {
   query_manager_->PrintBenchmarkStats();
 }
@@ -611,16 +807,47 @@ void ExecutionManager::SetClockSpeed(int new_clock_speed) {
 }
 
 void ExecutionManager::LoadStaticBitstream() {
+  if (config_.calibrate_reconfiguration) {
+    query_manager_->LoadInitialStaticBitstream(memory_manager_.get(),
+                                               config_.clock_speed);
+    config_.reconfiguration_costs =
+        query_manager_->MeasureBitstreamConfigurationSpeed(
+            config_.pr_hw_library, memory_manager_.get(),
+            config_.reconfiguration_profile_file);
+    config_.calibrate_reconfiguration = false;
+  }
+  // Reloading the static bitstream clears the PR region.
+  auto load_start = GetTimelineTime();
   query_manager_->LoadInitialStaticBitstream(memory_manager_.get(),
                                              config_.clock_speed);
+  reconfiguration_timeline_.RecordLoad(
+      "static", {0, static_cast<int>(config_.resource_string.size()) - 1},
+      LoadCause::kStatic, load_start, GetTimelineTime() - load_start);
+  reconfiguration_planner_.Reset();
+  if (configuration_verifier_) {
+    configuration_verifier_->Reset();
+  }
   // TODO: Remove the hardcoded aspect of this!
   current_routing_.clear();
   for (int i = 0; i < 31; i++) {
     current_routing_.push_back("RT");
   }
+}
 
-  /*query_manager_->MeasureBitstreamConfigurationSpeed(config_.pr_hw_library,
-                                                     memory_manager_.get());*/
+void ExecutionManager::VerifyConfiguration() {
+  if (!configuration_verifier_) {
+    Log(LogLevel::kWarning, "Configuration verification isn't enabled!");
+    return;
+  }
+  auto mismatched_regions = configuration_verifier_->Verify();
+  for (const auto& columns : mismatched_regions) {
+    reconfiguration_planner_.InvalidateColumns(columns);
+  }
+  Log(LogLevel::kInfo,
+      "Configuration verified; mismatched regions: " +
+          std::to_string(mismatched_regions.size()) +
+          "; skipped loads: " +
+          std::to_string(configuration_verifier_->GetSkippedLoadCount()));
 }
 
 void ExecutionManager::SetupSchedulingData(bool setup_bitstreams) {
@@ -25,6 +25,7 @@ limitations under the License.
 
 #include "accelerated_query_node.hpp"
 #include "accelerator_library_interface.hpp"
+#include "configuration_verifier.hpp"
 #include "data_manager_interface.hpp"
 #include "execution_manager_interface.hpp"
 #include "fpga_driver_factory_interface.hpp"
@@ -32,9 +33,13 @@ limitations under the License.
 #include "graph_processing_fsm_interface.hpp"
 #include "memory_block_interface.hpp"
 #include "memory_manager_interface.hpp"
+#include "module_residency_manager.hpp"
 #include "node_scheduler_interface.hpp"
+#include "performance_report.hpp"
 #include "query_manager_interface.hpp"
 #include "query_scheduling_data.hpp"
+#include "reconfiguration_planner.hpp"
+#include "reconfiguration_timeline.hpp"
 #include "scheduling_query_node.hpp"
 #include "state_interface.hpp"
 #include "graph_creator_interface.hpp"
@@ -48,13 +53,19 @@ using orkhestrafs::core_interfaces::query_scheduling_data::
     StreamResultParameters;
 using orkhestrafs::dbmstodspi::AcceleratedQueryNode;
 using orkhestrafs::dbmstodspi::AcceleratorLibraryInterface;
+using orkhestrafs::dbmstodspi::ConfigurationVerifier;
 using orkhestrafs::dbmstodspi::DataManagerInterface;
 using orkhestrafs::dbmstodspi::FPGADriverFactoryInterface;
 using orkhestrafs::dbmstodspi::FPGAManagerInterface;
 using orkhestrafs::dbmstodspi::GraphProcessingFSMInterface;
+using orkhestrafs::dbmstodspi::LoadCause;
 using orkhestrafs::dbmstodspi::MemoryManagerInterface;
+using orkhestrafs::dbmstodspi::ModuleResidencyManager;
 using orkhestrafs::dbmstodspi::NodeSchedulerInterface;
+using orkhestrafs::dbmstodspi::PerformanceReport;
 using orkhestrafs::dbmstodspi::QueryManagerInterface;
+using orkhestrafs::dbmstodspi::ReconfigurationPlanner;
+using orkhestrafs::dbmstodspi::ReconfigurationTimeline;
 using orkhestrafs::dbmstodspi::SchedulingQueryNode;
 using orkhestrafs::dbmstodspi::StateInterface;
 using orkhestrafs::dbmstodspi::GraphCreatorInterface;
@@ -80,6 +91,21 @@ class ExecutionManager : public ExecutionManagerInterface,
         scheduler_{std::move(scheduler)},
         graph_creator_{std::move(graph_creator)},
         config_{std::move(config)},
+        residency_manager_{config_.resource_string, config_.cost_of_columns,
+                           config_.pinned_modules},
+        reconfiguration_planner_{
+            static_cast<int>(config_.resource_string.size()),
+            config_.combined_routing_bitstreams},
+        reconfiguration_timeline_{
+            static_cast<int>(config_.resource_string.size())},
+        configuration_verifier_{
+            config_.enable_configuration_verification
+                ? std::make_unique<ConfigurationVerifier>(
+                      driver_factory->CreateReadbackSource(),
+                      config_.resource_string, config_.cost_of_columns,
+                      config_.readback_region_offset,
+                      config_.configuration_verification_interval)
+                : nullptr},
         accelerator_library_{std::move(
             driver_factory->CreateAcceleratorLibrary(memory_manager_.get()))},
         fpga_manager_{std::move(
@@ -103,6 +129,7 @@ class ExecutionManager : public ExecutionManagerInterface,
   void PrintHWState() override;
   auto GetFPGASpeed() -> int override;
   void SetFinishedFlag() override;
+  void FinishQuery() override;
   void UpdateAvailableNodesGraph() override;
   void Execute(
       std::unique_ptr<ExecutionPlanGraphInterface> execution_graph) override;
@@ -119,6 +146,7 @@ class ExecutionManager : public ExecutionManagerInterface,
 
   void BenchmarkScheduleUnscheduledNodes() override;
   auto IsBenchmarkDone() -> bool override;
+  void VerifyConfiguration() override;
 
  private:
   long config_time_;
@@ -132,6 +160,16 @@ class ExecutionManager : public ExecutionManagerInterface,
   std::unique_ptr<NodeSchedulerInterface> scheduler_;
   std::unique_ptr<GraphCreatorInterface> graph_creator_;
   Config config_;
+  // Cross query module usage.
+  ModuleResidencyManager residency_manager_;
+  // Bitstreams configured in the PR region.
+  ReconfigurationPlanner reconfiguration_planner_;
+  // Every load and run of the session.
+  ReconfigurationTimeline reconfiguration_timeline_;
+  std::chrono::steady_clock::time_point timeline_begin_ =
+      std::chrono::steady_clock::now();
+  // Null if the configuration isn't verified.
+  std::unique_ptr<ConfigurationVerifier> configuration_verifier_;
   // State status
   bool print_hw_ = false;
   std::chrono::steady_clock::time_point exec_begin;
@@ -156,15 +194,25 @@ class ExecutionManager : public ExecutionManagerInterface,
   std::queue<std::pair<std::vector<ScheduledModule>, std::vector<QueryNode*>>>
       query_node_runs_queue_;
   std::vector<ScheduledModule> current_configuration_;
+  // Next run's bitstreams to load while the current run is streaming.
+  std::vector<std::string> prefetch_bitstreams_;
+  std::vector<ScheduledModule> prefetched_modules_;
+  std::vector<ScheduledModule> current_run_modules_;
 
   // Clear for each run
   std::map<std::string, std::vector<StreamResultParameters>> result_parameters_;
   std::vector<AcceleratedQueryNode> query_nodes_;
   std::vector<std::string> scheduled_node_names_;
 
+  PerformanceReport performance_report_;
+
   auto GetModuleCapacity(int module_position, QueryOperationType operation)
       -> std::vector<int>;
   auto PopNextScheduledRun() -> std::vector<QueryNode*>;
+  auto GetTimelineTime() const -> long;
+  auto LoadAndRecordBitstreams(const std::vector<std::string>& bitstreams,
+                               const std::vector<ScheduledModule>& new_modules,
+                               LoadCause cause) -> long;
 
   // TODO(Kaspar): Move this to a different class
   static auto GetCurrentNodeIndexFromNextNode(QueryNode* current_node,
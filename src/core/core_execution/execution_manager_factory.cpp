@@ -16,6 +16,10 @@ limitations under the License.
 
 #include "execution_manager_factory.hpp"
 
+#include <map>
+#include <set>
+#include <string>
+
 #include "csv_reader.hpp"
 #include "data_manager.hpp"
 #include "elastic_resource_scheduler.hpp"
@@ -65,12 +69,41 @@ auto ExecutionManagerFactory::GetManager(const Config& config,
     }
   }
 
+  auto memory_manager = std::make_unique<MemoryManager>();
+  memory_manager->SetupBitstreamRelocation(config.bitstream_relocations);
+  std::map<std::string, std::string> compressed_bitstreams;
+  for (const auto& [operation, operation_modules] : config.pr_hw_library) {
+    for (const auto& [bitstream, module_data] :
+         operation_modules.bitstream_map) {
+      if (!module_data.compressed_bitstream.empty()) {
+        compressed_bitstreams.insert(
+            {bitstream, module_data.compressed_bitstream});
+      }
+    }
+  }
+  memory_manager->SetupCompressedBitstreams(compressed_bitstreams);
+  if (config.bitstream_cache_budget > 0) {
+    std::set<std::string> pr_bitstreams;
+    for (const auto& [operation, operation_modules] : config.pr_hw_library) {
+      for (const auto& [bitstream, module_data] :
+           operation_modules.bitstream_map) {
+        // Compressed bitstreams are staged compressed.
+        pr_bitstreams.insert(module_data.compressed_bitstream.empty()
+                                 ? bitstream
+                                 : module_data.compressed_bitstream);
+      }
+    }
+    memory_manager->SetupBitstreamCache(config.bitstream_cache_directory,
+                                        config.bitstream_cache_budget,
+                                        pr_bitstreams);
+  }
+
   return std::make_unique<ExecutionManager>(
       config,
       std::make_unique<QueryManager>(std::make_unique<RapidJSONReader>()),
       std::make_unique<DataManager>(config.data_sizes, config.csv_separator,
                                     std::make_unique<CSVReader>()),
-      std::make_unique<MemoryManager>(), std::move(start_state),
+      std::move(memory_manager), std::move(start_state),
       std::make_unique<FPGADriverFactory>(), std::move(scheduler),
       std::make_unique<GraphCreator>(std::make_unique<RapidJSONReader>(),
                                      nullptr));
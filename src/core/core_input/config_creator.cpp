@@ -21,12 +21,14 @@ limitations under the License.
 #include <sstream>
 #include <vector>
 
+#include "bitstream_relocator.hpp"
 #include "logger.hpp"
 #include "pr_module_data.hpp"
 #include "query_scheduling_data.hpp"
 #include "table_data.hpp"
 
 using orkhestrafs::core::core_input::ConfigCreator;
+using orkhestrafs::dbmstodspi::BitstreamRelocator;
 
 using orkhestrafs::core_interfaces::hw_library::PRModuleData;
 using orkhestrafs::core_interfaces::operation_types::QueryOperation;
@@ -45,7 +47,7 @@ auto ConfigCreator::GetConfig(const std::string& config_filename) -> Config {
 
   std::string force_pr = "DEBUG_FORCE_PR";
   std::string reduce_runs = "REDUCE_RUNS";
-  std::string max_runs = "MAX_RUNS_CAP";
+  std::string max_runs = "MAX_RUNS";
   std::string children = "PRIORITISE_CHILDREN";
   std::string heuristic = "HEURISTIC";
   std::string exec_timeout = "EXEC_TIMEOUT";
@@ -59,6 +61,16 @@ auto ConfigCreator::GetConfig(const std::string& config_filename) -> Config {
 
   std::string clock_speed = "FPGA_CLOCK_SPEED";
   std::string single_runs = "SINGLE_RUNS";
+  std::string scheduler_thread_count = "SCHEDULER_THREADS";
+  std::string scheduler_transposition_table_size =
+      "SCHEDULER_TRANSPOSITION_TABLE_SIZE";
+  std::string scheduler_branch_and_bound = "SCHEDULER_BRANCH_AND_BOUND";
+  std::string scheduler_anytime = "SCHEDULER_ANYTIME";
+  std::string scheduler_latency_budget = "SCHEDULER_LATENCY_BUDGET_MS";
+  std::string scheduler_convergence_file = "SCHEDULER_CONVERGENCE_FILE";
+  std::string scheduler_plan_cache_file = "SCHEDULER_PLAN_CACHE_FILE";
+  std::string scheduler_beam_width = "SCHEDULER_BEAM_WIDTH";
+  std::string scheduler_exact_node_limit = "SCHEDULER_EXACT_NODE_LIMIT";
   std::string scheduling_benchmark = "BENCHMARK_SCHEDULER";
   std::string check_bitstreams = "CHECK_BITSTREAMS";
   std::string check_tables = "CHECK_TABLES";
@@ -76,6 +88,21 @@ auto ConfigCreator::GetConfig(const std::string& config_filename) -> Config {
   std::string print_scheduling = "PRINT_SCHEDULING_TIME";
   std::string print_config = "PRINT_CONFIGURATION_TIME";
   std::string enable_sw_backup = "ENABLE_SW_BACKUP";
+  std::string performance_counters_file = "PERFORMANCE_COUNTERS_FILE";
+  std::string reconfiguration_timeline_file = "RECONFIGURATION_TIMELINE_FILE";
+  std::string ila_capture_nodes = "ILA_CAPTURE_NODES";
+  std::string ila_capture_file = "ILA_CAPTURE_FILE";
+  std::string bitstream_cache_directory = "BITSTREAM_CACHE_DIRECTORY";
+  std::string bitstream_cache_budget = "BITSTREAM_CACHE_BUDGET";
+  std::string enable_speculative_prefetch = "SPECULATIVE_PREFETCH";
+  std::string enable_configuration_verification = "VERIFY_CONFIGURATION";
+  std::string configuration_verification_interval = "VERIFICATION_INTERVAL";
+  std::string readback_region_offset = "READBACK_REGION_OFFSET";
+  std::string reconfiguration_profile = "RECONFIGURATION_PROFILE";
+  std::string calibrate_reconfiguration = "CALIBRATE_RECONFIGURATION";
+  std::string pinned_modules = "PINNED_MODULES";
+  std::string combined_routing_bitstreams = "COMBINED_ROUTING_BITSTREAMS";
+  std::string relocate_bitstreams = "RELOCATE_BITSTREAMS";
 
   // repo.json is hardcoded for now.
 
@@ -116,6 +143,42 @@ auto ConfigCreator::GetConfig(const std::string& config_filename) -> Config {
       config.use_single_runs;
   Log(LogLevel::kTrace,
       "use_single_runs: " + std::to_string(config.use_single_runs));
+  std::istringstream(config_values[scheduler_thread_count]) >>
+      config.scheduler_thread_count;
+  Log(LogLevel::kTrace, "scheduler_thread_count: " +
+                            std::to_string(config.scheduler_thread_count));
+  // Which plans the runs cap prunes depends on the order they are found in.
+  if (config.scheduler_thread_count > 1 && config.use_max_runs_cap) {
+    throw std::runtime_error(
+        "SCHEDULER_THREADS above 1 can only be used with MAX_RUNS = false!");
+  }
+  std::istringstream(config_values[scheduler_transposition_table_size]) >>
+      config.scheduler_transposition_table_size;
+  Log(LogLevel::kTrace,
+      "scheduler_transposition_table_size: " +
+          std::to_string(config.scheduler_transposition_table_size));
+  std::istringstream(config_values[scheduler_branch_and_bound]) >>
+      std::boolalpha >> config.use_branch_and_bound;
+  Log(LogLevel::kTrace,
+      "use_branch_and_bound: " + std::to_string(config.use_branch_and_bound));
+  std::istringstream(config_values[scheduler_anytime]) >> std::boolalpha >>
+      config.use_anytime_scheduling;
+  Log(LogLevel::kTrace, "use_anytime_scheduling: " +
+                            std::to_string(config.use_anytime_scheduling));
+  if (!config_values[scheduler_latency_budget].empty()) {
+    std::istringstream(config_values[scheduler_latency_budget]) >>
+        config.scheduler_latency_budget_in_milliseconds;
+  }
+  config.scheduler_convergence_file = config_values[scheduler_convergence_file];
+  config.plan_cache_file = config_values[scheduler_plan_cache_file];
+  std::istringstream(config_values[scheduler_beam_width]) >>
+      config.scheduler_beam_width;
+  Log(LogLevel::kTrace, "scheduler_beam_width: " +
+                            std::to_string(config.scheduler_beam_width));
+  std::istringstream(config_values[scheduler_exact_node_limit]) >>
+      config.scheduler_exact_node_limit;
+  Log(LogLevel::kTrace, "scheduler_exact_node_limit: " +
+                            std::to_string(config.scheduler_exact_node_limit));
   std::istringstream(config_values[scheduling_benchmark]) >> std::boolalpha >>
       config.benchmark_scheduler;
   Log(LogLevel::kTrace,
@@ -141,6 +204,39 @@ auto ConfigCreator::GetConfig(const std::string& config_filename) -> Config {
       config.print_config;
   std::istringstream(config_values[enable_sw_backup]) >> std::boolalpha >>
       config.enable_sw_backup;
+  config.performance_counters_file = config_values[performance_counters_file];
+  config.reconfiguration_timeline_file =
+      config_values[reconfiguration_timeline_file];
+  config.ila_capture_nodes =
+      SetCommaSeparatedValues(config_values[ila_capture_nodes]);
+  if (!config_values[ila_capture_file].empty()) {
+    config.ila_capture_file = config_values[ila_capture_file];
+  }
+  if (!config_values[bitstream_cache_directory].empty()) {
+    config.bitstream_cache_directory = config_values[bitstream_cache_directory];
+  }
+  std::istringstream(config_values[bitstream_cache_budget]) >>
+      config.bitstream_cache_budget;
+  std::istringstream(config_values[enable_speculative_prefetch]) >>
+      std::boolalpha >> config.enable_speculative_prefetch;
+  std::istringstream(config_values[enable_configuration_verification]) >>
+      std::boolalpha >> config.enable_configuration_verification;
+  std::istringstream(config_values[configuration_verification_interval]) >>
+      config.configuration_verification_interval;
+  std::istringstream(config_values[readback_region_offset]) >>
+      config.readback_region_offset;
+  config.reconfiguration_profile_file = config_values[reconfiguration_profile];
+  std::istringstream(config_values[calibrate_reconfiguration]) >>
+      std::boolalpha >> config.calibrate_reconfiguration;
+  if (FILE* file = fopen(config.reconfiguration_profile_file.c_str(), "r")) {
+    fclose(file);
+    config.reconfiguration_costs =
+        json_reader_->ReadValueMap(config.reconfiguration_profile_file);
+  }
+  config.pinned_modules =
+      SetCommaSeparatedValues(config_values[pinned_modules]);
+  config.combined_routing_bitstreams =
+      SetCommaSeparatedValues(config_values[combined_routing_bitstreams]);
 
   auto string_key_data_sizes =
       json_reader_->ReadValueMap(config_values[data_type_sizes]);
@@ -209,6 +305,15 @@ auto ConfigCreator::GetConfig(const std::string& config_filename) -> Config {
   if (config.check_bitstreams) {
     CheckBitstreamsExist(config.pr_hw_library);
   }
+  std::istringstream(config_values[relocate_bitstreams]) >> std::boolalpha >>
+      config.enable_bitstream_relocation;
+  if (config.enable_bitstream_relocation) {
+    config.bitstream_relocations = BitstreamRelocator::AddRelocatedBitstreams(
+        config.pr_hw_library, config.resource_string);
+    Log(LogLevel::kDebug,
+        std::to_string(config.bitstream_relocations.size()) +
+            " relocated bitstreams added");
+  }
 
   auto column_sizes = json_reader_->ReadValueMap(config_values[column_cost]);
   for (const auto& [column_type, size] : column_sizes) {
@@ -229,10 +334,14 @@ void ConfigCreator::CheckBitstreamsExist(
   for (const auto& [operation, bitstreams_info] : hw_library) {
     for (const auto& [bitstream_name, bitstream_info] :
          bitstreams_info.bitstream_map) {
-      if (FILE* file = fopen(bitstream_name.c_str(), "r")) {
+      // Compressed bitstreams get decompressed when they are loaded.
+      const auto& stored_bitstream = bitstream_info.compressed_bitstream.empty()
+                                         ? bitstream_name
+                                         : bitstream_info.compressed_bitstream;
+      if (FILE* file = fopen(stored_bitstream.c_str(), "r")) {
         fclose(file);
       } else {
-        throw std::runtime_error(bitstream_name + " doesn't exist!");
+        throw std::runtime_error(stored_bitstream + " doesn't exist!");
       }
     }
     for (int location = 0; location < bitstreams_info.starting_locations.size();
@@ -246,7 +355,7 @@ void ConfigCreator::CheckBitstreamsExist(
         }
         if (bitstreams_info.bitstream_map.at(bitstream_name)
                 .fitting_locations.at(0) != location) {
-          // Currently we don't do runtime relocation so just one location.
+          // Relocated bitstreams get their own names so just one location.
           throw std::runtime_error(bitstream_name + " is incorrectly placed!");
         }
       }
@@ -338,6 +447,7 @@ auto ConfigCreator::CreateHWLibrary(
   std::string capacity_field = "capacity";
   std::string resource_string_field = "string";
   std::string is_backwards_field = "is_backwards";
+  std::string compressed_field = "compressed";
 
   std::map<QueryOperationType, OperationPRModules> resulting_library;
 
@@ -357,6 +467,11 @@ auto ConfigCreator::CreateHWLibrary(
           std::get<int>(bitstream_parameters.at(length_field));
       current_module.resource_string =
           std::get<std::string>(bitstream_parameters.at(resource_string_field));
+      if (auto search = bitstream_parameters.find(compressed_field);
+          search != bitstream_parameters.end()) {
+        current_module.compressed_bitstream =
+            std::get<std::string>(search->second);
+      }
 
       bitstream_map.insert({bitstream_name, current_module});
     }
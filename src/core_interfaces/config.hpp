@@ -16,6 +16,7 @@ limitations under the License.
 
 #pragma once
 
+#include <cstdint>
 #include <map>
 #include <string>
 #include <utility>
@@ -25,6 +26,7 @@ limitations under the License.
 #include "query_scheduling_data.hpp"
 #include "table_data.hpp"
 
+using orkhestrafs::core_interfaces::hw_library::BitstreamRelocation;
 using orkhestrafs::core_interfaces::hw_library::OperationPRModules;
 using orkhestrafs::core_interfaces::operation_types::QueryOperation;
 using orkhestrafs::core_interfaces::operation_types::QueryOperationType;
@@ -54,6 +56,27 @@ struct Config {
 
   int clock_speed = 300;
   bool use_single_runs = false;
+  /// Threads searching the scheduling decision tree. 1 to search sequentially.
+  /// More threads can't be used with the max runs cap.
+  int scheduler_thread_count = 1;
+  /// Plan continuations kept for searched scheduler states. 0 to disable.
+  int scheduler_transposition_table_size = 0;
+  /// Prune scheduler branches which can't find a cheaper plan.
+  bool use_branch_and_bound = false;
+  /// Cost plans as they are found and use the cheapest found plan.
+  bool use_anytime_scheduling = false;
+  /// Anytime scheduling time limit. -1 to use the scheduler time limit.
+  double scheduler_latency_budget_in_milliseconds = -1;
+  /// Where the costs of cheaper anytime plans are logged against time.
+  std::string scheduler_convergence_file;
+  /// Where the chosen execution plans are cached. Empty to disable.
+  std::string plan_cache_file;
+  /// Partial plans kept by the beam search. 1 schedules greedily and 0 to
+  /// search exhaustively.
+  int scheduler_beam_width = 0;
+  /// Graphs with at most this many nodes are scheduled with dynamic
+  /// programming instead of searching all plans. 0 to disable.
+  int scheduler_exact_node_limit = 3;
   bool benchmark_scheduler = false;
   bool check_bitstreams = false;
   bool check_tables = false;
@@ -68,10 +91,48 @@ struct Config {
 
   bool enable_sw_backup = true;
 
+  /// Where to export the performance counters of each run. Empty to disable.
+  std::string performance_counters_file;
+  /// Where to export the reconfiguration timeline. Empty to disable.
+  std::string reconfiguration_timeline_file;
+  /// Runs containing any of these nodes get their ILA data exported.
+  std::vector<std::string> ila_capture_nodes;
+  /// Prefix of the exported VCD files.
+  std::string ila_capture_file = "ila_capture";
+
+  /// RAM backed directory to stage partial bitstreams in.
+  std::string bitstream_cache_directory = "/dev/shm/orkhestrafs_bitstreams";
+  /// How many bytes of bitstreams can be staged. 0 to disable staging.
+  uintmax_t bitstream_cache_budget = 0;
+  /// Load the next run's modules into idle PR regions during execution.
+  bool enable_speculative_prefetch = false;
+  /// Check loaded PR regions by reading back the configuration.
+  bool enable_configuration_verification = false;
+  /// Runs between verifications. 0 to only verify on demand.
+  int configuration_verification_interval = 0;
+  /// Where the PR region starts in the read back configuration.
+  uintmax_t readback_region_offset = 0;
+
   int execution_timeout = 60;
 
-  double streaming_speed = 4800000000;
-  double configuration_speed = 66000000;
+  /// Data streaming speed in MB/s.
+  double streaming_speed = 4800;
+  /// Configuration data streaming speed in MB/s.
+  double configuration_speed = 66;
+  /// Calibrated bitstream load times in microseconds.
+  std::map<std::string, double> reconfiguration_costs;
+  /// Where the calibrated load times are stored.
+  std::string reconfiguration_profile_file;
+  /// Measure the load times on the board and store them in the profile.
+  bool calibrate_reconfiguration = false;
+  /// Bitstreams kept configured across queries.
+  std::vector<std::string> pinned_modules;
+  /// Routing bitstreams covering multiple adjacent columns.
+  std::vector<std::string> combined_routing_bitstreams;
+  /// Create module bitstreams for other locations by relocation.
+  bool enable_bitstream_relocation = false;
+  /// Bitstreams created by relocation and how to create them.
+  std::map<std::string, BitstreamRelocation> bitstream_relocations;
 
   double scheduler_time_limit_in_seconds = -1;
 
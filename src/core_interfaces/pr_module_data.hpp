@@ -31,6 +31,8 @@ struct PRModuleData {
   std::vector<int> capacity;
   std::string resource_string;
   bool is_backwards;
+  // Empty if the bitstream isn't stored compressed.
+  std::string compressed_bitstream;
 };
 
 /**
@@ -42,4 +44,15 @@ struct OperationPRModules {
   std::map<std::string, PRModuleData> bitstream_map;
 };
 
+/**
+ * @brief Data to create a PR module bitstream for a different location from
+ * an existing bitstream of the same module.
+ */
+struct BitstreamRelocation {
+  std::string source_bitstream;
+  std::string location_template;
+  int column_shift;
+  bool is_template_end_aligned;
+};
+
 }  // namespace orkhestrafs::core_interfaces::hw_library
\ No newline at end of file
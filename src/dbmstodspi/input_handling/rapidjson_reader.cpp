@@ -264,6 +264,7 @@ auto RapidJSONReader::ReadHWLibraryData(std::string json_filename)
   std::string capacity_field = "capacity";
   std::string resource_string_field = "string";
   std::string is_backwards_field = "is_backwards";
+  std::string compressed_field = "compressed";
 
   const auto document = Read(json_filename);
   auto* document_ptr = document.get();
@@ -313,6 +314,11 @@ auto RapidJSONReader::ReadHWLibraryData(std::string json_filename)
       bitstream_parameters_map.insert(
           {is_backwards_field,
            bitstream_object.value[is_backwards_field.c_str()].GetInt()});
+      if (bitstream_object.value.HasMember(compressed_field.c_str())) {
+        bitstream_parameters_map.insert(
+            {compressed_field,
+             bitstream_object.value[compressed_field.c_str()].GetString()});
+      }
       operation_module_bitstream_map.insert(
           {bitstream_name, bitstream_parameters_map});
     }
@@ -35,6 +35,7 @@ void AcceleratorLibrary::SetupOperation(
   auto current_module = driver->CreateModule(
       memory_manager_, node_parameters.operation_module_location);
   driver->SetupModule(*current_module, node_parameters);
+  current_module->FlushWritesToModule();
   recent_setup_modules_.push_back(std::move(current_module));
 }
 
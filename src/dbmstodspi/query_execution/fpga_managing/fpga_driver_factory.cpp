@@ -26,6 +26,7 @@ limitations under the License.
 #include "filter_setup.hpp"
 #include "fpga_driver_factory.hpp"
 #include "fpga_manager.hpp"
+#include "fpga_readback_source.hpp"
 #include "join_setup.hpp"
 #include "linear_sort_setup.hpp"
 #include "merge_sort_setup.hpp"
@@ -70,3 +71,7 @@ auto FPGADriverFactory::CreateAcceleratorLibrary(
                                               std::make_unique<DMASetup>(),
                                               std::move(module_driver_library));
 }
+auto FPGADriverFactory::CreateReadbackSource()
+    -> std::unique_ptr<ReadbackSourceInterface> {
+  return std::make_unique<FPGAReadbackSource>();
+}
@@ -41,6 +41,12 @@ class FPGADriverFactory : public FPGADriverFactoryInterface {
    */
   auto CreateAcceleratorLibrary(MemoryManagerInterface* memory_manager)
       -> std::unique_ptr<AcceleratorLibraryInterface> override;
+  /**
+   * @brief Factory method to create configuration readback sources.
+   * @return Object to read back the configuration of the FPGA.
+   */
+  auto CreateReadbackSource()
+      -> std::unique_ptr<ReadbackSourceInterface> override;
 };
 
 }  // namespace orkhestrafs::dbmstodspi
\ No newline at end of file
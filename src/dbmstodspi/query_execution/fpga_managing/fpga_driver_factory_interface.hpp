@@ -21,6 +21,7 @@ limitations under the License.
 #include "accelerator_library_interface.hpp"
 #include "fpga_manager_interface.hpp"
 #include "memory_manager_interface.hpp"
+#include "readback_source_interface.hpp"
 
 namespace orkhestrafs::dbmstodspi {
 
@@ -35,6 +36,8 @@ class FPGADriverFactoryInterface {
       -> std::unique_ptr<FPGAManagerInterface> = 0;
   virtual auto CreateAcceleratorLibrary(MemoryManagerInterface* memory_manager)
       -> std::unique_ptr<AcceleratorLibraryInterface> = 0;
+  virtual auto CreateReadbackSource()
+      -> std::unique_ptr<ReadbackSourceInterface> = 0;
 };
 
 }  // namespace orkhestrafs::dbmstodspi
\ No newline at end of file
@@ -30,13 +30,21 @@ limitations under the License.
 #include "aggregation_sum.hpp"
 #include "dma_setup.hpp"
 #include "ila.hpp"
+#include "ila_capture.hpp"
 #include "logger.hpp"
 #include "operation_types.hpp"
+#include "performance_counter_collector.hpp"
+#include "pipeline_finder.hpp"
 #include "query_acceleration_constants.hpp"
 
 using orkhestrafs::core_interfaces::operation_types::QueryOperationType;
 using orkhestrafs::dbmstodspi::AcceleratedQueryNode;
 using orkhestrafs::dbmstodspi::FPGAManager;
+using orkhestrafs::dbmstodspi::ILACapture;
+using orkhestrafs::dbmstodspi::PerformanceCounterCollector;
+using orkhestrafs::dbmstodspi::PerformanceCounters;
+using orkhestrafs::dbmstodspi::PipelineData;
+using orkhestrafs::dbmstodspi::PipelineFinder;
 using orkhestrafs::dbmstodspi::logging::Log;
 using orkhestrafs::dbmstodspi::logging::LogLevel;
 
@@ -80,6 +88,17 @@ void FPGAManager::SetupQueryAcceleration(
     throw std::runtime_error("Input or output streams missing!");
   }
   dma_setup_.SetupDMAModule(*dma_engine_, input_streams, output_streams);
+  running_pipelines_ = PipelineFinder::FindPipelines(query_nodes);
+  run_streams_.clear();
+  for (const auto& stream : input_streams) {
+    run_streams_.push_back({stream.stream_id, true, stream.stream_record_size,
+                            stream.stream_record_count});
+  }
+  for (const auto& stream : output_streams) {
+    // Output record counts are only known once the pipeline finishes.
+    run_streams_.push_back(
+        {stream.stream_id, false, stream.stream_record_size, 0});
+  }
 
   dma_engine_->StartController(true, input_streams_active_status_);
 
@@ -134,35 +153,119 @@ void FPGAManager::FindIOStreams(
 auto FPGAManager::RunQueryAcceleration(
     int timeout, std::map<int, std::vector<double>>& read_back_values)
     -> std::array<int, query_acceleration_constants::kMaxIOStreamCount> {
+  StartQueryAcceleration();
+  std::array<int, query_acceleration_constants::kMaxIOStreamCount>
+      result_sizes{};
+  while (IsQueryAccelerationRunning()) {
+    for (const auto& [stream_id, record_count] :
+         WaitForFinishedPipelines(timeout, read_back_values)) {
+      result_sizes[stream_id] = record_count;
+    }
+  }
+  return result_sizes;
+}
+
+void FPGAManager::StartQueryAcceleration() {
   std::vector<int> active_input_stream_ids;
   std::vector<int> active_output_stream_ids;
-  // This can be expanded on in the future with multi threaded processing where
-  // some streams are checked while others are being setup and fired.
   FindActiveStreams(active_input_stream_ids, active_output_stream_ids);
 
   if (active_input_stream_ids.empty() || active_output_stream_ids.empty()) {
     throw std::runtime_error("FPGA does not have active streams!");
   }
 
-  std::chrono::steady_clock::time_point begin =
-      std::chrono::steady_clock::now();
-  WaitForStreamsToFinish(timeout);
-  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+#ifdef FPGA_AVAILABLE
+  if (capture_ila_module_) {
+    capture_ila_module_->StartILAs();
+  }
+#endif
+  acceleration_start_ = std::chrono::steady_clock::now();
+  dma_engine_->StartController(false, output_streams_active_status_);
+}
+
+auto FPGAManager::IsQueryAccelerationRunning() -> bool {
+  return !running_pipelines_.empty();
+}
+
+auto FPGAManager::WaitForFinishedPipelines(
+    int timeout, std::map<int, std::vector<double>>& read_back_values)
+    -> std::map<int, int> {
+  std::map<int, int> result_sizes;
+  if (running_pipelines_.empty()) {
+    return result_sizes;
+  }
+  auto finished_pipelines = FindFinishedPipelines(timeout);
+
+  std::bitset<query_acceleration_constants::kMaxIOStreamCount>
+      finished_output_streams;
+  for (const auto& pipeline : finished_pipelines) {
+    finished_output_streams |= pipeline.output_streams;
+    input_streams_active_status_ &= ~pipeline.input_streams;
+    output_streams_active_status_ &= ~pipeline.output_streams;
+  }
 
 #ifdef FPGA_AVAILABLE
-  ReadResultsFromRegisters(read_back_values);
+  ReadResultsFromRegisters(read_back_values, finished_output_streams);
 #endif
 
-  Log(LogLevel::kInfo,
-      "Execution time = " +
-          std::to_string(
-              std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
-                  .count()) +
-          "[microseconds]");
+  for (int stream_id = 0;
+       stream_id < query_acceleration_constants::kMaxIOStreamCount;
+       stream_id++) {
+    if (finished_output_streams[stream_id]) {
+      result_sizes.insert(
+          {stream_id, dma_engine_->GetControllerStreamSize(false, stream_id)});
+    }
+  }
+  for (auto& stream : run_streams_) {
+    if (!stream.is_input && result_sizes.find(stream.stream_id) !=
+                                result_sizes.end()) {
+      stream.record_count = result_sizes.at(stream.stream_id);
+    }
+  }
+
+  auto finish_time = std::chrono::duration_cast<std::chrono::microseconds>(
+                         std::chrono::steady_clock::now() - acceleration_start_)
+                         .count();
+  Log(LogLevel::kDebug, std::to_string(finished_pipelines.size()) +
+                            " pipeline(s) finished after " +
+                            std::to_string(finish_time) + "[microseconds]");
+
+  if (running_pipelines_.empty()) {
+    Log(LogLevel::kInfo,
+        "Execution time = " + std::to_string(finish_time) + "[microseconds]");
+    last_run_counters_ = PerformanceCounterCollector::CollectCounters(
+        *dma_engine_, run_streams_);
+    PrintDebuggingData();
+    if (capture_ila_module_) {
+      WriteILACapture();
+    }
+  }
+  return result_sizes;
+}
+
+auto FPGAManager::GetLastRunPerformanceCounters() -> PerformanceCounters {
+  return last_run_counters_;
+}
 
-  PrintDebuggingData();
-  return GetResultingStreamSizes(active_input_stream_ids,
-                                 active_output_stream_ids);
+void FPGAManager::CaptureILAOfNextRun(std::unique_ptr<ILA> ila_module,
+                                      std::string vcd_filename,
+                                      int clock_speed) {
+  capture_ila_module_ = std::move(ila_module);
+  capture_vcd_filename_ = std::move(vcd_filename);
+  capture_clock_speed_ = clock_speed;
+}
+
+void FPGAManager::WriteILACapture() {
+#ifdef FPGA_AVAILABLE
+  auto captures = ILACapture::ReadAllCaptures(*capture_ila_module_,
+                                              ILACapture::kCaptureDepth);
+  ILACapture::WriteVCDFile(captures, capture_clock_speed_,
+                           capture_vcd_filename_);
+  Log(LogLevel::kDebug, "ILA capture written to " + capture_vcd_filename_);
+#else
+  Log(LogLevel::kDebug, "ILA capture skipped without an FPGA!");
+#endif
+  capture_ila_module_.reset();
 }
 
 void FPGAManager::FindActiveStreams(
@@ -180,36 +283,62 @@ void FPGAManager::FindActiveStreams(
   }
 }
 
-void FPGAManager::WaitForStreamsToFinish(int timeout) {
-  dma_engine_->StartController(false, output_streams_active_status_);
+auto FPGAManager::FindFinishedPipelines(int timeout)
+    -> std::vector<PipelineData> {
+  std::vector<PipelineData> finished_pipelines;
 #ifdef FPGA_AVAILABLE
-  std::chrono::steady_clock::time_point begin =
-      std::chrono::steady_clock::now();
-  while (!(dma_engine_->IsControllerFinished(true) &&
-           dma_engine_->IsControllerFinished(false))) {
+  while (true) {
+    for (auto pipeline_it = running_pipelines_.begin();
+         pipeline_it != running_pipelines_.end();) {
+      if (IsPipelineFinished(*pipeline_it)) {
+        finished_pipelines.push_back(*pipeline_it);
+        pipeline_it = running_pipelines_.erase(pipeline_it);
+      } else {
+        ++pipeline_it;
+      }
+    }
+    if (!finished_pipelines.empty()) {
+      return finished_pipelines;
+    }
     if (std::chrono::duration_cast<std::chrono::seconds>(
-            std::chrono::steady_clock::now() - begin)
+            std::chrono::steady_clock::now() - acceleration_start_)
             .count() > timeout) {
       throw std::runtime_error("Execution timed out!");
     }
-    // sleep(3);
-    // std::cout << "Processing..." << std::endl;
-    // std::cout << "Input:"
-    //          << dma_engine_.IsInputControllerFinished()
-    //          << std::endl;
-    // std::cout << "Output:"
-    //          << dma_engine_.IsOutputControllerFinished()
-    //          << std::endl;
   }
+#else
+  // Without the FPGA every stream finishes straight away.
+  finished_pipelines = std::move(running_pipelines_);
+  running_pipelines_.clear();
 #endif
+  return finished_pipelines;
+}
+
+auto FPGAManager::IsPipelineFinished(const PipelineData& pipeline) -> bool {
+  for (int stream_id = 0;
+       stream_id < query_acceleration_constants::kMaxIOStreamCount;
+       stream_id++) {
+    if ((pipeline.input_streams[stream_id] &&
+         !dma_engine_->IsControllerStreamFinished(true, stream_id)) ||
+        (pipeline.output_streams[stream_id] &&
+         !dma_engine_->IsControllerStreamFinished(false, stream_id))) {
+      return false;
+    }
+  }
+  return true;
 }
 
 void FPGAManager::ReadResultsFromRegisters(
-    std::map<int, std::vector<double>>& read_back_values) {
+    std::map<int, std::vector<double>>& read_back_values,
+    const std::bitset<query_acceleration_constants::kMaxIOStreamCount>&
+        finished_output_streams) {
   if (!read_back_modules_.empty()) {
     // Assuming there are equal number of read back modules and parameters
     for (int module_index = 0; module_index < read_back_modules_.size();
          module_index++) {
+      if (!finished_output_streams[read_back_streams_ids_.at(module_index)]) {
+        continue;
+      }
       read_back_values.insert({read_back_streams_ids_.at(module_index), {}});
       for (auto const& position : read_back_parameters_.at(module_index)) {
         /*std::cout << "SUM: " << std::fixed << std::setprecision(2)
@@ -227,31 +356,6 @@ void FPGAManager::ReadResultsFromRegisters(
   }
 }
 
-auto FPGAManager::GetResultingStreamSizes(
-    const std::vector<int>& active_input_stream_ids,
-    const std::vector<int>& active_output_stream_ids)
-    -> std::array<int, query_acceleration_constants::kMaxIOStreamCount> {
-  for (auto stream_id : active_input_stream_ids) {
-    input_streams_active_status_[stream_id] = false;
-  }
-  std::array<int, query_acceleration_constants::kMaxIOStreamCount>
-      result_sizes{};
-  for (auto stream_id : active_output_stream_ids) {
-    output_streams_active_status_[stream_id] = false;
-    /*if (stream_id == 2) {
-      result_sizes[stream_id - 2] =
-          dma_engine_->GetControllerStreamSize(false, stream_id);
-      int yo = 0;
-    } else {
-      auto thing = dma_engine_->GetControllerStreamSize(false, stream_id);
-      int yo = 0;
-    }*/
-    result_sizes[stream_id] =
-        dma_engine_->GetControllerStreamSize(false, stream_id);
-  }
-  return result_sizes;
-}
-
 void FPGAManager::PrintDebuggingData() {
 #ifdef FPGA_AVAILABLE
   auto log_level = LogLevel::kTrace;
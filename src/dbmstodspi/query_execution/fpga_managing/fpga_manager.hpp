@@ -17,7 +17,9 @@ limitations under the License.
 #pragma once
 #include <array>
 #include <bitset>
+#include <chrono>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <optional>
 #include <string>
@@ -27,6 +29,8 @@ limitations under the License.
 #include "dma_interface.hpp"
 #include "dma_setup_interface.hpp"
 #include "fpga_manager_interface.hpp"
+#include "performance_counters.hpp"
+#include "pipeline_data.hpp"
 #include "read_back_module.hpp"
 #include "stream_data_parameters.hpp"
 
@@ -53,15 +57,24 @@ class FPGAManager : public FPGAManagerInterface {
   std::vector<std::vector<int>> read_back_parameters_;
   std::vector<int> read_back_streams_ids_;
   std::vector<std::vector<double>> read_back_values_;
+  std::vector<PipelineData> running_pipelines_;
+  std::chrono::steady_clock::time_point acceleration_start_;
+  std::vector<StreamPerformanceCounters> run_streams_;
+  PerformanceCounters last_run_counters_;
+  std::unique_ptr<ILA> capture_ila_module_;
+  std::string capture_vcd_filename_;
+  int capture_clock_speed_ = 0;
 
   void FindActiveStreams(std::vector<int>& active_input_stream_ids,
                          std::vector<int>& active_output_stream_ids);
-  void WaitForStreamsToFinish(int timeout);
-  void ReadResultsFromRegisters(std::map<int, std::vector<double>>& read_back_values);
-  auto GetResultingStreamSizes(const std::vector<int>& active_input_stream_ids,
-                               const std::vector<int>& active_output_stream_ids)
-      -> std::array<int, query_acceleration_constants::kMaxIOStreamCount>;
+  auto FindFinishedPipelines(int timeout) -> std::vector<PipelineData>;
+  auto IsPipelineFinished(const PipelineData& pipeline) -> bool;
+  void ReadResultsFromRegisters(
+      std::map<int, std::vector<double>>& read_back_values,
+      const std::bitset<query_acceleration_constants::kMaxIOStreamCount>&
+          finished_output_streams);
   void PrintDebuggingData();
+  void WriteILACapture();
   static void FindIOStreams(
       const std::vector<StreamDataParameters>& all_streams,
       std::vector<StreamDataParameters>& found_streams,
@@ -91,6 +104,48 @@ class FPGAManager : public FPGAManagerInterface {
   auto RunQueryAcceleration(int timeout, std::map<int, std::vector<double>>& read_back_values)
       -> std::array<int, query_acceleration_constants::kMaxIOStreamCount> override;
 
+  /**
+   * @brief Start the output controller without waiting for the streams to
+   * finish.
+   */
+  void StartQueryAcceleration() override;
+  /**
+   * @brief Check if any of the pipelines of the current run haven't been
+   * collected yet.
+   * @return Boolean showing if there are still pipelines running.
+   */
+  auto IsQueryAccelerationRunning() -> bool override;
+  /**
+   * @brief Wait until at least one of the running pipelines has finished. The
+   * streams of the finished pipelines are released.
+   *
+   * The released stream IDs and DMA channels are only reused by the next run.
+   * Queued nodes aren't started on them while the rest of the run is still
+   * streaming as the DMA setup of a run resets the whole engine.
+   * @param timeout How many seconds can the whole run take.
+   * @param read_back_values Map to which the read back module results of the
+   * finished pipelines get written to.
+   * @return How many records each output stream of the finished pipelines had
+   * in its results.
+   */
+  auto WaitForFinishedPipelines(
+      int timeout, std::map<int, std::vector<double>>& read_back_values)
+      -> std::map<int, int> override;
+  /**
+   * @brief Get the performance counters collected after the last run finished.
+   * @return Snapshot of the DMA counters and the data each stream moved.
+   */
+  auto GetLastRunPerformanceCounters() -> PerformanceCounters override;
+  /**
+   * @brief Capture the ILA cores during the next run and write the capture
+   * windows to a VCD file once all of the pipelines have finished.
+   * @param ila_module ILA to capture with.
+   * @param vcd_filename Output file.
+   * @param clock_speed Clock speed in MHz for the waveform timescale.
+   */
+  void CaptureILAOfNextRun(std::unique_ptr<ILA> ila_module,
+                           std::string vcd_filename, int clock_speed) override;
+
   /**
    * @brief Constructor to setup memory mapped registers.
    * @param module_library Library of the drivers and the modules.
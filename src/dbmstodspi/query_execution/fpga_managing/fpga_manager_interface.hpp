@@ -18,8 +18,12 @@ limitations under the License.
 #include <array>
 #include <vector>
 #include <map>
+#include <memory>
+#include <string>
 
 #include "accelerated_query_node.hpp"
+#include "ila.hpp"
+#include "performance_counters.hpp"
 #include "query_acceleration_constants.hpp"
 
 namespace orkhestrafs::dbmstodspi {
@@ -34,6 +38,16 @@ class FPGAManagerInterface {
 
   virtual auto RunQueryAcceleration(int timeout, std::map<int, std::vector<double>>& read_back_values)
       -> std::array<int, query_acceleration_constants::kMaxIOStreamCount> = 0;
+
+  virtual void StartQueryAcceleration() = 0;
+  virtual auto IsQueryAccelerationRunning() -> bool = 0;
+  virtual auto WaitForFinishedPipelines(
+      int timeout, std::map<int, std::vector<double>>& read_back_values)
+      -> std::map<int, int> = 0;
+  virtual auto GetLastRunPerformanceCounters() -> PerformanceCounters = 0;
+  virtual void CaptureILAOfNextRun(std::unique_ptr<ILA> ila_module,
+                                   std::string vcd_filename,
+                                   int clock_speed) = 0;
 };
 
 }  // namespace orkhestrafs::dbmstodspi
\ No newline at end of file
@@ -0,0 +1,52 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "fpga_readback_source.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include "bitstream_relocator.hpp"
+
+#ifdef FPGA_AVAILABLE
+#include "fpga.h"
+#endif
+
+using orkhestrafs::dbmstodspi::BitstreamRelocator;
+using orkhestrafs::dbmstodspi::FPGAReadbackSource;
+
+auto FPGAReadbackSource::ReadConfiguration() -> std::vector<char> {
+#ifdef FPGA_AVAILABLE
+  FPGAManager fpga_manager(0);
+  return fpga_manager.readbackImage();
+#else
+  throw std::runtime_error("Can't read back the configuration without FPGA!");
+#endif
+}
+
+auto FPGAReadbackSource::ReadBitstreamFrames(const std::string& bitstream)
+    -> std::vector<char> {
+  // Decompressed bitstreams are removed after loading.
+  std::ifstream input_file(bitstream, std::ios::binary);
+  if (!input_file) {
+    return {};
+  }
+  return BitstreamRelocator::GetFrameData(
+      {std::istreambuf_iterator<char>(input_file),
+       std::istreambuf_iterator<char>()});
+}
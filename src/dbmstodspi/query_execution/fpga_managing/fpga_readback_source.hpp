@@ -0,0 +1,38 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "readback_source_interface.hpp"
+
+namespace orkhestrafs::dbmstodspi {
+
+/**
+ * @brief Class to read back the configuration through the FPGA manager
+ * driver.
+ */
+class FPGAReadbackSource : public ReadbackSourceInterface {
+ public:
+  auto ReadConfiguration() -> std::vector<char> override;
+  auto ReadBitstreamFrames(const std::string& bitstream)
+      -> std::vector<char> override;
+};
+
+}  // namespace orkhestrafs::dbmstodspi
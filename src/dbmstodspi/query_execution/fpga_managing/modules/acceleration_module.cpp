@@ -16,55 +16,40 @@ limitations under the License.
 
 #include "acceleration_module.hpp"
 
-#include <sstream>
 #ifdef FPGA_AVAILABLE
 #include <unistd.h>
 #endif
 
-#include "logger.hpp"
-
 using orkhestrafs::dbmstodspi::AccelerationModule;
-using orkhestrafs::dbmstodspi::logging::Log;
-using orkhestrafs::dbmstodspi::logging::LogLevel;
-using orkhestrafs::dbmstodspi::logging::ShouldLog;
-
-auto AccelerationModule::CalculateMemoryMappedAddress(
-    int module_internal_address) -> volatile uint32_t* {
-  uintptr_t address_offset =
-      (1024 * 1024) * module_position_;  // calculate the main address
-                                         // of the target module
-  address_offset += module_internal_address;
-  return memory_manager_->GetVirtualRegisterAddress(address_offset);
-}
 
 void AccelerationModule::WriteToModule(
     int module_internal_address,  // Internal address of the memory mapped
                                   // register of the module
     uint32_t write_data           // Data to be written to module's register
 ) {
-  volatile uint32_t* register_address =
-      CalculateMemoryMappedAddress(module_internal_address);
-  auto log_level = LogLevel::kTrace;
-  if (ShouldLog(log_level)) {
-    std::stringstream ss;
-    ss << std::hex << "Module: " << module_position_
-       << " Address: " << module_internal_address << " Data: " << write_data;
-    Log(log_level, ss.str());
-  }
   // Uncomment to add an additional wait after writes
   /*#ifdef FPGA_AVAILABLE
     usleep(100);
   #endif*/
-  *register_address = write_data;
+  register_access_.Write(module_internal_address, write_data);
 }
 
 auto AccelerationModule::ReadFromModule(
     int module_internal_address  // Internal address of the memory mapped
                                  // register of the module
     ) -> volatile uint32_t {
-  volatile uint32_t* register_address =
-      CalculateMemoryMappedAddress(module_internal_address);
-  return *register_address;
+  return register_access_.Read(module_internal_address);
+}
+
+void AccelerationModule::QueueWriteToModule(int module_internal_address,
+                                            uint32_t write_data) {
+  register_access_.QueueWrite(module_internal_address, write_data);
+}
+
+void AccelerationModule::FlushWritesToModule() { register_access_.Flush(); }
+
+void AccelerationModule::ResetRegisterBase() {
+  register_access_.ResetBaseRegister();
 }
 
 AccelerationModule::~AccelerationModule() = default;
@@ -18,6 +18,7 @@ limitations under the License.
 #include <cstdint>
 
 #include "memory_manager_interface.hpp"
+#include "register_access.hpp"
 
 namespace orkhestrafs::dbmstodspi {
 
@@ -27,21 +28,10 @@ namespace orkhestrafs::dbmstodspi {
  */
 class AccelerationModule {
  private:
-  /// Memory manager instance to be able to access the register memory space.
-  MemoryManagerInterface* memory_manager_;
-  /// Location of the module on the FPGA.
-  const int module_position_;
-
-  /**
-   * @brief Calculate where the virtual memory address is memory mapped to.
-   *
-   * The result depends on the module position.
-   * @param module_internal_address Internal virtual address which is desired to
-   * be accessed.
-   * @return Global memory mapped address which can be read or written to.
-   */
-  auto CalculateMemoryMappedAddress(int module_internal_address)
-      -> volatile uint32_t*;
+  /// Address space of each module.
+  static const int kModuleAddressSpaceSize = 1024 * 1024;
+  /// Access to the registers of the module at the given position.
+  RegisterAccess register_access_;
 
  protected:
   /**
@@ -56,6 +46,19 @@ class AccelerationModule {
    * @return Data read from the register.
    */
   auto ReadFromModule(int module_internal_address) -> volatile uint32_t;
+  /**
+   * @brief Queue data to be written to a module configuration register. Queued
+   * data gets written with the next flush or before the next immediate
+   * register access.
+   * @param module_internal_address Internal address of the register.
+   * @param write_data Data to be written to the register.
+   */
+  void QueueWriteToModule(int module_internal_address, uint32_t write_data);
+  /**
+   * @brief Resolve the module's registers again with the next access. Needed
+   * by modules which are kept while a new static bitstream is loaded.
+   */
+  void ResetRegisterBase();
   /**
    * @brief Constructor to pass the memory manager instance and the module
    * position information.
@@ -66,10 +69,16 @@ class AccelerationModule {
    */
   AccelerationModule(MemoryManagerInterface* memory_manager,
                      int module_position)
-      : memory_manager_(memory_manager), module_position_(module_position){};
+      : register_access_(memory_manager,
+                         kModuleAddressSpaceSize * module_position){};
 
  public:
   virtual ~AccelerationModule() = 0;
+  /**
+   * @brief Write all of the queued data to the module registers. Done once
+   * the module has been set up.
+   */
+  void FlushWritesToModule();
 };
 
 }  // namespace orkhestrafs::dbmstodspi
\ No newline at end of file
@@ -21,24 +21,31 @@ limitations under the License.
 #include <iostream>
 #include <string>
 
+#ifdef REGISTER_TRACE_ENABLED
 #include "logger.hpp"
 
 using orkhestrafs::dbmstodspi::logging::Log;
 using orkhestrafs::dbmstodspi::logging::LogLevel;
+using orkhestrafs::dbmstodspi::logging::ShouldLog;
+#endif
 
 using orkhestrafs::dbmstodspi::DMA;
 
 void DMA::SetControllerParams(bool is_input, int stream_id, int ddr_burst_size,
                               int records_per_ddr_burst, int buffer_start,
                               int buffer_end) {
-  Log(LogLevel::kTrace,
-      "Controller params: is_input - " +
-          std::to_string(static_cast<int>(is_input)) + "; stream_id - " +
-          std::to_string(stream_id) + "; ddr_burst_size - " +
-          std::to_string(ddr_burst_size) + "; records_per_ddr_burst - " +
-          std::to_string(records_per_ddr_burst) + "; buffer_start - " +
-          std::to_string(buffer_start) + "; buffer_end - " +
-          std::to_string(buffer_end));
+#ifdef REGISTER_TRACE_ENABLED
+  if (ShouldLog(LogLevel::kTrace)) {
+    Log(LogLevel::kTrace,
+        "Controller params: is_input - " +
+            std::to_string(static_cast<int>(is_input)) + "; stream_id - " +
+            std::to_string(stream_id) + "; ddr_burst_size - " +
+            std::to_string(ddr_burst_size) + "; records_per_ddr_burst - " +
+            std::to_string(records_per_ddr_burst) + "; buffer_start - " +
+            std::to_string(buffer_start) + "; buffer_end - " +
+            std::to_string(buffer_end));
+  }
+#endif
   int base_address = (is_input) ? (1 << 6) : (1 << 16);
   AccelerationModule::WriteToModule(
       base_address + stream_id * 4,
@@ -55,10 +62,14 @@ auto DMA::GetControllerParams(bool is_input, int stream_id)
 
 void DMA::SetControllerStreamAddress(bool is_input, int stream_id,
                                      uintptr_t address) {
-  Log(LogLevel::kTrace, "Address: is_input - " +
-                            std::to_string(static_cast<int>(is_input)) +
-                            "; stream_id - " + std::to_string(stream_id) +
-                            "; address - " + std::to_string(address));
+#ifdef REGISTER_TRACE_ENABLED
+  if (ShouldLog(LogLevel::kTrace)) {
+    Log(LogLevel::kTrace,
+        "Address: is_input - " + std::to_string(static_cast<int>(is_input)) +
+            "; stream_id - " + std::to_string(stream_id) + "; address - " +
+            std::to_string(address));
+  }
+#endif
   int base_address = (is_input) ? (2 << 6) : ((1 << 16) + (1 << 6));
   AccelerationModule::WriteToModule(base_address + stream_id * 4, address >> 4);
 }
@@ -72,10 +83,14 @@ auto DMA::GetControllerStreamAddress(bool is_input, int stream_id)
 void DMA::SetControllerStreamSize(
     bool is_input, int stream_id,
     int size) {  // starting size of stream in amount of records
-  Log(LogLevel::kTrace, "Stream size: is_input - " +
-                            std::to_string(static_cast<int>(is_input)) +
-                            "; stream_id - " + std::to_string(stream_id) +
-                            "; size - " + std::to_string(size));
+#ifdef REGISTER_TRACE_ENABLED
+  if (ShouldLog(LogLevel::kTrace)) {
+    Log(LogLevel::kTrace,
+        "Stream size: is_input - " +
+            std::to_string(static_cast<int>(is_input)) + "; stream_id - " +
+            std::to_string(stream_id) + "; size - " + std::to_string(size));
+  }
+#endif
   int base_address = (is_input) ? (3 << 6) : ((1 << 16) + (2 << 6));
   AccelerationModule::WriteToModule(base_address + stream_id * 4, size);
 }
@@ -114,18 +129,29 @@ auto DMA::IsControllerFinished(bool is_input)
   return (AccelerationModule::ReadFromModule(base_address) == 0);
 }
 
+auto DMA::IsControllerStreamFinished(bool is_input, int stream_id)
+    -> bool {  // true if the stream's active bit has been cleared
+  int base_address = (is_input) ? (0) : ((1 << 16) + (3 << 6));
+  return ((AccelerationModule::ReadFromModule(base_address) >> stream_id) &
+          1) == 0;
+}
+
 // How many chunks is a record on a particular stream_id
 void DMA::SetRecordSize(int stream_id, int record_size) {
-  Log(LogLevel::kTrace, "Stream record size: stream_id - " +
-                            std::to_string(stream_id) + "; record_size - " +
-                            std::to_string(record_size));
+#ifdef REGISTER_TRACE_ENABLED
+  if (ShouldLog(LogLevel::kTrace)) {
+    Log(LogLevel::kTrace,
+        "Stream record size: stream_id - " + std::to_string(stream_id) +
+            "; record_size - " + std::to_string(record_size));
+  }
+#endif
   AccelerationModule::WriteToModule(((1 << 17) + (1 << 8) + (stream_id * 4)),
                                     record_size - 1);
 }
 // set ChunkID at clock cycle of interfaceCycle for records on a particular
-// stream_id
+// stream_id. Queued until the next immediate register access.
 void DMA::SetRecordChunkIDs(int stream_id, int interface_cycle, int chunk_id) {
-  AccelerationModule::WriteToModule(
+  AccelerationModule::QueueWriteToModule(
       ((1 << 17) + (1 << 13) + (stream_id << 8) + (interface_cycle << 2)),
       chunk_id);
 }
@@ -156,7 +182,9 @@ void DMA::SetCrossbarValues(
       throw std::runtime_error("Incorrect input!");
       break;
   }
-  AccelerationModule::WriteToModule(
+  // Queued until the next immediate register access like starting the
+  // controller.
+  AccelerationModule::QueueWriteToModule(
       (base_address + (stream_id << 12) + (clock_cycle << 5) + (offset << 2)),
       ((configuration_values[0] << 24) + (configuration_values[1] << 16) +
        (configuration_values[2] << 8) + configuration_values[3]));
@@ -167,24 +195,36 @@ void DMA::SetNumberOfInputStreamsWithMultipleChannels(
     int number) {  // Number of special channeled streams (for example for merge
                    // sorting) These streams would be located at StreamIDs
                    // 0..(number-1)
-  Log(LogLevel::kTrace,
-      "Mul channels stream count: number - " + std::to_string(number));
+#ifdef REGISTER_TRACE_ENABLED
+  if (ShouldLog(LogLevel::kTrace)) {
+    Log(LogLevel::kTrace,
+        "Mul channels stream count: number - " + std::to_string(number));
+  }
+#endif
   AccelerationModule::WriteToModule(4, number);
 }
 void DMA::SetRecordsPerBurstForMultiChannelStreams(
     int stream_id, int records_per_burst) {  // possible values 1-32
-  Log(LogLevel::kTrace, "Record per burst for mul channels: stream_id - " +
-                            std::to_string(stream_id) +
-                            "; records_per_burst - " +
-                            std::to_string(records_per_burst));
+#ifdef REGISTER_TRACE_ENABLED
+  if (ShouldLog(LogLevel::kTrace)) {
+    Log(LogLevel::kTrace,
+        "Record per burst for mul channels: stream_id - " +
+            std::to_string(stream_id) + "; records_per_burst - " +
+            std::to_string(records_per_burst));
+  }
+#endif
   AccelerationModule::WriteToModule(0x80000 + (stream_id * 4),
                                     records_per_burst);
 }
 void DMA::SetDDRBurstSizeForMultiChannelStreams(int stream_id,
                                                 int ddr_burst_size) {
-  Log(LogLevel::kTrace, "DDRBurst for multi channel: stream_id - " +
-                            std::to_string(stream_id) + "; ddr_burst_size - " +
-                            std::to_string(ddr_burst_size));
+#ifdef REGISTER_TRACE_ENABLED
+  if (ShouldLog(LogLevel::kTrace)) {
+    Log(LogLevel::kTrace,
+        "DDRBurst for multi channel: stream_id - " + std::to_string(stream_id) +
+            "; ddr_burst_size - " + std::to_string(ddr_burst_size));
+  }
+#endif
   AccelerationModule::WriteToModule(0x80000 + (1 << 6) + (stream_id * 4),
                                     ddr_burst_size - 1);
 }
@@ -192,28 +232,41 @@ void DMA::SetNumberOfActiveChannelsForMultiChannelStreams(
     int stream_id,
     int active_channels) {  // possible values 1 to the synthesized channel
                             // capacity (1024 currently)
-  Log(LogLevel::kTrace, "Number of channels for mul channel: stream_id - " +
-                            std::to_string(stream_id) + "; active_channels - " +
-                            std::to_string(active_channels));
+#ifdef REGISTER_TRACE_ENABLED
+  if (ShouldLog(LogLevel::kTrace)) {
+    Log(LogLevel::kTrace,
+        "Number of channels for mul channel: stream_id - " +
+            std::to_string(stream_id) + "; active_channels - " +
+            std::to_string(active_channels));
+  }
+#endif
   AccelerationModule::WriteToModule(0x80000 + (2 << 6) + (stream_id * 4),
                                     active_channels);
 }
 void DMA::SetAddressForMultiChannelStreams(int stream_id, int channel_id,
                                            uintptr_t address) {
-  Log(LogLevel::kTrace, "Address for mul channel: stream_id - " +
-                            std::to_string(stream_id) + "; channel_id - " +
-                            std::to_string(channel_id) + "; address - " +
-                            std::to_string(address));
+#ifdef REGISTER_TRACE_ENABLED
+  if (ShouldLog(LogLevel::kTrace)) {
+    Log(LogLevel::kTrace,
+        "Address for mul channel: stream_id - " + std::to_string(stream_id) +
+            "; channel_id - " + std::to_string(channel_id) + "; address - " +
+            std::to_string(address));
+  }
+#endif
   AccelerationModule::WriteToModule(
       0x80000 + (1 << 16) + (stream_id << 14) + (channel_id << 2),
       address >> 4);
 }
 void DMA::SetSizeForMultiChannelStreams(int stream_id, int channel_id,
                                         int number_of_records) {
-  Log(LogLevel::kTrace,
-      "Size for mul channel: stream_id - " + std::to_string(stream_id) +
-          "; channel_id - " + std::to_string(channel_id) +
-          "; number_of_records - " + std::to_string(number_of_records));
+#ifdef REGISTER_TRACE_ENABLED
+  if (ShouldLog(LogLevel::kTrace)) {
+    Log(LogLevel::kTrace,
+        "Size for mul channel: stream_id - " + std::to_string(stream_id) +
+            "; channel_id - " + std::to_string(channel_id) +
+            "; number_of_records - " + std::to_string(number_of_records));
+  }
+#endif
   AccelerationModule::WriteToModule(
       0x80000 + (2 << 16) + (stream_id << 14) + (channel_id << 2),
       number_of_records + 1);
@@ -338,6 +391,9 @@ auto DMA::GetOutputActiveInstructionCycles() -> volatile uint32_t {
 }
 
 void DMA::GlobalReset() {
+  // The DMA module is kept between runs and a static bitstream might have been
+  // loaded since the last one.
+  AccelerationModule::ResetRegisterBase();
   AccelerationModule::WriteToModule(8, kResetDuration_);
 }
 
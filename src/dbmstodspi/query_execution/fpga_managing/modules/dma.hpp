@@ -112,6 +112,15 @@ class DMA : public AccelerationModule, public DMAInterface {
    * @return Boolean showing if the input/output controller has finished.
    */
   auto IsControllerFinished(bool is_input) -> bool override;
+  /**
+   * @brief Find out if a single stream of the input/output controller has
+   * finished streaming.
+   * @param is_input Bool noting if the configuration is for input or output.
+   * @param stream_id Which stream is being checked.
+   * @return Boolean showing if the given stream is no longer active.
+   */
+  auto IsControllerStreamFinished(bool is_input, int stream_id)
+      -> bool override;
 
   /**
    * @brief Set record size in terms of integers of a stream.
@@ -50,6 +50,8 @@ class DMAInterface {
       std::bitset<query_acceleration_constants::kMaxIOStreamCount>
           stream_active) = 0;
   virtual auto IsControllerFinished(bool is_input) -> bool = 0;
+  virtual auto IsControllerStreamFinished(bool is_input, int stream_id)
+      -> bool = 0;
 
   virtual void SetRecordSize(int stream_id, int record_size) = 0;
   virtual void SetRecordChunkIDs(int stream_id, int interface_cycle,
@@ -154,17 +154,18 @@ void Filter::FilterWriteDNFClauseLiteralsToModule(int datapath_width,
             clauses_packed_negative_result |= 0;  // boolean expression
           }
         }
-        AccelerationModule::WriteToModule(
+        AccelerationModule::QueueWriteToModule(
             ((1 << 16) + (data_position << 2) + (1 << 7) + (chunk_id << 8) +
              (compare_lane << 13)),
             clauses_packed_positive_result);
-        AccelerationModule::WriteToModule(
+        AccelerationModule::QueueWriteToModule(
             ((1 << 16) + (data_position << 2) + (0 << 7) + (chunk_id << 8) +
              (compare_lane << 13)),
             clauses_packed_negative_result);
       }
     }
   }
+  AccelerationModule::FlushWritesToModule();
 }
 void Filter::WriteDNFClauseLiteralsToFilter_1CMP_8DNF(
     int datapath_width /*1-32: 16->512bit datapath; 32->1024-bit datapath*/) {
@@ -17,6 +17,7 @@ limitations under the License.
 #include "ila.hpp"
 
 #include <iostream>
+#include <stdexcept>
 
 using orkhestrafs::dbmstodspi::ILA;
 
@@ -36,6 +37,20 @@ auto ILA::GetValues(int clock_cycle, int location, ILADataTypes data_type)
       ILA::CalcAddress(clock_cycle, location, static_cast<int>(data_type)));
 }
 
+auto ILA::GetCaptureWindow(int ila_id, int max_clock,
+                           const std::vector<ILADataTypes>& data_types)
+    -> std::vector<std::vector<uint32_t>> {
+  std::vector<std::vector<uint32_t>> capture_window(
+      max_clock, std::vector<uint32_t>(data_types.size()));
+  for (int clock = 0; clock < max_clock; clock++) {
+    for (int type_i = 0; type_i < data_types.size(); type_i++) {
+      capture_window[clock][type_i] = ILA::ReadFromModule(ILA::CalcAddress(
+          clock, ila_id, static_cast<int>(data_types.at(type_i))));
+    }
+  }
+  return capture_window;
+}
+
 auto ILA::CalcAddress(int clock, int ila_id, int offset) -> int {
   int base_address = 0;
   if (ila_id == 0) {
@@ -16,6 +16,7 @@ limitations under the License.
 
 #pragma once
 #include <cstdint>
+#include <vector>
 
 #include "ila_types.hpp"
 #include "memory_manager_interface.hpp"
@@ -51,6 +52,18 @@ class ILA {
    */
   auto GetValues(int clock_cycle, int location, ILADataTypes data_type)
       -> uint32_t;
+  /**
+   * @brief Read a whole capture window of the given data types in address
+   * order.
+   * @param ila_id ID of the ILA
+   * @param max_clock How many clock cycles of data there is.
+   * @param data_types Which data should be read.
+   * @return Vector of values for each clock cycle in the same order as the
+   * requested data types.
+   */
+  auto GetCaptureWindow(int ila_id, int max_clock,
+                        const std::vector<ILADataTypes>& data_types)
+      -> std::vector<std::vector<uint32_t>>;
   /**
    * @brief Print all data ILA has been collecting.
    * @param ila_id ID of the ILA
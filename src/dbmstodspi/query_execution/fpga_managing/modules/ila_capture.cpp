@@ -0,0 +1,228 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "ila_capture.hpp"
+
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+using orkhestrafs::dbmstodspi::ILACapture;
+using orkhestrafs::dbmstodspi::ILACoreCapture;
+using orkhestrafs::dbmstodspi::ILADataTypes;
+
+auto ILACapture::GetCoreSignals(int ila_id)
+    -> std::vector<std::pair<std::string, ILADataTypes>> {
+  if (ila_id == 0 || ila_id == 1) {
+    return {{"CLOCK_CYCLE", ILADataTypes::kClockCycle},
+            {"TYPE", ILADataTypes::kType},
+            {"STREAMID", ILADataTypes::kStreamID},
+            {"CHUNKID", ILADataTypes::kChunkID},
+            {"STATE", ILADataTypes::kState},
+            {"CHANNELID", ILADataTypes::kChannelID},
+            {"LAST", ILADataTypes::kLast},
+            {"DATA_15", ILADataTypes::kDataAtPos15},
+            {"DATA_14", ILADataTypes::kDataAtPos14},
+            {"DATA_13", ILADataTypes::kDataAtPos13},
+            {"DATA_12", ILADataTypes::kDataAtPos12},
+            {"DATA_11", ILADataTypes::kDataAtPos11},
+            {"DATA_10", ILADataTypes::kDataAtPos10},
+            {"DATA_9", ILADataTypes::kDataAtPos9},
+            {"DATA_8", ILADataTypes::kDataAtPos8},
+            {"DATA_7", ILADataTypes::kDataAtPos7},
+            {"DATA_6", ILADataTypes::kDataAtPos6},
+            {"DATA_5", ILADataTypes::kDataAtPos5},
+            {"DATA_4", ILADataTypes::kDataAtPos4},
+            {"DATA_3", ILADataTypes::kDataAtPos3},
+            {"DATA_2", ILADataTypes::kDataAtPos2},
+            {"DATA_1", ILADataTypes::kDataAtPos1},
+            {"DATA_0", ILADataTypes::kDataAtPos0},
+            {"INSTR_CHANNELID", ILADataTypes::kInstrChannelID},
+            {"INSTR_PARAM", ILADataTypes::kInstrParam},
+            {"INSTR_STREAMID", ILADataTypes::kInstrStreamID},
+            {"INSTR_TYPE", ILADataTypes::kInstrType},
+            {"JOIN_STATE", ILADataTypes::kJoinState}};
+  }
+  if (ila_id == 2) {
+    return {{"IC_S", ILADataTypes::kIcS},
+            {"IC_CH", ILADataTypes::kIcCh},
+            {"IC_I", ILADataTypes::kIcI},
+            {"IC_IP", ILADataTypes::kIcIp},
+            {"IC_V", ILADataTypes::kIcV},
+            {"IC_P", ILADataTypes::kIcP},
+            {"ICD_BUSY", ILADataTypes::kIcdBusy},
+            {"ICD_S", ILADataTypes::kIcdS},
+            {"ICD_B", ILADataTypes::kIcdB},
+            {"ICD_E", ILADataTypes::kIcdE},
+            {"ICD_CH", ILADataTypes::kIcdCh},
+            {"ICD_BU", ILADataTypes::kIcdBu},
+            {"DR_A", ILADataTypes::kDrA},
+            {"DR_L", ILADataTypes::kDrL},
+            {"DR_S", ILADataTypes::kDrS},
+            {"DR_B", ILADataTypes::kDrB},
+            {"DR_E", ILADataTypes::kDrE},
+            {"DR_CH", ILADataTypes::kDrCh},
+            {"DR_BU", ILADataTypes::kDrBu},
+            {"DR_AR", ILADataTypes::kDrAr},
+            {"DR_AV", ILADataTypes::kDrAv},
+            {"DRC_ARV", ILADataTypes::kDrcArv},
+            {"DRC_ARB", ILADataTypes::kDrcArb},
+            {"DRC_ARA", ILADataTypes::kDrcAra},
+            {"DRC_ARL", ILADataTypes::kDrcArl},
+            {"DRC_RD", ILADataTypes::kDrcRd},
+            {"DRC_RV", ILADataTypes::kDrcRv},
+            {"DRC_RR", ILADataTypes::kDrcRr},
+            {"DRC_RL", ILADataTypes::kDrcRl},
+            {"IB_D", ILADataTypes::kIbD},
+            {"IB_V", ILADataTypes::kIbV},
+            {"IB_S", ILADataTypes::kIbS},
+            {"IB_B", ILADataTypes::kIbB},
+            {"IB_CH", ILADataTypes::kIbCh},
+            {"IB_CL", ILADataTypes::kIbCl},
+            {"IB_L", ILADataTypes::kIbL},
+            {"IB_SI", ILADataTypes::kIbSi},
+            {"IB_VS", ILADataTypes::kIbVs},
+            {"IB_BU", ILADataTypes::kIbBu},
+            {"U_NA_DIN", ILADataTypes::kUNaDin},
+            {"U_NA_DOUT", ILADataTypes::kUNaDout},
+            {"U_NA_WADD", ILADataTypes::kUNaWadd},
+            {"U_NA_RADD", ILADataTypes::kUNaRadd},
+            {"U_NA_WEN", ILADataTypes::kUNaWen},
+            {"U_RR_DIN", ILADataTypes::kURrDin},
+            {"U_RR_DOUT", ILADataTypes::kURrDout},
+            {"U_RR_WADD", ILADataTypes::kURrWadd},
+            {"U_RR_RADD", ILADataTypes::kURrRadd},
+            {"U_RR_WEN", ILADataTypes::kURrWen},
+            {"U_RPB", ILADataTypes::kURpb},
+            {"U_BS", ILADataTypes::kUBs}};
+  }
+  throw std::runtime_error("Wrong ILA core ID given!");
+}
+
+auto ILACapture::ReadCoreCapture(ILA& ila_module, int ila_id, int max_clock)
+    -> ILACoreCapture {
+  auto signals = GetCoreSignals(ila_id);
+  std::vector<ILADataTypes> data_types;
+  data_types.reserve(signals.size());
+  for (const auto& [name, data_type] : signals) {
+    data_types.push_back(data_type);
+  }
+  auto capture_window =
+      ila_module.GetCaptureWindow(ila_id, max_clock, data_types);
+
+  ILACoreCapture core_capture = {ila_id, {}};
+  for (int signal_i = 0; signal_i < signals.size(); signal_i++) {
+    ILASignalCapture signal_capture = {signals.at(signal_i).first, {}};
+    signal_capture.values.reserve(max_clock);
+    for (const auto& clock_values : capture_window) {
+      signal_capture.values.push_back(clock_values.at(signal_i));
+    }
+    core_capture.signals.push_back(std::move(signal_capture));
+  }
+  return core_capture;
+}
+
+auto ILACapture::ReadAllCaptures(ILA& ila_module, int max_clock)
+    -> std::vector<ILACoreCapture> {
+  std::vector<ILACoreCapture> captures;
+  for (int ila_id = 0; ila_id < kILACoreCount; ila_id++) {
+    captures.push_back(ReadCoreCapture(ila_module, ila_id, max_clock));
+  }
+  return captures;
+}
+
+void ILACapture::WriteVCD(const std::vector<ILACoreCapture>& captures,
+                          int clock_speed, std::ostream& output) {
+  if (clock_speed <= 0) {
+    throw std::runtime_error("Clock speed has to be positive!");
+  }
+  // Clock speed is given in MHz.
+  const auto clock_period_in_ps =
+      static_cast<long>(std::lround(1000000.0 / clock_speed));
+
+  output << "$version OrkhestraFPGAStream ILA capture $end\n";
+  output << "$timescale 1ps $end\n";
+  int signal_index = 0;
+  int max_clock = 0;
+  for (const auto& core_capture : captures) {
+    output << "$scope module ila_" << core_capture.ila_id << " $end\n";
+    for (const auto& signal : core_capture.signals) {
+      output << "$var wire 32 " << GetIdentifier(signal_index++) << " "
+             << signal.name << " $end\n";
+      max_clock = std::max(max_clock, static_cast<int>(signal.values.size()));
+    }
+    output << "$upscope $end\n";
+  }
+  output << "$enddefinitions $end\n";
+
+  for (int clock = 0; clock < max_clock; clock++) {
+    output << "#" << clock * clock_period_in_ps << "\n";
+    if (clock == 0) {
+      output << "$dumpvars\n";
+    }
+    signal_index = 0;
+    for (const auto& core_capture : captures) {
+      for (const auto& signal : core_capture.signals) {
+        // Only changes get written after the initial values.
+        if (clock < signal.values.size() &&
+            (clock == 0 ||
+             signal.values.at(clock) != signal.values.at(clock - 1))) {
+          output << "b" << ToBinary(signal.values.at(clock)) << " "
+                 << GetIdentifier(signal_index) << "\n";
+        }
+        signal_index++;
+      }
+    }
+    if (clock == 0) {
+      output << "$end\n";
+    }
+  }
+  output << "#" << max_clock * clock_period_in_ps << "\n";
+}
+
+void ILACapture::WriteVCDFile(const std::vector<ILACoreCapture>& captures,
+                              int clock_speed, const std::string& filename) {
+  std::ofstream output_file(filename, std::ios::trunc);
+  if (!output_file) {
+    throw std::runtime_error("Couldn't open: " + filename);
+  }
+  WriteVCD(captures, clock_speed, output_file);
+}
+
+auto ILACapture::GetIdentifier(int signal_index) -> std::string {
+  // VCD identifiers use the printable ASCII characters from '!' to '~'.
+  const int first_character = 33;
+  const int character_count = 94;
+  std::string identifier;
+  do {
+    identifier +=
+        static_cast<char>(first_character + signal_index % character_count);
+    signal_index /= character_count;
+  } while (signal_index > 0);
+  return identifier;
+}
+
+auto ILACapture::ToBinary(uint32_t value) -> std::string {
+  if (value == 0) {
+    return "0";
+  }
+  std::string binary_value;
+  while (value > 0) {
+    binary_value.insert(binary_value.begin(), (value & 1) ? '1' : '0');
+    value >>= 1;
+  }
+  return binary_value;
+}
@@ -0,0 +1,104 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ila.hpp"
+#include "ila_types.hpp"
+
+namespace orkhestrafs::dbmstodspi {
+
+/**
+ * @brief Struct to hold the decoded values of a single ILA probe.
+ */
+struct ILASignalCapture {
+  std::string name;
+  std::vector<uint32_t> values;
+};
+
+/**
+ * @brief Struct to hold all of the probes of one ILA core.
+ */
+struct ILACoreCapture {
+  int ila_id;
+  std::vector<ILASignalCapture> signals;
+};
+
+/**
+ * @brief Class to read complete capture windows from the ILA cores and export
+ * them as VCD waveforms.
+ */
+class ILACapture {
+ public:
+  /// How many clock cycles of data each ILA core holds.
+  static constexpr int kCaptureDepth = 2048;
+  /// How many ILA cores there are.
+  static constexpr int kILACoreCount = 3;
+
+  /**
+   * @brief Get the probes of the given ILA core. Cores 0 and 1 are connected
+   * to the module interfaces and core 2 to the DMA.
+   * @param ila_id ID of the ILA
+   * @return Probe names and their data types.
+   */
+  static auto GetCoreSignals(int ila_id)
+      -> std::vector<std::pair<std::string, ILADataTypes>>;
+  /**
+   * @brief Read and decode the capture window of one ILA core.
+   * @param ila_module ILA to read from.
+   * @param ila_id ID of the ILA
+   * @param max_clock How many clock cycles of data there is.
+   * @return Decoded capture.
+   */
+  static auto ReadCoreCapture(ILA& ila_module, int ila_id, int max_clock)
+      -> ILACoreCapture;
+  /**
+   * @brief Read and decode the capture windows of all ILA cores.
+   * @param ila_module ILA to read from.
+   * @param max_clock How many clock cycles of data there is.
+   * @return Decoded captures.
+   */
+  static auto ReadAllCaptures(ILA& ila_module, int max_clock)
+      -> std::vector<ILACoreCapture>;
+  /**
+   * @brief Write the captures as a VCD waveform. Each core gets its own scope
+   * and each captured clock cycle is one clock period.
+   * @param captures Decoded captures.
+   * @param clock_speed Clock speed in MHz.
+   * @param output Stream to write to.
+   */
+  static void WriteVCD(const std::vector<ILACoreCapture>& captures,
+                       int clock_speed, std::ostream& output);
+  /**
+   * @brief Write the captures to a VCD file.
+   * @param captures Decoded captures.
+   * @param clock_speed Clock speed in MHz.
+   * @param filename Output file.
+   */
+  static void WriteVCDFile(const std::vector<ILACoreCapture>& captures,
+                           int clock_speed, const std::string& filename);
+
+ private:
+  static auto GetIdentifier(int signal_index) -> std::string;
+  static auto ToBinary(uint32_t value) -> std::string;
+};
+
+}  // namespace orkhestrafs::dbmstodspi
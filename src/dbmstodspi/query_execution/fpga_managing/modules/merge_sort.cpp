@@ -16,53 +16,67 @@ limitations under the License.
 
 #include "merge_sort.hpp"
 
+#ifdef REGISTER_TRACE_ENABLED
 #include <string>
 
 #include "logger.hpp"
 
 using orkhestrafs::dbmstodspi::logging::Log;
 using orkhestrafs::dbmstodspi::logging::LogLevel;
+#endif
 
 using orkhestrafs::dbmstodspi::MergeSort;
 
 void MergeSort::StartPrefetchingData(int base_channel_id,
                                      bool is_not_first_module) {
+#ifdef REGISTER_TRACE_ENABLED
   Log(LogLevel::kTrace,
       "Start prefetch: channel - " + std::to_string(base_channel_id) +
           "; not first - " +
           std::to_string(static_cast<int>(is_not_first_module)));
+#endif
   AccelerationModule::WriteToModule(
       0, (base_channel_id << 8) + static_cast<int>(is_not_first_module));
 }
 
 void MergeSort::SetStreamParams(int stream_id, int chunks_per_record) {
+#ifdef REGISTER_TRACE_ENABLED
   Log(LogLevel::kTrace, "Params: stream_id - " + std::to_string(stream_id) +
                             "; chunks_per_record - " +
                             std::to_string(chunks_per_record));
+#endif
   AccelerationModule::WriteToModule(4,
                                     ((chunks_per_record - 1) << 8) + stream_id);
 }
 
 void MergeSort::SetBufferSize(int record_count) {
+#ifdef REGISTER_TRACE_ENABLED
   Log(LogLevel::kTrace,
       "Buffer size: record_count - " + std::to_string(record_count));
+#endif
   AccelerationModule::WriteToModule(8, record_count);
 }
 
 void MergeSort::SetRecordCountPerFetch(int record_count) {
+#ifdef REGISTER_TRACE_ENABLED
   Log(LogLevel::kTrace,
       "Record count per fetch: record_count - " + std::to_string(record_count));
+#endif
   AccelerationModule::WriteToModule(12, record_count);
 }
 
 void MergeSort::SetFetchCount(int fetch_count) {
+#ifdef REGISTER_TRACE_ENABLED
   Log(LogLevel::kTrace,
       "Fetch count: fetch_count - " + std::to_string(fetch_count));
+#endif
   AccelerationModule::WriteToModule(16, fetch_count);
 }
 
 void MergeSort::SetFetchOffset(int offset_record_count) {
+#ifdef REGISTER_TRACE_ENABLED
   Log(LogLevel::kTrace, "Fetch offset: offset_record_count - " +
                             std::to_string(offset_record_count));
+#endif
   AccelerationModule::WriteToModule(20, offset_record_count);
 }
@@ -0,0 +1,102 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "register_access.hpp"
+
+#ifdef REGISTER_TRACE_ENABLED
+#include <sstream>
+
+#include "logger.hpp"
+
+using orkhestrafs::dbmstodspi::logging::Log;
+using orkhestrafs::dbmstodspi::logging::LogLevel;
+using orkhestrafs::dbmstodspi::logging::ShouldLog;
+#endif
+
+using orkhestrafs::dbmstodspi::RegisterAccess;
+
+void RegisterAccess::Write(int address, uint32_t write_data) {
+  if (queued_write_count_ != 0) {
+    Flush();
+  }
+  TraceWrite(address, write_data);
+  *GetRegister(address) = write_data;
+}
+
+auto RegisterAccess::Read(int address) -> uint32_t {
+  if (queued_write_count_ != 0) {
+    Flush();
+  }
+  return *GetRegister(address);
+}
+
+void RegisterAccess::QueueWrite(int address, uint32_t write_data) {
+  // Larger tables get written in batches of the queue's capacity.
+  if (queued_write_count_ == kQueueCapacity) {
+    Flush();
+  }
+  queued_writes_[queued_write_count_++] = {address, write_data};
+}
+
+void RegisterAccess::Flush() {
+  if (queued_write_count_ == 0) {
+    return;
+  }
+  // Stable insertion sort to keep the order of repeated writes to the same
+  // register. The queue is short and mostly in address order already, and
+  // unlike std::stable_sort this doesn't allocate a buffer.
+  for (int write_i = 1; write_i < queued_write_count_; write_i++) {
+    auto queued_write = queued_writes_[write_i];
+    int position = write_i;
+    while (position > 0 &&
+           queued_writes_[position - 1].address > queued_write.address) {
+      queued_writes_[position] = queued_writes_[position - 1];
+      position--;
+    }
+    queued_writes_[position] = queued_write;
+  }
+  for (int write_i = 0; write_i < queued_write_count_; write_i++) {
+    const auto& [address, write_data] = queued_writes_[write_i];
+    TraceWrite(address, write_data);
+    *GetRegister(address) = write_data;
+  }
+  queued_write_count_ = 0;
+}
+
+auto RegisterAccess::GetQueuedWriteCount() const -> int {
+  return queued_write_count_;
+}
+
+void RegisterAccess::ResetBaseRegister() { base_register_ = nullptr; }
+
+auto RegisterAccess::GetRegister(int address) -> volatile uint32_t* {
+  if (base_register_ == nullptr) {
+    base_register_ = memory_manager_->GetVirtualRegisterAddress(base_address_);
+  }
+  return &base_register_[address / kAddressesPerRegister];
+}
+
+void RegisterAccess::TraceWrite(int address, uint32_t write_data) const {
+#ifdef REGISTER_TRACE_ENABLED
+  auto log_level = LogLevel::kTrace;
+  if (ShouldLog(log_level)) {
+    std::stringstream ss;
+    ss << std::hex << "Base: " << base_address_ << " Address: " << address
+       << " Data: " << write_data;
+    Log(log_level, ss.str());
+  }
+#endif
+}
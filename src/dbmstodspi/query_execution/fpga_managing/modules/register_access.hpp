@@ -0,0 +1,105 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+#include <array>
+#include <cstdint>
+
+#include "memory_manager_interface.hpp"
+
+namespace orkhestrafs::dbmstodspi {
+
+/**
+ * @brief Class to access the memory mapped registers of a single module.
+ *
+ * The module's base register is resolved with the first access and every
+ * access is indexed from it. Writes can be either done immediately or queued
+ * into a batch. Queued writes are written in address order. Any immediate
+ * access flushes the batch first to keep the access order. The queue is kept
+ * inside the object and a full queue gets flushed before more writes are
+ * queued.
+ */
+class RegisterAccess {
+ public:
+  /// How many addresses each element of the register array covers.
+#ifdef FPGA_AVAILABLE
+  static constexpr int kAddressesPerRegister = 4;
+#else
+  static constexpr int kAddressesPerRegister = 1;
+#endif
+
+  /**
+   * @brief Constructor to set the register space of the module.
+   * @param memory_manager Memory manager instance to access memory mapped
+   * registers.
+   * @param base_address Global address of the first register of the module.
+   */
+  RegisterAccess(MemoryManagerInterface* memory_manager, int base_address)
+      : memory_manager_{memory_manager}, base_address_{base_address} {};
+
+  /**
+   * @brief Write data to a register immediately.
+   * @param address Internal address of the register.
+   * @param write_data Data to be written to the register.
+   */
+  void Write(int address, uint32_t write_data);
+  /**
+   * @brief Read data from a register.
+   * @param address Internal address of the register.
+   * @return Data read from the register.
+   */
+  auto Read(int address) -> uint32_t;
+  /**
+   * @brief Queue a write to be done with the next flush.
+   * @param address Internal address of the register.
+   * @param write_data Data to be written to the register.
+   */
+  void QueueWrite(int address, uint32_t write_data);
+  /**
+   * @brief Write all of the queued writes to the registers.
+   */
+  void Flush();
+  /**
+   * @brief Get how many writes are waiting for the next flush.
+   * @return Number of queued writes.
+   */
+  auto GetQueuedWriteCount() const -> int;
+  /**
+   * @brief Resolve the base register again with the next access. Loading a
+   * static bitstream reallocates the register space.
+   */
+  void ResetBaseRegister();
+
+ private:
+  /// Enough for every module's setup apart from the filter and DMA tables.
+  static constexpr int kQueueCapacity = 64;
+
+  struct QueuedWrite {
+    int address;
+    uint32_t write_data;
+  };
+
+  MemoryManagerInterface* memory_manager_;
+  const int base_address_;
+  volatile uint32_t* base_register_ = nullptr;
+  std::array<QueuedWrite, kQueueCapacity> queued_writes_;
+  int queued_write_count_ = 0;
+
+  auto GetRegister(int address) -> volatile uint32_t*;
+  void TraceWrite(int address, uint32_t write_data) const;
+};
+
+}  // namespace orkhestrafs::dbmstodspi
@@ -0,0 +1,106 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "performance_counter_collector.hpp"
+
+#include <algorithm>
+
+#include "query_acceleration_constants.hpp"
+#include "stream_parameter_calculator.hpp"
+
+using orkhestrafs::dbmstodspi::PerformanceCounterCollector;
+using orkhestrafs::dbmstodspi::PerformanceCounters;
+using orkhestrafs::dbmstodspi::StreamParameterCalculator;
+
+auto PerformanceCounterCollector::CollectCounters(
+    DMAInterface& dma_engine, std::vector<StreamPerformanceCounters> streams)
+    -> PerformanceCounters {
+#ifdef FPGA_AVAILABLE
+  return ReadCounters(dma_engine, std::move(streams));
+#else
+  return ModelCounters(std::move(streams));
+#endif
+}
+
+auto PerformanceCounterCollector::ReadCounters(
+    DMAInterface& dma_engine, std::vector<StreamPerformanceCounters> streams)
+    -> PerformanceCounters {
+  PerformanceCounters counters;
+  counters.runtime_cycles = dma_engine.GetRuntime();
+  counters.valid_read_cycles = dma_engine.GetValidReadCyclesCount();
+  counters.valid_write_cycles = dma_engine.GetValidWriteCyclesCount();
+  counters.input_active_data_cycles = dma_engine.GetInputActiveDataCycles();
+  counters.input_active_data_last_cycles =
+      dma_engine.GetInputActiveDataLastCycles();
+  counters.input_active_control_cycles =
+      dma_engine.GetInputActiveControlCycles();
+  counters.input_active_control_last_cycles =
+      dma_engine.GetInputActiveControlLastCycles();
+  counters.input_active_end_of_stream_cycles =
+      dma_engine.GetInputActiveEndOfStreamCycles();
+  counters.input_active_instruction_cycles =
+      dma_engine.GetInputActiveInstructionCycles();
+  counters.output_active_data_cycles = dma_engine.GetOutputActiveDataCycles();
+  counters.output_active_data_last_cycles =
+      dma_engine.GetOutputActiveDataLastCycles();
+  counters.output_active_control_cycles =
+      dma_engine.GetOutputActiveControlCycles();
+  counters.output_active_control_last_cycles =
+      dma_engine.GetOutputActiveControlLastCycles();
+  counters.output_active_end_of_stream_cycles =
+      dma_engine.GetOutputActiveEndOfStreamCycles();
+  counters.output_active_instruction_cycles =
+      dma_engine.GetOutputActiveInstructionCycles();
+  counters.streams = std::move(streams);
+  return counters;
+}
+
+auto PerformanceCounterCollector::ModelCounters(
+    std::vector<StreamPerformanceCounters> streams) -> PerformanceCounters {
+  PerformanceCounters counters;
+  uint64_t read_integers = 0;
+  uint64_t written_integers = 0;
+  for (const auto& stream : streams) {
+    uint64_t stream_integers =
+        static_cast<uint64_t>(stream.record_size) * stream.record_count;
+    uint32_t stream_cycles =
+        StreamParameterCalculator::CalculateChunksPerRecord(
+            stream.record_size) *
+        stream.record_count;
+    if (stream.is_input) {
+      read_integers += stream_integers;
+      counters.input_active_data_cycles += stream_cycles;
+      counters.input_active_data_last_cycles += stream.record_count;
+      counters.input_active_end_of_stream_cycles++;
+    } else {
+      written_integers += stream_integers;
+      counters.output_active_data_cycles += stream_cycles;
+      counters.output_active_data_last_cycles += stream.record_count;
+      counters.output_active_end_of_stream_cycles++;
+    }
+  }
+  const int integers_per_cycle = query_acceleration_constants::kDdrSizePerCycle;
+  counters.valid_read_cycles =
+      (read_integers + integers_per_cycle - 1) / integers_per_cycle;
+  counters.valid_write_cycles =
+      (written_integers + integers_per_cycle - 1) / integers_per_cycle;
+  counters.runtime_cycles = std::max(
+      {counters.valid_read_cycles, counters.valid_write_cycles,
+       static_cast<uint64_t>(counters.input_active_data_cycles),
+       static_cast<uint64_t>(counters.output_active_data_cycles)});
+  counters.streams = std::move(streams);
+  return counters;
+}
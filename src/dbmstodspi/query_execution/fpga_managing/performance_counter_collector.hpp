@@ -0,0 +1,60 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+#include <vector>
+
+#include "dma_interface.hpp"
+#include "performance_counters.hpp"
+
+namespace orkhestrafs::dbmstodspi {
+
+/**
+ * @brief Class to snapshot the DMA performance counters after a run.
+ */
+class PerformanceCounterCollector {
+ public:
+  /**
+   * @brief Collect the counters of the last run. Without the FPGA the counters
+   * are estimated with #ModelCounters.
+   * @param dma_engine DMA module to read the counters from.
+   * @param streams Data moved by each active stream.
+   * @return Snapshot of the counters.
+   */
+  static auto CollectCounters(DMAInterface& dma_engine,
+                              std::vector<StreamPerformanceCounters> streams)
+      -> PerformanceCounters;
+  /**
+   * @brief Read the counters from the DMA registers.
+   * @param dma_engine DMA module to read the counters from.
+   * @param streams Data moved by each active stream.
+   * @return Snapshot of the counters.
+   */
+  static auto ReadCounters(DMAInterface& dma_engine,
+                           std::vector<StreamPerformanceCounters> streams)
+      -> PerformanceCounters;
+  /**
+   * @brief Estimate the counters assuming the streams don't stall. Each record
+   * takes one interface cycle per chunk and memory moves kDdrSizePerCycle
+   * integers per cycle.
+   * @param streams Data moved by each active stream.
+   * @return Modelled counters.
+   */
+  static auto ModelCounters(std::vector<StreamPerformanceCounters> streams)
+      -> PerformanceCounters;
+};
+
+}  // namespace orkhestrafs::dbmstodspi
@@ -0,0 +1,97 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace orkhestrafs::dbmstodspi {
+
+/**
+ * @brief Struct to hold how much data a single DMA stream moved during a run.
+ */
+struct StreamPerformanceCounters {
+  /// ID
+  int stream_id;
+  /// Is the stream read from memory or written to memory.
+  bool is_input;
+  /// How many integers worth of data does a record hold.
+  int record_size;
+  /// How many records were streamed.
+  int record_count;
+
+  auto operator==(const StreamPerformanceCounters& rhs) const -> bool {
+    return stream_id == rhs.stream_id && is_input == rhs.is_input &&
+           record_size == rhs.record_size && record_count == rhs.record_count;
+  }
+};
+
+/**
+ * @brief Struct to hold a snapshot of the DMA performance counters of a run.
+ */
+struct PerformanceCounters {
+  /// How many cycles the run took.
+  uint64_t runtime_cycles = 0;
+  /// How many cycles had valid data read from memory.
+  uint64_t valid_read_cycles = 0;
+  /// How many cycles had valid data written to memory.
+  uint64_t valid_write_cycles = 0;
+
+  uint32_t input_active_data_cycles = 0;
+  uint32_t input_active_data_last_cycles = 0;
+  uint32_t input_active_control_cycles = 0;
+  uint32_t input_active_control_last_cycles = 0;
+  uint32_t input_active_end_of_stream_cycles = 0;
+  uint32_t input_active_instruction_cycles = 0;
+  uint32_t output_active_data_cycles = 0;
+  uint32_t output_active_data_last_cycles = 0;
+  uint32_t output_active_control_cycles = 0;
+  uint32_t output_active_control_last_cycles = 0;
+  uint32_t output_active_end_of_stream_cycles = 0;
+  uint32_t output_active_instruction_cycles = 0;
+
+  /// Data moved by each of the active streams.
+  std::vector<StreamPerformanceCounters> streams;
+
+  auto operator==(const PerformanceCounters& rhs) const -> bool {
+    return runtime_cycles == rhs.runtime_cycles &&
+           valid_read_cycles == rhs.valid_read_cycles &&
+           valid_write_cycles == rhs.valid_write_cycles &&
+           input_active_data_cycles == rhs.input_active_data_cycles &&
+           input_active_data_last_cycles ==
+               rhs.input_active_data_last_cycles &&
+           input_active_control_cycles == rhs.input_active_control_cycles &&
+           input_active_control_last_cycles ==
+               rhs.input_active_control_last_cycles &&
+           input_active_end_of_stream_cycles ==
+               rhs.input_active_end_of_stream_cycles &&
+           input_active_instruction_cycles ==
+               rhs.input_active_instruction_cycles &&
+           output_active_data_cycles == rhs.output_active_data_cycles &&
+           output_active_data_last_cycles ==
+               rhs.output_active_data_last_cycles &&
+           output_active_control_cycles == rhs.output_active_control_cycles &&
+           output_active_control_last_cycles ==
+               rhs.output_active_control_last_cycles &&
+           output_active_end_of_stream_cycles ==
+               rhs.output_active_end_of_stream_cycles &&
+           output_active_instruction_cycles ==
+               rhs.output_active_instruction_cycles &&
+           streams == rhs.streams;
+  }
+};
+
+}  // namespace orkhestrafs::dbmstodspi
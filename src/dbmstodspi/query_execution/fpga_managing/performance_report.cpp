@@ -0,0 +1,264 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "performance_report.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+#include "rapidjson/document.h"
+#include "rapidjson/filewritestream.h"
+#include "rapidjson/writer.h"
+
+using orkhestrafs::dbmstodspi::PerformanceReport;
+using orkhestrafs::dbmstodspi::RunPerformanceRecord;
+using rapidjson::Document;
+using rapidjson::FileWriteStream;
+using rapidjson::Value;
+using rapidjson::Writer;
+
+auto PerformanceReport::AddRun(std::vector<std::string> node_names,
+                               PerformanceCounters counters, int clock_speed)
+    -> const RunPerformanceRecord& {
+  RunPerformanceRecord record;
+  record.run_index = records_.size();
+  record.node_names = std::move(node_names);
+  record.clock_speed = clock_speed;
+  record.counters = std::move(counters);
+  CalculateDerivedMetrics(record);
+  records_.push_back(std::move(record));
+  return records_.back();
+}
+
+auto PerformanceReport::GetRecords() const
+    -> const std::vector<RunPerformanceRecord>& {
+  return records_;
+}
+
+void PerformanceReport::CalculateDerivedMetrics(RunPerformanceRecord& record) {
+  const auto& counters = record.counters;
+  if (record.clock_speed <= 0) {
+    throw std::runtime_error("Clock speed has to be positive!");
+  }
+  // Clock speed is given in MHz.
+  record.runtime_in_seconds =
+      static_cast<double>(counters.runtime_cycles) / (record.clock_speed * 1e6);
+
+  uint64_t read_integers = 0;
+  uint64_t written_integers = 0;
+  record.stream_bandwidths.clear();
+  for (const auto& stream : counters.streams) {
+    uint64_t stream_integers =
+        static_cast<uint64_t>(stream.record_size) * stream.record_count;
+    if (stream.is_input) {
+      read_integers += stream_integers;
+    } else {
+      written_integers += stream_integers;
+    }
+    record.stream_bandwidths.push_back(
+        GetBandwidth(stream_integers, record.runtime_in_seconds));
+  }
+  record.input_bandwidth =
+      GetBandwidth(read_integers, record.runtime_in_seconds);
+  record.output_bandwidth =
+      GetBandwidth(written_integers, record.runtime_in_seconds);
+
+  record.read_stall_ratio =
+      1 - GetRatio(counters.valid_read_cycles, counters.runtime_cycles);
+  record.write_stall_ratio =
+      1 - GetRatio(counters.valid_write_cycles, counters.runtime_cycles);
+  record.input_utilisation =
+      GetRatio(counters.input_active_data_cycles, counters.runtime_cycles);
+  record.output_utilisation =
+      GetRatio(counters.output_active_data_cycles, counters.runtime_cycles);
+}
+
+auto PerformanceReport::GetRatio(uint64_t part, uint64_t whole) -> double {
+  if (whole == 0) {
+    return 0;
+  }
+  return static_cast<double>(part) / whole;
+}
+
+auto PerformanceReport::GetBandwidth(uint64_t integer_count, double seconds)
+    -> double {
+  if (seconds <= 0) {
+    return 0;
+  }
+  // 4 bytes per integer and 10^9 bytes in a GB.
+  return integer_count * 4 / seconds / 1e9;
+}
+
+auto PerformanceReport::JoinNodeNames(
+    const std::vector<std::string>& node_names, const std::string& separator)
+    -> std::string {
+  std::string joined_names;
+  for (int name_i = 0; name_i < node_names.size(); name_i++) {
+    if (name_i != 0) {
+      joined_names += separator;
+    }
+    joined_names += node_names.at(name_i);
+  }
+  return joined_names;
+}
+
+auto PerformanceReport::GetCSVField(const std::string& value) -> std::string {
+  // RFC 4180: Enclose in double quotes and double the embedded quotes.
+  std::string field = "\"";
+  for (const auto& character : value) {
+    if (character == '"') {
+      field += '"';
+    }
+    field += character;
+  }
+  return field + "\"";
+}
+
+void PerformanceReport::WriteJSON(const std::string& filename) const {
+  Document document;
+  document.SetArray();
+  auto& allocator = document.GetAllocator();
+  for (const auto& record : records_) {
+    const auto& counters = record.counters;
+    Value record_object(rapidjson::kObjectType);
+    record_object.AddMember("run", record.run_index, allocator);
+    Value node_names(rapidjson::kArrayType);
+    for (const auto& node_name : record.node_names) {
+      Value node_name_value;
+      node_name_value.SetString(node_name.c_str(), node_name.size(),
+                                allocator);
+      node_names.PushBack(node_name_value, allocator);
+    }
+    record_object.AddMember("nodes", node_names, allocator);
+    record_object.AddMember("clock_speed", record.clock_speed, allocator);
+    record_object.AddMember("runtime_cycles", counters.runtime_cycles,
+                            allocator);
+    record_object.AddMember("valid_read_cycles", counters.valid_read_cycles,
+                            allocator);
+    record_object.AddMember("valid_write_cycles", counters.valid_write_cycles,
+                            allocator);
+    record_object.AddMember("input_active_data_cycles",
+                            counters.input_active_data_cycles, allocator);
+    record_object.AddMember("input_active_data_last_cycles",
+                            counters.input_active_data_last_cycles, allocator);
+    record_object.AddMember("input_active_control_cycles",
+                            counters.input_active_control_cycles, allocator);
+    record_object.AddMember("input_active_control_last_cycles",
+                            counters.input_active_control_last_cycles,
+                            allocator);
+    record_object.AddMember("input_active_end_of_stream_cycles",
+                            counters.input_active_end_of_stream_cycles,
+                            allocator);
+    record_object.AddMember("input_active_instruction_cycles",
+                            counters.input_active_instruction_cycles,
+                            allocator);
+    record_object.AddMember("output_active_data_cycles",
+                            counters.output_active_data_cycles, allocator);
+    record_object.AddMember("output_active_data_last_cycles",
+                            counters.output_active_data_last_cycles,
+                            allocator);
+    record_object.AddMember("output_active_control_cycles",
+                            counters.output_active_control_cycles, allocator);
+    record_object.AddMember("output_active_control_last_cycles",
+                            counters.output_active_control_last_cycles,
+                            allocator);
+    record_object.AddMember("output_active_end_of_stream_cycles",
+                            counters.output_active_end_of_stream_cycles,
+                            allocator);
+    record_object.AddMember("output_active_instruction_cycles",
+                            counters.output_active_instruction_cycles,
+                            allocator);
+    record_object.AddMember("runtime_in_seconds", record.runtime_in_seconds,
+                            allocator);
+    record_object.AddMember("input_bandwidth_gbps", record.input_bandwidth,
+                            allocator);
+    record_object.AddMember("output_bandwidth_gbps", record.output_bandwidth,
+                            allocator);
+    record_object.AddMember("read_stall_ratio", record.read_stall_ratio,
+                            allocator);
+    record_object.AddMember("write_stall_ratio", record.write_stall_ratio,
+                            allocator);
+    record_object.AddMember("input_utilisation", record.input_utilisation,
+                            allocator);
+    record_object.AddMember("output_utilisation", record.output_utilisation,
+                            allocator);
+    Value streams(rapidjson::kArrayType);
+    for (int stream_i = 0; stream_i < counters.streams.size(); stream_i++) {
+      const auto& stream = counters.streams.at(stream_i);
+      Value stream_object(rapidjson::kObjectType);
+      stream_object.AddMember("stream_id", stream.stream_id, allocator);
+      stream_object.AddMember("is_input", stream.is_input, allocator);
+      stream_object.AddMember("record_size", stream.record_size, allocator);
+      stream_object.AddMember("record_count", stream.record_count, allocator);
+      stream_object.AddMember("bandwidth_gbps",
+                              record.stream_bandwidths.at(stream_i),
+                              allocator);
+      streams.PushBack(stream_object, allocator);
+    }
+    record_object.AddMember("streams", streams, allocator);
+    document.PushBack(record_object, allocator);
+  }
+
+  FILE* file_pointer = fopen(filename.c_str(), "wb");
+  if (!file_pointer) {
+    throw std::runtime_error("Couldn't open: " + filename);
+  }
+  char write_buffer[8192];
+  FileWriteStream output_stream(file_pointer, write_buffer,
+                                sizeof(write_buffer));
+  Writer<FileWriteStream> writer(output_stream);
+  document.Accept(writer);
+  bool is_written = ferror(file_pointer) == 0;
+  if (fclose(file_pointer) != 0 || !is_written) {
+    throw std::runtime_error("Couldn't write " + filename);
+  }
+}
+
+void PerformanceReport::WriteCSV(const std::string& filename) const {
+  std::ofstream output_file(filename, std::ios::trunc);
+  if (!output_file) {
+    throw std::runtime_error("Couldn't open: " + filename);
+  }
+  output_file << "run,nodes,stream_id,is_input,record_size,record_count,"
+                 "stream_bandwidth_gbps,runtime_cycles,valid_read_cycles,"
+                 "valid_write_cycles,input_bandwidth_gbps,output_bandwidth_"
+                 "gbps,read_stall_ratio,write_stall_ratio,input_utilisation,"
+                 "output_utilisation\n";
+  for (const auto& record : records_) {
+    const auto& counters = record.counters;
+    for (int stream_i = 0; stream_i < counters.streams.size(); stream_i++) {
+      const auto& stream = counters.streams.at(stream_i);
+      output_file << record.run_index << ","
+                  << GetCSVField(JoinNodeNames(record.node_names, ";")) << ","
+                  << stream.stream_id << "," << stream.is_input << ","
+                  << stream.record_size << "," << stream.record_count << ","
+                  << record.stream_bandwidths.at(stream_i) << ","
+                  << counters.runtime_cycles << ","
+                  << counters.valid_read_cycles << ","
+                  << counters.valid_write_cycles << ","
+                  << record.input_bandwidth << "," << record.output_bandwidth
+                  << "," << record.read_stall_ratio << ","
+                  << record.write_stall_ratio << ","
+                  << record.input_utilisation << ","
+                  << record.output_utilisation << "\n";
+    }
+  }
+  output_file.close();
+  if (!output_file) {
+    throw std::runtime_error("Couldn't write " + filename);
+  }
+}
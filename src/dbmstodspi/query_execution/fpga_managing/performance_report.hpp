@@ -0,0 +1,102 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+#include <string>
+#include <vector>
+
+#include "performance_counters.hpp"
+
+namespace orkhestrafs::dbmstodspi {
+
+/**
+ * @brief Struct to hold the counters of a run with the metrics derived from
+ * them.
+ */
+struct RunPerformanceRecord {
+  /// Which run this was.
+  int run_index;
+  /// Names of the nodes which were executed in this run.
+  std::vector<std::string> node_names;
+  /// Clock speed in MHz the counters were collected with.
+  int clock_speed;
+  /// Raw counter values.
+  PerformanceCounters counters;
+
+  double runtime_in_seconds = 0;
+  /// Effective bandwidths in GB/s.
+  double input_bandwidth = 0;
+  double output_bandwidth = 0;
+  /// Share of the run where no valid data was moved to/from memory.
+  double read_stall_ratio = 0;
+  double write_stall_ratio = 0;
+  /// Share of the run where the interfaces to the modules were moving data.
+  double input_utilisation = 0;
+  double output_utilisation = 0;
+  /// Effective bandwidth of each stream in the same order as the counters.
+  std::vector<double> stream_bandwidths;
+};
+
+/**
+ * @brief Class to collect the performance counters of every run and export
+ * them.
+ */
+class PerformanceReport {
+ public:
+  /**
+   * @brief Add the counters of the next run and derive the metrics.
+   * @param node_names Names of the nodes executed in the run.
+   * @param counters Counters collected after the run.
+   * @param clock_speed Clock speed in MHz.
+   * @return The created record.
+   */
+  auto AddRun(std::vector<std::string> node_names,
+              PerformanceCounters counters, int clock_speed)
+      -> const RunPerformanceRecord&;
+  /**
+   * @brief Get all of the collected records.
+   * @return Records in the order the runs were executed.
+   */
+  [[nodiscard]] auto GetRecords() const
+      -> const std::vector<RunPerformanceRecord>&;
+  /**
+   * @brief Write all records to a JSON file with one object per run.
+   * @param filename Output file.
+   */
+  void WriteJSON(const std::string& filename) const;
+  /**
+   * @brief Write all records to a CSV file with one row per stream.
+   * @param filename Output file.
+   */
+  void WriteCSV(const std::string& filename) const;
+
+  /**
+   * @brief Derive the metrics from the counters.
+   * @param record Record with counters and the clock speed set.
+   */
+  static void CalculateDerivedMetrics(RunPerformanceRecord& record);
+
+ private:
+  std::vector<RunPerformanceRecord> records_;
+
+  static auto GetRatio(uint64_t part, uint64_t whole) -> double;
+  static auto GetBandwidth(uint64_t integer_count, double seconds) -> double;
+  static auto JoinNodeNames(const std::vector<std::string>& node_names,
+                            const std::string& separator) -> std::string;
+  static auto GetCSVField(const std::string& value) -> std::string;
+};
+
+}  // namespace orkhestrafs::dbmstodspi
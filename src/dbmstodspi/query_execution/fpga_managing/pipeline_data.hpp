@@ -0,0 +1,40 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+#include <bitset>
+
+#include "query_acceleration_constants.hpp"
+
+namespace orkhestrafs::dbmstodspi {
+
+/**
+ * @brief Struct to hold the DMA streams of a set of connected query nodes
+ * which can finish independently of the rest of the FPGA run.
+ */
+struct PipelineData {
+  /// Which input streams are read from memory by this pipeline.
+  std::bitset<query_acceleration_constants::kMaxIOStreamCount> input_streams;
+  /// Which output streams are written to memory by this pipeline.
+  std::bitset<query_acceleration_constants::kMaxIOStreamCount> output_streams;
+
+  auto operator==(const PipelineData& rhs) const -> bool {
+    return input_streams == rhs.input_streams &&
+           output_streams == rhs.output_streams;
+  }
+};
+
+}  // namespace orkhestrafs::dbmstodspi
@@ -0,0 +1,121 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "pipeline_finder.hpp"
+
+#include <map>
+
+#include "query_acceleration_constants.hpp"
+
+using orkhestrafs::dbmstodspi::PipelineData;
+using orkhestrafs::dbmstodspi::PipelineFinder;
+using orkhestrafs::dbmstodspi::query_acceleration_constants::kMaxIOStreamCount;
+using orkhestrafs::dbmstodspi::query_acceleration_constants::
+    kPassthroughStreamID;
+
+auto PipelineFinder::FindPipelines(
+    const std::vector<AcceleratedQueryNode>& query_nodes)
+    -> std::vector<PipelineData> {
+  // Union find over the stream IDs. -1 marks unused IDs.
+  std::vector<int> parents(kMaxIOStreamCount, -1);
+  for (const auto& query_node : query_nodes) {
+    int root = -1;
+    for (const auto& stream : query_node.input_streams) {
+      if (stream.stream_id != kPassthroughStreamID) {
+        root = stream.stream_id;
+        break;
+      }
+    }
+    if (root == -1) {
+      for (const auto& stream : query_node.output_streams) {
+        if (stream.stream_id != kPassthroughStreamID) {
+          root = stream.stream_id;
+          break;
+        }
+      }
+    }
+    if (root == -1) {
+      continue;
+    }
+    if (parents.at(root) == -1) {
+      parents.at(root) = root;
+    }
+    AddStreamsToPipeline(query_node.input_streams, root, parents);
+    AddStreamsToPipeline(query_node.output_streams, root, parents);
+  }
+
+  std::map<int, PipelineData> pipelines;
+  for (const auto& query_node : query_nodes) {
+    for (const auto& stream : query_node.input_streams) {
+      if (stream.stream_id != kPassthroughStreamID &&
+          !stream.physical_addresses_map.empty()) {
+        pipelines[FindRoot(parents, stream.stream_id)]
+            .input_streams[stream.stream_id] = true;
+      }
+    }
+    for (const auto& stream : query_node.output_streams) {
+      if (stream.stream_id != kPassthroughStreamID &&
+          !stream.physical_addresses_map.empty()) {
+        pipelines[FindRoot(parents, stream.stream_id)]
+            .output_streams[stream.stream_id] = true;
+      }
+    }
+  }
+
+  std::map<int, PipelineData> ordered_pipelines;
+  for (const auto& [root, pipeline] : pipelines) {
+    int lowest_id = 0;
+    while (!pipeline.input_streams[lowest_id] &&
+           !pipeline.output_streams[lowest_id] &&
+           lowest_id < kMaxIOStreamCount - 1) {
+      lowest_id++;
+    }
+    ordered_pipelines.insert({lowest_id, pipeline});
+  }
+  std::vector<PipelineData> found_pipelines;
+  found_pipelines.reserve(ordered_pipelines.size());
+  for (const auto& [lowest_id, pipeline] : ordered_pipelines) {
+    found_pipelines.push_back(pipeline);
+  }
+  return found_pipelines;
+}
+
+auto PipelineFinder::FindRoot(std::vector<int>& parents, int stream_id)
+    -> int {
+  while (parents.at(stream_id) != stream_id) {
+    parents.at(stream_id) = parents.at(parents.at(stream_id));
+    stream_id = parents.at(stream_id);
+  }
+  return stream_id;
+}
+
+void PipelineFinder::AddStreamsToPipeline(
+    const std::vector<StreamDataParameters>& streams, int root,
+    std::vector<int>& parents) {
+  for (const auto& stream : streams) {
+    if (stream.stream_id == kPassthroughStreamID) {
+      continue;
+    }
+    if (parents.at(stream.stream_id) == -1) {
+      parents.at(stream.stream_id) = stream.stream_id;
+    }
+    auto stream_root = FindRoot(parents, stream.stream_id);
+    auto current_root = FindRoot(parents, root);
+    if (stream_root != current_root) {
+      parents.at(stream_root) = current_root;
+    }
+  }
+}
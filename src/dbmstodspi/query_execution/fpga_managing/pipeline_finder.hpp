@@ -0,0 +1,49 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+#include <vector>
+
+#include "accelerated_query_node.hpp"
+#include "pipeline_data.hpp"
+
+namespace orkhestrafs::dbmstodspi {
+
+/**
+ * @brief Class to find the independent pipelines of an FPGA run.
+ */
+class PipelineFinder {
+ public:
+  /**
+   * @brief Group the given nodes into pipelines. Nodes are in the same
+   * pipeline if they share a stream ID as the IDs are passed on from the
+   * previous node by the #IDManager.
+   * @param query_nodes Nodes configured for the current run.
+   * @return Vector of DMA streams used by each pipeline ordered by the lowest
+   * stream ID.
+   */
+  static auto FindPipelines(
+      const std::vector<AcceleratedQueryNode>& query_nodes)
+      -> std::vector<PipelineData>;
+
+ private:
+  static auto FindRoot(std::vector<int>& parents, int stream_id) -> int;
+  static void AddStreamsToPipeline(
+      const std::vector<StreamDataParameters>& streams, int root,
+      std::vector<int>& parents);
+};
+
+}  // namespace orkhestrafs::dbmstodspi
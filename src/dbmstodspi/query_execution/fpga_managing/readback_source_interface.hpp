@@ -0,0 +1,45 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace orkhestrafs::dbmstodspi {
+
+/**
+ * @brief Interface class for reading back the configuration of the FPGA.
+ */
+class ReadbackSourceInterface {
+ public:
+  virtual ~ReadbackSourceInterface() = default;
+  /**
+   * @brief Read back the configuration data of the whole device.
+   * @return Configuration data starting from the first frame.
+   */
+  virtual auto ReadConfiguration() -> std::vector<char> = 0;
+  /**
+   * @brief Read the configuration frame data the given bitstream writes.
+   * @param bitstream Bitstream file.
+   * @return Frame data in readback order. Empty if the file isn't available.
+   */
+  virtual auto ReadBitstreamFrames(const std::string& bitstream)
+      -> std::vector<char> = 0;
+};
+
+}  // namespace orkhestrafs::dbmstodspi
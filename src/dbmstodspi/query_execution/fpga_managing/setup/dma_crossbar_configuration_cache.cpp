@@ -0,0 +1,62 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "dma_crossbar_configuration_cache.hpp"
+
+using orkhestrafs::dbmstodspi::CrossbarConfiguration;
+using orkhestrafs::dbmstodspi::DMACrossbarConfigurationCache;
+
+auto DMACrossbarConfigurationCache::Find(const CrossbarConfigurationKey& key)
+    -> std::shared_ptr<const CrossbarConfiguration> {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  auto search = configurations_.find(key);
+  if (search == configurations_.end()) {
+    miss_count_++;
+    return nullptr;
+  }
+  hit_count_++;
+  return search->second;
+}
+
+void DMACrossbarConfigurationCache::Insert(
+    const CrossbarConfigurationKey& key,
+    const CrossbarConfiguration& configuration) {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  configurations_.insert(
+      {key, std::make_shared<const CrossbarConfiguration>(configuration)});
+}
+
+void DMACrossbarConfigurationCache::Clear() {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  configurations_.clear();
+  hit_count_ = 0;
+  miss_count_ = 0;
+}
+
+auto DMACrossbarConfigurationCache::GetSize() -> int {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  return configurations_.size();
+}
+
+auto DMACrossbarConfigurationCache::GetHitCount() -> int {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  return hit_count_;
+}
+
+auto DMACrossbarConfigurationCache::GetMissCount() -> int {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  return miss_count_;
+}
@@ -0,0 +1,108 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#include "dma_crossbar_setup_data.hpp"
+
+namespace orkhestrafs::dbmstodspi {
+
+/**
+ * @brief Struct to hold all of the inputs the crossbar configuration depends
+ * on.
+ */
+struct CrossbarConfigurationKey {
+  bool is_input_stream;
+  bool is_multichannel_stream;
+  int record_size;
+  int records_per_ddr_burst;
+  int chunks_per_record;
+  std::vector<int> selected_columns;
+
+  auto operator<(const CrossbarConfigurationKey& other) const -> bool {
+    return std::tie(is_input_stream, is_multichannel_stream, record_size,
+                    records_per_ddr_burst, chunks_per_record,
+                    selected_columns) <
+           std::tie(other.is_input_stream, other.is_multichannel_stream,
+                    other.record_size, other.records_per_ddr_burst,
+                    other.chunks_per_record, other.selected_columns);
+  }
+};
+
+/**
+ * @brief Struct to hold a computed crossbar configuration.
+ */
+struct CrossbarConfiguration {
+  std::vector<int> expanded_column_selection;
+  std::vector<DMACrossbarSetupData> crossbar_setup_data;
+};
+
+/**
+ * @brief Class to remember already computed crossbar configurations such that
+ * streams with the same record layout don't have to recompute the crossbar
+ * register values.
+ */
+class DMACrossbarConfigurationCache {
+ public:
+  /**
+   * @brief Find a previously computed configuration.
+   * @param key Crossbar configuration inputs.
+   * @return Configuration if it has been computed before. Nullptr otherwise.
+   */
+  auto Find(const CrossbarConfigurationKey& key)
+      -> std::shared_ptr<const CrossbarConfiguration>;
+  /**
+   * @brief Store a computed configuration.
+   * @param key Crossbar configuration inputs.
+   * @param configuration Computed configuration.
+   */
+  void Insert(const CrossbarConfigurationKey& key,
+              const CrossbarConfiguration& configuration);
+  /**
+   * @brief Remove all configurations and reset the statistics.
+   */
+  void Clear();
+  /**
+   * @brief Get how many configurations are stored.
+   * @return Number of stored configurations.
+   */
+  auto GetSize() -> int;
+  /**
+   * @brief Get how many lookups found a configuration.
+   * @return Number of cache hits.
+   */
+  auto GetHitCount() -> int;
+  /**
+   * @brief Get how many lookups didn't find a configuration.
+   * @return Number of cache misses.
+   */
+  auto GetMissCount() -> int;
+
+ private:
+  std::mutex cache_mutex_;
+  std::map<CrossbarConfigurationKey,
+           std::shared_ptr<const CrossbarConfiguration>>
+      configurations_;
+  int hit_count_ = 0;
+  int miss_count_ = 0;
+};
+
+}  // namespace orkhestrafs::dbmstodspi
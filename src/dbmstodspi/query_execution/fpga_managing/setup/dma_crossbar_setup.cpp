@@ -28,6 +28,8 @@ limitations under the License.
 #include "query_acceleration_constants.hpp"
 #include "stream_parameter_calculator.hpp"
 
+using orkhestrafs::dbmstodspi::CrossbarConfigurationKey;
+using orkhestrafs::dbmstodspi::DMACrossbarConfigurationCache;
 using orkhestrafs::dbmstodspi::DMACrossbarSetup;
 using orkhestrafs::dbmstodspi::logging::Log;
 using orkhestrafs::dbmstodspi::logging::LogLevel;
@@ -36,8 +38,53 @@ using orkhestrafs::dbmstodspi::logging::ShouldLog;
 void DMACrossbarSetup::CalculateCrossbarSetupData(
     DMASetupData& stream_setup_data, const int record_size,
     const std::vector<int>& selected_columns) {
-  std::vector<int> expanded_column_selection;
+  // Partially configured streams can't be described by the key.
+  if (!stream_setup_data.crossbar_setup_data.empty()) {
+    ComputeCrossbarSetupData(stream_setup_data, record_size, selected_columns);
+    return;
+  }
+
+  CrossbarConfigurationKey key = {stream_setup_data.is_input_stream,
+                                  stream_setup_data.active_channel_count != -1,
+                                  record_size,
+                                  stream_setup_data.records_per_ddr_burst,
+                                  stream_setup_data.chunks_per_record,
+                                  selected_columns};
+  auto& cache = GetConfigurationCache();
+  auto cached_configuration = cache.Find(key);
+  if (cached_configuration) {
+    stream_setup_data.crossbar_setup_data =
+        cached_configuration->crossbar_setup_data;
+    PrintCrossbarConfigData(cached_configuration->expanded_column_selection,
+                            stream_setup_data);
+    return;
+  }
+
+  auto expanded_column_selection = ConfigureCrossbarSetupData(
+      stream_setup_data, record_size, selected_columns);
+  cache.Insert(key, {expanded_column_selection,
+                     stream_setup_data.crossbar_setup_data});
+  PrintCrossbarConfigData(expanded_column_selection, stream_setup_data);
+}
+
+void DMACrossbarSetup::ComputeCrossbarSetupData(
+    DMASetupData& stream_setup_data, const int record_size,
+    const std::vector<int>& selected_columns) {
+  auto expanded_column_selection = ConfigureCrossbarSetupData(
+      stream_setup_data, record_size, selected_columns);
+  PrintCrossbarConfigData(expanded_column_selection, stream_setup_data);
+}
+
+auto DMACrossbarSetup::GetConfigurationCache()
+    -> DMACrossbarConfigurationCache& {
+  static DMACrossbarConfigurationCache configuration_cache;
+  return configuration_cache;
+}
 
+auto DMACrossbarSetup::ConfigureCrossbarSetupData(
+    DMASetupData& stream_setup_data, const int record_size,
+    const std::vector<int>& selected_columns) -> std::vector<int> {
+  std::vector<int> expanded_column_selection;
   if (stream_setup_data.is_input_stream) {
     ConfigureInputCrossbarSetupData(selected_columns, stream_setup_data,
                                     expanded_column_selection, record_size);
@@ -45,8 +92,7 @@ void DMACrossbarSetup::CalculateCrossbarSetupData(
     ConfigureOutputCrossbarSetupData(
         selected_columns, expanded_column_selection, stream_setup_data);
   }
-
-  PrintCrossbarConfigData(expanded_column_selection, stream_setup_data);
+  return expanded_column_selection;
 }
 
 auto DMACrossbarSetup::GetReverseIndex(int index, int row_size) -> int {
@@ -18,6 +18,7 @@ limitations under the License.
 #include <queue>
 #include <vector>
 
+#include "dma_crossbar_configuration_cache.hpp"
 #include "dma_setup_data.hpp"
 
 namespace orkhestrafs::dbmstodspi {
@@ -31,7 +32,8 @@ class DMACrossbarSetup {
   /**
    * @brief Calculate crossbar setup data such that the configuration data can
    * be directly written to the DMA registers to configure the crossbar
-   * according to the the given specifications.
+   * according to the the given specifications. Configurations are reused from
+   * the cache if the same record layout has been configured before.
    * @param stream_setup_data Setup data struct where the DMA configuration is
    * stored.
    * @param record_size How many integers worth of data there is in a record.
@@ -41,8 +43,29 @@ class DMACrossbarSetup {
   static void CalculateCrossbarSetupData(
       DMASetupData& stream_setup_data, int record_size,
       const std::vector<int>& selected_columns);
+  /**
+   * @brief Calculate crossbar setup data without using the cache.
+   * @param stream_setup_data Setup data struct where the DMA configuration is
+   * stored.
+   * @param record_size How many integers worth of data there is in a record.
+   * @param selected_columns Integer vector noting which columns should be
+   * where.
+   */
+  static void ComputeCrossbarSetupData(
+      DMASetupData& stream_setup_data, int record_size,
+      const std::vector<int>& selected_columns);
+  /**
+   * @brief Get the cache holding all of the previously computed
+   * configurations.
+   * @return Crossbar configuration cache.
+   */
+  static auto GetConfigurationCache() -> DMACrossbarConfigurationCache&;
 
  private:
+  static auto ConfigureCrossbarSetupData(
+      DMASetupData& stream_setup_data, int record_size,
+      const std::vector<int>& selected_columns) -> std::vector<int>;
+
   static auto GetReverseIndex(int index, int row_size) -> int;
 
   static void SetUpEmptyCrossbarSetupData(DMASetupData& stream_setup_data,
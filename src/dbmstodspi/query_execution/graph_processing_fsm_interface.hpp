@@ -44,6 +44,11 @@ class GraphProcessingFSMInterface {
    * @brief Stop the FSM form executing the next state.
    */
   virtual void SetFinishedFlag() = 0;
+  /**
+   * @brief Update the cross query module usage statistics once all of the
+   * query nodes have been executed.
+   */
+  virtual void FinishQuery() = 0;
   /**
    * @brief Check if there are nodes to schedule.
    * @return Boolean flag showing if there are no more nodes to schedule.
@@ -117,5 +122,10 @@ class GraphProcessingFSMInterface {
   virtual void LoadBitstream(ScheduledModule new_module) = 0;
   virtual auto IsHWPrintEnabled()->bool = 0;
   virtual auto IsSWBackupEnabled() -> bool = 0;
+  /**
+   * @brief Read back the configuration and reload mismatched regions when
+   * they are used next.
+   */
+  virtual void VerifyConfiguration() = 0;
 };
 }  // namespace orkhestrafs::dbmstodspi
\ No newline at end of file
@@ -35,6 +35,8 @@ const int kModuleSize = 1024 * 1024;
 
 /// How many IO streams can there be concurrently.
 const int kMaxIOStreamCount = 16;
+/// Which stream ID is reserved for the passthrough modules.
+const int kPassthroughStreamID = 15;
 
 /// Which vector contains what information for query node I/O stream params.
 const struct StreamParamDefinition {
@@ -17,6 +17,7 @@ limitations under the License.
 #include "bitstream_config_helper.hpp"
 
 #include <algorithm>
+#include <utility>
 
 using orkhestrafs::dbmstodspi::BitstreamConfigHelper;
 
@@ -59,7 +60,7 @@ auto BitstreamConfigHelper::GetConfigCompliments(
     }
   }
 
-  return {reduced_next_config, reduced_current_config};
+  return {std::move(reduced_next_config), std::move(reduced_current_config)};
 }
 
 auto BitstreamConfigHelper::GetOldNonOverlappingModules(
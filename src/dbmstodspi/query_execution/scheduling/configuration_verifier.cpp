@@ -0,0 +1,209 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "configuration_verifier.hpp"
+
+#include <stdexcept>
+
+using orkhestrafs::dbmstodspi::ConfigurationVerifier;
+
+ConfigurationVerifier::ConfigurationVerifier(
+    std::unique_ptr<ReadbackSourceInterface> readback_source,
+    const std::string& resource_string,
+    const std::map<char, int>& cost_of_columns, uintmax_t region_offset,
+    int verification_interval)
+    : readback_source_{std::move(readback_source)},
+      verification_interval_{verification_interval},
+      readback_checksums_(resource_string.size(), 0),
+      is_readback_current_(resource_string.size(), false) {
+  column_offsets_.push_back(region_offset);
+  for (const auto column_type : resource_string) {
+    column_offsets_.push_back(column_offsets_.back() +
+                              cost_of_columns.at(column_type));
+  }
+}
+
+void ConfigurationVerifier::RecordLoad(const std::string& bitstream,
+                                       std::pair<int, int> columns) {
+  if (columns.first < 0 || columns.second + 1 >= column_offsets_.size()) {
+    loaded_regions_.clear();
+    is_readback_current_.assign(is_readback_current_.size(), false);
+  } else {
+    for (int column = columns.first; column <= columns.second; column++) {
+      is_readback_current_[column] = false;
+    }
+    SetLoadedRegion(bitstream, columns);
+  }
+}
+
+void ConfigurationVerifier::Reset() {
+  loaded_regions_.clear();
+  is_readback_current_.assign(is_readback_current_.size(), false);
+}
+
+void ConfigurationVerifier::RecordRun() { runs_since_verification_++; }
+
+auto ConfigurationVerifier::IsVerificationDue() const -> bool {
+  return verification_interval_ > 0 &&
+         runs_since_verification_ >= verification_interval_;
+}
+
+auto ConfigurationVerifier::FindConfiguredBitstreams(
+    const std::vector<std::string>& bitstreams,
+    const std::vector<std::pair<int, int>>& columns) -> std::vector<bool> {
+  std::vector<bool> is_configured(bitstreams.size(), false);
+  for (int bitstream_i = 0; bitstream_i < bitstreams.size(); bitstream_i++) {
+    const auto& bitstream_columns = columns.at(bitstream_i);
+    if (bitstream_columns.first < 0 ||
+        bitstream_columns.second + 1 >= column_offsets_.size()) {
+      continue;
+    }
+    // Other loads of the sequence would overwrite the region.
+    bool is_overwritten = false;
+    for (int other_i = 0; other_i < bitstreams.size(); other_i++) {
+      const auto& other_columns = columns.at(other_i);
+      if (other_i != bitstream_i &&
+          (other_columns.first < 0 ||
+           (other_columns.first <= bitstream_columns.second &&
+            bitstream_columns.first <= other_columns.second))) {
+        is_overwritten = true;
+      }
+    }
+    // Checked before reading the bitstream frames.
+    bool is_readback_current = true;
+    for (int column = bitstream_columns.first;
+         column <= bitstream_columns.second; column++) {
+      is_readback_current = is_readback_current && is_readback_current_[column];
+    }
+    if (is_overwritten || !is_readback_current) {
+      continue;
+    }
+    const auto& bitstream = bitstreams.at(bitstream_i);
+    if (IsReadbackMatching(GetExpectedChecksums(bitstream, bitstream_columns),
+                           bitstream_columns)) {
+      is_configured[bitstream_i] = true;
+      skipped_load_count_++;
+      SetLoadedRegion(bitstream, bitstream_columns);
+    }
+  }
+  return is_configured;
+}
+
+auto ConfigurationVerifier::Verify() -> std::vector<std::pair<int, int>> {
+  runs_since_verification_ = 0;
+  if (expected_checksums_.empty()) {
+    return {};
+  }
+  auto configuration = readback_source_->ReadConfiguration();
+  if (column_offsets_.back() > configuration.size()) {
+    throw std::runtime_error("Readback doesn't cover the PR region!");
+  }
+  for (int column = 0; column < readback_checksums_.size(); column++) {
+    readback_checksums_[column] =
+        GetChecksum(configuration, column_offsets_.at(column),
+                    column_offsets_.at(column + 1));
+  }
+  is_readback_current_.assign(is_readback_current_.size(), true);
+
+  std::vector<std::pair<int, int>> mismatched_regions;
+  for (auto region = loaded_regions_.begin();
+       region != loaded_regions_.end();) {
+    if (!IsReadbackMatching(
+            expected_checksums_.at({region->second, region->first}),
+            region->first)) {
+      mismatched_regions.push_back(region->first);
+      mismatch_count_++;
+      region = loaded_regions_.erase(region);
+    } else {
+      ++region;
+    }
+  }
+  return mismatched_regions;
+}
+
+auto ConfigurationVerifier::GetSkippedLoadCount() const -> int {
+  return skipped_load_count_;
+}
+
+auto ConfigurationVerifier::GetMismatchCount() const -> int {
+  return mismatch_count_;
+}
+
+auto ConfigurationVerifier::GetChecksum(const std::vector<char>& configuration,
+                                        uintmax_t first_byte,
+                                        uintmax_t last_byte) -> uint64_t {
+  uint64_t checksum = 14695981039346656037ULL;
+  for (auto byte_i = first_byte; byte_i < last_byte; byte_i++) {
+    checksum ^= static_cast<unsigned char>(configuration[byte_i]);
+    checksum *= 1099511628211ULL;
+  }
+  return checksum;
+}
+
+auto ConfigurationVerifier::GetExpectedChecksums(const std::string& bitstream,
+                                                 std::pair<int, int> columns)
+    -> const std::vector<uint64_t>& {
+  auto cached_checksums = expected_checksums_.find({bitstream, columns});
+  if (cached_checksums != expected_checksums_.end()) {
+    return cached_checksums->second;
+  }
+  std::vector<uint64_t> checksums;
+  auto frame_data = readback_source_->ReadBitstreamFrames(bitstream);
+  auto region_start = column_offsets_.at(columns.first);
+  if (frame_data.size() ==
+      column_offsets_.at(columns.second + 1) - region_start) {
+    for (int column = columns.first; column <= columns.second; column++) {
+      checksums.push_back(
+          GetChecksum(frame_data, column_offsets_.at(column) - region_start,
+                      column_offsets_.at(column + 1) - region_start));
+    }
+  }
+  return expected_checksums_.insert({{bitstream, columns}, checksums})
+      .first->second;
+}
+
+auto ConfigurationVerifier::IsReadbackMatching(
+    const std::vector<uint64_t>& expected_checksums,
+    std::pair<int, int> columns) const -> bool {
+  if (expected_checksums.empty()) {
+    return false;
+  }
+  for (int column = columns.first; column <= columns.second; column++) {
+    if (!is_readback_current_[column] ||
+        readback_checksums_[column] !=
+            expected_checksums.at(column - columns.first)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ConfigurationVerifier::SetLoadedRegion(const std::string& bitstream,
+                                            std::pair<int, int> columns) {
+  for (auto region = loaded_regions_.begin();
+       region != loaded_regions_.end();) {
+    if (region->first.first <= columns.second &&
+        columns.first <= region->first.second) {
+      region = loaded_regions_.erase(region);
+    } else {
+      ++region;
+    }
+  }
+  if (!GetExpectedChecksums(bitstream, columns).empty()) {
+    loaded_regions_.insert({columns, bitstream});
+  }
+}
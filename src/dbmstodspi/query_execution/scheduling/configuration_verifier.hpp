@@ -0,0 +1,138 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "readback_source_interface.hpp"
+
+namespace orkhestrafs::dbmstodspi {
+
+/**
+ * @brief Class to verify that the PR regions still hold the bitstreams they
+ * were loaded with by comparing checksums of the read back configuration.
+ *
+ * The expected checksum of each column is taken from the frame data of the
+ * loaded bitstream so a load which failed is reported by the first readback.
+ * Bitstreams which don't write exactly their columns can't be verified. A
+ * readback covers the whole device so every readback checks all of the loaded
+ * regions at once. Loads are only skipped based on the last readback such that
+ * the configuration isn't read back for every load.
+ */
+class ConfigurationVerifier {
+ public:
+  /**
+   * @brief Constructor to set where each column is in the readback data.
+   * @param readback_source Source of the configuration data.
+   * @param resource_string PR region resources.
+   * @param cost_of_columns Configuration data size of each column type.
+   * @param region_offset Where the PR region starts in the readback data.
+   * @param verification_interval Runs between periodic verifications. 0 to
+   * only verify on demand.
+   */
+  ConfigurationVerifier(
+      std::unique_ptr<ReadbackSourceInterface> readback_source,
+      const std::string& resource_string,
+      const std::map<char, int>& cost_of_columns, uintmax_t region_offset,
+      int verification_interval);
+
+  /**
+   * @brief Record that a bitstream got loaded.
+   * @param bitstream Loaded bitstream.
+   * @param columns First and last column indexes. -1s if unknown which
+   * means no region is known anymore.
+   */
+  void RecordLoad(const std::string& bitstream, std::pair<int, int> columns);
+  /**
+   * @brief Forget every region after the static bitstream is loaded.
+   */
+  void Reset();
+  /**
+   * @brief Count a run for the periodic verification.
+   */
+  void RecordRun();
+  /**
+   * @brief Check if the periodic verification should be done.
+   * @return Enough runs have been executed since the last verification.
+   */
+  [[nodiscard]] auto IsVerificationDue() const -> bool;
+
+  /**
+   * @brief Check if the requested bitstreams are configured already such that
+   * loading them can be skipped. Columns are compared against the last
+   * verification readback which is only current until the columns get loaded.
+   * @param bitstreams Bitstreams to load.
+   * @param columns Columns of each bitstream.
+   * @return If each bitstream is configured already.
+   */
+  auto FindConfiguredBitstreams(
+      const std::vector<std::string>& bitstreams,
+      const std::vector<std::pair<int, int>>& columns) -> std::vector<bool>;
+  /**
+   * @brief Read back the configuration and check every loaded region.
+   * @return Columns of the regions which don't match their bitstream anymore.
+   */
+  auto Verify() -> std::vector<std::pair<int, int>>;
+
+  [[nodiscard]] auto GetSkippedLoadCount() const -> int;
+  [[nodiscard]] auto GetMismatchCount() const -> int;
+
+  /**
+   * @brief Calculate the FNV-1a checksum of the given columns.
+   * @param configuration Read back configuration data.
+   * @param first_byte Start of the columns in the data.
+   * @param last_byte End of the columns in the data (exclusive).
+   * @return Checksum of the configuration data.
+   */
+  static auto GetChecksum(const std::vector<char>& configuration,
+                          uintmax_t first_byte, uintmax_t last_byte)
+      -> uint64_t;
+
+ private:
+  using BitstreamPlacement = std::pair<std::string, std::pair<int, int>>;
+
+  std::unique_ptr<ReadbackSourceInterface> readback_source_;
+  /// Start of each column in the readback data and the end of the region.
+  std::vector<uintmax_t> column_offsets_;
+  int verification_interval_;
+  int runs_since_verification_ = 0;
+  /// Loaded bitstream of each verifiable region.
+  std::map<std::pair<int, int>, std::string> loaded_regions_;
+  /// Checksum of each column written by the bitstream. Empty if unverifiable.
+  std::map<BitstreamPlacement, std::vector<uint64_t>> expected_checksums_;
+  /// Column checksums of the last readback.
+  std::vector<uint64_t> readback_checksums_;
+  /// If the column hasn't been loaded since the last readback.
+  std::vector<bool> is_readback_current_;
+  int skipped_load_count_ = 0;
+  int mismatch_count_ = 0;
+
+  auto GetExpectedChecksums(const std::string& bitstream,
+                            std::pair<int, int> columns)
+      -> const std::vector<uint64_t>&;
+  auto IsReadbackMatching(const std::vector<uint64_t>& expected_checksums,
+                          std::pair<int, int> columns) const -> bool;
+  void SetLoadedRegion(const std::string& bitstream,
+                       std::pair<int, int> columns);
+};
+
+}  // namespace orkhestrafs::dbmstodspi
@@ -18,10 +18,12 @@ limitations under the License.
 
 #include <algorithm>
 #include <chrono>
+#include <fstream>
 #include <iostream>
 #include <limits>
 #include <numeric>
 #include <stdexcept>
+#include <tuple>
 
 #include "elastic_scheduling_graph_parser.hpp"
 #include "logger.hpp"
@@ -33,6 +35,8 @@ using orkhestrafs::dbmstodspi::logging::LogLevel;
 
 using orkhestrafs::dbmstodspi::ElasticResourceNodeScheduler;
 using orkhestrafs::dbmstodspi::ElasticSchedulingGraphParser;
+using orkhestrafs::dbmstodspi::PlanCache;
+using orkhestrafs::dbmstodspi::PlanCostEstimator;
 using orkhestrafs::dbmstodspi::TimeLimitException;
 
 using orkhestrafs::core_interfaces::query_scheduling_data::NodeRunData;
@@ -41,6 +45,16 @@ auto ElasticResourceNodeScheduler::GetTime() -> long {
   return scheduling_time_;
 }
 
+void ElasticResourceNodeScheduler::SetModuleReuseWeights(
+    std::map<std::string, double> module_reuse_weights) {
+  module_reuse_weights_ = std::move(module_reuse_weights);
+}
+
+void ElasticResourceNodeScheduler::SetPinnedModules(
+    std::set<std::string> pinned_modules) {
+  pinned_modules_ = std::move(pinned_modules);
+}
+
 void ElasticResourceNodeScheduler::RemoveUnnecessaryTables(
     const std::unordered_map<std::string, SchedulingQueryNode> &graph,
     std::map<std::string, TableMetadata> &tables) {
@@ -60,15 +74,14 @@ void ElasticResourceNodeScheduler::RemoveUnnecessaryTables(
 auto ElasticResourceNodeScheduler::CalculateTimeLimit(
     const std::unordered_map<std::string, SchedulingQueryNode> &graph,
     const std::map<std::string, TableMetadata> &data_tables,
-    double config_speed, double streaming_speed,
-    const std::unordered_map<QueryOperationType, int> &operation_costs)
+    double streaming_speed,
+    const std::unordered_map<QueryOperationType, double> &operation_costs)
     -> double {
-  int smallest_config_size = 0;
+  double config_time = 0;
   for (const auto &[node_name, parameters] : graph) {
-    smallest_config_size += operation_costs.at(parameters.operation);
+    config_time += operation_costs.at(parameters.operation);
   }
-  double config_time = smallest_config_size / config_speed;
-  int table_sizes = 0;
+  long table_sizes = 0;
   for (const auto &[node_name, parameters] : graph) {
     for (const auto &table_name : parameters.data_tables) {
       if (!table_name.empty()) {
@@ -77,26 +90,138 @@ auto ElasticResourceNodeScheduler::CalculateTimeLimit(
       }
     }
   }
+  // Bytes divided by MB/s gives microseconds.
   double execution_time = table_sizes / streaming_speed;
-  return config_time + execution_time;
+  return (config_time + execution_time) / 1000000.0;
 }
 
-auto ElasticResourceNodeScheduler::GetLargestModulesSizes(
-    const std::map<QueryOperationType, OperationPRModules> & /*hw_libary*/)
-    -> std::unordered_map<QueryOperationType, int> {
-  // Hardcoded for now.
-  std::unordered_map<QueryOperationType, int> operation_costs = {
-      {QueryOperationType::kFilter, 315456},
-      {QueryOperationType::kLinearSort, 770784},
-      {QueryOperationType::kMergeSort, 770784},
-      {QueryOperationType::kJoin, 462768},
-      {QueryOperationType::kAddition, 315456},
-      {QueryOperationType::kMultiplication, 916608},
-      {QueryOperationType::kAggregationSum, 229152},
-  };
+auto ElasticResourceNodeScheduler::GetLargestModuleCosts(
+    const std::map<QueryOperationType, OperationPRModules> &hw_libary,
+    const ReconfigurationCostModel &cost_model)
+    -> std::unordered_map<QueryOperationType, double> {
+  std::unordered_map<QueryOperationType, double> operation_costs;
+  for (const auto &[operation, operation_modules] : hw_libary) {
+    double largest_cost = 0;
+    for (const auto &[bitstream, module_data] :
+         operation_modules.bitstream_map) {
+      largest_cost = std::max(
+          largest_cost, cost_model.GetBitstreamCost(
+                            bitstream, module_data.resource_string));
+    }
+    operation_costs.insert({operation, largest_cost});
+  }
   return operation_costs;
 }
 
+auto ElasticResourceNodeScheduler::GetCostModel(const Config &config)
+    -> const ReconfigurationCostModel & {
+  if (!cost_model_) {
+    cost_model_ = std::make_unique<ReconfigurationCostModel>(
+        config.reconfiguration_costs, config.resource_string,
+        config.cost_of_columns, config.configuration_speed);
+  }
+  return *cost_model_;
+}
+
+auto ElasticResourceNodeScheduler::IsExactSearchUsed(
+    const std::unordered_map<std::string, SchedulingQueryNode> &graph,
+    const Config &config) -> bool {
+  // The beam search is only used if it's asked for.
+  return config.scheduler_beam_width == 0 &&
+         static_cast<int>(graph.size()) <= config.scheduler_exact_node_limit;
+}
+
+auto ElasticResourceNodeScheduler::IsGreedyFallbackAllowed(
+    const std::unordered_map<std::string, SchedulingQueryNode> &graph,
+    const Config &config) -> bool {
+  return config.use_anytime_scheduling || config.scheduler_beam_width > 1 ||
+         IsExactSearchUsed(graph, config);
+}
+
+void ElasticResourceNodeScheduler::SetPlanCostEstimator(
+    const std::unordered_map<std::string, SchedulingQueryNode> &graph,
+    const std::vector<ScheduledModule> &current_configuration,
+    const Config &config) {
+  // Only the searches which compare plans as they go need costs. The others
+  // keep the first found of the plans with modules in the same positions.
+  if (!config.use_anytime_scheduling && !config.use_branch_and_bound &&
+      config.scheduler_beam_width == 0 && !IsExactSearchUsed(graph, config)) {
+    scheduler_->SetPlanCostEstimator(nullptr, false);
+    return;
+  }
+  scheduler_->SetPlanCostEstimator(
+      std::make_unique<PlanCostEstimator>(
+          config.pr_hw_library, config.resource_string,
+          config.streaming_speed, GetCostModel(config), current_configuration,
+          module_reuse_weights_, pinned_modules_),
+      config.use_branch_and_bound);
+}
+
+void ElasticResourceNodeScheduler::WriteConvergenceLog(
+    const std::string &filename) {
+  auto convergence_log = scheduler_->GetConvergenceLog();
+  if (!convergence_log.empty()) {
+    Log(LogLevel::kDebug,
+        "Cheaper plans found: " + std::to_string(convergence_log.size()) +
+            " Best cost: " + std::to_string(convergence_log.back().cost) +
+            " found after " + std::to_string(convergence_log.back().time) +
+            "[microseconds]");
+  }
+  if (filename.empty()) {
+    return;
+  }
+  // The first round starts a new log.
+  std::ofstream output_file(filename, scheduling_round_ == 0
+                                          ? std::ios::trunc
+                                          : std::ios::app);
+  if (!output_file) {
+    throw std::runtime_error("Couldn't open: " + filename);
+  }
+  if (scheduling_round_ == 0) {
+    output_file << "round,time,cost\n";
+  }
+  for (const auto &point : convergence_log) {
+    output_file << scheduling_round_ << "," << point.time << ","
+                << point.cost << "\n";
+  }
+  scheduling_round_++;
+}
+
+void ElasticResourceNodeScheduler::ConnectSkippedNodeInputs(
+    const std::vector<QueryNode *> &skipped_nodes) {
+  std::unordered_set<QueryNode *> unconnected_nodes(skipped_nodes.begin(),
+                                                    skipped_nodes.end());
+  for (auto *node : skipped_nodes) {
+    ConnectSkippedNodeInput(node, unconnected_nodes);
+  }
+}
+
+void ElasticResourceNodeScheduler::ConnectSkippedNodeInput(
+    QueryNode *node, std::unordered_set<QueryNode *> &unconnected_nodes) {
+  if (unconnected_nodes.erase(node) == 0) {
+    return;
+  }
+  // A skipped node before this one has to pass its input on first.
+  ConnectSkippedNodeInput(node->previous_nodes.front(), unconnected_nodes);
+  auto *next_node = node->next_nodes.front();
+  if (next_node != nullptr) {
+    auto stream_index = std::find(next_node->previous_nodes.begin(),
+                                  next_node->previous_nodes.end(), node) -
+                        next_node->previous_nodes.begin();
+    next_node->given_input_data_definition_files.at(stream_index) =
+        node->given_input_data_definition_files.front();
+  }
+}
+
+auto ElasticResourceNodeScheduler::GetPlanCache(const Config &config)
+    -> PlanCache & {
+  if (!plan_cache_) {
+    plan_cache_ =
+        std::make_unique<PlanCache>(config.plan_cache_file, config);
+  }
+  return *plan_cache_;
+}
+
 auto ElasticResourceNodeScheduler::ScheduleAndGetAllPlans(
     const std::unordered_set<std::string> &starting_nodes,
     const std::unordered_set<std::string> &processed_nodes,
@@ -107,38 +232,94 @@ auto ElasticResourceNodeScheduler::ScheduleAndGetAllPlans(
                   std::map<std::vector<std::vector<ScheduledModule>>,
                            ExecutionPlanSchedulingData>,
                   long long, bool, std::pair<int, int>> {
+  auto scheduling_time = SearchPlans(starting_nodes, processed_nodes, graph,
+                                     tables, config, blocked_nodes);
+  return {-1, scheduler_->GetResultingPlan(), scheduling_time,
+          scheduler_->GetTimeoutStatus(), scheduler_->GetStats()};
+}
+
+auto ElasticResourceNodeScheduler::SearchPlans(
+    const std::unordered_set<std::string> &starting_nodes,
+    const std::unordered_set<std::string> &processed_nodes,
+    const std::unordered_map<std::string, SchedulingQueryNode> &graph,
+    const std::map<std::string, TableMetadata> &tables, const Config &config,
+    const std::unordered_set<std::string> &blocked_nodes) -> long long {
   double time_limit_duration_in_seconds = config.scheduler_time_limit_in_seconds;
-  if (time_limit_duration_in_seconds == -1) {
-    auto operation_costs = GetLargestModulesSizes(config.pr_hw_library);
+  if (config.use_anytime_scheduling &&
+      config.scheduler_latency_budget_in_milliseconds != -1) {
     time_limit_duration_in_seconds =
-        CalculateTimeLimit(graph, tables, config.configuration_speed,
-                           config.streaming_speed, operation_costs);
+        config.scheduler_latency_budget_in_milliseconds / 1000.0;
+  } else if (time_limit_duration_in_seconds == -1) {
+    auto operation_costs =
+        GetLargestModuleCosts(config.pr_hw_library, GetCostModel(config));
+    time_limit_duration_in_seconds = CalculateTimeLimit(
+        graph, tables, config.streaming_speed, operation_costs);
+  }
+  // The exact and beam searches have no plans to return before they finish.
+  // Part of the time is kept to finish the plans greedily after a timeout.
+  if (config.scheduler_beam_width > 1 || IsExactSearchUsed(graph, config)) {
+    time_limit_duration_in_seconds *= 1 - kGreedyFallbackTimeShare;
   }
   auto time_limit =
       std::chrono::system_clock::now() +
-      std::chrono::milliseconds(int(time_limit_duration_in_seconds * 1000));
+      std::chrono::microseconds(
+          static_cast<long>(time_limit_duration_in_seconds * 1000000));
 
-  scheduler_->SetTimeLimit(time_limit);
+  // The default search keeps going until it has a plan to return.
+  bool is_greedy_fallback_allowed = IsGreedyFallbackAllowed(graph, config);
+  scheduler_->SetTimeLimit(time_limit, is_greedy_fallback_allowed);
   std::chrono::steady_clock::time_point begin =
       std::chrono::steady_clock::now();
 
   // Configure the runtime_error behaviour
   try {
-    scheduler_->PlaceNodesRecursively(starting_nodes, processed_nodes, graph,
-                                      {}, {}, tables, blocked_nodes, {}, 0);
+    if (config.scheduler_beam_width > 0) {
+      scheduler_->PlaceNodesWithBeamSearch(config.scheduler_beam_width,
+                                           starting_nodes, processed_nodes,
+                                           graph, {}, {}, tables,
+                                           blocked_nodes, {}, 0);
+    } else if (IsExactSearchUsed(graph, config)) {
+      scheduler_->PlaceNodesWithDynamicProgramming(
+          starting_nodes, processed_nodes, graph, {}, {}, tables,
+          blocked_nodes, {}, 0);
+    } else {
+      scheduler_->PlaceNodesRecursively(starting_nodes, processed_nodes, graph,
+                                        {}, {}, tables, blocked_nodes, {}, 0);
+    }
   } catch (TimeLimitException &e) {
     Log(LogLevel::kInfo, "Timeout of " +
                              std::to_string(time_limit_duration_in_seconds) +
                              " seconds hit by the scheduler.");
     //throw std::runtime_error("TIMEOUT!");
   }
+  if (is_greedy_fallback_allowed && scheduler_->GetTimeoutStatus() &&
+      !scheduler_->HasFoundPlan()) {
+    Log(LogLevel::kInfo,
+        "No plan found before the timeout. Scheduling greedily.");
+    scheduler_->PlaceNodesGreedilyAfterTimeout(starting_nodes, processed_nodes,
+                                               graph, tables, blocked_nodes);
+  }
 
   std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
 
-  return {-1, scheduler_->GetResultingPlan(),
-          std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
-              .count(),
-          scheduler_->GetTimeoutStatus(), scheduler_->GetStats()};
+  if (config.scheduler_transposition_table_size > 0) {
+    auto table_statistics = scheduler_->GetTranspositionTableStatistics();
+    Log(LogLevel::kDebug,
+        "Transposition table hits: " + std::to_string(table_statistics.hits) +
+            "/" + std::to_string(table_statistics.lookups) +
+            " Stored states: " +
+            std::to_string(table_statistics.stored_states) +
+            " Rejected states: " +
+            std::to_string(table_statistics.rejected_states));
+  }
+  if (config.use_branch_and_bound) {
+    Log(LogLevel::kDebug,
+        "Branches pruned by cost: " +
+            std::to_string(scheduler_->GetPrunedBranchCount()));
+  }
+
+  return std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+      .count();
 }
 
 void ElasticResourceNodeScheduler::BenchmarkScheduling(
@@ -160,9 +341,32 @@ void ElasticResourceNodeScheduler::BenchmarkScheduling(
         config.pr_hw_library, heuristic_choices.at(config.heuristic_choice),
         first_node_names, drivers, config.use_max_runs_cap,
         config.reduce_single_runs, config.prioritise_children,
-        config.use_single_runs);
+        config.use_single_runs, config.scheduler_thread_count,
+        config.scheduler_transposition_table_size);
   }
   scheduler_->PreprocessNodes(starting_nodes, processed_nodes, graph, tables);
+  double exhaustive_plan_cost = 0;
+  bool exhaustive_search_timed_out = false;
+  long exhaustive_search_time = 0;
+  if (config.scheduler_beam_width > 0) {
+    // The beam search plans are compared against the exhaustive search
+    // without pruning. If it times out, its best plan so far is used.
+    auto begin_exhaustive_search = std::chrono::steady_clock::now();
+    auto exhaustive_config = config;
+    exhaustive_config.scheduler_beam_width = 0;
+    exhaustive_config.scheduler_exact_node_limit = 0;
+    exhaustive_config.use_branch_and_bound = false;
+    exhaustive_config.use_anytime_scheduling = false;
+    std::tie(exhaustive_plan_cost, exhaustive_search_timed_out) =
+        GetBestPlanCost(starting_nodes, processed_nodes, graph, tables,
+                        current_configuration, exhaustive_config,
+                        blocked_nodes);
+    exhaustive_search_time =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - begin_exhaustive_search)
+            .count();
+  }
+  SetPlanCostEstimator(graph, current_configuration, config);
   std::chrono::steady_clock::time_point end_pre_process =
       std::chrono::steady_clock::now();
   auto pre_process_time = std::chrono::duration_cast<std::chrono::microseconds>(
@@ -180,7 +384,8 @@ void ElasticResourceNodeScheduler::BenchmarkScheduling(
           config.utilites_scaler, config.config_written_scaler,
           config.utility_per_frame_scaler, resulting_plans,
           config.cost_of_columns, config.streaming_speed,
-          config.configuration_speed);
+          GetCostModel(config), module_reuse_weights_,
+          pinned_modules_);
   std::chrono::steady_clock::time_point end_cost_eval =
       std::chrono::steady_clock::now();
 
@@ -190,7 +395,20 @@ void ElasticResourceNodeScheduler::BenchmarkScheduling(
 
   auto overall_time = std::chrono::duration_cast<std::chrono::microseconds>(
                           end_cost_eval - begin_pre_process)
-                          .count();
+                          .count() -
+                      exhaustive_search_time;
+  if (config.scheduler_beam_width > 0) {
+    benchmark_data["plan_cost"] +=
+        data_amount / config.streaming_speed + configuration_amount;
+    benchmark_data["exhaustive_plan_cost"] += exhaustive_plan_cost;
+    // Rounds in which the gap isn't against all plans.
+    benchmark_data["exhaustive_timeouts"] +=
+        static_cast<double>(exhaustive_search_timed_out);
+    // Relative cost increase over the exhaustive plans of all rounds.
+    benchmark_data["plan_quality_gap"] =
+        benchmark_data["plan_cost"] / benchmark_data["exhaustive_plan_cost"] -
+        1;
+  }
 //  std::cout << "schedule_time (Microseconds): " << std::to_string(scheduling_time)
 //            << std::endl;
 //  benchmark_data["discarded_placements"] += stats.second;
@@ -237,6 +455,11 @@ void ElasticResourceNodeScheduler::BenchmarkScheduling(
   current_configuration = new_last_config;
 
   benchmark_data["schedule_time"] += overall_time;
+  benchmark_data["plan_count"] += resulting_plans.size();
+  benchmark_data["explored_branches"] += scheduler_->GetExploredBranchCount();
+  benchmark_data["timeout"] += static_cast<double>(timed_out);
+  benchmark_data["greedy_fallbacks"] +=
+      static_cast<double>(scheduler_->IsGreedyFallbackUsed());
   // It's actually time
   //std::cout<<data_amount <<std::endl;
   //std::cout<<configuration_amount <<std::endl;
@@ -256,6 +479,79 @@ void ElasticResourceNodeScheduler::BenchmarkScheduling(
   }
 }
 
+auto ElasticResourceNodeScheduler::GetBestPlanCost(
+    const std::unordered_set<std::string> &starting_nodes,
+    const std::unordered_set<std::string> &processed_nodes,
+    const std::unordered_map<std::string, SchedulingQueryNode> &graph,
+    const std::map<std::string, TableMetadata> &tables,
+    const std::vector<ScheduledModule> &current_configuration,
+    const Config &config, const std::unordered_set<std::string> &blocked_nodes)
+    -> std::pair<double, bool> {
+  SetPlanCostEstimator(graph, current_configuration, config);
+  auto [min_runs, resulting_plans, scheduling_time, timed_out, stats] =
+      ScheduleAndGetAllPlans(starting_nodes, processed_nodes, graph, tables,
+                             config, blocked_nodes);
+  auto [best_plan, new_last_config, data_amount, configuration_amount] =
+      plan_evaluator_->GetBestPlan(
+          min_runs, current_configuration, config.resource_string,
+          config.utilites_scaler, config.config_written_scaler,
+          config.utility_per_frame_scaler, resulting_plans,
+          config.cost_of_columns, config.streaming_speed,
+          GetCostModel(config), module_reuse_weights_,
+          pinned_modules_);
+  return {data_amount / config.streaming_speed + configuration_amount,
+          timed_out};
+}
+
+auto ElasticResourceNodeScheduler::ScheduleBestPlan(
+    const std::unordered_set<std::string> &starting_nodes,
+    const std::unordered_set<std::string> &skipped_nodes,
+    const std::unordered_map<std::string, SchedulingQueryNode> &graph,
+    const std::map<std::string, TableMetadata> &tables,
+    const std::vector<ScheduledModule> &current_configuration,
+    const Config &config, const std::unordered_set<std::string> &blocked_nodes)
+    -> std::pair<std::vector<std::vector<ScheduledModule>>,
+                 ExecutionPlanSchedulingData> {
+  SetPlanCostEstimator(graph, current_configuration, config);
+  if (config.use_anytime_scheduling) {
+    // Plans are costed as they are found so only the cheapest one is kept.
+    auto scheduling_time = SearchPlans(starting_nodes, skipped_nodes, graph,
+                                       tables, config, blocked_nodes);
+    Log(LogLevel::kInfo, "Main scheduling loop time = " +
+                             std::to_string(scheduling_time / 1000) +
+                             "[milliseconds]");
+    WriteConvergenceLog(config.scheduler_convergence_file);
+    return scheduler_->GetBestFoundPlan();
+  }
+
+  auto [min_runs, resulting_plans, scheduling_time, ignored_timeout,
+        ignored_stats] = ScheduleAndGetAllPlans(starting_nodes, skipped_nodes,
+                                                graph, tables, config, blocked_nodes);
+  Log(LogLevel::kInfo,
+      "Main scheduling loop time = " + std::to_string(scheduling_time / 1000) +
+          "[milliseconds]");
+  //std::cout << "PLAN COUNT:" << resulting_plans.size() << std::endl;
+
+  Log(LogLevel::kTrace, "Choosing best plan.");
+  // resulting_plans
+  std::vector<std::vector<ScheduledModule>> best_plan;
+  if (resulting_plans.size() != 1){
+    auto [result, ignored_new_last_config, ignored_data_size, ignored_config_size] =
+        plan_evaluator_->GetBestPlan(
+            min_runs, current_configuration, config.resource_string,
+            config.utilites_scaler, config.config_written_scaler,
+            config.utility_per_frame_scaler, resulting_plans,
+            config.cost_of_columns, config.streaming_speed,
+            GetCostModel(config), module_reuse_weights_,
+            pinned_modules_);
+    best_plan = std::move(result);
+  } else {
+    best_plan = std::move(resulting_plans.begin()->first);
+  }
+  auto best_plan_data = std::move(resulting_plans.at(best_plan));
+  return {std::move(best_plan), std::move(best_plan_data)};
+}
+
 auto ElasticResourceNodeScheduler::GetNextSetOfRuns(
     std::vector<QueryNode *> &available_nodes,
     const std::unordered_set<std::string> &first_node_names,
@@ -282,34 +578,47 @@ auto ElasticResourceNodeScheduler::GetNextSetOfRuns(
         config.pr_hw_library, heuristic_choices.at(config.heuristic_choice),
         first_node_names, drivers, config.use_max_runs_cap,
         config.reduce_single_runs, config.prioritise_children,
-        config.use_single_runs);
+        config.use_single_runs, config.scheduler_thread_count,
+        config.scheduler_transposition_table_size);
   }
   std::chrono::steady_clock::time_point start =
       std::chrono::steady_clock::now();
+  // Skipped nodes are removed from the graph during scheduling.
+  std::unordered_map<std::string, QueryNode *> query_nodes;
+  for (const auto &[node_name, node] : graph) {
+    query_nodes.insert({node_name, node.node_ptr});
+  }
+  auto previously_processed_nodes = skipped_nodes;
   scheduler_->PreprocessNodes(starting_nodes, skipped_nodes, graph, tables);
 
-  auto [min_runs, resulting_plans, scheduling_time, ignored_timeout,
-        ignored_stats] = ScheduleAndGetAllPlans(starting_nodes, skipped_nodes,
-                                                graph, tables, config, blocked_nodes);
-  Log(LogLevel::kInfo,
-      "Main scheduling loop time = " + std::to_string(scheduling_time / 1000) +
-          "[milliseconds]");
-  //std::cout << "PLAN COUNT:" << resulting_plans.size() << std::endl;
-
-  Log(LogLevel::kTrace, "Choosing best plan.");
-  // resulting_plans
   std::vector<std::vector<ScheduledModule>> best_plan;
-  if (resulting_plans.size() != 1){
-    auto [result, ignored_new_last_config, ignored_data_size, ignored_config_size] =
-        plan_evaluator_->GetBestPlan(
-            min_runs, current_configuration, config.resource_string,
-            config.utilites_scaler, config.config_written_scaler,
-            config.utility_per_frame_scaler, resulting_plans,
-            config.cost_of_columns, config.streaming_speed,
-            config.configuration_speed);
-    best_plan = std::move(result);
+  ExecutionPlanSchedulingData best_plan_data;
+  PlanCache::Key plan_cache_key;
+  std::optional<PlanCache::CachedPlan> cached_plan;
+  if (!config.plan_cache_file.empty()) {
+    plan_cache_key =
+        PlanCache::GetKey(starting_nodes, skipped_nodes, blocked_nodes, graph,
+                          tables, current_configuration,
+                          module_reuse_weights_, pinned_modules_);
+    cached_plan = GetPlanCache(config).Find(plan_cache_key, tables);
+  }
+  if (cached_plan) {
+    Log(LogLevel::kInfo, "Execution plan found in the plan cache.");
+    best_plan = cached_plan->plan;
+    // The streamed data and resulting tables depend on the exact tables.
+    best_plan_data =
+        scheduler_->ReplayPlan(best_plan, starting_nodes, skipped_nodes, graph,
+                               tables, blocked_nodes);
   } else {
-    best_plan = std::move(resulting_plans.begin()->first);
+    std::tie(best_plan, best_plan_data) =
+        ScheduleBestPlan(starting_nodes, skipped_nodes, graph, tables,
+                         current_configuration, config, blocked_nodes);
+    // Plans cut short by the time limit aren't kept for later queries.
+    if (!config.plan_cache_file.empty() && !scheduler_->GetTimeoutStatus() &&
+        !scheduler_->IsGreedyFallbackUsed()) {
+      GetPlanCache(config).Insert(plan_cache_key, best_plan,
+                                  best_plan_data.data_tables, tables);
+    }
   }
 
 
@@ -324,8 +633,23 @@ auto ElasticResourceNodeScheduler::GetNextSetOfRuns(
   // No need to update the following commented out values
   // starting_nodes = resulting_plans.at(best_plan).available_nodes
   // graph = resulting_plans.at(best_plan).graph;
+  std::unordered_set<std::string> placed_nodes;
+  for (const auto &run : best_plan) {
+    for (const auto &module : run) {
+      placed_nodes.insert(module.node_name);
+    }
+  }
+  std::vector<QueryNode *> nodes_skipped_by_plan;
+  for (const auto &node_name : best_plan_data.processed_nodes) {
+    if (previously_processed_nodes.find(node_name) ==
+            previously_processed_nodes.end() &&
+        placed_nodes.find(node_name) == placed_nodes.end()) {
+      nodes_skipped_by_plan.push_back(query_nodes.at(node_name));
+    }
+  }
+  ConnectSkippedNodeInputs(nodes_skipped_by_plan);
   // We want skipped nodes for deleting them from the main Graph later
-  skipped_nodes.merge(resulting_plans.at(best_plan).processed_nodes);
+  skipped_nodes.merge(best_plan_data.processed_nodes);
   // skipped_nodes = resulting_plans.at(best_plan).processed_nodes;
   // The nodes that aren't in the graph aren't executed anyway and the tables
   // have already been handled.
@@ -336,7 +660,7 @@ auto ElasticResourceNodeScheduler::GetNextSetOfRuns(
     }
   }
   // To update tables as normal execution doesn't update sorted statuses.
-  tables = resulting_plans.at(best_plan).data_tables;
+  tables = best_plan_data.data_tables;
 
   auto resulting_runs = GetQueueOfResultingRuns(
       available_nodes, best_plan, config.pr_hw_library, tables, table_counter);
@@ -21,7 +21,9 @@ limitations under the License.
 #include "elastic_scheduling_graph_parser.hpp"
 #include "module_selection.hpp"
 #include "node_scheduler_interface.hpp"
+#include "plan_cache.hpp"
 #include "plan_evaluator_interface.hpp"
+#include "reconfiguration_cost_model.hpp"
 
 using orkhestrafs::core_interfaces::query_scheduling_data::NodeRunData;
 
@@ -34,6 +36,9 @@ namespace orkhestrafs::dbmstodspi {
 class ElasticResourceNodeScheduler : public NodeSchedulerInterface {
  public:
   auto GetTime() -> long override;
+  void SetModuleReuseWeights(
+      std::map<std::string, double> module_reuse_weights) override;
+  void SetPinnedModules(std::set<std::string> pinned_modules) override;
   explicit ElasticResourceNodeScheduler(
       std::unique_ptr<PlanEvaluatorInterface> plan_evaluator)
       : plan_evaluator_{std::move(plan_evaluator)} {}
@@ -75,6 +80,9 @@ class ElasticResourceNodeScheduler : public NodeSchedulerInterface {
       const std::unordered_set<std::string> &blocked_nodes) override;
 
  private:
+  // Share of the time limit kept for the greedy pass after the exact or beam
+  // search timed out.
+  static constexpr double kGreedyFallbackTimeShare = 0.1;
   long scheduling_time_;
   struct LengthOfSortedSequences {
     int offset;
@@ -110,8 +118,8 @@ class ElasticResourceNodeScheduler : public NodeSchedulerInterface {
   static auto CalculateTimeLimit(
       const std::unordered_map<std::string, SchedulingQueryNode> &graph,
       const std::map<std::string, TableMetadata> &data_tables,
-      double config_speed, double streaming_speed,
-      const std::unordered_map<QueryOperationType, int> &operation_costs)
+      double streaming_speed,
+      const std::unordered_map<QueryOperationType, double> &operation_costs)
       -> double;
   static auto FindSharedPointerFromRootNodes(
       const std::string &searched_node_name, QueryNode *current_node)
@@ -136,11 +144,84 @@ class ElasticResourceNodeScheduler : public NodeSchedulerInterface {
       std::unordered_map<std::string, int> &table_counter)
       -> std::queue<
           std::pair<std::vector<ScheduledModule>, std::vector<QueryNode *>>>;
-  static auto GetLargestModulesSizes(
-      const std::map<QueryOperationType, OperationPRModules> &hw_libary)
-      -> std::unordered_map<QueryOperationType, int>;
+  static auto GetLargestModuleCosts(
+      const std::map<QueryOperationType, OperationPRModules> &hw_libary,
+      const ReconfigurationCostModel &cost_model)
+      -> std::unordered_map<QueryOperationType, double>;
+  auto GetCostModel(const Config &config) -> const ReconfigurationCostModel &;
+  /**
+   * @brief Check if the graph is small enough to find the cheapest plan with
+   * dynamic programming instead of searching all plans.
+   * @param graph Nodes to schedule.
+   * @param config Scheduler configuration.
+   * @return Boolean flag noting if dynamic programming is used.
+   */
+  static auto IsExactSearchUsed(
+      const std::unordered_map<std::string, SchedulingQueryNode> &graph,
+      const Config &config) -> bool;
+  /**
+   * @brief Check if the nodes can be scheduled greedily when the search hits
+   * the time limit before finding any plan. Only anytime scheduling and the
+   * searches which find no plans before they finish stop early.
+   * @param graph Nodes to schedule.
+   * @param config Scheduler configuration.
+   * @return Boolean flag noting if the greedy fallback is used.
+   */
+  static auto IsGreedyFallbackAllowed(
+      const std::unordered_map<std::string, SchedulingQueryNode> &graph,
+      const Config &config) -> bool;
+  void SetPlanCostEstimator(
+      const std::unordered_map<std::string, SchedulingQueryNode> &graph,
+      const std::vector<ScheduledModule> &current_configuration,
+      const Config &config);
+  auto GetPlanCache(const Config &config) -> PlanCache &;
+  /**
+   * @brief Move the input tables of the nodes the chosen plan skips to the
+   * nodes after them. The search only changes its own copies of the graph.
+   * @param skipped_nodes Nodes which are skipped by the chosen plan.
+   */
+  static void ConnectSkippedNodeInputs(
+      const std::vector<QueryNode *> &skipped_nodes);
+  static void ConnectSkippedNodeInput(
+      QueryNode *node, std::unordered_set<QueryNode *> &unconnected_nodes);
+  auto SearchPlans(
+      const std::unordered_set<std::string> &starting_nodes,
+      const std::unordered_set<std::string> &processed_nodes,
+      const std::unordered_map<std::string, SchedulingQueryNode> &graph,
+      const std::map<std::string, TableMetadata> &tables, const Config &config,
+      const std::unordered_set<std::string> &blocked_nodes) -> long long;
+  void WriteConvergenceLog(const std::string &filename);
+  /**
+   * @brief Search plans with the given configuration and cost the best one.
+   * @return Streaming and configuration time of the best plan and if the
+   * search timed out before it finished.
+   */
+  auto GetBestPlanCost(
+      const std::unordered_set<std::string> &starting_nodes,
+      const std::unordered_set<std::string> &processed_nodes,
+      const std::unordered_map<std::string, SchedulingQueryNode> &graph,
+      const std::map<std::string, TableMetadata> &tables,
+      const std::vector<ScheduledModule> &current_configuration,
+      const Config &config,
+      const std::unordered_set<std::string> &blocked_nodes)
+      -> std::pair<double, bool>;
+  auto ScheduleBestPlan(
+      const std::unordered_set<std::string> &starting_nodes,
+      const std::unordered_set<std::string> &skipped_nodes,
+      const std::unordered_map<std::string, SchedulingQueryNode> &graph,
+      const std::map<std::string, TableMetadata> &tables,
+      const std::vector<ScheduledModule> &current_configuration,
+      const Config &config,
+      const std::unordered_set<std::string> &blocked_nodes)
+      -> std::pair<std::vector<std::vector<ScheduledModule>>,
+                   ExecutionPlanSchedulingData>;
 
   std::unique_ptr<PlanEvaluatorInterface> plan_evaluator_;
+  std::unique_ptr<ReconfigurationCostModel> cost_model_;
+  std::unique_ptr<PlanCache> plan_cache_;
+  int scheduling_round_ = 0;
+  std::map<std::string, double> module_reuse_weights_;
+  std::set<std::string> pinned_modules_;
   std::unique_ptr<ElasticSchedulingGraphParser> scheduler_;
 };
 }  // namespace orkhestrafs::dbmstodspi
\ No newline at end of file
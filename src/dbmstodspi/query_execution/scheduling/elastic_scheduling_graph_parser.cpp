@@ -17,6 +17,7 @@ limitations under the License.
 #include "elastic_scheduling_graph_parser.hpp"
 
 #include <algorithm>
+#include <functional>
 #include <iterator>
 #include <numeric>
 #include <stdexcept>
@@ -27,17 +28,21 @@ limitations under the License.
 
 #include "pre_scheduling_processor.hpp"
 #include "query_scheduling_helper.hpp"
+#include "scheduling_search_state.hpp"
 #include "table_data.hpp"
 #include "time_limit_execption.hpp"
 
 using orkhestrafs::dbmstodspi::ElasticSchedulingGraphParser;
 using orkhestrafs::dbmstodspi::PairHash;
 using orkhestrafs::dbmstodspi::QuerySchedulingHelper;
+using orkhestrafs::dbmstodspi::SchedulingSearchState;
 using orkhestrafs::dbmstodspi::TimeLimitException;
 #ifdef FPGA_AVAILALBLE
 using orkhestrafs::core_interfaces::operation_types::QueryOperationType;
 #endif  // FPGA_AVAILALBLE
 
+using NodeSet = SchedulingSearchState::NodeSet;
+
 void ElasticSchedulingGraphParser::PreprocessNodes(
     std::unordered_set<std::string>& available_nodes,
     std::unordered_set<std::string>& processed_nodes,
@@ -66,41 +71,41 @@ auto ElasticSchedulingGraphParser::CurrentRunHasFirstModule(
 }
 
 auto ElasticSchedulingGraphParser::RemoveUnavailableNodesInThisRun(
-    const std::unordered_set<std::string>& available_nodes,
-    const std::vector<ScheduledModule>& current_run,
-    const std::unordered_map<std::string, SchedulingQueryNode>& graph,
-    const std::unordered_set<std::string>& blocked_nodes, 
-    const std::map<std::string, TableMetadata>& data_tables)
-    -> std::unordered_set<std::string> {
-  auto resulting_nodes = available_nodes;
-  for (const auto& node_name : available_nodes) {
+    const SchedulingSearchState& state) -> std::vector<int> {
+  const auto& current_run = state.GetCurrentRun();
+  std::vector<int> resulting_nodes;
+  for (const auto& node_id :
+       SchedulingGraphIndex::GetNodeIds(state.GetNodes(NodeSet::kAvailable))) {
+    if (SchedulingGraphIndex::IsInSet(state.GetNodes(NodeSet::kBlocked),
+                                      node_id)) {
+      continue;
+    }
+    const auto& node_name = state.GetGraphIndex().GetNodeName(node_id);
     // Does the current run have something planned already such that you can't
     // place a node into first location
     if (constrained_first_nodes_.find(node_name) !=
         constrained_first_nodes_.end()) {
-      if (CurrentRunHasFirstModule(current_run, node_name,
-                                   graph.at(node_name).operation)) {
-        resulting_nodes.erase(node_name);
+      const auto& node = state.GetNode(node_id);
+      if (CurrentRunHasFirstModule(current_run, node_name, node.operation)) {
+        continue;
       } else {
         // Is there a parent node in the current run already.
         if (std::any_of(
                 current_run.begin(), current_run.end(),
                 [&](const auto& cur_module) {
                   return std::find_if(
-                             graph.at(node_name).before_nodes.begin(),
-                             graph.at(node_name).before_nodes.end(),
+                             node.before_nodes.begin(),
+                             node.before_nodes.end(),
                              [&](const auto& before_pointer) {
                                        return before_pointer.first ==
                                               cur_module.node_name;
-                             }) != graph.at(node_name).before_nodes.end();
+                             }) != node.before_nodes.end();
                 })) {
-          resulting_nodes.erase(node_name);
+          continue;
         }
       }
     }
-    if (blocked_nodes.find(node_name) != blocked_nodes.end()) {
-      resulting_nodes.erase(node_name);
-    }
+    resulting_nodes.push_back(node_id);
 
   //  auto current_operation = graph.at(node_name).operation;
 
@@ -176,11 +181,10 @@ auto ElasticSchedulingGraphParser::RemoveUnavailableNodesInThisRun(
 
 auto ElasticSchedulingGraphParser::GetMinPositionInCurrentRun(
     const std::vector<ScheduledModule>& current_run,
-    const std::string& node_name,
-    const std::unordered_map<std::string, SchedulingQueryNode>& graph) -> int {
+    const SchedulingQueryNode& node) -> int {
   /*std::vector<ScheduledModule> currently_scheduled_prereq_nodes;*/
   int current_min = -1;
-  for (const auto& [previous_node_name, _] : graph.at(node_name).before_nodes) {
+  for (const auto& [previous_node_name, _] : node.before_nodes) {
     for (const auto& module_placement : current_run) {
       if (previous_node_name == module_placement.node_name) {
         if (module_placement.position.second > current_min) {
@@ -236,41 +240,36 @@ auto ElasticSchedulingGraphParser::FindAllAvailableBitstreamsAfterMinPos(
     const std::vector<std::vector<std::string>>& bitstream_start_locations)
     -> std::vector<std::tuple<int, int, int>> {
   std::vector<std::tuple<int, int, int>> all_positions_and_bitstream_indexes;
+  HWLibraryIndex::ModuleSet overlapping_modules;
+  for (const auto& [first_column, last_column] : taken_positions) {
+    auto overlapping_taken_position = hw_library_index_.GetOverlappingModules(
+        current_operation, first_column, last_column);
+    if (overlapping_modules.empty()) {
+      overlapping_modules = std::move(overlapping_taken_position);
+    } else {
+      for (int word_index = 0; word_index < overlapping_modules.size();
+           word_index++) {
+        overlapping_modules[word_index] |=
+            overlapping_taken_position[word_index];
+      }
+    }
+  }
   for (int start_location_index = min_position;
        start_location_index < bitstream_start_locations.size();
        start_location_index++) {
     for (const auto& bitstream_name :
          bitstream_start_locations.at(start_location_index)) {
+      auto module_id = hw_library_index_.GetModuleId(
+          current_operation, start_location_index, bitstream_name);
       int bitstream_index =
-          std::find(hw_library_.at(current_operation)
-                        .starting_locations.at(start_location_index)
-                        .begin(),
-                    hw_library_.at(current_operation)
-                        .starting_locations.at(start_location_index)
-                        .end(),
-                    bitstream_name) -
-          hw_library_.at(current_operation)
-              .starting_locations.at(start_location_index)
-              .begin();
+          hw_library_index_.GetModule(module_id).location_index;
       if (taken_positions.empty()) {
         all_positions_and_bitstream_indexes.emplace_back(
             0, start_location_index, bitstream_index);
-      } else {
-        auto module_index =
-            GetModuleIndex(start_location_index, taken_positions);
-        auto end_index = start_location_index +
-                         hw_library_.at(current_operation)
-                             .bitstream_map.at(bitstream_name)
-                             .length -
-                         1;
-        if ((taken_positions.size() == module_index &&
-             taken_positions.at(module_index - 1).second <
-                 start_location_index) ||
-            (taken_positions.size() != module_index &&
-             taken_positions.at(module_index).first > end_index)) {
-          all_positions_and_bitstream_indexes.emplace_back(
-              module_index, start_location_index, bitstream_index);
-        }
+      } else if (!HWLibraryIndex::IsInSet(overlapping_modules, module_id)) {
+        all_positions_and_bitstream_indexes.emplace_back(
+            GetModuleIndex(start_location_index, taken_positions),
+            start_location_index, bitstream_index);
       }
     }
   }
@@ -280,26 +279,10 @@ auto ElasticSchedulingGraphParser::FindAllAvailableBitstreamsAfterMinPos(
 auto ElasticSchedulingGraphParser::GetBitstreamEndFromLibrary(
     int chosen_bitstream_index, int chosen_column_position,
     QueryOperationType current_operation) -> std::pair<std::string, int> {
-  /*auto chosen_bitstream_name =
-      hw_library.at(current_operation)
-          .starting_locations.at(chosen_column_position)
-          .at(chosen_bitstream_index);*/
-  /*auto end_index = chosen_column_position +
-                   hw_library.at(current_operation)
-                       .bitstream_map.at(chosen_bitstream_name)
-                       .length -
-                   1;*/
-  return {hw_library_.at(current_operation)
-              .starting_locations.at(chosen_column_position)
-              .at(chosen_bitstream_index),
-          chosen_column_position +
-              hw_library_.at(current_operation)
-                  .bitstream_map
-                  .at(hw_library_.at(current_operation)
-                          .starting_locations.at(chosen_column_position)
-                          .at(chosen_bitstream_index))
-                  .length -
-              1};
+  const auto& module =
+      hw_library_index_.GetModule(hw_library_index_.GetModuleId(
+          current_operation, chosen_column_position, chosen_bitstream_index));
+  return {module.bitstream, module.end};
 }
 
 void ElasticSchedulingGraphParser::ReduceSelectionAccordingToHeuristics(
@@ -347,10 +330,11 @@ auto ElasticSchedulingGraphParser::GetChosenModulePlacements(
                            is_composed}});
     }
     if (!new_modules.empty()) {
-      statistics_counters_.first += new_modules.size();
+      auto& statistics_counters = GetSearchState().statistics_counters;
+      statistics_counters.first += new_modules.size();
       ReduceSelectionAccordingToHeuristics(new_modules, heuristics);
-      statistics_counters_.first -= new_modules.size();
-      statistics_counters_.second += 1;
+      statistics_counters.first -= new_modules.size();
+      statistics_counters.second += 1;
       module_placements.merge(new_modules);
       modules_found = true;
     }
@@ -359,23 +343,32 @@ auto ElasticSchedulingGraphParser::GetChosenModulePlacements(
 }
 
 void ElasticSchedulingGraphParser::GetScheduledModulesForNodeAfterPos(
-    const std::unordered_map<std::string, SchedulingQueryNode>& graph,
-    const std::vector<ScheduledModule>& current_run,
-    const std::string& node_name,
-    const std::map<std::string, TableMetadata>& data_tables,
+    const SchedulingSearchState& state, int node_id,
     std::unordered_set<std::pair<int, ScheduledModule>, PairHash>&
         module_placements) {
-  // Get current query
-  std::string current_query = node_name;
+  const auto& graph_index = state.GetGraphIndex();
+  const auto& current_run = state.GetCurrentRun();
+  const auto& node = state.GetNode(node_id);
+  const auto& node_name = graph_index.GetNodeName(node_id);
+  // Get current query. The key has to cover everything the placements depend
+  // on as workers fill their caches in a different order.
+  std::vector<std::size_t> current_query = {
+      static_cast<std::size_t>(node_id)};
+  current_query.reserve(2 * current_run.size() + 2);
   for (const auto& module : current_run) {
-    current_query += module.bitstream;
+    current_query.push_back(graph_index.GetNodeId(module.node_name));
+    current_query.push_back(hw_library_index_.GetBitstreamId(
+        module.operation_type, module.bitstream));
     if (use_single_runs_) {
       return;
     }
   }
+  current_query.push_back(GetBitstreamListHash(node.satisfying_bitstreams));
 
   // Find placements
-  if (saved_placements_.find(current_query) == saved_placements_.end()) {
+  auto& saved_placements = GetSearchState().saved_placements;
+  auto search = saved_placements.find(current_query);
+  if (search == saved_placements.end()) {
     // Not found
     bool is_composed = std::any_of(
         current_run.begin(), current_run.end(),
@@ -383,11 +376,11 @@ void ElasticSchedulingGraphParser::GetScheduledModulesForNodeAfterPos(
     std::unordered_set<std::pair<int, ScheduledModule>, PairHash>
         found_placements;
     GetScheduledModulesForNodeAfterPosOrig(
-        graph, GetMinPositionInCurrentRun(current_run, node_name, graph),
-        node_name, GetTakenColumns(current_run), data_tables, found_placements,
-        is_composed);
-    saved_placements_.insert(
-        {current_query, std::move(found_placements)});
+        node, GetMinPositionInCurrentRun(current_run, node), node_name,
+        GetTakenColumns(current_run), found_placements, is_composed);
+    search = saved_placements
+                 .emplace(std::move(current_query), std::move(found_placements))
+                 .first;
     //module_placements.merge(found_placements);
   }
     
@@ -404,32 +397,40 @@ void ElasticSchedulingGraphParser::GetScheduledModulesForNodeAfterPos(
     }*/
   //  module_placements.insert(search->second.begin(), search->second.end());
   //}
-  module_placements.insert(saved_placements_[current_query].begin(),
-                           saved_placements_[current_query].end());
+  module_placements.insert(search->second.begin(), search->second.end());
+}
+
+auto ElasticSchedulingGraphParser::GetBitstreamListHash(
+    const std::vector<std::vector<std::string>>& bitstream_start_locations)
+    -> std::size_t {
+  std::size_t seed = bitstream_start_locations.size();
+  for (const auto& bitstreams : bitstream_start_locations) {
+    seed = seed * 31 + bitstreams.size();
+    for (const auto& bitstream : bitstreams) {
+      seed = seed * 31 + std::hash<std::string>{}(bitstream);
+    }
+  }
+  return seed;
 }
 
 void ElasticSchedulingGraphParser::GetScheduledModulesForNodeAfterPosOrig(
-    const std::unordered_map<std::string, SchedulingQueryNode>& graph,
-    int min_position, const std::string& node_name,
+    const SchedulingQueryNode& node, int min_position,
+    const std::string& node_name,
     const std::vector<std::pair<int, int>>& taken_positions,
-    const std::map<std::string, TableMetadata>& /*data_tables*/,
     std::unordered_set<std::pair<int, ScheduledModule>, PairHash>&
         module_placements,
     bool is_composed) {
   auto modules_found = false;
-  if (!graph.at(node_name).satisfying_bitstreams.empty() &&
-      !heuristics_.first.empty()) {
+  if (!node.satisfying_bitstreams.empty() && !heuristics_.first.empty()) {
     modules_found = GetChosenModulePlacements(
-        node_name, graph.at(node_name).operation, heuristics_.first,
-        min_position, taken_positions,
-        graph.at(node_name).satisfying_bitstreams, module_placements,
+        node_name, node.operation, heuristics_.first, min_position,
+        taken_positions, node.satisfying_bitstreams, module_placements,
         is_composed);
   }
-  if (!modules_found && drivers_.IsIncompleteOperationSupported(graph.at(node_name).operation)) {
+  if (!modules_found && drivers_.IsIncompleteOperationSupported(node.operation)) {
     modules_found = GetChosenModulePlacements(
-        node_name, graph.at(node_name).operation, heuristics_.second,
-        min_position, taken_positions,
-        hw_library_.at(graph.at(node_name).operation).starting_locations,
+        node_name, node.operation, heuristics_.second, min_position,
+        taken_positions, hw_library_.at(node.operation).starting_locations,
         module_placements, is_composed);
   }
 }
@@ -472,16 +473,16 @@ auto ElasticSchedulingGraphParser::FindMissingUtility(
 }
 
 void ElasticSchedulingGraphParser::UpdateGraphCapacities(
-    const std::vector<int>& missing_utility,
-    std::unordered_map<std::string, SchedulingQueryNode>& new_graph,
-    const std::string& node_name, bool is_node_fully_processed) {
+    const std::vector<int>& missing_utility, SchedulingSearchState& state,
+    int node_id, bool is_node_fully_processed) {
   if (!is_node_fully_processed) {
     std::vector<int> new_capacity_values;
     new_capacity_values.reserve(missing_utility.size());
     for (int capacity_parameter_index : missing_utility) {
       new_capacity_values.push_back(std::max(0, capacity_parameter_index));
     }
-    new_graph.at(node_name).capacity = new_capacity_values;
+    state.SaveNode(node_id);
+    state.GetNode(node_id).capacity = new_capacity_values;
   }
 }
 
@@ -514,9 +515,7 @@ void ElasticSchedulingGraphParser::UpdateNextNodeTables(
 }
 
 auto ElasticSchedulingGraphParser::UpdateGraphCapacitiesAndTables(
-    std::unordered_map<std::string, SchedulingQueryNode>& new_graph,
-    std::map<std::string, TableMetadata>& new_data_tables,
-    const std::string& bitstream, const std::string& node_name,
+    SchedulingSearchState& state, const std::string& bitstream, int node_id,
     const std::vector<int>& capacity, QueryOperationType operation,
     bool is_composed) -> bool {
   bool is_node_fully_processed = false;
@@ -524,21 +523,26 @@ auto ElasticSchedulingGraphParser::UpdateGraphCapacitiesAndTables(
     // Just linear sort. It always gets fully processed and no need to look at
     // capacity. Make it more generic in the future!
     // TODO(Kaspar): Assuming single next node.
+    const auto& node = state.GetNode(node_id);
+    const auto& sorted_table_names =
+        node.node_ptr->given_output_data_definition_files;
+    auto data_tables = state.GetDataTables();
     is_node_fully_processed = drivers_.UpdateDataTable(
         operation,
         hw_library_.at(operation).bitstream_map.at(bitstream).capacity,
-        new_graph.at(node_name).node_ptr->given_output_data_definition_files,
-        new_data_tables);
-    const auto& next_node_name = new_graph.at(node_name).after_nodes.front();
+        sorted_table_names, data_tables);
+    state.SetDataTables(data_tables);
+    const auto& next_node_name = node.after_nodes.front();
     if (!next_node_name.empty()) {
-      if (new_graph.at(next_node_name).operation ==
-          QueryOperationType::kMergeSort) {
+      int next_node_id = state.GetGraphIndex().GetNodeId(next_node_name);
+      auto next_operation = state.GetNode(next_node_id).operation;
+      if (next_operation == QueryOperationType::kMergeSort) {
         auto required_merge_capacity = drivers_.GetWorstCaseNodeCapacity(
             operation,
             hw_library_.at(operation).bitstream_map.at(bitstream).capacity,
-            new_graph.at(node_name).data_tables, new_data_tables,
-            new_graph.at(next_node_name).operation);
-        new_graph[next_node_name].capacity = required_merge_capacity;
+            node.data_tables, data_tables, next_operation);
+        state.SaveNode(next_node_id);
+        state.GetNode(next_node_id).capacity = required_merge_capacity;
       } else {
         // Assume the sort has been skipped and there isn't a sort later in the
         // graph.
@@ -557,7 +561,7 @@ auto ElasticSchedulingGraphParser::UpdateGraphCapacitiesAndTables(
     is_node_fully_processed = drivers_.SetMissingFunctionalCapacity(
         hw_library_.at(operation).bitstream_map.at(bitstream).capacity,
         missing_utility, capacity, is_composed, operation);
-    UpdateGraphCapacities(missing_utility, new_graph, node_name,
+    UpdateGraphCapacities(missing_utility, state, node_id,
                           is_node_fully_processed);
   }
   
@@ -574,15 +578,22 @@ auto ElasticSchedulingGraphParser::UpdateGraphCapacitiesAndTables(
   return is_node_fully_processed;
 }
 
-auto ElasticSchedulingGraphParser::CreateNewAvailableNodes(
-    const std::unordered_map<std::string, SchedulingQueryNode>& graph,
-    std::unordered_set<std::string>& available_nodes,
-    std::unordered_set<std::string>& processed_nodes,
-    const std::string& node_name) {
-  available_nodes.erase(node_name);
-  processed_nodes.insert(node_name);
-  QuerySchedulingHelper::UpdateAvailableNodesAfterSchedulingGivenNode(
-      node_name, processed_nodes, graph, available_nodes);
+void ElasticSchedulingGraphParser::CreateNewAvailableNodes(
+    SchedulingSearchState& state, int node_id) {
+  const auto& graph_index = state.GetGraphIndex();
+  state.EraseNode(NodeSet::kAvailable, node_id);
+  state.InsertNode(NodeSet::kProcessed, node_id);
+  const auto& processed_nodes = state.GetNodes(NodeSet::kProcessed);
+  for (const auto& next_node_id : graph_index.GetAfterNodeIds(node_id)) {
+    const auto& before_node_ids = graph_index.GetBeforeNodeIds(next_node_id);
+    if (std::all_of(before_node_ids.begin(), before_node_ids.end(),
+                    [&](const auto& before_node_id) {
+                      return SchedulingGraphIndex::IsInSet(processed_nodes,
+                                                           before_node_id);
+                    })) {
+      state.InsertNode(NodeSet::kAvailable, next_node_id);
+    }
+  }
 }
 
 auto ElasticSchedulingGraphParser::IsTableEqualForGivenNode(
@@ -613,64 +624,76 @@ auto ElasticSchedulingGraphParser::IsTableEqualForGivenNode(
 
 void ElasticSchedulingGraphParser::
     UpdateAvailableNodesAndSatisfyingBitstreamsList(
-        const std::string& node_name,
-        std::unordered_map<std::string, SchedulingQueryNode>& new_graph,
-        std::unordered_set<std::string>& new_available_nodes,
-        std::map<std::string, TableMetadata>& new_tables,
-        std::unordered_set<std::string>& new_processed_nodes,
-        QueryOperationType operation, bool satisfied_requirements,
-        std::unordered_set<std::string>& new_next_run_blocked_nodes,
-        const std::unordered_set<std::string>& blocked_nodes) {
+        int node_id, SchedulingSearchState& state,
+        QueryOperationType operation, bool satisfied_requirements) {
+  const auto& node_name = state.GetGraphIndex().GetNodeName(node_id);
   // If sorting module and not finished - Redo itself; If sorting module and
   // finished - Redo next node.
   if (drivers_.IsOperationSorting(operation)) {
     if (satisfied_requirements) {
-      new_processed_nodes.insert(node_name);
-      new_available_nodes.erase(node_name);
+      state.EraseNode(NodeSet::kAvailable, node_id);
+      // The pre-scheduler can change any node or table after the sort. The
+      // changed values are put back into the state afterwards.
+      auto graph = state.GetGraph();
+      auto processed_nodes = state.GetNodeNames(NodeSet::kProcessed);
+      processed_nodes.insert(node_name);
       auto immediate_new_available_nodes =
           QuerySchedulingHelper::GetNewAvailableNodesAfterSchedulingGivenNode(
-              node_name, new_processed_nodes, new_graph);
+              node_name, processed_nodes, graph);
+      auto data_tables = state.GetDataTables();
       pre_scheduler_.AddSatisfyingBitstreamLocationsToGraph(
-          new_graph, new_tables, immediate_new_available_nodes,
-          new_processed_nodes);
-      new_available_nodes.merge(immediate_new_available_nodes);
-      new_graph.erase(node_name);
+          graph, data_tables, immediate_new_available_nodes, processed_nodes);
+      graph.erase(node_name);
+      state.SetGraph(graph);
+      state.SetDataTables(data_tables);
+      for (const auto& processed_node_name : processed_nodes) {
+        state.InsertNodeName(NodeSet::kProcessed, processed_node_name);
+      }
+      for (const auto& new_node_name : immediate_new_available_nodes) {
+        state.InsertNodeName(NodeSet::kAvailable, new_node_name);
+      }
     } else {
-      pre_scheduler_.UpdateOnlySatisfyingBitstreams(node_name, new_graph,
-                                                    new_tables);
+      // Only the sorted node gets updated.
+      std::unordered_map<std::string, SchedulingQueryNode> graph = {
+          {node_name, state.GetNode(node_id)}};
+      pre_scheduler_.UpdateOnlySatisfyingBitstreams(
+          node_name, graph, GetNodeDataTables(state, node_id));
+      state.SaveNode(node_id);
+      state.GetNode(node_id) = std::move(graph.at(node_name));
     }
   } else if (satisfied_requirements) {
-    CreateNewAvailableNodes(new_graph, new_available_nodes, new_processed_nodes,
-                            node_name);
+    CreateNewAvailableNodes(state, node_id);
     // TODO(Kaspar): Create a list of nodes that have been checked for this
     // already - perhaps
-    GetNewBlockedNodes(new_next_run_blocked_nodes, new_graph, operation,
-                       node_name, blocked_nodes);
-    new_graph.erase(node_name);
+    auto new_next_run_blocked_nodes =
+        state.GetNodes(NodeSet::kNextRunBlocked);
+    GetNewBlockedNodes(new_next_run_blocked_nodes, state, operation, node_id);
+    for (const auto& blocked_node_id :
+         SchedulingGraphIndex::GetNodeIds(new_next_run_blocked_nodes)) {
+      state.InsertNode(NodeSet::kNextRunBlocked, blocked_node_id);
+    }
+    state.RemoveNodeFromGraph(node_id);
   }
 }
 
 void ElasticSchedulingGraphParser::FindDataSensitiveNodeNames(
-    const std::string& node_name,
-    const std::unordered_map<std::string, SchedulingQueryNode>& graph,
-    std::unordered_set<std::string>& new_next_run_blocked_nodes,
-    const std::unordered_set<std::string>& blocked_nodes) {
-  for (const auto& next_node_name : graph.at(node_name).after_nodes) {
-    if (!next_node_name.empty()) {
-      if (drivers_.IsOperationDataSensitive(
-              graph.at(next_node_name).operation)) {
-        if (blocked_nodes.find(next_node_name) == blocked_nodes.end() &&
-            new_next_run_blocked_nodes.find(next_node_name) ==
-                new_next_run_blocked_nodes.end()) {
-          new_next_run_blocked_nodes.insert(next_node_name);
-          FindDataSensitiveNodeNames(next_node_name, graph,
-                                     new_next_run_blocked_nodes, blocked_nodes);
-        }
-        // Else do nothing.
-      } else {
-        FindDataSensitiveNodeNames(next_node_name, graph,
-                                   new_next_run_blocked_nodes, blocked_nodes);
+    int node_id, const SchedulingSearchState& state,
+    SchedulingGraphIndex::NodeIdSet& new_next_run_blocked_nodes) {
+  for (const auto& next_node_id :
+       state.GetGraphIndex().GetAfterNodeIds(node_id)) {
+    if (drivers_.IsOperationDataSensitive(
+            state.GetNode(next_node_id).operation)) {
+      if (!SchedulingGraphIndex::IsInSet(state.GetNodes(NodeSet::kBlocked),
+                                         next_node_id) &&
+          SchedulingGraphIndex::AddToSet(new_next_run_blocked_nodes,
+                                         next_node_id)) {
+        FindDataSensitiveNodeNames(next_node_id, state,
+                                   new_next_run_blocked_nodes);
       }
+      // Else do nothing.
+    } else {
+      FindDataSensitiveNodeNames(next_node_id, state,
+                                 new_next_run_blocked_nodes);
     }
   }
 }
@@ -679,100 +702,92 @@ void ElasticSchedulingGraphParser::FindDataSensitiveNodeNames(
 // TODO(Kaspar): Always when a filter or join gets placed it goes through the
 // whole thing.
 void ElasticSchedulingGraphParser::GetNewBlockedNodes(
-    std::unordered_set<std::string>& next_run_blocked_nodes,
-    const std::unordered_map<std::string, SchedulingQueryNode>& graph,
-    QueryOperationType operation, const std::string& node_name,
-    const std::unordered_set<std::string>& blocked_nodes) {
+    SchedulingGraphIndex::NodeIdSet& next_run_blocked_nodes,
+    const SchedulingSearchState& state, QueryOperationType operation,
+    int node_id) {
   if (drivers_.IsOperationReducingData(operation)) {
-    FindDataSensitiveNodeNames(node_name, graph, next_run_blocked_nodes,
-                               blocked_nodes);
+    FindDataSensitiveNodeNames(node_id, state, next_run_blocked_nodes);
   }
 }
 
 auto ElasticSchedulingGraphParser::GetNewStreamedDataSize(
-    const std::vector<ScheduledModule>& current_run,
-    const std::string& node_name,
-    const std::map<std::string, TableMetadata>& data_tables,
-    const std::unordered_map<std::string, SchedulingQueryNode>& graph) -> int {
-  std::vector<std::string> before_node_names;
-  for (const auto& before_stream : graph.at(node_name).before_nodes) {
-    before_node_names.push_back(before_stream.first);
-  }
-  auto required_tables = graph.at(node_name).data_tables;
-  for (const auto& placement : current_run) {
-    auto before_node_search =
-        std::find(before_node_names.begin(), before_node_names.end(),
-                  placement.node_name);
-    if (before_node_search != before_node_names.end()) {
-      required_tables[before_node_search - before_node_names.begin()] = "";
+    const SchedulingSearchState& state, const std::string& node_name) -> int {
+  const auto& node =
+      state.GetNode(state.GetGraphIndex().GetNodeId(node_name));
+  std::vector<bool> is_table_from_current_run(node.data_tables.size(), false);
+  for (const auto& placement : state.GetCurrentRun()) {
+    auto before_node_search = std::find_if(
+        node.before_nodes.begin(), node.before_nodes.end(),
+        [&](const auto& before_stream) {
+          return before_stream.first == placement.node_name;
+        });
+    if (before_node_search != node.before_nodes.end()) {
+      is_table_from_current_run.at(before_node_search -
+                                   node.before_nodes.begin()) = true;
     }
   }
-  auto operation_type = graph.at(node_name).operation;
   int streamed_data_size = 0;
-  for (const auto& table_name : required_tables) {
-    if (!table_name.empty()) {
-      if (operation_type == QueryOperationType::kMergeSort){
-        streamed_data_size += graph.at(node_name).capacity.front() * data_tables.at(table_name).sorted_status.at(2) * data_tables.at(table_name).record_size * 4;
-      }
-      // Record size is in 4 byte words
-      streamed_data_size += data_tables.at(table_name).record_count *
-                            data_tables.at(table_name).record_size * 4;
+  for (int table_index = 0; table_index < node.data_tables.size();
+       table_index++) {
+    const auto& table_name = node.data_tables.at(table_index);
+    if (table_name.empty() || is_table_from_current_run.at(table_index)) {
+      continue;
+    }
+    const auto& table =
+        state.GetTable(state.GetGraphIndex().GetTableId(table_name));
+    if (!table) {
+      throw std::runtime_error(table_name + " isn't in the scheduled tables!");
     }
+    if (node.operation == QueryOperationType::kMergeSort) {
+      streamed_data_size += node.capacity.front() * table->sorted_status.at(2) *
+                            table->record_size * 4;
+    }
+    // Record size is in 4 byte words
+    streamed_data_size += table->record_count * table->record_size * 4;
   }
   return streamed_data_size;
 }
 
-auto ElasticSchedulingGraphParser::IsSubsetOf(
-    const std::unordered_set<std::string>& a,
-    const std::unordered_set<std::string>& b) -> bool {
-  // return true if all members of a are also in b
-  if (a.size() > b.size()) {
-    return false;
+auto ElasticSchedulingGraphParser::GetNodeDataTables(
+    const SchedulingSearchState& state, int node_id)
+    -> std::map<std::string, TableMetadata> {
+  std::map<std::string, TableMetadata> data_tables;
+  for (const auto& table_name : state.GetNode(node_id).data_tables) {
+    if (table_name.empty()) {
+      continue;
+    }
+    const auto& table =
+        state.GetTable(state.GetGraphIndex().GetTableId(table_name));
+    if (table) {
+      data_tables.insert({table_name, *table});
+    }
   }
-
-  return std::all_of(a.begin(), a.end(), [&](const auto& a_string) {
-    return b.find(a_string) != b.end();
-  });
+  return data_tables;
 }
 
 void ElasticSchedulingGraphParser::UpdateGraphAndTableValuesGivenPlacement(
-    std::unordered_map<std::string, SchedulingQueryNode>& new_graph,
-    std::unordered_set<std::string>& new_available_nodes,
-    const ScheduledModule& module_placement,
-    std::unordered_set<std::string>& new_processed_nodes,
-    std::map<std::string, TableMetadata>& new_data_tables,
-    std::unordered_set<std::string>& new_next_run_blocked_nodes,
-    const std::unordered_set<std::string>& blocked_nodes) {
+    SchedulingSearchState& state, const ScheduledModule& module_placement) {
+  int node_id = state.GetGraphIndex().GetNodeId(module_placement.node_name);
+  auto operation = state.GetNode(node_id).operation;
   auto satisfied_requirements = UpdateGraphCapacitiesAndTables(
-      new_graph, new_data_tables, module_placement.bitstream,
-      module_placement.node_name,
-      new_graph.at(module_placement.node_name).capacity,
-      new_graph.at(module_placement.node_name).operation,
-      module_placement.is_composed);
+      state, module_placement.bitstream, node_id,
+      state.GetNode(node_id).capacity, operation, module_placement.is_composed);
 
-  UpdateAvailableNodesAndSatisfyingBitstreamsList(
-      module_placement.node_name, new_graph, new_available_nodes,
-      new_data_tables, new_processed_nodes,
-      new_graph.at(module_placement.node_name).operation,
-      satisfied_requirements, new_next_run_blocked_nodes, blocked_nodes);
+  UpdateAvailableNodesAndSatisfyingBitstreamsList(node_id, state, operation,
+                                                  satisfied_requirements);
 }
 
 void ElasticSchedulingGraphParser::GetAllAvailableModulePlacementsInCurrentRun(
     std::unordered_set<std::pair<int, ScheduledModule>, PairHash>&
         available_module_placements,
-    const std::unordered_set<std::string>& available_nodes,
-    const std::vector<ScheduledModule>& current_run,
-    const std::unordered_map<std::string, SchedulingQueryNode>& graph,
-    const std::unordered_set<std::string>& blocked_nodes,
-    const std::map<std::string, TableMetadata>& data_tables) {
-
-  auto available_nodes_in_this_run = RemoveUnavailableNodesInThisRun(
-      available_nodes, current_run, graph, blocked_nodes, data_tables);
+    const SchedulingSearchState& state) {
+  const auto& current_run = state.GetCurrentRun();
+  const auto& graph_index = state.GetGraphIndex();
+  auto available_nodes_in_this_run = RemoveUnavailableNodesInThisRun(state);
 
 
-  for (const auto& node_name : available_nodes_in_this_run) {
-    GetScheduledModulesForNodeAfterPos(graph, current_run, node_name,
-                                       data_tables,
+  for (const auto& node_id : available_nodes_in_this_run) {
+    GetScheduledModulesForNodeAfterPos(state, node_id,
                                        available_module_placements);
   }
 
@@ -780,7 +795,8 @@ void ElasticSchedulingGraphParser::GetAllAvailableModulePlacementsInCurrentRun(
     std::unordered_set<std::pair<int, ScheduledModule>, PairHash> result;
     for (const auto& [location, available_module] :
          available_module_placements) {
-      const auto& node = graph.at(available_module.node_name);
+      const auto& node =
+          state.GetNode(graph_index.GetNodeId(available_module.node_name));
       for (const auto& [previous_node_name, _] : node.before_nodes) {
         for (const auto& placed_module : current_run) {
           if (placed_module.node_name == previous_node_name) {
@@ -798,21 +814,92 @@ void ElasticSchedulingGraphParser::GetAllAvailableModulePlacementsInCurrentRun(
 
 void ElasticSchedulingGraphParser::AddPlanToAllPlansAndMeasureTime(
     const std::vector<std::vector<ScheduledModule>>& current_plan,
-    const std::unordered_set<std::string>& processed_nodes,
+    std::unordered_set<std::string> processed_nodes,
     const std::map<std::string, TableMetadata>& data_tables,
-    int streamed_data_size) {
+    int streamed_data_size, const std::vector<int>& branch_path) {
   ExecutionPlanSchedulingData current_scheduling_data = {
-      processed_nodes, data_tables, streamed_data_size};
-  if (const auto& [it, inserted] =
-          resulting_plan_.try_emplace(current_plan, current_scheduling_data);
-      inserted) {
-    if (current_plan.size() < min_runs_) {
-      min_runs_ = current_plan.size();
+      std::move(processed_nodes), data_tables, streamed_data_size};
+  auto& search_state = GetSearchState();
+  // Plans are only needed while a searched state can still be stored.
+  if (std::any_of(search_state.transposition_frames.begin(),
+                  search_state.transposition_frames.end(),
+                  [](const auto& frame) { return frame.is_complete; })) {
+    search_state.found_plans.push_back(
+        std::make_shared<const TranspositionTable::FoundPlan>(
+            TranspositionTable::FoundPlan{current_plan, current_scheduling_data,
+                                          branch_path}));
+  }
+  for (auto& frame : search_state.transposition_frames) {
+    if (frame.is_complete &&
+        search_state.found_plans.size() - frame.first_found_plan >
+            search_state.transposition_table.GetRemainingCapacity()) {
+      frame.is_complete = false;
     }
   }
+  double plan_cost = 0;
+  int pinned_eviction_count = 0;
+  if (cost_estimator_) {
+    plan_cost = cost_estimator_->GetPlanCost(
+        current_plan, streamed_data_size, search_state.configured_runs);
+    pinned_eviction_count = cost_estimator_->GetPinnedEvictionCount(
+        current_plan, search_state.configured_runs);
+  }
   if (std::chrono::system_clock::now() > time_limit_) {
     trigger_timeout_ = true;
   }
+  // Plans with modules in the same positions are stored once.
+  if (const auto& [it, inserted] = search_state.resulting_plan.try_emplace(
+          current_plan, current_scheduling_data);
+      !inserted) {
+    if (!IsPlanPreferred(plan_cost, branch_path,
+                         search_state.plan_costs.at(current_plan),
+                         thread_pool_
+                             ? search_state.branch_paths.at(current_plan)
+                             : branch_path)) {
+      return;
+    }
+    search_state.resulting_plan.erase(it);
+    search_state.resulting_plan.emplace(current_plan,
+                                        std::move(current_scheduling_data));
+  }
+  search_state.plan_costs.insert_or_assign(current_plan, plan_cost);
+  if (thread_pool_) {
+    search_state.branch_paths.insert_or_assign(current_plan, branch_path);
+  }
+  int current_min_runs = min_runs_;
+  while (current_plan.size() < current_min_runs &&
+         !min_runs_.compare_exchange_weak(
+             current_min_runs, static_cast<int>(current_plan.size()))) {
+  }
+  // Only the costs of stored plans bound the search. Otherwise branches could
+  // get pruned for a plan which isn't kept. Plans which evict pinned modules
+  // don't bound it either as any plan which doesn't is preferred.
+  if (cost_estimator_ && pinned_eviction_count == 0) {
+    double best_plan_cost = best_plan_cost_;
+    while (plan_cost < best_plan_cost &&
+           !best_plan_cost_.compare_exchange_weak(best_plan_cost, plan_cost)) {
+    }
+    if (plan_cost < best_plan_cost) {
+      UpdateBestPlan(current_plan, search_state.resulting_plan.at(current_plan),
+                     pinned_eviction_count, plan_cost);
+    }
+  } else if (cost_estimator_ &&
+             best_plan_cost_ == std::numeric_limits<double>::max()) {
+    UpdateBestPlan(current_plan, search_state.resulting_plan.at(current_plan),
+                   pinned_eviction_count, plan_cost);
+  }
+}
+
+auto ElasticSchedulingGraphParser::IsPlanPreferred(
+    double plan_cost, const std::vector<int>& branch_path,
+    double stored_plan_cost, const std::vector<int>& stored_branch_path)
+    -> bool {
+  // The cheaper plan is kept. Equally cheap plans are kept as the sequential
+  // search would have found them first.
+  if (plan_cost != stored_plan_cost) {
+    return plan_cost < stored_plan_cost;
+  }
+  return branch_path < stored_branch_path;
 }
 
 void ElasticSchedulingGraphParser::PlaceNodesRecursively(
@@ -825,120 +912,741 @@ void ElasticSchedulingGraphParser::PlaceNodesRecursively(
     std::unordered_set<std::string> blocked_nodes,
     std::unordered_set<std::string> next_run_blocked_nodes,
     int streamed_data_size) {
-  // TODO(Kaspar): Potentially check for timeouts more often
+  SchedulingSearchState state(
+      std::move(available_nodes), std::move(processed_nodes), std::move(graph),
+      std::move(current_run), std::move(current_plan), std::move(data_tables),
+      std::move(blocked_nodes), std::move(next_run_blocked_nodes),
+      streamed_data_size);
+  if (!thread_pool_) {
+    PlaceNodesInBranch(state, {});
+    return;
+  }
+  thread_pool_->Submit([&]() { PlaceNodesInBranch(state, {}); });
+  // Rethrows the timeout from whichever worker hit it first.
+  thread_pool_->WaitForAll();
+}
+
+void ElasticSchedulingGraphParser::SpawnOrPlaceNodesInBranch(
+    SchedulingSearchState& state, std::vector<int> branch_path) {
+  // Only hand the branch over if someone is waiting for work. Otherwise the
+  // copy and queueing cost more than searching the branch directly. Either
+  // way the caller rolls the given state back afterwards.
+  if (!thread_pool_ || !thread_pool_->HasIdleWorkers()) {
+    PlaceNodesInBranch(state, std::move(branch_path));
+    return;
+  }
+  // The searched states don't see the plans found by other workers.
+  for (auto& frame : GetSearchState().transposition_frames) {
+    frame.is_complete = false;
+  }
+  thread_pool_->Submit([this, branch_state = SchedulingSearchState(state),
+                        branch_path = std::move(branch_path)]() mutable {
+    PlaceNodesInBranch(branch_state, std::move(branch_path));
+  });
+}
+
+void ElasticSchedulingGraphParser::PlaceNodesInBranch(
+    SchedulingSearchState& state, std::vector<int> branch_path) {
+  if (!use_transposition_table_) {
+    SearchNodePlacements(state, std::move(branch_path));
+    return;
+  }
+  auto& search_state = GetSearchState();
+  auto state_hash = GetTranspositionKey(state);
+  if (const auto* entry = search_state.transposition_table.Find(state_hash)) {
+    for (const auto& found_plan : entry->found_plans) {
+      AddContinuation(state, *entry, *found_plan, branch_path);
+    }
+    return;
+  }
+  search_state.transposition_frames.push_back(
+      {state_hash,
+       {static_cast<int>(state.GetCurrentPlan().size()),
+        state.GetStreamedDataSize(), static_cast<int>(branch_path.size()),
+        {}},
+       static_cast<int>(search_state.found_plans.size()),
+       true});
+  SearchNodePlacements(state, std::move(branch_path));
+  auto frame = std::move(search_state.transposition_frames.back());
+  search_state.transposition_frames.pop_back();
+  if (frame.is_complete) {
+    frame.entry.found_plans.assign(
+        search_state.found_plans.begin() + frame.first_found_plan,
+        search_state.found_plans.end());
+    search_state.transposition_table.Insert(frame.state_hash,
+                                            std::move(frame.entry));
+  }
+  if (search_state.transposition_frames.empty()) {
+    search_state.found_plans.clear();
+  }
+}
+
+void ElasticSchedulingGraphParser::UpdateBestPlan(
+    const std::vector<std::vector<ScheduledModule>>& current_plan,
+    const ExecutionPlanSchedulingData& scheduling_data,
+    int pinned_eviction_count, double plan_cost) {
+  std::lock_guard<std::mutex> lock(best_plan_mutex_);
+  // Another worker could have stored a better plan in the meantime.
+  if (!convergence_log_.empty() &&
+      std::make_pair(best_plan_pinned_eviction_count_,
+                     convergence_log_.back().cost) <=
+          std::make_pair(pinned_eviction_count, plan_cost)) {
+    return;
+  }
+  best_plan_pinned_eviction_count_ = pinned_eviction_count;
+  best_plan_ = current_plan;
+  best_plan_data_ = scheduling_data;
+  convergence_log_.push_back(
+      {std::chrono::duration_cast<std::chrono::microseconds>(
+           std::chrono::steady_clock::now() - search_start_)
+           .count(),
+       plan_cost});
+}
+
+auto ElasticSchedulingGraphParser::IsBranchPruned(
+    const SchedulingSearchState& state) -> bool {
+  if (!cost_estimator_ || !prune_branches_) {
+    return false;
+  }
+  auto& search_state = GetSearchState();
+  // Plans with the same cost as the best plan are still found.
+  if (cost_estimator_->GetLowerBound(state, search_state.configured_runs) <=
+      best_plan_cost_) {
+    return false;
+  }
+  search_state.pruned_branch_count++;
+  // The stored plans depend on the best cost and not only the state.
+  for (auto& frame : search_state.transposition_frames) {
+    frame.is_complete = false;
+  }
+  return true;
+}
+
+auto ElasticSchedulingGraphParser::GetTranspositionKey(
+    SchedulingSearchState& state) const -> std::size_t {
+  auto state_hash = state.GetHash();
+  // What the runs cap cuts depends on how many runs have been finished
+  // already and on the cap when the search of the state starts. With both
+  // the same the search finds the same plans in the same order again.
+  if (use_max_runs_cap_) {
+    hash_combine(state_hash, state.GetCurrentPlan().size());
+    hash_combine(state_hash, min_runs_.load());
+  }
+  return state_hash;
+}
+
+void ElasticSchedulingGraphParser::AddContinuation(
+    const SchedulingSearchState& state,
+    const TranspositionTable::Entry& entry,
+    const TranspositionTable::FoundPlan& found_plan,
+    const std::vector<int>& branch_path) {
+  auto current_plan = state.GetCurrentPlan();
+  current_plan.insert(current_plan.end(),
+                      found_plan.plan.begin() + entry.finished_run_count,
+                      found_plan.plan.end());
+  auto continuation_branch_path = branch_path;
+  continuation_branch_path.insert(
+      continuation_branch_path.end(),
+      found_plan.branch_path.begin() + entry.branch_path_length,
+      found_plan.branch_path.end());
+  AddPlanToAllPlansAndMeasureTime(
+      current_plan, found_plan.scheduling_data.processed_nodes,
+      found_plan.scheduling_data.data_tables,
+      state.GetStreamedDataSize() +
+          found_plan.scheduling_data.streamed_data_size -
+          entry.streamed_data_size,
+      continuation_branch_path);
+}
+
+void ElasticSchedulingGraphParser::SearchNodePlacements(
+    SchedulingSearchState& state, std::vector<int> branch_path) {
+  // Once there is a plan to return the time limit is checked on every branch.
+  // Anytime scheduling can stop before that and schedule the nodes greedily.
+  if ((stop_before_first_plan_ || HasFoundPlan()) &&
+      std::chrono::system_clock::now() > time_limit_) {
+    trigger_timeout_ = true;
+  }
   if (trigger_timeout_) {
     throw TimeLimitException("Timeout");
   }
+  GetSearchState().explored_branch_count++;
+  const auto& available_nodes = state.GetNodes(NodeSet::kAvailable);
+  const auto& blocked_nodes = state.GetNodes(NodeSet::kBlocked);
   std::unordered_set<std::pair<int, ScheduledModule>, PairHash>
       available_module_placements;
-  while (!available_nodes.empty() &&
-         !IsSubsetOf(available_nodes, blocked_nodes)) {
-    GetAllAvailableModulePlacementsInCurrentRun(
-        available_module_placements, available_nodes, current_run, graph,
-        blocked_nodes, data_tables);
+  while (!SchedulingGraphIndex::IsSubsetOf(available_nodes, blocked_nodes)) {
+    if (IsBranchPruned(state)) {
+      return;
+    }
+    GetAllAvailableModulePlacementsInCurrentRun(available_module_placements,
+                                                state);
     // Start planning a new run if we can't find any new valid placements
     if (available_module_placements.empty()) {
-      if (current_run.empty()) {
+      if (state.GetCurrentRun().empty()) {
         // Empty runs could be useful for crossbar usage in the future!
         throw std::runtime_error("Can't use an empty run at the moment!");
       }
-      current_plan.push_back(std::move(current_run));
-      if (use_max_runs_cap_ && current_plan.size() > min_runs_) {
+      state.FinishRun();
+      if (use_max_runs_cap_ && state.GetCurrentPlan().size() > min_runs_) {
         return;
       }
-      current_run.clear();
-      blocked_nodes.merge(next_run_blocked_nodes);
-      next_run_blocked_nodes.clear();
     } else {
       // Get the placement we are going to place in this branch
       auto current_placement =
           std::move(available_module_placements
                         .extract(available_module_placements.begin())
                         .value());
+      // Branches are numbered in the order the sequential search visits them.
+      int branch_index = 0;
       // If there are still other placements to consider do them in different
       // recursion branches.
       if (!available_module_placements.empty()) {
         for (const auto& [module_index, module_placement] :
              available_module_placements) {
-          // Make new variables
-          auto new_current_run = current_run;
-          new_current_run.insert(new_current_run.begin() + module_index,
-                                 module_placement);
-          auto new_streamed_data_size = streamed_data_size;
-          new_streamed_data_size += GetNewStreamedDataSize(
-              current_run, module_placement.node_name, data_tables, graph);
-          std::unordered_set<std::string> new_available_nodes = available_nodes;
-          std::unordered_set<std::string> new_processed_nodes = processed_nodes;
-          std::map<std::string, TableMetadata> new_data_tables = data_tables;
-          std::unordered_map<std::string, SchedulingQueryNode> new_graph =
-              graph;
-          std::unordered_set<std::string> new_next_run_blocked_nodes =
-              next_run_blocked_nodes;
-
-          // Update new variables
-          UpdateGraphAndTableValuesGivenPlacement(
-              new_graph, new_available_nodes, module_placement,
-              new_processed_nodes, new_data_tables, new_next_run_blocked_nodes,
-              blocked_nodes);
+          auto checkpoint = state.GetCheckpoint();
+          state.AddStreamedDataSize(
+              GetNewStreamedDataSize(state, module_placement.node_name));
+          state.InsertModule(module_index, module_placement);
+          UpdateGraphAndTableValuesGivenPlacement(state, module_placement);
 
           // Go to a new decision branch
-          PlaceNodesRecursively(
-              std::move(new_available_nodes), std::move(new_processed_nodes),
-              std::move(new_graph), std::move(new_current_run), current_plan,
-              std::move(new_data_tables), blocked_nodes,
-              std::move(new_next_run_blocked_nodes), new_streamed_data_size);
+          SpawnOrPlaceNodesInBranch(state,
+                                    GetBranchPath(branch_path, branch_index++));
+          state.Rollback(checkpoint);
         }
         available_module_placements.clear();
       }
       // Check early run finishing option
-      if (!reduce_single_runs_ && !current_run.empty() &&
-          !(use_max_runs_cap_ && current_plan.size() + 1 > min_runs_)) {
-        auto new_current_plan = current_plan;
-        new_current_plan.push_back(current_run);
-        auto new_blocked_nodes = blocked_nodes;
-        for (const auto& blocked_node : next_run_blocked_nodes) {
-          new_blocked_nodes.insert(blocked_node);
-        }
-        PlaceNodesRecursively(available_nodes, processed_nodes, graph, {},
-                              new_current_plan, data_tables, new_blocked_nodes,
-                              {}, streamed_data_size);
+      if (!reduce_single_runs_ && !state.GetCurrentRun().empty() &&
+          !(use_max_runs_cap_ &&
+            state.GetCurrentPlan().size() + 1 > min_runs_)) {
+        auto checkpoint = state.GetCheckpoint();
+        state.FinishRun();
+        SpawnOrPlaceNodesInBranch(state,
+                                  GetBranchPath(branch_path, branch_index));
+        state.Rollback(checkpoint);
       }
+      branch_path = GetBranchPath(branch_path, branch_index + 1);
       // Update the values for this decision branch.
-      current_run.insert(current_run.begin() + current_placement.first,
-                         current_placement.second);
-      streamed_data_size += GetNewStreamedDataSize(
-          current_run, current_placement.second.node_name, data_tables, graph);
-      UpdateGraphAndTableValuesGivenPlacement(
-          graph, available_nodes, current_placement.second, processed_nodes,
-          data_tables, next_run_blocked_nodes, blocked_nodes);
+      state.InsertModule(current_placement.first, current_placement.second);
+      state.AddStreamedDataSize(
+          GetNewStreamedDataSize(state, current_placement.second.node_name));
+      UpdateGraphAndTableValuesGivenPlacement(state, current_placement.second);
     }
   }
-  if (!current_run.empty()) {
-    current_plan.push_back(std::move(current_run));
+  AddStatePlan(state, branch_path);
+}
+
+void ElasticSchedulingGraphParser::AddStatePlan(
+    const SchedulingSearchState& state, const std::vector<int>& branch_path) {
+  auto current_plan = state.GetCurrentPlan();
+  if (!state.GetCurrentRun().empty()) {
+    current_plan.push_back(state.GetCurrentRun());
   }
-  AddPlanToAllPlansAndMeasureTime(current_plan, processed_nodes, data_tables,
-                                  streamed_data_size);
+  AddPlanToAllPlansAndMeasureTime(
+      current_plan, state.GetNodeNames(NodeSet::kProcessed),
+      state.GetDataTables(),
+      state.GetStreamedDataSize(), branch_path);
+}
+
+void ElasticSchedulingGraphParser::PlaceNodesWithBeamSearch(
+    int beam_width, std::unordered_set<std::string> available_nodes,
+    std::unordered_set<std::string> processed_nodes,
+    std::unordered_map<std::string, SchedulingQueryNode> graph,
+    std::vector<ScheduledModule> current_run,
+    std::vector<std::vector<ScheduledModule>> current_plan,
+    std::map<std::string, TableMetadata> data_tables,
+    std::unordered_set<std::string> blocked_nodes,
+    std::unordered_set<std::string> next_run_blocked_nodes,
+    int streamed_data_size) {
+  if (!cost_estimator_) {
+    throw std::runtime_error("Beam search requires plan costs!");
+  }
+  if (beam_width < 1) {
+    throw std::runtime_error("Beam width has to be positive!");
+  }
+  std::vector<std::unique_ptr<SchedulingSearchState>> beam;
+  beam.push_back(std::make_unique<SchedulingSearchState>(
+      std::move(available_nodes), std::move(processed_nodes), std::move(graph),
+      std::move(current_run), std::move(current_plan), std::move(data_tables),
+      std::move(blocked_nodes), std::move(next_run_blocked_nodes),
+      streamed_data_size));
+  while (!beam.empty()) {
+    // Plans are only found once they leave the beam. After the time limit
+    // the beam is narrowed to finish the cheapest partial plan greedily.
+    if (beam_width > 1 && std::chrono::system_clock::now() > time_limit_) {
+      trigger_timeout_ = true;
+      beam_width = 1;
+    }
+    std::vector<BeamCandidate> candidates;
+    for (int state_index = 0; state_index < beam.size(); state_index++) {
+      auto& state = *beam.at(state_index);
+      GetSearchState().explored_branch_count++;
+      // Finished partial plans leave the beam.
+      if (SchedulingGraphIndex::IsSubsetOf(
+              state.GetNodes(NodeSet::kAvailable),
+              state.GetNodes(NodeSet::kBlocked))) {
+        AddStatePlan(state, {});
+        continue;
+      }
+      for (auto& step : GetSearchSteps(state)) {
+        AddBeamCandidate(candidates, state, state_index, std::move(step));
+      }
+    }
+    beam = SelectBeam(std::move(beam), std::move(candidates), beam_width);
+  }
+}
+
+auto ElasticSchedulingGraphParser::GetSearchSteps(SchedulingSearchState& state)
+    -> std::vector<SearchStep> {
+  std::unordered_set<std::pair<int, ScheduledModule>, PairHash>
+      available_module_placements;
+  GetAllAvailableModulePlacementsInCurrentRun(available_module_placements,
+                                              state);
+  std::vector<SearchStep> steps(available_module_placements.begin(),
+                                available_module_placements.end());
+  if (steps.empty() && state.GetCurrentRun().empty()) {
+    throw std::runtime_error("Can't use an empty run at the moment!");
+  }
+  // The current run can be finished early unless there are placements left
+  // and single runs get reduced.
+  if (steps.empty() ||
+      (!reduce_single_runs_ && !state.GetCurrentRun().empty())) {
+    steps.emplace_back(std::nullopt);
+  }
+  return steps;
+}
+
+void ElasticSchedulingGraphParser::AddBeamCandidate(
+    std::vector<BeamCandidate>& candidates, SchedulingSearchState& state,
+    int state_index, SearchStep step) {
+  auto checkpoint = state.GetCheckpoint();
+  ApplySearchStep(state, step);
+  candidates.push_back(
+      {cost_estimator_->GetPartialPlanCost(state,
+                                           GetSearchState().configured_runs),
+       state.GetHash(), state_index, std::move(step)});
+  state.Rollback(checkpoint);
+}
+
+void ElasticSchedulingGraphParser::ApplySearchStep(
+    SchedulingSearchState& state, const SearchStep& step) {
+  if (!step) {
+    state.FinishRun();
+    return;
+  }
+  const auto& [module_index, module_placement] = *step;
+  state.AddStreamedDataSize(
+      GetNewStreamedDataSize(state, module_placement.node_name));
+  state.InsertModule(module_index, module_placement);
+  UpdateGraphAndTableValuesGivenPlacement(state, module_placement);
+}
+
+auto ElasticSchedulingGraphParser::SelectBeam(
+    std::vector<std::unique_ptr<SchedulingSearchState>> beam,
+    std::vector<BeamCandidate> candidates, int beam_width)
+    -> std::vector<std::unique_ptr<SchedulingSearchState>> {
+  // Ties are kept in the order the candidates were found.
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const auto& lhs, const auto& rhs) {
+                     return lhs.cost < rhs.cost;
+                   });
+  // States with the same hash continue the same way so only the cheapest one
+  // is kept to leave room for different partial plans.
+  std::vector<BeamCandidate> selected_candidates;
+  std::unordered_set<std::size_t> selected_state_hashes;
+  for (auto& candidate : candidates) {
+    if (selected_candidates.size() == beam_width) {
+      break;
+    }
+    if (selected_state_hashes.insert(candidate.state_hash).second) {
+      selected_candidates.push_back(std::move(candidate));
+    }
+  }
+  std::vector<int> remaining_child_counts(beam.size(), 0);
+  for (const auto& candidate : selected_candidates) {
+    remaining_child_counts.at(candidate.state_index)++;
+  }
+  std::vector<std::unique_ptr<SchedulingSearchState>> new_beam;
+  for (const auto& candidate : selected_candidates) {
+    auto& parent_state = beam.at(candidate.state_index);
+    // The last child takes the parent state over instead of copying it.
+    auto child_state =
+        --remaining_child_counts.at(candidate.state_index) == 0
+            ? std::move(parent_state)
+            : std::make_unique<SchedulingSearchState>(*parent_state);
+    ApplySearchStep(*child_state, candidate.step);
+    new_beam.push_back(std::move(child_state));
+  }
+  return new_beam;
+}
+
+void ElasticSchedulingGraphParser::PlaceNodesWithDynamicProgramming(
+    std::unordered_set<std::string> available_nodes,
+    std::unordered_set<std::string> processed_nodes,
+    std::unordered_map<std::string, SchedulingQueryNode> graph,
+    std::vector<ScheduledModule> current_run,
+    std::vector<std::vector<ScheduledModule>> current_plan,
+    std::map<std::string, TableMetadata> data_tables,
+    std::unordered_set<std::string> blocked_nodes,
+    std::unordered_set<std::string> next_run_blocked_nodes,
+    int streamed_data_size) {
+  if (!cost_estimator_) {
+    throw std::runtime_error("Dynamic programming requires plan costs!");
+  }
+  SchedulingSearchState state(
+      std::move(available_nodes), std::move(processed_nodes), std::move(graph),
+      std::move(current_run), std::move(current_plan), std::move(data_tables),
+      std::move(blocked_nodes), std::move(next_run_blocked_nodes),
+      streamed_data_size);
+  std::unordered_map<std::size_t, std::vector<ExactSolution>> solutions;
+  FindCheapestPlanCost(state, solutions);
+  // Follow the cheapest steps to build the plan.
+  while (!SchedulingGraphIndex::IsSubsetOf(state.GetNodes(NodeSet::kAvailable),
+                                           state.GetNodes(NodeSet::kBlocked))) {
+    const auto* solution = FindExactSolution(state, solutions);
+    if (!solution) {
+      throw std::runtime_error(
+          "Searched scheduling state missing from the exact solutions!");
+    }
+    if (solution->remaining_cost.cost == std::numeric_limits<double>::max()) {
+      throw std::runtime_error("No plan found with dynamic programming!");
+    }
+    ApplySearchStep(state, solution->step);
+  }
+  AddStatePlan(state, {});
+}
+
+auto ElasticSchedulingGraphParser::FindCheapestPlanCost(
+    SchedulingSearchState& state,
+    std::unordered_map<std::size_t, std::vector<ExactSolution>>& solutions)
+    -> ExactPlanCost {
+  // There is no plan to return before the search is finished.
+  if (std::chrono::system_clock::now() > time_limit_) {
+    trigger_timeout_ = true;
+    throw TimeLimitException("Timeout");
+  }
+  auto& search_state = GetSearchState();
+  search_state.explored_branch_count++;
+  int finished_run_count = state.GetCurrentPlan().size();
+  auto finished_runs_cost = cost_estimator_->GetFinishedRunsCost(
+      state, search_state.configured_runs);
+  if (const auto* found_solution = FindExactSolution(state, solutions)) {
+    return {finished_run_count + found_solution->remaining_cost.run_count,
+            found_solution->remaining_cost.pinned_eviction_count,
+            finished_runs_cost + found_solution->remaining_cost.cost};
+  }
+  ExactSolution solution = {GetExactSolutionState(state),
+                            {std::numeric_limits<int>::max(),
+                             std::numeric_limits<int>::max(),
+                             std::numeric_limits<double>::max()},
+                            std::nullopt};
+  if (SchedulingGraphIndex::IsSubsetOf(state.GetNodes(NodeSet::kAvailable),
+                                       state.GetNodes(NodeSet::kBlocked))) {
+    auto plan = state.GetCurrentPlan();
+    if (!state.GetCurrentRun().empty()) {
+      plan.push_back(state.GetCurrentRun());
+    }
+    solution.remaining_cost = {
+        static_cast<int>(plan.size()) - finished_run_count,
+        cost_estimator_->GetPinnedEvictionCount(plan,
+                                                search_state.configured_runs),
+        cost_estimator_->GetPlanCost(plan, state.GetStreamedDataSize(),
+                                     search_state.configured_runs) -
+            finished_runs_cost};
+  } else {
+    for (auto& step : GetSearchSteps(state)) {
+      auto checkpoint = state.GetCheckpoint();
+      ApplySearchStep(state, step);
+      auto plan_cost = FindCheapestPlanCost(state, solutions);
+      state.Rollback(checkpoint);
+      ExactPlanCost remaining_cost = {
+          plan_cost.run_count - finished_run_count,
+          plan_cost.pinned_eviction_count,
+          plan_cost.cost - finished_runs_cost};
+      if (IsExactPlanCostLower(remaining_cost, solution.remaining_cost)) {
+        solution.remaining_cost = remaining_cost;
+        solution.step = std::move(step);
+      }
+    }
+  }
+  ExactPlanCost plan_cost = {
+      finished_run_count + solution.remaining_cost.run_count,
+      solution.remaining_cost.pinned_eviction_count,
+      finished_runs_cost + solution.remaining_cost.cost};
+  solutions[GetExactSolutionKey(state)].push_back(std::move(solution));
+  return plan_cost;
+}
+
+auto ElasticSchedulingGraphParser::IsExactPlanCostLower(
+    const ExactPlanCost& cost, const ExactPlanCost& other_cost) const -> bool {
+  // The runs cap only keeps the plans with the fewest runs. Evicting fewer
+  // pinned modules matters more than the cost.
+  if (use_max_runs_cap_ && cost.run_count != other_cost.run_count) {
+    return cost.run_count < other_cost.run_count;
+  }
+  return std::make_pair(cost.pinned_eviction_count, cost.cost) <
+         std::make_pair(other_cost.pinned_eviction_count, other_cost.cost);
+}
+
+auto ElasticSchedulingGraphParser::GetExactSolutionKey(
+    SchedulingSearchState& state) -> std::size_t {
+  // The runs before the current one only matter through the configuration
+  // they leave behind.
+  auto solution_key = state.GetHash();
+  hash_combine(solution_key,
+               cost_estimator_->GetConfigurationHash(
+                   state, GetSearchState().configured_runs));
+  return solution_key;
+}
+
+auto ElasticSchedulingGraphParser::GetExactSolutionState(
+    SchedulingSearchState& state) -> ExactSolutionState {
+  const auto& configured_run = cost_estimator_->GetFinishedRunsConfiguration(
+      state, GetSearchState().configured_runs);
+  // Configured modules are compared by their bitstreams and positions only as
+  // it doesn't matter which node they were placed for.
+  std::vector<std::pair<std::string, std::pair<int, int>>> configuration;
+  configuration.reserve(configured_run.configuration.size());
+  for (const auto& module : configured_run.configuration) {
+    configuration.emplace_back(module.bitstream, module.position);
+  }
+  return {state.GetNodes(NodeSet::kProcessed), state.GetHash(),
+          std::move(configuration), configured_run.routing};
+}
+
+auto ElasticSchedulingGraphParser::FindExactSolution(
+    SchedulingSearchState& state,
+    const std::unordered_map<std::size_t, std::vector<ExactSolution>>&
+        solutions) -> const ExactSolution* {
+  auto search = solutions.find(GetExactSolutionKey(state));
+  if (search == solutions.end()) {
+    return nullptr;
+  }
+  // States with colliding hashes are stored next to each other.
+  auto solution_state = GetExactSolutionState(state);
+  for (const auto& solution : search->second) {
+    if (solution.state == solution_state) {
+      return &solution;
+    }
+  }
+  return nullptr;
+}
+
+auto ElasticSchedulingGraphParser::ReplayPlan(
+    const std::vector<std::vector<ScheduledModule>>& plan,
+    std::unordered_set<std::string> available_nodes,
+    std::unordered_set<std::string> processed_nodes,
+    std::unordered_map<std::string, SchedulingQueryNode> graph,
+    std::map<std::string, TableMetadata> data_tables,
+    std::unordered_set<std::string> blocked_nodes)
+    -> ExecutionPlanSchedulingData {
+  SchedulingSearchState state(std::move(available_nodes),
+                              std::move(processed_nodes), std::move(graph), {},
+                              {}, std::move(data_tables),
+                              std::move(blocked_nodes), {}, 0);
+  for (const auto& run : plan) {
+    std::vector<bool> is_placed(run.size(), false);
+    // Modules are placed after the modules of the run they read from like
+    // during the search.
+    auto is_ready = [&](int module_index) {
+      if (is_placed.at(module_index)) {
+        return false;
+      }
+      const auto& node = state.GetNode(
+          state.GetGraphIndex().GetNodeId(run.at(module_index).node_name));
+      for (const auto& before_stream : node.before_nodes) {
+        for (int i = 0; i < run.size(); i++) {
+          if (!is_placed.at(i) && run.at(i).node_name == before_stream.first) {
+            return false;
+          }
+        }
+      }
+      return true;
+    };
+    for (int placed_count = 0; placed_count < run.size(); placed_count++) {
+      int module_index = 0;
+      while (module_index < run.size() && !is_ready(module_index)) {
+        module_index++;
+      }
+      if (module_index == run.size()) {
+        throw std::runtime_error("Can't replay a cyclic run!");
+      }
+      int insert_position = std::count(
+          is_placed.begin(), is_placed.begin() + module_index, true);
+      ApplySearchStep(state,
+                      std::make_pair(insert_position, run.at(module_index)));
+      is_placed.at(module_index) = true;
+    }
+    ApplySearchStep(state, std::nullopt);
+  }
+  return {state.GetNodeNames(NodeSet::kProcessed), state.GetDataTables(),
+          state.GetStreamedDataSize()};
+}
+
+void ElasticSchedulingGraphParser::PlaceNodesGreedilyAfterTimeout(
+    std::unordered_set<std::string> available_nodes,
+    std::unordered_set<std::string> processed_nodes,
+    std::unordered_map<std::string, SchedulingQueryNode> graph,
+    std::map<std::string, TableMetadata> data_tables,
+    std::unordered_set<std::string> blocked_nodes) {
+  is_greedy_fallback_used_ = true;
+  PlaceNodesWithBeamSearch(1, std::move(available_nodes),
+                           std::move(processed_nodes), std::move(graph), {},
+                           {}, std::move(data_tables),
+                           std::move(blocked_nodes), {}, 0);
+}
+
+auto ElasticSchedulingGraphParser::HasFoundPlan() const -> bool {
+  return min_runs_ != std::numeric_limits<int>::max();
 }
 
 auto ElasticSchedulingGraphParser::GetTimeoutStatus() const -> bool {
   return trigger_timeout_;
 }
 
+auto ElasticSchedulingGraphParser::IsGreedyFallbackUsed() const -> bool {
+  return is_greedy_fallback_used_;
+}
+
 auto ElasticSchedulingGraphParser::GetResultingPlan()
     -> std::map<std::vector<std::vector<ScheduledModule>>,
                 ExecutionPlanSchedulingData> {
-  return resulting_plan_;
+  if (!thread_pool_) {
+    return search_states_.front().resulting_plan;
+  }
+  std::map<std::vector<std::vector<ScheduledModule>>,
+           ExecutionPlanSchedulingData>
+      resulting_plan;
+  std::map<std::vector<std::vector<ScheduledModule>>, std::vector<int>>
+      branch_paths;
+  std::map<std::vector<std::vector<ScheduledModule>>, double> plan_costs;
+  for (const auto& search_state : search_states_) {
+    for (const auto& [plan, scheduling_data] : search_state.resulting_plan) {
+      const auto& branch_path = search_state.branch_paths.at(plan);
+      auto plan_cost = search_state.plan_costs.at(plan);
+      if (auto [it, inserted] =
+              resulting_plan.try_emplace(plan, scheduling_data);
+          inserted) {
+        branch_paths.insert({plan, branch_path});
+        plan_costs.insert({plan, plan_cost});
+      } else if (IsPlanPreferred(plan_cost, branch_path, plan_costs.at(plan),
+                                 branch_paths.at(plan))) {
+        resulting_plan.erase(it);
+        resulting_plan.emplace(plan, scheduling_data);
+        branch_paths.at(plan) = branch_path;
+        plan_costs.at(plan) = plan_cost;
+      }
+    }
+  }
+  return resulting_plan;
 }
 
 auto ElasticSchedulingGraphParser::GetStats() -> std::pair<int, int> {
-  return statistics_counters_;
+  std::pair<int, int> statistics_counters = {0, 0};
+  for (const auto& search_state : search_states_) {
+    statistics_counters.first += search_state.statistics_counters.first;
+    statistics_counters.second += search_state.statistics_counters.second;
+  }
+  return statistics_counters;
+}
+
+auto ElasticSchedulingGraphParser::GetTranspositionTableStatistics() const
+    -> TranspositionTable::Statistics {
+  TranspositionTable::Statistics table_statistics;
+  for (const auto& search_state : search_states_) {
+    auto worker_statistics = search_state.transposition_table.GetStatistics();
+    table_statistics.lookups += worker_statistics.lookups;
+    table_statistics.hits += worker_statistics.hits;
+    table_statistics.stored_states += worker_statistics.stored_states;
+    table_statistics.rejected_states += worker_statistics.rejected_states;
+  }
+  return table_statistics;
+}
+
+auto ElasticSchedulingGraphParser::GetExploredBranchCount() const -> long {
+  long explored_branch_count = 0;
+  for (const auto& search_state : search_states_) {
+    explored_branch_count += search_state.explored_branch_count;
+  }
+  return explored_branch_count;
+}
+
+auto ElasticSchedulingGraphParser::GetPrunedBranchCount() const -> long {
+  long pruned_branch_count = 0;
+  for (const auto& search_state : search_states_) {
+    pruned_branch_count += search_state.pruned_branch_count;
+  }
+  return pruned_branch_count;
+}
+
+void ElasticSchedulingGraphParser::SetPlanCostEstimator(
+    std::unique_ptr<PlanCostEstimator> cost_estimator, bool prune_branches) {
+  cost_estimator_ = std::move(cost_estimator);
+  prune_branches_ = prune_branches;
+  for (auto& search_state : search_states_) {
+    search_state.configured_runs.clear();
+  }
+}
+
+auto ElasticSchedulingGraphParser::GetBestFoundPlan()
+    -> std::pair<std::vector<std::vector<ScheduledModule>>,
+                 ExecutionPlanSchedulingData> {
+  std::lock_guard<std::mutex> lock(best_plan_mutex_);
+  if (convergence_log_.empty()) {
+    throw std::runtime_error("No costed plans found!");
+  }
+  return {best_plan_, best_plan_data_};
+}
+
+auto ElasticSchedulingGraphParser::GetConvergenceLog()
+    -> std::vector<ConvergencePoint> {
+  std::lock_guard<std::mutex> lock(best_plan_mutex_);
+  return convergence_log_;
+}
+
+auto ElasticSchedulingGraphParser::GetBranchPath(
+    const std::vector<int>& branch_path, int branch_index) const
+    -> std::vector<int> {
+  if (!thread_pool_) {
+    return {};
+  }
+  auto new_branch_path = branch_path;
+  new_branch_path.push_back(branch_index);
+  return new_branch_path;
+}
+
+auto ElasticSchedulingGraphParser::GetSearchState() -> SearchState& {
+  return search_states_.at(
+      std::max(WorkStealingThreadPool::GetWorkerIndex(), 0));
 }
 
 void ElasticSchedulingGraphParser::SetTimeLimit(
-    const std::chrono::system_clock::time_point new_time_limit) {
+    const std::chrono::system_clock::time_point new_time_limit,
+    const bool stop_before_first_plan) {
   time_limit_ = new_time_limit;
+  stop_before_first_plan_ = stop_before_first_plan;
   trigger_timeout_ = false;
+  is_greedy_fallback_used_ = false;
   min_runs_ = std::numeric_limits<int>::max();
-  resulting_plan_.clear();
-  statistics_counters_ = {0, 0};
+  best_plan_cost_ = std::numeric_limits<double>::max();
+  {
+    std::lock_guard<std::mutex> lock(best_plan_mutex_);
+    best_plan_.clear();
+    best_plan_data_ = {};
+    best_plan_pinned_eviction_count_ = 0;
+    convergence_log_.clear();
+    search_start_ = std::chrono::steady_clock::now();
+  }
+  for (auto& search_state : search_states_) {
+    search_state.resulting_plan.clear();
+    search_state.branch_paths.clear();
+    search_state.plan_costs.clear();
+    search_state.statistics_counters = {0, 0};
+    search_state.explored_branch_count = 0;
+    search_state.transposition_table.Clear();
+    search_state.transposition_frames.clear();
+    search_state.found_plans.clear();
+    search_state.pruned_branch_count = 0;
+  }
 }
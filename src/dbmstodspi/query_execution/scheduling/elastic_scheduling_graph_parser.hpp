@@ -15,26 +15,43 @@ limitations under the License.
 */
 
 #pragma once
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <limits>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "accelerator_library_interface.hpp"
+#include "hw_library_index.hpp"
 #include "module_selection.hpp"
 #include "pr_module_data.hpp"
 #include "pre_scheduling_processor.hpp"
+#include "plan_cost_estimator.hpp"
 #include "scheduled_module.hpp"
 #include "scheduling_data.hpp"
+#include "scheduling_search_state.hpp"
+#include "transposition_table.hpp"
+#include "work_stealing_thread_pool.hpp"
 
 using orkhestrafs::core_interfaces::hw_library::OperationPRModules;
 using orkhestrafs::dbmstodspi::AcceleratorLibraryInterface;
+using orkhestrafs::dbmstodspi::HWLibraryIndex;
 using orkhestrafs::dbmstodspi::ModuleSelection;
 using orkhestrafs::dbmstodspi::PairHash;
+using orkhestrafs::dbmstodspi::PlanCostEstimator;
 using orkhestrafs::dbmstodspi::PreSchedulingProcessor;
 using orkhestrafs::dbmstodspi::ScheduledModule;
+using orkhestrafs::dbmstodspi::SchedulingSearchState;
+using orkhestrafs::dbmstodspi::TranspositionTable;
+using orkhestrafs::dbmstodspi::WorkStealingThreadPool;
 using orkhestrafs::dbmstodspi::scheduling_data::ExecutionPlanSchedulingData;
 
 namespace orkhestrafs::dbmstodspi {
@@ -44,6 +61,15 @@ namespace orkhestrafs::dbmstodspi {
  */
 class ElasticSchedulingGraphParser {
  public:
+  /**
+   * @brief Cost of a plan which was cheaper than any plan found before.
+   */
+  struct ConvergencePoint {
+    /// Microseconds since the start of the search.
+    long time;
+    double cost;
+  };
+
   ElasticSchedulingGraphParser(
       const std::map<QueryOperationType, OperationPRModules>& hw_library,
       std::pair<std::vector<std::vector<ModuleSelection>>,
@@ -52,10 +78,13 @@ class ElasticSchedulingGraphParser {
       std::unordered_set<std::string> constrained_first_nodes,
       AcceleratorLibraryInterface& drivers, const bool use_max_runs_cap,
       const bool reduce_single_runs, const bool prioritise_children,
-      const bool use_single_runs)
-      : hw_library_{hw_library},
+      const bool use_single_runs, const int thread_count = 1,
+      const int transposition_table_size = 0)
+      : min_runs_{std::numeric_limits<int>::max()},
+        best_plan_cost_{std::numeric_limits<double>::max()},
+        hw_library_{hw_library},
+        hw_library_index_{hw_library},
         heuristics_{std::move(heuristics)},
-        statistics_counters_{0, 0},
         constrained_first_nodes_{std::move(constrained_first_nodes)},
         drivers_{drivers},
         time_limit_{std::chrono::system_clock::time_point::max()},
@@ -64,9 +93,22 @@ class ElasticSchedulingGraphParser {
         reduce_single_runs_{reduce_single_runs},
         prioritise_children_{prioritise_children},
         use_single_runs_{use_single_runs},
-
-        min_runs_{std::numeric_limits<int>::max()},
-        pre_scheduler_{hw_library, drivers} {};
+        use_transposition_table_{transposition_table_size > 0},
+        pre_scheduler_{hw_library, hw_library_index_, drivers},
+        search_states_(std::max(thread_count, 1),
+                       SearchState(transposition_table_size /
+                                   std::max(thread_count, 1))),
+        thread_pool_{thread_count > 1
+                         ? std::make_unique<WorkStealingThreadPool>(
+                               thread_count)
+                         : nullptr} {
+    // Which plans the runs cap cuts depends on the order in which the plans
+    // are found. Only the sequential search finds them in a fixed order.
+    if (thread_pool_ && use_max_runs_cap_) {
+      throw std::runtime_error(
+          "Parallel scheduling can't be used with the max runs cap!");
+    }
+  };
 
   void PreprocessNodes(
       std::unordered_set<std::string>& available_nodes,
@@ -74,6 +116,10 @@ class ElasticSchedulingGraphParser {
       std::unordered_map<std::string, SchedulingQueryNode>& graph,
       std::map<std::string, TableMetadata>& data_tables);
 
+  /**
+   * @brief Find all plans for the given nodes. With multiple threads the
+   * decision branches are searched by the thread pool workers.
+   */
   void PlaceNodesRecursively(
       std::unordered_set<std::string> available_nodes,
       std::unordered_set<std::string> processed_nodes,
@@ -84,32 +130,267 @@ class ElasticSchedulingGraphParser {
       std::unordered_set<std::string> blocked_nodes,
       std::unordered_set<std::string> next_run_blocked_nodes,
       int streamed_data_size);
+  /**
+   * @brief Find plans by only keeping the cheapest partial plans after each
+   * placement or finished run instead of searching every decision branch.
+   * Partial plans are compared by their cost lower bounds which requires a
+   * cost estimator. A width of 1 schedules the nodes greedily.
+   * @param beam_width How many partial plans are kept after each step.
+   */
+  void PlaceNodesWithBeamSearch(
+      int beam_width, std::unordered_set<std::string> available_nodes,
+      std::unordered_set<std::string> processed_nodes,
+      std::unordered_map<std::string, SchedulingQueryNode> graph,
+      std::vector<ScheduledModule> current_run,
+      std::vector<std::vector<ScheduledModule>> current_plan,
+      std::map<std::string, TableMetadata> data_tables,
+      std::unordered_set<std::string> blocked_nodes,
+      std::unordered_set<std::string> next_run_blocked_nodes,
+      int streamed_data_size);
+  /**
+   * @brief Find the cheapest plan with dynamic programming over the search
+   * states. The cheapest continuation of every state is stored with the FPGA
+   * configuration left by its finished runs such that equivalent states are
+   * only searched once. Requires a cost estimator. With the runs cap the
+   * cheapest of the plans with the fewest runs is found. No plan is found if
+   * the time limit is hit.
+   */
+  void PlaceNodesWithDynamicProgramming(
+      std::unordered_set<std::string> available_nodes,
+      std::unordered_set<std::string> processed_nodes,
+      std::unordered_map<std::string, SchedulingQueryNode> graph,
+      std::vector<ScheduledModule> current_run,
+      std::vector<std::vector<ScheduledModule>> current_plan,
+      std::map<std::string, TableMetadata> data_tables,
+      std::unordered_set<std::string> blocked_nodes,
+      std::unordered_set<std::string> next_run_blocked_nodes,
+      int streamed_data_size);
 
+  /**
+   * @brief Place the modules of an already chosen plan again to get its
+   * processed nodes, tables and streamed data for the given tables.
+   * @param plan Plan to replay. The modules have to fit the given graph.
+   * @return Scheduling data of the plan with the given tables.
+   */
+  auto ReplayPlan(const std::vector<std::vector<ScheduledModule>>& plan,
+                  std::unordered_set<std::string> available_nodes,
+                  std::unordered_set<std::string> processed_nodes,
+                  std::unordered_map<std::string, SchedulingQueryNode> graph,
+                  std::map<std::string, TableMetadata> data_tables,
+                  std::unordered_set<std::string> blocked_nodes)
+      -> ExecutionPlanSchedulingData;
+
+  /**
+   * @brief Schedule the nodes with a greedy beam search after the search hit
+   * the time limit before finding any plan. The greedy pass isn't stopped by
+   * the time limit as it takes one step per placement.
+   */
+  void PlaceNodesGreedilyAfterTimeout(
+      std::unordered_set<std::string> available_nodes,
+      std::unordered_set<std::string> processed_nodes,
+      std::unordered_map<std::string, SchedulingQueryNode> graph,
+      std::map<std::string, TableMetadata> data_tables,
+      std::unordered_set<std::string> blocked_nodes);
+  /**
+   * @brief Check if the last search found any plan.
+   * @return Whether there is a plan to return.
+   */
+  [[nodiscard]] auto HasFoundPlan() const -> bool;
+
+  /**
+   * @brief Check if the last search hit the time limit. Stays set if the
+   * plans were finished greedily after that.
+   * @return Whether the search timed out.
+   */
   [[nodiscard]] auto GetTimeoutStatus() const -> bool;
+  /**
+   * @brief Check if the plans of the last search come from the greedy pass
+   * after a timeout.
+   * @return Whether PlaceNodesGreedilyAfterTimeout was used.
+   */
+  [[nodiscard]] auto IsGreedyFallbackUsed() const -> bool;
   auto GetResultingPlan() -> std::map<std::vector<std::vector<ScheduledModule>>,
                                       ExecutionPlanSchedulingData>;
   auto GetStats() -> std::pair<int, int>;
-
-  void SetTimeLimit(std::chrono::system_clock::time_point new_time_limit);
+  /**
+   * @brief Get how many decision branches the last search went through.
+   * @return Number of explored branches.
+   */
+  [[nodiscard]] auto GetExploredBranchCount() const -> long;
+  [[nodiscard]] auto GetTranspositionTableStatistics() const
+      -> TranspositionTable::Statistics;
+  /**
+   * @brief Get how many branches the last search pruned by their cost.
+   * @return Number of pruned branches.
+   */
+  [[nodiscard]] auto GetPrunedBranchCount() const -> long;
+
+  /**
+   * @brief Set plan costs to keep the best plan found so far and to prune
+   * branches which can't find a better plan.
+   * @param cost_estimator Costs for the next search. Null to find all plans.
+   * @param prune_branches Whether to prune branches or only cost the plans.
+   */
+  void SetPlanCostEstimator(std::unique_ptr<PlanCostEstimator> cost_estimator,
+                            bool prune_branches = true);
+  /**
+   * @brief Get the cheapest plan found so far which evicts the fewest pinned
+   * modules. Requires a cost estimator.
+   * @return Plan with its scheduling data.
+   */
+  auto GetBestFoundPlan()
+      -> std::pair<std::vector<std::vector<ScheduledModule>>,
+                   ExecutionPlanSchedulingData>;
+  /**
+   * @brief Get when each better plan was found during the last search.
+   * @return Found plan costs in the order they were found.
+   */
+  auto GetConvergenceLog() -> std::vector<ConvergencePoint>;
+
+  /**
+   * @brief Set the time limit of the next search.
+   * @param new_time_limit Time after which the search is stopped.
+   * @param stop_before_first_plan Whether the recursive search is stopped at
+   * the time limit before finding any plan. The nodes then have to be
+   * scheduled with PlaceNodesGreedilyAfterTimeout. Otherwise the search
+   * continues until the first plan is found.
+   */
+  void SetTimeLimit(std::chrono::system_clock::time_point new_time_limit,
+                    bool stop_before_first_plan = false);
 
  private:
-  int min_runs_;
+  // State which is searched and stored in the transposition table once all
+  // of its plans are found.
+  struct TranspositionFrame {
+    std::size_t state_hash;
+    TranspositionTable::Entry entry;
+    // Index of the first plan found after the state.
+    int first_found_plan;
+    bool is_complete;
+  };
+
+  // Hashes the node and bitstream IDs keying the saved placements.
+  struct PlacementQueryHash {
+    auto operator()(const std::vector<std::size_t>& query) const
+        -> std::size_t {
+      std::size_t seed = query.size();
+      for (const auto& id : query) {
+        hash_combine(seed, id);
+      }
+      return seed;
+    }
+  };
+
+  // Plans and placements found by a single worker.
+  struct SearchState {
+    explicit SearchState(int transposition_table_size)
+        : transposition_table{transposition_table_size} {}
+
+    std::map<std::vector<std::vector<ScheduledModule>>,
+             ExecutionPlanSchedulingData>
+        resulting_plan;
+    std::unordered_map<
+        std::vector<std::size_t>,
+        std::unordered_set<std::pair<int, ScheduledModule>, PairHash>,
+        PlacementQueryHash>
+        saved_placements;
+    std::pair<int, int> statistics_counters = {0, 0};
+    long explored_branch_count = 0;
+    // Where each plan was found. Only used by the parallel search.
+    std::map<std::vector<std::vector<ScheduledModule>>, std::vector<int>>
+        branch_paths;
+    // Estimated cost of each stored plan. Zero without a cost estimator.
+    std::map<std::vector<std::vector<ScheduledModule>>, double> plan_costs;
+    TranspositionTable transposition_table;
+    // States of the current branch which are being searched.
+    std::vector<TranspositionFrame> transposition_frames;
+    // Plans found since the outermost frame was started.
+    std::vector<std::shared_ptr<const TranspositionTable::FoundPlan>>
+        found_plans;
+    long pruned_branch_count = 0;
+    // Configurations of the runs of the last costed plan.
+    std::vector<PlanCostEstimator::ConfiguredRun> configured_runs;
+  };
+
+  // Module to place or the current run is finished if there is none.
+  using SearchStep = std::optional<std::pair<int, ScheduledModule>>;
+
+  // Step of a partial plan which could be kept in the beam.
+  struct BeamCandidate {
+    double cost;
+    std::size_t state_hash;
+    // Index of the partial plan in the beam.
+    int state_index;
+    SearchStep step;
+  };
+
+  // Searched state which is compared to find hash collisions. Only the
+  // processed nodes and the configuration left by the finished runs are kept.
+  // The rest of the state like the graph, the tables and the current run is
+  // only compared through its hash as it would take too much memory to keep
+  // for every state.
+  struct ExactSolutionState {
+    SchedulingGraphIndex::NodeIdSet processed_nodes;
+    std::size_t state_hash;
+    // Bitstream and position of each configured module.
+    std::vector<std::pair<std::string, std::pair<int, int>>> configuration;
+    std::vector<std::string> routing;
+
+    auto operator==(const ExactSolutionState& rhs) const -> bool {
+      return processed_nodes == rhs.processed_nodes &&
+             state_hash == rhs.state_hash &&
+             configuration == rhs.configuration && routing == rhs.routing;
+    }
+  };
+
+  // Cost of finishing a plan found by dynamic programming.
+  struct ExactPlanCost {
+    // Only compared with the runs cap.
+    int run_count;
+    // Pinned modules evicted by the plan. Compared before the cost.
+    int pinned_eviction_count;
+    double cost;
+  };
+
+  // Cheapest way to finish the plan from a searched state.
+  struct ExactSolution {
+    ExactSolutionState state;
+    // Runs and plan cost on top of the finished runs of the state.
+    ExactPlanCost remaining_cost;
+    // First step of the cheapest continuation.
+    SearchStep step;
+  };
+
+  std::atomic<int> min_runs_;
+  // Cost of the best plan found by any worker which evicts no pinned modules.
+  std::atomic<double> best_plan_cost_;
+  std::unique_ptr<PlanCostEstimator> cost_estimator_;
+  bool prune_branches_ = true;
+  // Best plan found by any worker and when each better plan was found. Plans
+  // which evict fewer pinned modules are better regardless of the cost.
+  std::mutex best_plan_mutex_;
+  std::vector<std::vector<ScheduledModule>> best_plan_;
+  int best_plan_pinned_eviction_count_ = 0;
+  ExecutionPlanSchedulingData best_plan_data_;
+  std::vector<ConvergencePoint> convergence_log_;
+  std::chrono::steady_clock::time_point search_start_;
   const std::map<QueryOperationType, OperationPRModules> hw_library_;
+  // Lookup tables compiled from the library once.
+  const HWLibraryIndex hw_library_index_;
   const std::pair<std::vector<std::vector<ModuleSelection>>,
                   std::vector<std::vector<ModuleSelection>>>
       heuristics_;
-  std::pair<int, int> statistics_counters_;
   const std::unordered_set<std::string> constrained_first_nodes_;
   AcceleratorLibraryInterface& drivers_;
   std::chrono::system_clock::time_point time_limit_;
-  bool trigger_timeout_;
+  std::atomic<bool> trigger_timeout_;
+  bool stop_before_first_plan_ = false;
+  bool is_greedy_fallback_used_ = false;
   const bool use_max_runs_cap_;
-  std::map<std::vector<std::vector<ScheduledModule>>,
-           ExecutionPlanSchedulingData>
-      resulting_plan_;
   const bool reduce_single_runs_;
   const bool prioritise_children_;
   const bool use_single_runs_;
+  const bool use_transposition_table_;
   PreSchedulingProcessor pre_scheduler_;
 
   /*struct CustomCmp {
@@ -150,34 +431,76 @@ class ElasticSchedulingGraphParser {
       std::string,
       std::unordered_set<std::pair<int, ScheduledModule>, PairHash>>
       saved_placements_;*/
-  std::unordered_map<
-      std::string,
-      std::unordered_set<std::pair<int, ScheduledModule>, PairHash>>
-      saved_placements_;
+  // One state for each worker. Merged once the search is finished.
+  std::vector<SearchState> search_states_;
+  // Null if the search is sequential.
+  std::unique_ptr<WorkStealingThreadPool> thread_pool_;
+
+  auto GetSearchState() -> SearchState&;
+
+  void PlaceNodesInBranch(SchedulingSearchState& state,
+                          std::vector<int> branch_path);
+  void SearchNodePlacements(SchedulingSearchState& state,
+                            std::vector<int> branch_path);
+  void AddStatePlan(const SchedulingSearchState& state,
+                    const std::vector<int>& branch_path);
+  auto GetSearchSteps(SchedulingSearchState& state) -> std::vector<SearchStep>;
+  void ApplySearchStep(SchedulingSearchState& state, const SearchStep& step);
+  void AddBeamCandidate(std::vector<BeamCandidate>& candidates,
+                        SchedulingSearchState& state, int state_index,
+                        SearchStep step);
+  auto SelectBeam(std::vector<std::unique_ptr<SchedulingSearchState>> beam,
+                  std::vector<BeamCandidate> candidates, int beam_width)
+      -> std::vector<std::unique_ptr<SchedulingSearchState>>;
+  auto FindCheapestPlanCost(
+      SchedulingSearchState& state,
+      std::unordered_map<std::size_t, std::vector<ExactSolution>>& solutions)
+      -> ExactPlanCost;
+  auto IsExactPlanCostLower(const ExactPlanCost& cost,
+                            const ExactPlanCost& other_cost) const -> bool;
+  auto GetExactSolutionKey(SchedulingSearchState& state) -> std::size_t;
+  auto GetExactSolutionState(SchedulingSearchState& state)
+      -> ExactSolutionState;
+  auto FindExactSolution(
+      SchedulingSearchState& state,
+      const std::unordered_map<std::size_t, std::vector<ExactSolution>>&
+          solutions) -> const ExactSolution*;
+  auto GetTranspositionKey(SchedulingSearchState& state) const -> std::size_t;
+  auto IsBranchPruned(const SchedulingSearchState& state) -> bool;
+  void UpdateBestPlan(
+      const std::vector<std::vector<ScheduledModule>>& current_plan,
+      const ExecutionPlanSchedulingData& scheduling_data,
+      int pinned_eviction_count, double plan_cost);
+  void AddContinuation(const SchedulingSearchState& state,
+                       const TranspositionTable::Entry& entry,
+                       const TranspositionTable::FoundPlan& found_plan,
+                       const std::vector<int>& branch_path);
+  void SpawnOrPlaceNodesInBranch(SchedulingSearchState& state,
+                                 std::vector<int> branch_path);
+  auto GetBranchPath(const std::vector<int>& branch_path,
+                     int branch_index) const -> std::vector<int>;
 
   void AddPlanToAllPlansAndMeasureTime(
       const std::vector<std::vector<ScheduledModule>>& current_plan,
-      const std::unordered_set<std::string>& processed_nodes,
+      std::unordered_set<std::string> processed_nodes,
       const std::map<std::string, TableMetadata>& data_tables,
-      int streamed_data_size);
+      int streamed_data_size, const std::vector<int>& branch_path);
+  static auto IsPlanPreferred(double plan_cost,
+                              const std::vector<int>& branch_path,
+                              double stored_plan_cost,
+                              const std::vector<int>& stored_branch_path)
+      -> bool;
 
   void GetAllAvailableModulePlacementsInCurrentRun(
       std::unordered_set<std::pair<int, ScheduledModule>, PairHash>&
           available_module_placements,
-      const std::unordered_set<std::string>& available_nodes,
-      const std::vector<ScheduledModule>& current_run,
-      const std::unordered_map<std::string, SchedulingQueryNode>& graph,
-      const std::unordered_set<std::string>& blocked_nodes,
-      const std::map<std::string, TableMetadata>& data_tables);
-
-  static auto IsSubsetOf(const std::unordered_set<std::string>& a,
-                         const std::unordered_set<std::string>& b) -> bool;
+      const SchedulingSearchState& state);
 
-  static auto GetNewStreamedDataSize(
-      const std::vector<ScheduledModule>& current_run,
-      const std::string& node_name,
-      const std::map<std::string, TableMetadata>& data_tables,
-      const std::unordered_map<std::string, SchedulingQueryNode>& graph) -> int;
+  static auto GetNewStreamedDataSize(const SchedulingSearchState& state,
+                                     const std::string& node_name) -> int;
+  static auto GetNodeDataTables(const SchedulingSearchState& state,
+                                int node_id)
+      -> std::map<std::string, TableMetadata>;
 
   static auto IsTableEqualForGivenNode(
       const std::unordered_map<std::string, SchedulingQueryNode>& graph,
@@ -196,10 +519,9 @@ class ElasticSchedulingGraphParser {
                           QueryOperationType operation)
       -> std::vector<std::string>;
 
-  static void UpdateGraphCapacities(
-      const std::vector<int>& missing_utility,
-      std::unordered_map<std::string, SchedulingQueryNode>& new_graph,
-      const std::string& node_name, bool is_node_fully_processed);
+  static void UpdateGraphCapacities(const std::vector<int>& missing_utility,
+                                    SchedulingSearchState& state, int node_id,
+                                    bool is_node_fully_processed);
 
   static auto FindMissingUtility(const std::vector<int>& bitstream_capacity,
                                  std::vector<int>& missing_capacity,
@@ -246,81 +568,57 @@ class ElasticSchedulingGraphParser {
                                 const QueryOperationType operation_type)
       -> bool;
 
-  auto RemoveUnavailableNodesInThisRun(
-      const std::unordered_set<std::string>& available_nodes,
-      const std::vector<ScheduledModule>& current_run,
-      const std::unordered_map<std::string, SchedulingQueryNode>& graph,
-      const std::unordered_set<std::string>& blocked_nodes,
-      const std::map<std::string, TableMetadata>& data_tables)
-      -> std::unordered_set<std::string>;
+  auto RemoveUnavailableNodesInThisRun(const SchedulingSearchState& state)
+      -> std::vector<int>;
 
   static auto GetMinPositionInCurrentRun(
       const std::vector<ScheduledModule>& current_run,
-      const std::string& node_name,
-      const std::unordered_map<std::string, SchedulingQueryNode>& graph) -> int;
+      const SchedulingQueryNode& node) -> int;
 
   static auto GetTakenColumns(const std::vector<ScheduledModule>& current_run)
       -> std::vector<std::pair<int, int>>;
 
+  static auto GetBitstreamListHash(
+      const std::vector<std::vector<std::string>>& bitstream_start_locations)
+      -> std::size_t;
+
   void GetScheduledModulesForNodeAfterPosOrig(
-      const std::unordered_map<std::string, SchedulingQueryNode>& graph,
-      int min_position, const std::string& node_name,
+      const SchedulingQueryNode& node, int min_position,
+      const std::string& node_name,
       const std::vector<std::pair<int, int>>& taken_positions,
-      const std::map<std::string, TableMetadata>& data_tables,
       std::unordered_set<std::pair<int, ScheduledModule>, PairHash>&
           module_placements,
       bool is_composed);
   void GetScheduledModulesForNodeAfterPos(
-      const std::unordered_map<std::string, SchedulingQueryNode>& graph,
-      const std::vector<ScheduledModule>& current_run,
-      const std::string& node_name,
-      const std::map<std::string, TableMetadata>& data_tables,
+      const SchedulingSearchState& state, int node_id,
       std::unordered_set<std::pair<int, ScheduledModule>, PairHash>&
           module_placements);
 
   void UpdateGraphAndTableValuesGivenPlacement(
-      std::unordered_map<std::string, SchedulingQueryNode>& new_graph,
-      std::unordered_set<std::string>& new_available_nodes,
-      const ScheduledModule& module_placement,
-      std::unordered_set<std::string>& new_processed_nodes,
-      std::map<std::string, TableMetadata>& new_data_tables,
-      std::unordered_set<std::string>& new_next_run_blocked_nodes,
-      const std::unordered_set<std::string>& blocked_nodes);
-
-  auto UpdateGraphCapacitiesAndTables(
-      std::unordered_map<std::string, SchedulingQueryNode>& new_graph,
-      std::map<std::string, TableMetadata>& new_data_tables,
-      const std::string& bitstream, const std::string& node_name,
-      const std::vector<int>& capacity, QueryOperationType operation,
-      bool is_composed) -> bool;
+      SchedulingSearchState& state, const ScheduledModule& module_placement);
 
-  static auto CreateNewAvailableNodes(
-      const std::unordered_map<std::string, SchedulingQueryNode>& graph,
-      std::unordered_set<std::string>& available_nodes,
-      std::unordered_set<std::string>& processed_nodes,
-      const std::string& node_name);
+  auto UpdateGraphCapacitiesAndTables(SchedulingSearchState& state,
+                                      const std::string& bitstream,
+                                      int node_id,
+                                      const std::vector<int>& capacity,
+                                      QueryOperationType operation,
+                                      bool is_composed) -> bool;
+
+  static void CreateNewAvailableNodes(SchedulingSearchState& state,
+                                      int node_id);
 
   void UpdateAvailableNodesAndSatisfyingBitstreamsList(
-      const std::string& node_name,
-      std::unordered_map<std::string, SchedulingQueryNode>& new_graph,
-      std::unordered_set<std::string>& new_available_nodes,
-      std::map<std::string, TableMetadata>& new_tables,
-      std::unordered_set<std::string>& new_processed_nodes,
-      QueryOperationType operation, bool satisfied_requirements,
-      std::unordered_set<std::string>& next_run_blocked_nodes,
-      const std::unordered_set<std::string>& blocked_nodes);
+      int node_id, SchedulingSearchState& state, QueryOperationType operation,
+      bool satisfied_requirements);
 
   void GetNewBlockedNodes(
-      std::unordered_set<std::string>& next_run_blocked_nodes,
-      const std::unordered_map<std::string, SchedulingQueryNode>& graph,
-      QueryOperationType operation, const std::string& node_name,
-      const std::unordered_set<std::string>& blocked_nodes);
+      SchedulingGraphIndex::NodeIdSet& next_run_blocked_nodes,
+      const SchedulingSearchState& state, QueryOperationType operation,
+      int node_id);
 
   void FindDataSensitiveNodeNames(
-      const std::string& node_name,
-      const std::unordered_map<std::string, SchedulingQueryNode>& graph,
-      std::unordered_set<std::string>& new_next_run_blocked_nodes,
-      const std::unordered_set<std::string>& blocked_nodes);
+      int node_id, const SchedulingSearchState& state,
+      SchedulingGraphIndex::NodeIdSet& new_next_run_blocked_nodes);
 };
 
 }  // namespace orkhestrafs::dbmstodspi
\ No newline at end of file
@@ -0,0 +1,288 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "hw_library_index.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+using orkhestrafs::dbmstodspi::HWLibraryIndex;
+
+HWLibraryIndex::HWLibraryIndex(
+    const std::map<QueryOperationType, OperationPRModules>& hw_library) {
+  for (const auto& [operation, operation_modules] : hw_library) {
+    auto& operation_index = operations_[operation];
+    operation_index.first_module_id = modules_.size();
+    for (int column = 0; column < operation_modules.starting_locations.size();
+         column++) {
+      int first_column_module_id = modules_.size();
+      const auto& column_bitstreams =
+          operation_modules.starting_locations.at(column);
+      for (int location_index = 0; location_index < column_bitstreams.size();
+           location_index++) {
+        const auto& bitstream = column_bitstreams.at(location_index);
+        const auto& module_data =
+            operation_modules.bitstream_map.find(bitstream);
+        if (module_data == operation_modules.bitstream_map.end()) {
+          throw std::runtime_error(bitstream + " is missing from the library!");
+        }
+        operation_index.bitstream_ids.insert({bitstream, modules_.size()});
+        modules_.push_back({operation, bitstream, column,
+                            column + module_data->second.length - 1,
+                            location_index, module_data->second.capacity});
+      }
+      operation_index.column_ranges.emplace_back(first_column_module_id,
+                                                 modules_.size());
+    }
+    operation_index.module_count =
+        modules_.size() - operation_index.first_module_id;
+  }
+
+  for (auto& [operation, operation_index] : operations_) {
+    for (int module_id = operation_index.first_module_id;
+         module_id <
+         operation_index.first_module_id + operation_index.module_count;
+         module_id++) {
+      const auto& module = modules_.at(module_id);
+      operation_index.interval_tree.push_back(
+          {module.start, module.end, module.end, module_id});
+    }
+    BuildIntervalTree(operation_index, 0,
+                      operation_index.interval_tree.size() - 1);
+    BuildCapacityTables(operation_index);
+  }
+}
+
+auto HWLibraryIndex::GetModule(int module_id) const -> const ModulePlacement& {
+  return modules_.at(module_id);
+}
+
+auto HWLibraryIndex::GetModuleId(QueryOperationType operation, int column,
+                                 const std::string& bitstream) const -> int {
+  const auto& operation_index = GetOperationIndex(operation);
+  auto search = operation_index.bitstream_ids.find(bitstream);
+  if (search != operation_index.bitstream_ids.end() &&
+      modules_.at(search->second).start == column) {
+    return search->second;
+  }
+  // The same bitstream is listed at multiple start columns.
+  const auto& [first, last] = operation_index.column_ranges.at(column);
+  for (int module_id = first; module_id < last; module_id++) {
+    if (modules_.at(module_id).bitstream == bitstream) {
+      return module_id;
+    }
+  }
+  throw std::runtime_error(bitstream + " doesn't start at column " +
+                           std::to_string(column) + "!");
+}
+
+auto HWLibraryIndex::GetBitstreamId(QueryOperationType operation,
+                                    const std::string& bitstream) const
+    -> int {
+  const auto& bitstream_ids = GetOperationIndex(operation).bitstream_ids;
+  auto search = bitstream_ids.find(bitstream);
+  if (search == bitstream_ids.end()) {
+    throw std::runtime_error(bitstream + " is missing from the library!");
+  }
+  return search->second;
+}
+
+auto HWLibraryIndex::GetModuleId(QueryOperationType operation, int column,
+                                 int location_index) const -> int {
+  const auto& [first, last] =
+      GetOperationIndex(operation).column_ranges.at(column);
+  if (location_index < 0 || first + location_index >= last) {
+    throw std::runtime_error("Bitstream location index out of range!");
+  }
+  return first + location_index;
+}
+
+auto HWLibraryIndex::GetOverlappingModules(QueryOperationType operation,
+                                           int first_column,
+                                           int last_column) const
+    -> ModuleSet {
+  const auto& operation_index = GetOperationIndex(operation);
+  auto result = CreateEmptySet();
+  FindOverlapping(operation_index, 0, operation_index.interval_tree.size() - 1,
+                  first_column, last_column, result);
+  return result;
+}
+
+auto HWLibraryIndex::GetFittingModules(QueryOperationType operation,
+                                       const std::vector<int>& min_capacity)
+    const -> ModuleSet {
+  const auto& operation_index = GetOperationIndex(operation);
+  auto result = operation_index.all_modules;
+  for (int capacity_parameter_index = 0;
+       capacity_parameter_index < operation_index.capacity_thresholds.size();
+       capacity_parameter_index++) {
+    const auto& thresholds =
+        operation_index.capacity_thresholds.at(capacity_parameter_index);
+    auto threshold_index =
+        std::lower_bound(thresholds.begin(), thresholds.end(),
+                         min_capacity.at(capacity_parameter_index)) -
+        thresholds.begin();
+    if (threshold_index == thresholds.size()) {
+      return CreateEmptySet();
+    }
+    const auto& fitting_modules =
+        operation_index.capacity_sets.at(capacity_parameter_index)
+            .at(threshold_index);
+    for (int word_index = 0; word_index < result.size(); word_index++) {
+      result[word_index] &= fitting_modules[word_index];
+    }
+  }
+  return result;
+}
+
+auto HWLibraryIndex::IsFittingAt(QueryOperationType operation, int column,
+                                 const std::vector<int>& min_capacity) const
+    -> bool {
+  auto fitting_modules = GetFittingModules(operation, min_capacity);
+  const auto& [first, last] =
+      GetOperationIndex(operation).column_ranges.at(column);
+  for (int module_id = first; module_id < last; module_id++) {
+    if (IsInSet(fitting_modules, module_id)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+auto HWLibraryIndex::GetBitstreamLocations(QueryOperationType operation,
+                                           const ModuleSet& modules) const
+    -> std::vector<std::vector<std::string>> {
+  const auto& operation_index = GetOperationIndex(operation);
+  std::vector<std::vector<std::string>> bitstream_locations;
+  bitstream_locations.reserve(operation_index.column_ranges.size());
+  for (const auto& [first, last] : operation_index.column_ranges) {
+    auto& column_bitstreams = bitstream_locations.emplace_back();
+    for (int module_id = first; module_id < last; module_id++) {
+      if (IsInSet(modules, module_id)) {
+        column_bitstreams.push_back(modules_.at(module_id).bitstream);
+      }
+    }
+  }
+  return bitstream_locations;
+}
+
+auto HWLibraryIndex::IsInSet(const ModuleSet& modules, int module_id) -> bool {
+  return ((modules.at(module_id / kBitsPerWord) >> (module_id % kBitsPerWord)) &
+          1U) != 0U;
+}
+
+auto HWLibraryIndex::IsEmpty(const ModuleSet& modules) -> bool {
+  return std::all_of(modules.begin(), modules.end(),
+                     [](uint64_t word) { return word == 0; });
+}
+
+auto HWLibraryIndex::GetOperationIndex(QueryOperationType operation) const
+    -> const OperationIndex& {
+  auto search = operations_.find(operation);
+  if (search == operations_.end()) {
+    throw std::runtime_error("Operation is missing from the library!");
+  }
+  return search->second;
+}
+
+auto HWLibraryIndex::BuildIntervalTree(OperationIndex& operation_index,
+                                       int first, int last) -> int {
+  // The tree is implicit: The middle node of a range is the root of the
+  // subtree covering the range.
+  if (first > last) {
+    return -1;
+  }
+  int middle = first + (last - first) / 2;
+  auto& node = operation_index.interval_tree.at(middle);
+  node.max_end = std::max(
+      {node.end, BuildIntervalTree(operation_index, first, middle - 1),
+       BuildIntervalTree(operation_index, middle + 1, last)});
+  return node.max_end;
+}
+
+void HWLibraryIndex::BuildCapacityTables(
+    OperationIndex& operation_index) const {
+  operation_index.all_modules = CreateEmptySet();
+  int capacity_parameter_count = 0;
+  for (const auto& node : operation_index.interval_tree) {
+    AddToSet(operation_index.all_modules, node.module_id);
+    capacity_parameter_count =
+        std::max(capacity_parameter_count,
+                 static_cast<int>(modules_.at(node.module_id).capacity.size()));
+  }
+  for (int capacity_parameter_index = 0;
+       capacity_parameter_index < capacity_parameter_count;
+       capacity_parameter_index++) {
+    std::vector<int> thresholds;
+    for (const auto& node : operation_index.interval_tree) {
+      const auto& capacity = modules_.at(node.module_id).capacity;
+      if (capacity_parameter_index < capacity.size()) {
+        thresholds.push_back(capacity.at(capacity_parameter_index));
+      }
+    }
+    std::sort(thresholds.begin(), thresholds.end());
+    thresholds.erase(std::unique(thresholds.begin(), thresholds.end()),
+                     thresholds.end());
+
+    std::vector<ModuleSet> threshold_sets;
+    for (const auto& threshold : thresholds) {
+      auto& fitting_modules = threshold_sets.emplace_back(CreateEmptySet());
+      for (const auto& node : operation_index.interval_tree) {
+        const auto& capacity = modules_.at(node.module_id).capacity;
+        // Modules without the parameter aren't limited by it.
+        if (capacity_parameter_index >= capacity.size() ||
+            capacity.at(capacity_parameter_index) >= threshold) {
+          AddToSet(fitting_modules, node.module_id);
+        }
+      }
+    }
+    operation_index.capacity_thresholds.push_back(std::move(thresholds));
+    operation_index.capacity_sets.push_back(std::move(threshold_sets));
+  }
+}
+
+auto HWLibraryIndex::CreateEmptySet() const -> ModuleSet {
+  return ModuleSet((modules_.size() + kBitsPerWord - 1) / kBitsPerWord, 0);
+}
+
+void HWLibraryIndex::FindOverlapping(const OperationIndex& operation_index,
+                                     int first, int last, int first_column,
+                                     int last_column, ModuleSet& result) {
+  if (first > last) {
+    return;
+  }
+  int middle = first + (last - first) / 2;
+  const auto& node = operation_index.interval_tree.at(middle);
+  if (node.max_end < first_column) {
+    return;
+  }
+  FindOverlapping(operation_index, first, middle - 1, first_column,
+                  last_column, result);
+  if (node.start > last_column) {
+    return;
+  }
+  if (node.end >= first_column) {
+    AddToSet(result, node.module_id);
+  }
+  FindOverlapping(operation_index, middle + 1, last, first_column,
+                  last_column, result);
+}
+
+void HWLibraryIndex::AddToSet(ModuleSet& modules, int module_id) {
+  modules[module_id / kBitsPerWord] |= uint64_t{1}
+                                       << (module_id % kBitsPerWord);
+}
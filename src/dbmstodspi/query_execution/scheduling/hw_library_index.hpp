@@ -0,0 +1,191 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "operation_types.hpp"
+#include "pr_module_data.hpp"
+
+using orkhestrafs::core_interfaces::hw_library::OperationPRModules;
+using orkhestrafs::core_interfaces::operation_types::QueryOperationType;
+
+namespace orkhestrafs::dbmstodspi {
+
+/**
+ * @brief Class to compile the PR module library into lookup tables.
+ *
+ * Each bitstream start location gets a dense module ID. The IDs of an
+ * operation are ordered by start column and then by the order of the start
+ * location lists in the library such that ID order matches the library order.
+ * Module footprints are kept in an interval tree for each operation and
+ * capacity thresholds are turned into module sets to find fitting modules
+ * without scanning the library.
+ */
+class HWLibraryIndex {
+ public:
+  /// Set of module IDs. Bit i marks the module with ID i.
+  using ModuleSet = std::vector<uint64_t>;
+
+  /**
+   * @brief Placement data of a library bitstream.
+   */
+  struct ModulePlacement {
+    QueryOperationType operation;
+    std::string bitstream;
+    int start;
+    int end;
+    int location_index;
+    std::vector<int> capacity;
+  };
+
+  /**
+   * @brief Constructor to compile the given library.
+   * @param hw_library Map of PR modules available for each operation.
+   */
+  explicit HWLibraryIndex(
+      const std::map<QueryOperationType, OperationPRModules>& hw_library);
+
+  /**
+   * @brief Get the placement data of a module.
+   * @param module_id Dense module ID.
+   * @return Module placement.
+   */
+  auto GetModule(int module_id) const -> const ModulePlacement&;
+  /**
+   * @brief Get the module ID of a bitstream starting at the given column.
+   * @param operation Operation of the bitstream.
+   * @param column Start column.
+   * @param bitstream Bitstream file name.
+   * @return Module ID.
+   */
+  auto GetModuleId(QueryOperationType operation, int column,
+                   const std::string& bitstream) const -> int;
+  /**
+   * @brief Get an ID of a bitstream which doesn't depend on where it starts.
+   * @param operation Operation of the bitstream.
+   * @param bitstream Bitstream file name.
+   * @return ID of the first module placing the bitstream.
+   */
+  auto GetBitstreamId(QueryOperationType operation,
+                      const std::string& bitstream) const -> int;
+  /**
+   * @brief Get the module ID of the n-th bitstream starting at a column.
+   * @param operation Operation of the bitstream.
+   * @param column Start column.
+   * @param location_index Index in the library start location list.
+   * @return Module ID.
+   */
+  auto GetModuleId(QueryOperationType operation, int column,
+                   int location_index) const -> int;
+  /**
+   * @brief Find modules with footprints overlapping the given columns.
+   * @param operation Operation of the modules.
+   * @param first_column First column of the searched interval.
+   * @param last_column Last column of the searched interval.
+   * @return Set of overlapping modules.
+   */
+  auto GetOverlappingModules(QueryOperationType operation, int first_column,
+                             int last_column) const -> ModuleSet;
+  /**
+   * @brief Find modules meeting the given capacity requirements.
+   * @param operation Operation of the modules.
+   * @param min_capacity Minimum capacity values.
+   * @return Set of fitting modules.
+   */
+  auto GetFittingModules(QueryOperationType operation,
+                         const std::vector<int>& min_capacity) const
+      -> ModuleSet;
+  /**
+   * @brief Check if a module meeting the capacity requirements can start at
+   * the given column.
+   * @param operation Operation of the modules.
+   * @param column Start column.
+   * @param min_capacity Minimum capacity values.
+   * @return Boolean flag noting if there is a fitting module.
+   */
+  auto IsFittingAt(QueryOperationType operation, int column,
+                   const std::vector<int>& min_capacity) const -> bool;
+  /**
+   * @brief Get the bitstreams of the given modules in library order.
+   * @param operation Operation of the modules.
+   * @param modules Set of modules.
+   * @return Bitstream names for each start column.
+   */
+  auto GetBitstreamLocations(QueryOperationType operation,
+                             const ModuleSet& modules) const
+      -> std::vector<std::vector<std::string>>;
+  /**
+   * @brief Check if a module is in the given set.
+   * @param modules Set of modules.
+   * @param module_id Module ID.
+   * @return Boolean flag noting if the module is in the set.
+   */
+  static auto IsInSet(const ModuleSet& modules, int module_id) -> bool;
+  /**
+   * @brief Check if the given set is empty.
+   * @param modules Set of modules.
+   * @return Boolean flag noting if there are no modules in the set.
+   */
+  static auto IsEmpty(const ModuleSet& modules) -> bool;
+
+ private:
+  static const int kBitsPerWord = 64;
+
+  struct IntervalTreeNode {
+    int start;
+    int end;
+    int max_end;
+    int module_id;
+  };
+
+  struct OperationIndex {
+    int first_module_id = 0;
+    int module_count = 0;
+    // Module ID range for each start column.
+    std::vector<std::pair<int, int>> column_ranges;
+    std::unordered_map<std::string, int> bitstream_ids;
+    // Footprints sorted by start with the max end of each subtree.
+    std::vector<IntervalTreeNode> interval_tree;
+    // Sorted distinct capacity values of each capacity parameter and the set
+    // of modules reaching each of the values.
+    std::vector<std::vector<int>> capacity_thresholds;
+    std::vector<std::vector<ModuleSet>> capacity_sets;
+    ModuleSet all_modules;
+  };
+
+  std::vector<ModulePlacement> modules_;
+  std::unordered_map<QueryOperationType, OperationIndex> operations_;
+
+  auto GetOperationIndex(QueryOperationType operation) const
+      -> const OperationIndex&;
+  static auto BuildIntervalTree(OperationIndex& operation_index, int first,
+                                int last) -> int;
+  void BuildCapacityTables(OperationIndex& operation_index) const;
+  auto CreateEmptySet() const -> ModuleSet;
+  static void FindOverlapping(const OperationIndex& operation_index,
+                              int first, int last, int first_column,
+                              int last_column, ModuleSet& result);
+  static void AddToSet(ModuleSet& modules, int module_id);
+};
+
+}  // namespace orkhestrafs::dbmstodspi
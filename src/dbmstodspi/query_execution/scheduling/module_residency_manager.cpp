@@ -0,0 +1,107 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "module_residency_manager.hpp"
+
+#include <algorithm>
+#include <utility>
+
+using orkhestrafs::dbmstodspi::ModuleResidencyManager;
+using orkhestrafs::dbmstodspi::ResidencyStats;
+
+ModuleResidencyManager::ModuleResidencyManager(
+    std::string resource_string, std::map<char, int> cost_of_columns,
+    const std::vector<std::string>& pinned_bitstreams)
+    : resource_string_{std::move(resource_string)},
+      cost_of_columns_{std::move(cost_of_columns)},
+      pinned_bitstreams_{pinned_bitstreams.begin(), pinned_bitstreams.end()} {}
+
+void ModuleResidencyManager::Pin(const std::string& bitstream) {
+  pinned_bitstreams_.insert(bitstream);
+}
+
+void ModuleResidencyManager::Unpin(const std::string& bitstream) {
+  pinned_bitstreams_.erase(bitstream);
+}
+
+auto ModuleResidencyManager::IsPinned(const std::string& bitstream) const
+    -> bool {
+  return pinned_bitstreams_.find(bitstream) != pinned_bitstreams_.end();
+}
+
+auto ModuleResidencyManager::GetPinnedModules() const
+    -> const std::set<std::string>& {
+  return pinned_bitstreams_;
+}
+
+void ModuleResidencyManager::RecordRun(
+    const std::vector<ScheduledModule>& run,
+    const std::vector<ScheduledModule>& configuration_before) {
+  for (const auto& module : run) {
+    current_query_bitstreams_.insert(module.bitstream);
+    bool is_configured = std::any_of(
+        configuration_before.begin(), configuration_before.end(),
+        [&](const auto& configured_module) {
+          return configured_module.bitstream == module.bitstream &&
+                 configured_module.position == module.position;
+        });
+    if (is_configured) {
+      stats_.saved_bytes += GetModuleSize(module);
+    } else {
+      stats_.loaded_bytes += GetModuleSize(module);
+    }
+  }
+}
+
+void ModuleResidencyManager::FinishQuery() {
+  if (current_query_bitstreams_.empty()) {
+    return;
+  }
+  for (const auto& bitstream : current_query_bitstreams_) {
+    query_counts_[bitstream]++;
+  }
+  current_query_bitstreams_.clear();
+  stats_.query_count++;
+}
+
+auto ModuleResidencyManager::GetReuseWeights() const
+    -> std::map<std::string, double> {
+  std::map<std::string, double> reuse_weights;
+  if (stats_.query_count != 0) {
+    for (const auto& [bitstream, query_count] : query_counts_) {
+      reuse_weights.insert(
+          {bitstream, static_cast<double>(query_count) / stats_.query_count});
+    }
+  }
+  for (const auto& bitstream : pinned_bitstreams_) {
+    reuse_weights[bitstream] = 1;
+  }
+  return reuse_weights;
+}
+
+auto ModuleResidencyManager::GetStats() const -> ResidencyStats {
+  return stats_;
+}
+
+auto ModuleResidencyManager::GetModuleSize(const ScheduledModule& module) const
+    -> uintmax_t {
+  uintmax_t module_size = 0;
+  for (int column_i = module.position.first;
+       column_i < module.position.second + 1; column_i++) {
+    module_size += cost_of_columns_.at(resource_string_.at(column_i));
+  }
+  return module_size;
+}
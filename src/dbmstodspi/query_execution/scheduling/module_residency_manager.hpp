@@ -0,0 +1,109 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "scheduled_module.hpp"
+
+using orkhestrafs::dbmstodspi::ScheduledModule;
+
+namespace orkhestrafs::dbmstodspi {
+
+/**
+ * @brief Reconfiguration statistics over the whole workload.
+ */
+struct ResidencyStats {
+  int query_count;
+  uintmax_t loaded_bytes;
+  uintmax_t saved_bytes;
+};
+
+/**
+ * @brief Class to track which modules are used across queries to keep the
+ * frequently used modules configured.
+ */
+class ModuleResidencyManager {
+ public:
+  /**
+   * @brief Constructor to set the data needed to find module sizes.
+   * @param resource_string PR region resources.
+   * @param cost_of_columns Configuration data size of each column type.
+   * @param pinned_bitstreams Modules which should always stay configured.
+   */
+  ModuleResidencyManager(std::string resource_string,
+                         std::map<char, int> cost_of_columns,
+                         const std::vector<std::string>& pinned_bitstreams);
+
+  /**
+   * @brief Keep the given module configured whenever possible.
+   * @param bitstream Bitstream of the module.
+   */
+  void Pin(const std::string& bitstream);
+  /**
+   * @brief Treat the given module like any other module again.
+   * @param bitstream Bitstream of the module.
+   */
+  void Unpin(const std::string& bitstream);
+  auto IsPinned(const std::string& bitstream) const -> bool;
+  /**
+   * @brief Get the modules which plans shouldn't evict.
+   * @return Bitstreams of the pinned modules.
+   */
+  auto GetPinnedModules() const -> const std::set<std::string>&;
+
+  /**
+   * @brief Record the modules used by a run.
+   * @param run Modules of the run.
+   * @param configuration_before Modules configured before the run.
+   */
+  void RecordRun(const std::vector<ScheduledModule>& run,
+                 const std::vector<ScheduledModule>& configuration_before);
+  /**
+   * @brief Update the usage frequencies with the modules of the finished
+   * query. Nothing is counted if no runs were recorded.
+   */
+  void FinishQuery();
+
+  /**
+   * @brief Get how likely each module is to be used by the next query.
+   * Pinned modules are always expected to be reused.
+   * @return Map of bitstreams and their expected reuse between 0 and 1.
+   */
+  auto GetReuseWeights() const -> std::map<std::string, double>;
+  /**
+   * @brief Get how many configuration bytes were loaded and how many were
+   * saved by reusing configured modules.
+   * @return Workload statistics.
+   */
+  auto GetStats() const -> ResidencyStats;
+
+ private:
+  std::string resource_string_;
+  std::map<char, int> cost_of_columns_;
+  std::set<std::string> pinned_bitstreams_;
+  std::set<std::string> current_query_bitstreams_;
+  std::map<std::string, int> query_counts_;
+  ResidencyStats stats_ = {0, 0, 0};
+
+  auto GetModuleSize(const ScheduledModule& module) const -> uintmax_t;
+};
+
+}  // namespace orkhestrafs::dbmstodspi
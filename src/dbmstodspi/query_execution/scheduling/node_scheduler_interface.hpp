@@ -19,6 +19,8 @@ limitations under the License.
 #include <map>
 #include <memory>
 #include <queue>
+#include <set>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -55,6 +57,18 @@ class NodeSchedulerInterface {
 
   virtual ~NodeSchedulerInterface() = default;
 
+  /**
+   * @brief Set how likely modules are to be reused by later queries.
+   * @param module_reuse_weights Map of bitstreams and their expected reuse.
+   */
+  virtual void SetModuleReuseWeights(
+      std::map<std::string, double> module_reuse_weights) = 0;
+  /**
+   * @brief Set which modules plans should avoid evicting.
+   * @param pinned_modules Bitstreams of the pinned modules.
+   */
+  virtual void SetPinnedModules(std::set<std::string> pinned_modules) = 0;
+
   /**
    * @brief Find groups of accelerated query nodes which can be run in the
    * FPGA with multiple runs.
@@ -0,0 +1,496 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "plan_cache.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "logger.hpp"
+
+using orkhestrafs::dbmstodspi::PlanCache;
+using orkhestrafs::dbmstodspi::logging::Log;
+using orkhestrafs::dbmstodspi::logging::LogLevel;
+
+namespace {
+const uint64_t kFnvOffsetBasis = 14695981039346656037ULL;
+const uint64_t kFnvPrime = 1099511628211ULL;
+// Changed when the stored plans change such that older files are dropped.
+const int kFileVersion = 2;
+
+// FNV-1a to keep the fingerprint stable between builds.
+void HashString(uint64_t& hash, const std::string& value) {
+  for (const auto& character : value) {
+    hash ^= static_cast<unsigned char>(character);
+    hash *= kFnvPrime;
+  }
+  hash ^= 0xff;
+  hash *= kFnvPrime;
+}
+
+void AppendInts(std::string& key, const std::vector<int>& values) {
+  for (const auto& value : values) {
+    key += std::to_string(value) + ",";
+  }
+  key += ";";
+}
+
+// Bit width of the record count such that similar sizes share plans.
+auto GetRecordCountBucket(int record_count) -> int {
+  if (record_count <= 0) {
+    return record_count;
+  }
+  int bucket = 0;
+  while (record_count > 0) {
+    record_count >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+auto GetSortedStatusBucket(const TableMetadata& table) -> std::string {
+  if (table.sorted_status.empty()) {
+    return "unsorted";
+  }
+  if (table.sorted_status.size() == 4 &&
+      table.sorted_status.at(2) == table.record_count) {
+    return "sorted";
+  }
+  return "partial" + std::to_string(table.sorted_status.size() / 4);
+}
+
+auto GetTableShape(const TableMetadata& table) -> std::string {
+  return std::to_string(table.record_size) + ":" +
+         std::to_string(GetRecordCountBucket(table.record_count)) + ":" +
+         GetSortedStatusBucket(table);
+}
+
+// Renamed node or table. Names which aren't renamed are kept as they are.
+auto GetIndexName(const std::unordered_map<std::string, int>& indices,
+                  const std::string& name) -> std::string {
+  if (name.empty()) {
+    return name;
+  }
+  auto search = indices.find(name);
+  if (search == indices.end()) {
+    return "?" + name;
+  }
+  return std::to_string(search->second);
+}
+
+// Node data without names to order the nodes which are ready at once.
+auto GetNodeShape(const std::string& node_name, const SchedulingQueryNode& node,
+                  const std::unordered_map<std::string, int>& node_indices,
+                  const std::map<std::string, TableMetadata>& tables,
+                  const std::unordered_set<std::string>& available_nodes,
+                  const std::unordered_set<std::string>& processed_nodes,
+                  const std::unordered_set<std::string>& blocked_nodes)
+    -> std::string {
+  std::string shape;
+  for (const auto* node_set :
+       {&available_nodes, &processed_nodes, &blocked_nodes}) {
+    shape += node_set->find(node_name) != node_set->end() ? "1" : "0";
+  }
+  shape += ":" + std::to_string(static_cast<int>(node.operation)) + ":";
+  AppendInts(shape, node.capacity);
+  for (const auto& [before_node_name, stream_index] : node.before_nodes) {
+    shape += GetIndexName(node_indices, before_node_name) + "." +
+             std::to_string(stream_index) + ",";
+  }
+  shape += ";";
+  for (const auto& table_name : node.data_tables) {
+    auto search = tables.find(table_name);
+    shape += (search != tables.end() ? GetTableShape(search->second) : "-") +
+             ",";
+  }
+  shape += ";";
+  for (const auto& bitstreams : node.satisfying_bitstreams) {
+    for (const auto& bitstream : bitstreams) {
+      shape += bitstream + ",";
+    }
+    shape += ";";
+  }
+  return shape;
+}
+
+void WriteTable(std::ofstream& output_file, const std::string& prefix,
+                const std::string& table_name, const TableMetadata& table) {
+  output_file << prefix << " " << table_name << " " << table.record_size << " "
+              << table.record_count;
+  for (const auto& value : table.sorted_status) {
+    output_file << " " << value;
+  }
+  output_file << "\n";
+}
+
+void WritePlan(std::ofstream& output_file, const std::string& key,
+               const PlanCache::CachedPlan& cached_plan) {
+  output_file << "plan " << key << "\n";
+  for (const auto& run : cached_plan.plan) {
+    output_file << "run\n";
+    for (const auto& module : run) {
+      output_file << "module " << module.node_name << " "
+                  << static_cast<int>(module.operation_type) << " "
+                  << module.bitstream << " " << module.position.first << " "
+                  << module.position.second << " " << module.is_composed
+                  << "\n";
+    }
+  }
+  for (const auto& [table_name, table] : cached_plan.input_tables) {
+    WriteTable(output_file, "input_table", table_name, table);
+  }
+  output_file << "end\n";
+}
+
+auto ReadTable(std::istringstream& line_stream)
+    -> std::pair<std::string, TableMetadata> {
+  std::string table_name;
+  TableMetadata table = {};
+  line_stream >> table_name >> table.record_size >> table.record_count;
+  int value = 0;
+  while (line_stream >> value) {
+    table.sorted_status.push_back(value);
+  }
+  return {table_name, table};
+}
+}  // namespace
+
+PlanCache::PlanCache(std::string filename, const Config& config)
+    : filename_{std::move(filename)}, fingerprint_{GetFingerprint(config)} {
+  Load();
+}
+
+auto PlanCache::GetFingerprint(const Config& config) -> uint64_t {
+  uint64_t hash = kFnvOffsetBasis;
+  HashString(hash, std::to_string(kFileVersion));
+  HashString(hash, config.resource_string);
+  // Cost model inputs.
+  HashString(hash, std::to_string(config.streaming_speed) + ":" +
+                       std::to_string(config.configuration_speed));
+  for (const auto& [column_type, cost] : config.cost_of_columns) {
+    HashString(hash, std::string(1, column_type) + ":" + std::to_string(cost));
+  }
+  for (const auto& [bitstream, cost] : config.reconfiguration_costs) {
+    HashString(hash, bitstream + ":" + std::to_string(cost));
+  }
+  // Search setup.
+  std::string search_setup;
+  AppendInts(search_setup,
+             {config.heuristic_choice, config.reduce_single_runs,
+              config.use_max_runs_cap, config.prioritise_children,
+              config.use_single_runs, config.use_branch_and_bound,
+              config.use_anytime_scheduling, config.scheduler_beam_width,
+              config.scheduler_exact_node_limit});
+  for (const auto& value :
+       {config.utilites_scaler, config.config_written_scaler,
+        config.utility_per_frame_scaler,
+        config.scheduler_time_limit_in_seconds,
+        config.scheduler_latency_budget_in_milliseconds}) {
+    search_setup += std::to_string(value) + ",";
+  }
+  HashString(hash, search_setup);
+  for (const auto& [operation, operation_modules] : config.pr_hw_library) {
+    HashString(hash, std::to_string(static_cast<int>(operation)));
+    for (const auto& bitstreams : operation_modules.starting_locations) {
+      for (const auto& bitstream : bitstreams) {
+        HashString(hash, bitstream);
+      }
+      HashString(hash, "");
+    }
+    for (const auto& [bitstream, module_data] :
+         operation_modules.bitstream_map) {
+      std::string module_key;
+      AppendInts(module_key, module_data.fitting_locations);
+      AppendInts(module_key, module_data.capacity);
+      HashString(hash, bitstream + ":" + module_key +
+                           std::to_string(module_data.length) + ":" +
+                           module_data.resource_string + ":" +
+                           std::to_string(module_data.is_backwards));
+    }
+  }
+  return hash;
+}
+
+auto PlanCache::GetKey(
+    const std::unordered_set<std::string>& available_nodes,
+    const std::unordered_set<std::string>& processed_nodes,
+    const std::unordered_set<std::string>& blocked_nodes,
+    const std::unordered_map<std::string, SchedulingQueryNode>& graph,
+    const std::map<std::string, TableMetadata>& tables,
+    const std::vector<ScheduledModule>& current_configuration,
+    const std::map<std::string, double>& module_reuse_weights,
+    const std::set<std::string>& pinned_modules) -> Key {
+  // Nodes are renamed by their topological order. Nodes which are ready at
+  // the same time are ordered by their shape and only by name if it matches.
+  Key key;
+  std::unordered_map<std::string, int> node_indices;
+  std::set<std::string> unordered_nodes;
+  for (const auto& [node_name, node] : graph) {
+    unordered_nodes.insert(node_name);
+  }
+  while (!unordered_nodes.empty()) {
+    auto next_node = unordered_nodes.begin();
+    std::string next_node_shape;
+    bool is_ready_node_found = false;
+    for (auto it = unordered_nodes.begin(); it != unordered_nodes.end();
+         ++it) {
+      const auto& node = graph.at(*it);
+      if (!std::all_of(node.before_nodes.begin(), node.before_nodes.end(),
+                       [&](const auto& before_node) {
+                         return graph.find(before_node.first) == graph.end() ||
+                                node_indices.find(before_node.first) !=
+                                    node_indices.end();
+                       })) {
+        continue;
+      }
+      auto node_shape = GetNodeShape(*it, node, node_indices, tables,
+                                     available_nodes, processed_nodes,
+                                     blocked_nodes);
+      if (!is_ready_node_found || node_shape < next_node_shape) {
+        next_node = it;
+        next_node_shape = std::move(node_shape);
+        is_ready_node_found = true;
+      }
+    }
+    // Nodes in a cycle are ordered by name.
+    node_indices.insert({*next_node, key.node_names.size()});
+    key.node_names.push_back(*next_node);
+    unordered_nodes.erase(next_node);
+  }
+  std::unordered_map<std::string, int> table_indices;
+  for (const auto& node_name : key.node_names) {
+    for (const auto& table_name : graph.at(node_name).data_tables) {
+      if (!table_name.empty() &&
+          table_indices.insert({table_name, key.table_names.size()}).second) {
+        key.table_names.push_back(table_name);
+      }
+    }
+  }
+
+  for (const auto* node_set :
+       {&available_nodes, &processed_nodes, &blocked_nodes}) {
+    std::set<std::string> renamed_nodes;
+    for (const auto& node_name : *node_set) {
+      renamed_nodes.insert(GetIndexName(node_indices, node_name));
+    }
+    for (const auto& node_name : renamed_nodes) {
+      key.key += node_name + ",";
+    }
+    key.key += "|";
+  }
+
+  for (const auto& node_name : key.node_names) {
+    const auto& node = graph.at(node_name);
+    key.key += std::to_string(static_cast<int>(node.operation)) + ":";
+    AppendInts(key.key, node.capacity);
+    for (const auto& [before_node_name, stream_index] : node.before_nodes) {
+      key.key += GetIndexName(node_indices, before_node_name) + "." +
+                 std::to_string(stream_index) + ",";
+    }
+    key.key += ";";
+    for (const auto& after_node_name : node.after_nodes) {
+      key.key += GetIndexName(node_indices, after_node_name) + ",";
+    }
+    key.key += ";";
+    for (const auto& table_name : node.data_tables) {
+      key.key += GetIndexName(table_indices, table_name) + ",";
+    }
+    key.key += ";";
+    for (const auto& bitstreams : node.satisfying_bitstreams) {
+      for (const auto& bitstream : bitstreams) {
+        key.key += bitstream + ",";
+      }
+      key.key += ";";
+    }
+    key.key += "|";
+  }
+
+  for (const auto& table_name : key.table_names) {
+    auto search = tables.find(table_name);
+    if (search != tables.end()) {
+      key.key += GetIndexName(table_indices, table_name) + ":" +
+                 GetTableShape(search->second) + "|";
+    }
+  }
+
+  for (const auto& module : current_configuration) {
+    key.key += module.bitstream + ":" +
+               std::to_string(module.position.first) + ",";
+  }
+  key.key += "|";
+  for (const auto& [bitstream, weight] : module_reuse_weights) {
+    key.key += bitstream + "=" + std::to_string(weight) + ",";
+  }
+  key.key += "|";
+  for (const auto& bitstream : pinned_modules) {
+    key.key += bitstream + ",";
+  }
+  return key;
+}
+
+auto PlanCache::Find(const Key& key,
+                     const std::map<std::string, TableMetadata>& tables)
+    -> std::optional<CachedPlan> {
+  auto search = plans_.find(key.key);
+  if (search == plans_.end()) {
+    return std::nullopt;
+  }
+  CachedPlan cached_plan = {search->second.plan, {}};
+  for (const auto& [table_index, input_table] : search->second.input_tables) {
+    const auto& table_name = key.table_names.at(std::stoi(table_index));
+    auto table_search = tables.find(table_name);
+    if (table_search == tables.end() ||
+        !(table_search->second == input_table)) {
+      return std::nullopt;
+    }
+    cached_plan.input_tables.insert({table_name, input_table});
+  }
+  for (auto& run : cached_plan.plan) {
+    for (auto& module : run) {
+      module.node_name = key.node_names.at(std::stoi(module.node_name));
+    }
+  }
+  return cached_plan;
+}
+
+void PlanCache::Insert(const Key& key,
+                       const std::vector<std::vector<ScheduledModule>>& plan,
+                       const std::map<std::string, TableMetadata>&
+                           resulting_tables,
+                       const std::map<std::string, TableMetadata>& tables) {
+  std::unordered_map<std::string, int> node_indices;
+  for (int node_index = 0; node_index < key.node_names.size(); node_index++) {
+    node_indices.insert({key.node_names.at(node_index), node_index});
+  }
+  std::unordered_map<std::string, int> table_indices;
+  for (int table_index = 0; table_index < key.table_names.size();
+       table_index++) {
+    table_indices.insert({key.table_names.at(table_index), table_index});
+  }
+  CachedPlan cached_plan = {plan, {}};
+  for (auto& run : cached_plan.plan) {
+    for (auto& module : run) {
+      auto search = node_indices.find(module.node_name);
+      if (search == node_indices.end()) {
+        Log(LogLevel::kDebug,
+            "Plan with " + module.node_name + " isn't cached.");
+        return;
+      }
+      module.node_name = std::to_string(search->second);
+    }
+  }
+  for (const auto& [table_name, resulting_table] : resulting_tables) {
+    auto search = tables.find(table_name);
+    if (search != tables.end() && !(search->second == resulting_table)) {
+      auto index_search = table_indices.find(table_name);
+      if (index_search == table_indices.end()) {
+        Log(LogLevel::kDebug, "Plan with " + table_name + " isn't cached.");
+        return;
+      }
+      cached_plan.input_tables.insert(
+          {std::to_string(index_search->second), search->second});
+    }
+  }
+  const auto& [it, inserted] =
+      plans_.insert_or_assign(key.key, std::move(cached_plan));
+  if (is_file_loaded_) {
+    Append(it->first, it->second);
+  } else {
+    Save();
+    is_file_loaded_ = true;
+  }
+}
+
+auto PlanCache::GetPlanCount() const -> int { return plans_.size(); }
+
+void PlanCache::Load() {
+  std::ifstream input_file(filename_);
+  if (!input_file) {
+    return;
+  }
+  uint64_t file_fingerprint = 0;
+  if (!(input_file >> file_fingerprint) ||
+      file_fingerprint != fingerprint_) {
+    Log(LogLevel::kInfo, "Plan cache " + filename_ +
+                             " is for a different HW library or scheduler "
+                             "setup.");
+    return;
+  }
+  std::string line;
+  std::string key;
+  CachedPlan cached_plan = {};
+  int entry_count = 0;
+  while (std::getline(input_file, line)) {
+    std::istringstream line_stream(line);
+    std::string entry_type;
+    line_stream >> entry_type;
+    if (entry_type == "plan") {
+      line_stream >> key;
+      cached_plan = {};
+    } else if (entry_type == "run") {
+      cached_plan.plan.emplace_back();
+    } else if (entry_type == "module") {
+      if (cached_plan.plan.empty()) {
+        throw std::runtime_error("Module without a run in: " + filename_);
+      }
+      ScheduledModule module = {};
+      int operation = 0;
+      line_stream >> module.node_name >> operation >> module.bitstream >>
+          module.position.first >> module.position.second >>
+          module.is_composed;
+      module.operation_type = static_cast<QueryOperationType>(operation);
+      cached_plan.plan.back().push_back(std::move(module));
+    } else if (entry_type == "input_table") {
+      cached_plan.input_tables.insert(ReadTable(line_stream));
+    } else if (entry_type == "end") {
+      // Replaced plans are appended after the old ones.
+      plans_.insert_or_assign(key, std::move(cached_plan));
+      entry_count++;
+    } else if (!entry_type.empty()) {
+      throw std::runtime_error("Unknown plan cache entry: " + entry_type);
+    }
+  }
+  input_file.close();
+  is_file_loaded_ = true;
+  if (entry_count > plans_.size()) {
+    Save();
+  }
+}
+
+void PlanCache::Save() const {
+  std::ofstream output_file(filename_, std::ios::trunc);
+  if (!output_file) {
+    throw std::runtime_error("Couldn't open: " + filename_);
+  }
+  output_file << fingerprint_ << "\n";
+  for (const auto& [key, cached_plan] : plans_) {
+    WritePlan(output_file, key, cached_plan);
+  }
+}
+
+void PlanCache::Append(const std::string& key,
+                       const CachedPlan& cached_plan) const {
+  std::ofstream output_file(filename_, std::ios::app);
+  if (!output_file) {
+    throw std::runtime_error("Couldn't open: " + filename_);
+  }
+  WritePlan(output_file, key, cached_plan);
+}
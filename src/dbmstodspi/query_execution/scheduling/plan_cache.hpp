@@ -0,0 +1,147 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "config.hpp"
+#include "operation_types.hpp"
+#include "pr_module_data.hpp"
+#include "scheduled_module.hpp"
+#include "scheduling_query_node.hpp"
+#include "table_data.hpp"
+
+using orkhestrafs::core_interfaces::Config;
+using orkhestrafs::core_interfaces::hw_library::OperationPRModules;
+using orkhestrafs::core_interfaces::operation_types::QueryOperationType;
+using orkhestrafs::core_interfaces::table_data::TableMetadata;
+using orkhestrafs::dbmstodspi::ScheduledModule;
+using orkhestrafs::dbmstodspi::SchedulingQueryNode;
+
+namespace orkhestrafs::dbmstodspi {
+
+/**
+ * @brief Class to store chosen execution plans on disk to skip scheduling
+ * query graphs which have been scheduled before.
+ *
+ * Plans are keyed by the graph, the table sizes rounded to powers of two,
+ * the current FPGA configuration and the module reuse settings. Nodes and
+ * tables are renamed by their topological order in the key and the stored
+ * plans such that queries with the same shape share plans. The cache file is
+ * dropped if it was written for a different HW library, resource string,
+ * cost model or search setup. Only the plan is reused such that the
+ * scheduling data is found by replaying it with the current tables.
+ */
+class PlanCache {
+ public:
+  /**
+   * @brief Chosen plan with the tables it depends on.
+   */
+  struct CachedPlan {
+    std::vector<std::vector<ScheduledModule>> plan;
+    /// Exact input statistics of the tables the plan changes.
+    std::map<std::string, TableMetadata> input_tables;
+  };
+
+  /**
+   * @brief Cache key with the names of the renamed nodes and tables.
+   */
+  struct Key {
+    std::string key;
+    /// Node names in their topological order.
+    std::vector<std::string> node_names;
+    /// Table names in the order they are first used by the ordered nodes.
+    std::vector<std::string> table_names;
+  };
+
+  /**
+   * @brief Constructor to load the cached plans from the given file.
+   * @param filename Where the plans are stored. Created if it is missing.
+   * @param config Library, cost model and search setup the plans are
+   * scheduled with.
+   */
+  PlanCache(std::string filename, const Config& config);
+
+  /**
+   * @brief Create the cache key of a scheduling problem.
+   * @param available_nodes Nodes which can be scheduled first.
+   * @param processed_nodes Nodes which are already processed.
+   * @param blocked_nodes Nodes which can't be scheduled.
+   * @param graph Preprocessed graph.
+   * @param tables Table statistics.
+   * @param current_configuration Currently configured modules.
+   * @param module_reuse_weights Reuse weights of the modules.
+   * @param pinned_modules Modules which shouldn't be evicted.
+   * @return Key which is equal for problems with the same graph shape and
+   * similar table sizes.
+   */
+  static auto GetKey(
+      const std::unordered_set<std::string>& available_nodes,
+      const std::unordered_set<std::string>& processed_nodes,
+      const std::unordered_set<std::string>& blocked_nodes,
+      const std::unordered_map<std::string, SchedulingQueryNode>& graph,
+      const std::map<std::string, TableMetadata>& tables,
+      const std::vector<ScheduledModule>& current_configuration,
+      const std::map<std::string, double>& module_reuse_weights,
+      const std::set<std::string>& pinned_modules) -> Key;
+
+  /**
+   * @brief Find a cached plan.
+   * @param key Key of the scheduling problem.
+   * @param tables Current table statistics.
+   * @return Plan with the node names of the key. Empty if there is no plan
+   * for the key or the tables the plan changes don't match exactly.
+   */
+  auto Find(const Key& key,
+            const std::map<std::string, TableMetadata>& tables)
+      -> std::optional<CachedPlan>;
+  /**
+   * @brief Store a chosen plan and append it to the cache file. Plans with
+   * nodes or tables which aren't in the key aren't stored.
+   * @param key Key of the scheduling problem.
+   * @param plan Chosen plan.
+   * @param resulting_tables Table statistics after the plan.
+   * @param tables Table statistics before the plan.
+   */
+  void Insert(const Key& key,
+              const std::vector<std::vector<ScheduledModule>>& plan,
+              const std::map<std::string, TableMetadata>& resulting_tables,
+              const std::map<std::string, TableMetadata>& tables);
+
+  [[nodiscard]] auto GetPlanCount() const -> int;
+
+ private:
+  static auto GetFingerprint(const Config& config) -> uint64_t;
+  void Load();
+  void Save() const;
+  void Append(const std::string& key, const CachedPlan& cached_plan) const;
+
+  const std::string filename_;
+  const uint64_t fingerprint_;
+  std::map<std::string, CachedPlan> plans_;
+  // Whether the file has the plans with the current fingerprint.
+  bool is_file_loaded_ = false;
+};
+
+}  // namespace orkhestrafs::dbmstodspi
@@ -0,0 +1,280 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "plan_cost_estimator.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <set>
+#include <utility>
+
+#include "module_selection.hpp"
+#include "plan_evaluator.hpp"
+
+using orkhestrafs::dbmstodspi::PlanCostEstimator;
+using orkhestrafs::dbmstodspi::PlanEvaluator;
+using orkhestrafs::dbmstodspi::SchedulingGraphIndex;
+
+namespace {
+// Same column count as the PlanEvaluator routing.
+const int kColumnCount = 31;
+}  // namespace
+
+PlanCostEstimator::PlanCostEstimator(
+    const std::map<QueryOperationType, OperationPRModules>& hw_library,
+    std::string resource_string, double streaming_speed,
+    ReconfigurationCostModel cost_model,
+    std::vector<ScheduledModule> current_configuration,
+    std::map<std::string, double> module_reuse_weights,
+    std::set<std::string> pinned_modules)
+    : resource_string_{std::move(resource_string)},
+      streaming_speed_{streaming_speed},
+      cost_model_{std::move(cost_model)},
+      current_configuration_{std::move(current_configuration)},
+      module_reuse_weights_{std::move(module_reuse_weights)},
+      pinned_modules_{std::move(pinned_modules)},
+      fixed_overhead_{static_cast<long>(cost_model_.GetFixedOverhead())} {
+  auto get_reuse_savings = [&](const std::string& bitstream, double cost) {
+    auto search = module_reuse_weights_.find(bitstream);
+    return search == module_reuse_weights_.end()
+               ? 0.0
+               : std::max(0.0, search->second) * cost;
+  };
+  // Any of the placed or already configured modules can be reused.
+  double reuse_savings = 0;
+  for (const auto& [operation, operation_modules] : hw_library) {
+    long cheapest_cost = std::numeric_limits<long>::max();
+    for (int column = 0; column < operation_modules.starting_locations.size();
+         column++) {
+      for (const auto& bitstream :
+           operation_modules.starting_locations.at(column)) {
+        auto cost = cost_model_.GetBitstreamCost(
+            bitstream,
+            resource_string_.substr(
+                std::min<int>(column, resource_string_.size()),
+                operation_modules.bitstream_map.at(bitstream).length));
+        cheapest_cost = std::min(cheapest_cost, static_cast<long>(cost));
+        reuse_savings += get_reuse_savings(bitstream, cost);
+      }
+    }
+    if (cheapest_cost != std::numeric_limits<long>::max()) {
+      cheapest_module_costs_.insert({operation, cheapest_cost});
+    }
+  }
+  for (const auto& module : current_configuration_) {
+    reuse_savings += get_reuse_savings(
+        module.bitstream,
+        cost_model_.GetBitstreamCost(
+            module.bitstream,
+            resource_string_.substr(
+                module.position.first,
+                module.position.second - module.position.first + 1)));
+  }
+  max_reuse_savings_ = static_cast<long>(reuse_savings);
+}
+
+auto PlanCostEstimator::GetPlanCost(
+    const std::vector<std::vector<ScheduledModule>>& plan,
+    long streamed_data_size, std::vector<ConfiguredRun>& configured_runs) const
+    -> double {
+  const auto& configured_run =
+      GetConfiguredRun(plan, plan.size(), configured_runs);
+  auto reuse_savings = PlanEvaluator::FindExpectedReuseSavings(
+      configured_run.configuration, resource_string_, cost_model_,
+      module_reuse_weights_);
+  return streamed_data_size / streaming_speed_ +
+         (configured_run.configuration_cost - reuse_savings);
+}
+
+auto PlanCostEstimator::GetPinnedEvictionCount(
+    const std::vector<std::vector<ScheduledModule>>& plan,
+    std::vector<ConfiguredRun>& configured_runs) const -> int {
+  return PlanEvaluator::FindPinnedEvictionCount(
+      current_configuration_,
+      GetConfiguredRun(plan, plan.size(), configured_runs).configuration,
+      pinned_modules_);
+}
+
+auto PlanCostEstimator::GetLowerBound(
+    const SchedulingSearchState& state,
+    std::vector<ConfiguredRun>& configured_runs) const -> double {
+  const auto& finished_runs = state.GetCurrentPlan();
+  return GetEstimatedCost(state, GetConfiguredRun(finished_runs,
+                                                  finished_runs.size(),
+                                                  configured_runs));
+}
+
+auto PlanCostEstimator::GetPartialPlanCost(
+    const SchedulingSearchState& state,
+    std::vector<ConfiguredRun>& configured_runs) const -> double {
+  auto plan = state.GetCurrentPlan();
+  if (!state.GetCurrentRun().empty()) {
+    plan.push_back(state.GetCurrentRun());
+  }
+  return GetEstimatedCost(
+      state, GetConfiguredRun(plan, plan.size(), configured_runs));
+}
+
+auto PlanCostEstimator::GetFinishedRunsCost(
+    const SchedulingSearchState& state,
+    std::vector<ConfiguredRun>& configured_runs) const -> double {
+  const auto& finished_runs = state.GetCurrentPlan();
+  return state.GetStreamedDataSize() / streaming_speed_ +
+         GetConfiguredRun(finished_runs, finished_runs.size(), configured_runs)
+             .configuration_cost;
+}
+
+auto PlanCostEstimator::GetConfigurationHash(
+    const SchedulingSearchState& state,
+    std::vector<ConfiguredRun>& configured_runs) const -> std::size_t {
+  const auto& configured_run =
+      GetFinishedRunsConfiguration(state, configured_runs);
+  std::size_t configuration_hash = 0;
+  for (const auto& module : configured_run.configuration) {
+    hash_combine(configuration_hash, module.bitstream);
+    hash_combine(configuration_hash, module.position.first);
+    hash_combine(configuration_hash, module.position.second);
+  }
+  for (const auto& routed_module : configured_run.routing) {
+    hash_combine(configuration_hash, routed_module);
+  }
+  return configuration_hash;
+}
+
+auto PlanCostEstimator::GetFinishedRunsConfiguration(
+    const SchedulingSearchState& state,
+    std::vector<ConfiguredRun>& configured_runs) const
+    -> const ConfiguredRun& {
+  const auto& finished_runs = state.GetCurrentPlan();
+  return GetConfiguredRun(finished_runs, finished_runs.size(),
+                          configured_runs);
+}
+
+auto PlanCostEstimator::GetEstimatedCost(
+    const SchedulingSearchState& state,
+    const ConfiguredRun& configured_run) const -> double {
+  using NodeSet = SchedulingSearchState::NodeSet;
+  const auto& current_run = state.GetCurrentRun();
+  const auto& blocked_nodes = state.GetNodes(NodeSet::kBlocked);
+  const auto& next_run_blocked_nodes = state.GetNodes(NodeSet::kNextRunBlocked);
+
+  long streamed_data_size = state.GetStreamedDataSize();
+  std::set<QueryOperationType> missing_operations;
+  // Available nodes which aren't blocked get placed before the search ends.
+  for (const auto& node_id :
+       SchedulingGraphIndex::GetNodeIds(state.GetNodes(NodeSet::kAvailable))) {
+    const auto& node_name = state.GetGraphIndex().GetNodeName(node_id);
+    if (SchedulingGraphIndex::IsInSet(blocked_nodes, node_id) ||
+        SchedulingGraphIndex::IsInSet(next_run_blocked_nodes, node_id) ||
+        std::any_of(current_run.begin(), current_run.end(),
+                    [&](const auto& module) {
+                      return module.node_name == node_name;
+                    })) {
+      continue;
+    }
+    streamed_data_size += GetRemainingStreamedDataSize(state, node_id);
+    auto operation = state.GetNode(node_id).operation;
+    auto has_operation = [&](const auto& module) {
+      return module.operation_type == operation;
+    };
+    if (std::none_of(current_run.begin(), current_run.end(), has_operation) &&
+        std::none_of(configured_run.configuration.begin(),
+                     configured_run.configuration.end(), has_operation)) {
+      missing_operations.insert(operation);
+    }
+  }
+
+  long configuration_cost =
+      configured_run.configuration_cost - max_reuse_savings_;
+  for (const auto& operation : missing_operations) {
+    auto search = cheapest_module_costs_.find(operation);
+    if (search != cheapest_module_costs_.end()) {
+      configuration_cost += search->second;
+    }
+  }
+  if (!missing_operations.empty()) {
+    configuration_cost += fixed_overhead_;
+  }
+  return streamed_data_size / streaming_speed_ + configuration_cost;
+}
+
+auto PlanCostEstimator::GetConfiguredRun(
+    const std::vector<std::vector<ScheduledModule>>& plan, int run_count,
+    std::vector<ConfiguredRun>& configured_runs) const
+    -> const ConfiguredRun& {
+  if (configured_runs.empty()) {
+    std::vector<std::string> routing(kColumnCount, "RT");
+    for (const auto& module : current_configuration_) {
+      for (int column = module.position.first;
+           column <= module.position.second; column++) {
+        routing.at(column) = module.bitstream;
+      }
+    }
+    configured_runs.push_back(
+        {{}, 0, current_configuration_, std::move(routing)});
+  }
+  // Only the runs which differ from the previous plan are configured again.
+  for (int run_index = 0; run_index < run_count; run_index++) {
+    if (run_index + 1 < configured_runs.size() &&
+        configured_runs.at(run_index + 1).run == plan.at(run_index)) {
+      continue;
+    }
+    configured_runs.erase(configured_runs.begin() + run_index + 1,
+                          configured_runs.end());
+    const auto& previous_run = configured_runs.back();
+    auto routing = previous_run.routing;
+    auto [configuration_cost, configuration] =
+        PlanEvaluator::FindConfigWrittenForConfiguration(
+            plan.at(run_index), previous_run.configuration, routing,
+            resource_string_, cost_model_);
+    configured_runs.push_back(
+        {plan.at(run_index),
+         previous_run.configuration_cost + configuration_cost,
+         std::move(configuration), std::move(routing)});
+  }
+  return configured_runs.at(run_count);
+}
+
+auto PlanCostEstimator::GetRemainingStreamedDataSize(
+    const SchedulingSearchState& state, int node_id) -> long {
+  const auto& node = state.GetNode(node_id);
+  const auto& current_run = state.GetCurrentRun();
+  long streamed_data_size = 0;
+  for (int table_index = 0; table_index < node.data_tables.size();
+       table_index++) {
+    const auto& table_name = node.data_tables.at(table_index);
+    if (table_name.empty()) {
+      continue;
+    }
+    // Data from a module in the current run doesn't have to be streamed.
+    if (table_index < node.before_nodes.size() &&
+        std::any_of(current_run.begin(), current_run.end(),
+                    [&](const auto& module) {
+                      return module.node_name ==
+                             node.before_nodes.at(table_index).first;
+                    })) {
+      continue;
+    }
+    const auto& table =
+        state.GetTable(state.GetGraphIndex().GetTableId(table_name));
+    if (table) {
+      // Record size is in 4 byte words
+      streamed_data_size += table->record_count * table->record_size * 4;
+    }
+  }
+  return streamed_data_size;
+}
@@ -0,0 +1,173 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "pr_module_data.hpp"
+#include "reconfiguration_cost_model.hpp"
+#include "scheduled_module.hpp"
+#include "scheduling_search_state.hpp"
+
+using orkhestrafs::core_interfaces::hw_library::OperationPRModules;
+using orkhestrafs::dbmstodspi::ReconfigurationCostModel;
+using orkhestrafs::dbmstodspi::ScheduledModule;
+using orkhestrafs::dbmstodspi::SchedulingSearchState;
+
+namespace orkhestrafs::dbmstodspi {
+
+/**
+ * @brief Class to find plan costs while the plans are being searched.
+ *
+ * Costs are the same as the ones the PlanEvaluator uses to choose the best
+ * plan: streamed data divided by the streaming speed and the configuration
+ * time reduced by the expected module reuse savings. Plans which evict fewer
+ * pinned modules are preferred regardless of the cost as well. The lower
+ * bound of a search state never exceeds the cost of any plan found from the
+ * state.
+ */
+class PlanCostEstimator {
+ public:
+  /**
+   * @brief Configuration after a run. Cached for the runs of a plan.
+   */
+  struct ConfiguredRun {
+    std::vector<ScheduledModule> run;
+    // Configuration cost of all runs up to and including this one.
+    long configuration_cost;
+    std::vector<ScheduledModule> configuration;
+    std::vector<std::string> routing;
+  };
+
+  PlanCostEstimator(
+      const std::map<QueryOperationType, OperationPRModules>& hw_library,
+      std::string resource_string, double streaming_speed,
+      ReconfigurationCostModel cost_model,
+      std::vector<ScheduledModule> current_configuration,
+      std::map<std::string, double> module_reuse_weights,
+      std::set<std::string> pinned_modules);
+
+  /**
+   * @brief Get the cost of a complete plan.
+   * @param plan Runs of the plan.
+   * @param streamed_data_size Data streamed by the plan.
+   * @param configured_runs Cached configurations of the previous plan.
+   * @return Plan cost in microseconds.
+   */
+  auto GetPlanCost(const std::vector<std::vector<ScheduledModule>>& plan,
+                   long streamed_data_size,
+                   std::vector<ConfiguredRun>& configured_runs) const
+      -> double;
+  /**
+   * @brief Get how many pinned modules a complete plan evicts. Plans are
+   * compared by this count before the cost.
+   * @param plan Runs of the plan.
+   * @param configured_runs Cached configurations of the previous plan.
+   * @return Number of evicted pinned modules.
+   */
+  auto GetPinnedEvictionCount(
+      const std::vector<std::vector<ScheduledModule>>& plan,
+      std::vector<ConfiguredRun>& configured_runs) const -> int;
+  /**
+   * @brief Get the lowest cost any plan found from the given state can have.
+   *
+   * The bound has the data every available node which isn't blocked streams
+   * from memory as a plan is only finished once these are placed. The
+   * finished runs are configured the same way as in the plan evaluator.
+   * Modules are only reused with the same operation, so each operation
+   * without a module in the current run or the configuration costs at least
+   * its cheapest module and the fixed overhead. The reuse savings can't
+   * exceed the savings of every module in the library.
+   * @param state Search state.
+   * @param configured_runs Cached configurations of the previous plan.
+   * @return Lower bound of the plan costs in microseconds.
+   */
+  auto GetLowerBound(const SchedulingSearchState& state,
+                     std::vector<ConfiguredRun>& configured_runs) const
+      -> double;
+  /**
+   * @brief Estimate the cost of the plans found from the given state to rank
+   * partial plans against each other.
+   *
+   * Unlike the lower bound the current run is configured as if it was
+   * finished. Otherwise modules placed in the current run would look free.
+   * @param state Search state.
+   * @param configured_runs Cached configurations of the previous plan.
+   * @return Estimated plan cost in microseconds.
+   */
+  auto GetPartialPlanCost(const SchedulingSearchState& state,
+                          std::vector<ConfiguredRun>& configured_runs) const
+      -> double;
+  /**
+   * @brief Get the cost of the data streamed so far and of configuring the
+   * finished runs of the given state.
+   * @param state Search state.
+   * @param configured_runs Cached configurations of the previous plan.
+   * @return Cost in microseconds.
+   */
+  auto GetFinishedRunsCost(const SchedulingSearchState& state,
+                           std::vector<ConfiguredRun>& configured_runs) const
+      -> double;
+  /**
+   * @brief Get the hash of the modules and routing the finished runs of the
+   * given state leave on the FPGA. How much the following runs cost only
+   * depends on this configuration and not on the runs before it.
+   * @param state Search state.
+   * @param configured_runs Cached configurations of the previous plan.
+   * @return Hash of the FPGA configuration.
+   */
+  auto GetConfigurationHash(const SchedulingSearchState& state,
+                            std::vector<ConfiguredRun>& configured_runs) const
+      -> std::size_t;
+  /**
+   * @brief Get the modules and routing the finished runs of the given state
+   * leave on the FPGA.
+   * @param state Search state.
+   * @param configured_runs Cached configurations of the previous plan.
+   * @return Configuration after the last finished run. Only valid until
+   * configured_runs changes.
+   */
+  auto GetFinishedRunsConfiguration(
+      const SchedulingSearchState& state,
+      std::vector<ConfiguredRun>& configured_runs) const
+      -> const ConfiguredRun&;
+
+ private:
+  std::string resource_string_;
+  double streaming_speed_;
+  ReconfigurationCostModel cost_model_;
+  std::vector<ScheduledModule> current_configuration_;
+  std::map<std::string, double> module_reuse_weights_;
+  std::set<std::string> pinned_modules_;
+  std::map<QueryOperationType, long> cheapest_module_costs_;
+  long fixed_overhead_;
+  long max_reuse_savings_;
+
+  auto GetConfiguredRun(const std::vector<std::vector<ScheduledModule>>& plan,
+                        int run_count,
+                        std::vector<ConfiguredRun>& configured_runs) const
+      -> const ConfiguredRun&;
+  auto GetEstimatedCost(const SchedulingSearchState& state,
+                        const ConfiguredRun& configured_run) const -> double;
+  static auto GetRemainingStreamedDataSize(const SchedulingSearchState& state,
+                                           int node_id) -> long;
+};
+
+}  // namespace orkhestrafs::dbmstodspi
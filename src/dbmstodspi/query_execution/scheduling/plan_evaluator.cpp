@@ -21,6 +21,7 @@ limitations under the License.
 #include <numeric>
 #include <set>
 #include <stdexcept>
+#include <utility>
 
 #include "bitstream_config_helper.hpp"
 
@@ -43,8 +44,9 @@ auto PlanEvaluator::FindConfigWrittenForConfiguration(
     const std::vector<ScheduledModule>& next_config,
     const std::vector<ScheduledModule>& current_config,
     std::vector<std::string>& current_routing,
-    const std::map<std::string, int>& cost_of_bitstreams)
-    -> std::pair<int, std::vector<ScheduledModule>> {
+    const std::string& resource_string,
+    const ReconfigurationCostModel& cost_model)
+    -> std::pair<long, std::vector<ScheduledModule>> {
 
   std::vector<int> written_frames(31, 0);
 
@@ -73,14 +75,20 @@ auto PlanEvaluator::FindConfigWrittenForConfiguration(
     }
   }
 
-  std::vector<std::string> required_bitstreams;
+  double cost = 0;
+  int loaded_bitstream_count = 0;
   for (const auto& new_module : reduced_next_config) {
     for (int column_i = new_module.position.first;
          column_i < new_module.position.second + 1; column_i++) {
       written_frames[column_i] = 0;
       current_routing[column_i] = new_module.bitstream;
     }
-    required_bitstreams.push_back(new_module.bitstream);
+    cost += cost_model.GetBitstreamCost(
+        new_module.bitstream,
+        resource_string.substr(
+            new_module.position.first,
+            new_module.position.second - new_module.position.first + 1));
+    loaded_bitstream_count++;
   }
 
   auto left_over_config = BitstreamConfigHelper::GetResultingConfig(
@@ -96,31 +104,29 @@ auto PlanEvaluator::FindConfigWrittenForConfiguration(
   int furthest_required_column = next_config.back().position.second;
   // 2.Check if there is a connection from beginning - if not add RT
   // And find all passthrough modules
-  std::unordered_map<std::string, QueryOperationType> old_operations;
-  for (const auto& prev_module : current_config) {
-    old_operations.insert({prev_module.bitstream, prev_module.operation_type});
-  }
-  std::unordered_map<std::string, QueryOperationType> new_operations;
-  for (const auto& new_module : next_config) {
-    new_operations.insert({new_module.bitstream, new_module.operation_type});
-  }
+  // The configurations only have a few modules so they are searched directly.
+  auto has_bitstream = [](const std::vector<ScheduledModule>& configuration,
+                          const std::string& bitstream) {
+    return std::any_of(
+        configuration.begin(), configuration.end(),
+        [&](const auto& module) { return module.bitstream == bitstream; });
+  };
 
   std::string last_seen_bitstream = "";
   for (int column_i = 0; column_i <= furthest_required_column; column_i++) {
     if (current_routing[column_i].empty() ||
         current_routing[column_i] == "TAA") {
       current_routing[column_i] = "RT";
-      required_bitstreams.push_back("RT");
+      cost += cost_model.GetRoutingCost(column_i);
+      loaded_bitstream_count++;
     } else if (last_seen_bitstream == current_routing[column_i] ||
                current_routing[column_i] == "RT") {
       // Do nothing
     } else if (last_seen_bitstream != current_routing[column_i] &&
-               new_operations.find(current_routing[column_i]) !=
-                   new_operations.end()) {
+               has_bitstream(next_config, current_routing[column_i])) {
       last_seen_bitstream = current_routing[column_i];
     } else if (last_seen_bitstream != current_routing[column_i] &&
-               old_operations.find(current_routing[column_i]) !=
-                   old_operations.end()) {
+               has_bitstream(current_config, current_routing[column_i])) {
       last_seen_bitstream = current_routing[column_i];
     } else {
       throw std::runtime_error("Unknown routing bitstream");
@@ -133,7 +139,8 @@ auto PlanEvaluator::FindConfigWrittenForConfiguration(
        column_i < 31; column_i++) {
     if (current_routing[column_i].empty()) {
       current_routing[column_i] = "TAA";
-      required_bitstreams.push_back("RT");
+      cost += cost_model.GetTurnaroundCost(column_i);
+      loaded_bitstream_count++;
       break;
     } else if (current_routing[column_i] == "TAA") {
       break;
@@ -141,32 +148,29 @@ auto PlanEvaluator::FindConfigWrittenForConfiguration(
                current_routing[column_i] == "RT") {
       // Do nothing
     } else if (last_seen_bitstream != current_routing[column_i] &&
-               new_operations.find(current_routing[column_i]) !=
-                   new_operations.end()) {
+               has_bitstream(next_config, current_routing[column_i])) {
       last_seen_bitstream = current_routing[column_i];
     } else if (last_seen_bitstream != current_routing[column_i] &&
-               old_operations.find(current_routing[column_i]) !=
-                   old_operations.end()) {
+               has_bitstream(current_config, current_routing[column_i])) {
       last_seen_bitstream = current_routing[column_i];
     } else {
       throw std::runtime_error("Unknown routing bitstream");
     }
   }
 
-  int cost = 0;
-  for (const auto& bitstream : required_bitstreams){
-    cost+=cost_of_bitstreams.at(bitstream);
+  if (loaded_bitstream_count != 0) {
+    cost += cost_model.GetFixedOverhead();
   }
 
-  return {cost,
-          std::move(left_over_config)};
+  return {static_cast<long>(cost), std::move(left_over_config)};
 }
 
 auto PlanEvaluator::FindConfigWritten(
     const std::vector<std::vector<ScheduledModule>>& all_runs,
     const std::vector<ScheduledModule>& current_configuration,
-    const std::map<std::string, int>& cost_of_bitstreams)
-    -> std::pair<int, std::vector<ScheduledModule>> {
+    const std::string& resource_string,
+    const ReconfigurationCostModel& cost_model)
+    -> std::pair<long, std::vector<ScheduledModule>> {
   std::vector<std::string> current_columns;
   for (int i = 0; i<31; i++){
     current_columns.push_back("RT");
@@ -178,10 +182,12 @@ auto PlanEvaluator::FindConfigWritten(
   }
   auto [overall_config_written, new_config] =
       FindConfigWrittenForConfiguration(all_runs.front(), current_configuration,
-                                        current_columns, cost_of_bitstreams);
+                                        current_columns, resource_string,
+                                        cost_model);
   for (int run_i = 0; run_i < all_runs.size() - 1; run_i++) {
     auto [config_written, returned_config] = FindConfigWrittenForConfiguration(
-        all_runs.at(run_i + 1), new_config, current_columns, cost_of_bitstreams);
+        all_runs.at(run_i + 1), new_config, current_columns, resource_string,
+        cost_model);
     new_config = returned_config;
     overall_config_written += config_written;
   }
@@ -190,21 +196,68 @@ auto PlanEvaluator::FindConfigWritten(
 
 auto PlanEvaluator::FindFastestPlan(
     const std::vector<long>& data_streamed,
-    const std::vector<long>& configuration_time, double streaming_speed) -> int {
+    const std::vector<long>& configuration_time,
+    const std::vector<int>& pinned_eviction_counts, double streaming_speed)
+    -> int {
   auto current_min_runtime = std::numeric_limits<double>::max();
+  auto current_min_eviction_count = std::numeric_limits<int>::max();
   auto current_min_runtime_i = 0;
   for (int plan_i = 0; plan_i < data_streamed.size(); plan_i++) {
     auto current_runtime =
         (data_streamed.at(plan_i) / streaming_speed +
          configuration_time.at(plan_i));
-    if (current_runtime < current_min_runtime) {
+    // Evicting fewer pinned modules matters more than the runtime.
+    if (std::make_pair(pinned_eviction_counts.at(plan_i), current_runtime) <
+        std::make_pair(current_min_eviction_count, current_min_runtime)) {
       current_min_runtime_i = plan_i;
       current_min_runtime = current_runtime;
+      current_min_eviction_count = pinned_eviction_counts.at(plan_i);
     }
   }
   return current_min_runtime_i;
 }
 
+auto PlanEvaluator::FindExpectedReuseSavings(
+    const std::vector<ScheduledModule>& resulting_config,
+    const std::string& resource_string,
+    const ReconfigurationCostModel& cost_model,
+    const std::map<std::string, double>& module_reuse_weights) -> long {
+  // Modules left configured don't have to be loaded again by later queries.
+  double expected_savings = 0;
+  for (const auto& module : resulting_config) {
+    auto search = module_reuse_weights.find(module.bitstream);
+    if (search != module_reuse_weights.end()) {
+      expected_savings +=
+          search->second *
+          cost_model.GetBitstreamCost(
+              module.bitstream,
+              resource_string.substr(
+                  module.position.first,
+                  module.position.second - module.position.first + 1));
+    }
+  }
+  return static_cast<long>(expected_savings);
+}
+
+auto PlanEvaluator::FindPinnedEvictionCount(
+    const std::vector<ScheduledModule>& last_configuration,
+    const std::vector<ScheduledModule>& resulting_config,
+    const std::set<std::string>& pinned_modules) -> int {
+  int eviction_count = 0;
+  for (const auto& module : last_configuration) {
+    // Reused modules can be placed for a different node.
+    if (pinned_modules.find(module.bitstream) != pinned_modules.end() &&
+        std::none_of(resulting_config.begin(), resulting_config.end(),
+                     [&](const auto& resulting_module) {
+                       return resulting_module.bitstream == module.bitstream &&
+                              resulting_module.position == module.position;
+                     })) {
+      eviction_count++;
+    }
+  }
+  return eviction_count;
+}
+
 auto PlanEvaluator::GetBestPlan(
     int /*min_run_count*/,
     const std::vector<ScheduledModule>& last_configuration,
@@ -212,12 +265,16 @@ auto PlanEvaluator::GetBestPlan(
     double /*config_written_scaler*/, double /*utility_per_frame_scaler*/,
     const std::map<std::vector<std::vector<ScheduledModule>>,
                    ExecutionPlanSchedulingData>& plan_metadata,
-    const std::map<char, int>& cost_of_columns, double streaming_speed,
-    double /*configuration_speed*/)
+    const std::map<char, int>& /*cost_of_columns*/, double streaming_speed,
+    const ReconfigurationCostModel& cost_model,
+    const std::map<std::string, double>& module_reuse_weights,
+    const std::set<std::string>& pinned_modules)
     -> std::tuple<std::vector<std::vector<ScheduledModule>>,
                   std::vector<ScheduledModule>, long, long> {
   std::vector<long> data_streamed;
   std::vector<long> configuration_times;
+  std::vector<long> discounted_configuration_times;
+  std::vector<int> pinned_eviction_counts;
   std::vector<std::vector<ScheduledModule>> last_configurations;
 
   std::vector<std::vector<std::vector<ScheduledModule>>> all_plans_list;
@@ -229,12 +286,19 @@ auto PlanEvaluator::GetBestPlan(
   for (auto& plan_i : all_plans_list) {
     data_streamed.push_back(plan_metadata.at(plan_i).streamed_data_size);
     auto [config_time, new_config] = FindConfigWritten(
-        plan_i, last_configuration, cost_of_bitstreams_);
+        plan_i, last_configuration, resource_string, cost_model);
     configuration_times.push_back(config_time);
+    discounted_configuration_times.push_back(
+        config_time -
+        FindExpectedReuseSavings(new_config, resource_string, cost_model,
+                                 module_reuse_weights));
+    pinned_eviction_counts.push_back(FindPinnedEvictionCount(
+        last_configuration, new_config, pinned_modules));
     last_configurations.push_back(new_config);
   }
-  int max_plan_i = FindFastestPlan(data_streamed, configuration_times,
-                                   streaming_speed);
+  int max_plan_i =
+      FindFastestPlan(data_streamed, discounted_configuration_times,
+                      pinned_eviction_counts, streaming_speed);
   std::tuple<std::vector<std::vector<ScheduledModule>>,
              std::vector<ScheduledModule>, long, long>
       best_plan = {all_plans_list.at(max_plan_i),
@@ -17,8 +17,11 @@ limitations under the License.
 #pragma once
 
 #include <map>
+#include <set>
+#include <string>
 #include <vector>
 
+#include "reconfiguration_cost_model.hpp"
 #include "scheduled_module.hpp"
 #include "scheduling_data.hpp"
 
@@ -43,7 +46,9 @@ class PlanEvaluatorInterface {
    * @param plan_metadata All plans meta data
    * @param cost_of_columns How expensive each column is
    * @param streaming_speed Current IO speed
-   * @param configuration_speed How fast is configuration data streamed
+   * @param cost_model How long loading each bitstream takes
+   * @param module_reuse_weights How likely each module is to be reused later
+   * @param pinned_modules Bitstreams which shouldn't be evicted
    * @return Best plan with the last configuration and cost values
    */
   virtual auto GetBestPlan(
@@ -53,7 +58,9 @@ class PlanEvaluatorInterface {
       const std::map<std::vector<std::vector<ScheduledModule>>,
                      ExecutionPlanSchedulingData>& plan_metadata,
       const std::map<char, int>& cost_of_columns, double streaming_speed,
-      double configuration_speed)
+      const ReconfigurationCostModel& cost_model,
+      const std::map<std::string, double>& module_reuse_weights,
+      const std::set<std::string>& pinned_modules)
       -> std::tuple<std::vector<std::vector<ScheduledModule>>,
                     std::vector<ScheduledModule>, long, long> = 0;
 };
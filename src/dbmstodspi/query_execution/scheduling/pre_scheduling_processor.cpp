@@ -72,55 +72,18 @@ auto PreSchedulingProcessor::FindAdequateBitstreams(
     const std::vector<int>& min_requirements,
     std::unordered_map<std::string, SchedulingQueryNode>& graph,
     const std::string& node_name) -> bool {
-  std::unordered_set<std::string> fitting_bitstreams;
-  for (const auto& [bitstream_name, bitstream_parameters] :
-       hw_library_.at(graph.at(node_name).operation).bitstream_map) {
-    bool bitstream_utility_is_great_enough = true;
-    for (int capacity_parameter_index = 0;
-         capacity_parameter_index < bitstream_parameters.capacity.size();
-         capacity_parameter_index++) {
-      if (bitstream_parameters.capacity.at(capacity_parameter_index) <
-          min_requirements.at(capacity_parameter_index)) {
-        bitstream_utility_is_great_enough = false;
-        break;
-      }
-    }
-    if (bitstream_utility_is_great_enough) {
-      fitting_bitstreams.insert(bitstream_name);
-    }
-  }
-  if (!fitting_bitstreams.empty()) {
+  auto operation = graph.at(node_name).operation;
+  auto fitting_modules =
+      hw_library_index_.GetFittingModules(operation, min_requirements);
+  if (!HWLibraryIndex::IsEmpty(fitting_modules)) {
     auto old_bitstreams = graph.at(node_name).satisfying_bitstreams;
-    graph.at(node_name).satisfying_bitstreams = GetFittingBitstreamLocations(
-        fitting_bitstreams,
-        hw_library_.at(graph.at(node_name).operation).starting_locations);
+    graph.at(node_name).satisfying_bitstreams =
+        hw_library_index_.GetBitstreamLocations(operation, fitting_modules);
     return old_bitstreams != graph.at(node_name).satisfying_bitstreams;
   }
   return false;
 }
 
-auto PreSchedulingProcessor::GetFittingBitstreamLocations(
-    const std::unordered_set<std::string>& fitting_bitstreams_names,
-    const std::vector<std::vector<std::string>>& start_locations)
-    -> std::vector<std::vector<std::string>> {
-  std::vector<std::vector<std::string>> fitting_bitstream_locations =
-      start_locations;
-  for (int location_index = 0; location_index < start_locations.size();
-       location_index++) {
-    for (int bitstream_index = start_locations.at(location_index).size() - 1;
-         bitstream_index >= 0; bitstream_index--) {
-      if (fitting_bitstreams_names.find(
-              start_locations.at(location_index).at(bitstream_index)) ==
-          fitting_bitstreams_names.end()) {
-        fitting_bitstream_locations.at(location_index)
-            .erase(fitting_bitstream_locations.at(location_index).begin() +
-                   bitstream_index);
-      }
-    }
-  }
-  return fitting_bitstream_locations;
-}
-
 auto PreSchedulingProcessor::SetWorstCaseProcessedTables(
     const std::vector<std::string>& input_table_names,
     const std::vector<int>& min_capacity,
@@ -264,18 +227,9 @@ void PreSchedulingProcessor::AddSatisfyingBitstreamLocationsToGraph(
             "Can't skip node with multiple inputs or outputs!");
       }
 
-      // Move input table name to outputs input table.
-      const auto& after_node = graph.at(current_node_name).after_nodes.front();
-      if (!after_node.empty()) {
-        int index = QuerySchedulingHelper::GetCurrentNodeIndexesByName(
-                        graph, after_node, current_node_name)
-                        .front()
-                        .first;
-        graph.at(after_node)
-            .node_ptr->given_input_data_definition_files[index] =
-            graph.at(current_node_name)
-                .node_ptr->given_input_data_definition_files.front();
-      }
+      // The query nodes are shared by all search branches. The scheduler
+      // moves the input table to the next node once the node is skipped in
+      // the chosen plan.
       processed_nodes.insert(current_node_name);
       current_processed_nodes.insert(current_node_name);
       if (available_nodes.find(current_node_name) != available_nodes.end()) {
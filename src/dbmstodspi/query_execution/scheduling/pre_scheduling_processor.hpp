@@ -22,6 +22,7 @@ limitations under the License.
 #include <vector>
 
 #include "accelerator_library_interface.hpp"
+#include "hw_library_index.hpp"
 #include "operation_types.hpp"
 #include "pr_module_data.hpp"
 #include "scheduling_query_node.hpp"
@@ -62,14 +63,6 @@ class PreSchedulingProcessor {
       std::unordered_map<std::string, SchedulingQueryNode>& graph,
       const std::string& node_name) -> bool;
 
-  // def
-  // get_fitting_bitstream_locations_based_on_list(list_of_fitting_bitstreams,
-  // start_locations)
-  static auto GetFittingBitstreamLocations(
-      const std::unordered_set<std::string>& fitting_bitstreams_names,
-      const std::vector<std::vector<std::string>>& start_locations)
-      -> std::vector<std::vector<std::string>>;
-
   // def get_worst_case_fully_processed_tables(input_tables,
   // current_node_decorators, data_tables, min_capacity)
   auto SetWorstCaseProcessedTables(
@@ -85,15 +78,16 @@ class PreSchedulingProcessor {
       const std::map<std::string, TableMetadata>& data_tables,
       const std::vector<int>& min_capacity) -> bool;
 
-  const std::map<QueryOperationType, OperationPRModules> hw_library_;
+  const HWLibraryIndex& hw_library_index_;
   AcceleratorLibraryInterface& accelerator_library_;
   const std::unordered_map<QueryOperationType, std::vector<int>> min_capacity_;
 
  public:
   PreSchedulingProcessor(
       const std::map<QueryOperationType, OperationPRModules>& hw_library,
+      const HWLibraryIndex& hw_library_index,
       AcceleratorLibraryInterface& accelerator_library)
-      : hw_library_{hw_library},
+      : hw_library_index_{hw_library_index},
         accelerator_library_{accelerator_library},
         min_capacity_{GetMinimumCapacityValuesFromHWLibrary(hw_library)} {};
 
@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <algorithm>
 #include <chrono>
+#include <future>
 #include <iomanip>
 #include <iostream>
 #include <set>
@@ -48,9 +49,10 @@ auto QueryManager::GetData() -> std::vector<long> {
 }
 auto QueryManager::GetConfigTime() -> long { return latest_config_; }
 
-void QueryManager::MeasureBitstreamConfigurationSpeed(
+auto QueryManager::MeasureBitstreamConfigurationSpeed(
     const std::map<QueryOperationType, OperationPRModules>& hw_library,
-    MemoryManagerInterface* memory_manager) {
+    MemoryManagerInterface* memory_manager,
+    const std::string& profile_filename) -> std::map<std::string, double> {
   std::set<std::string> bitstreams_to_measure;
   for (const auto& [operation, bitstreams_info] : hw_library) {
     for (const auto& [bitstream_name, bitstream_info] :
@@ -77,7 +79,12 @@ void QueryManager::MeasureBitstreamConfigurationSpeed(
   // bitstreams_to_measure.insert("byteman_PRregionRTandTA_0_96.bin");
   // bitstreams_to_measure.insert("byteman_MergeSort128_bitstreamSizeTest_7_42.bin");
   // bitstreams_to_measure.insert("byteman_MergeSort128_bitstreamSizeTest_37_72.bin");
-  memory_manager->MeasureConfigurationSpeed(bitstreams_to_measure);
+  auto measured_costs =
+      memory_manager->MeasureConfigurationSpeed(bitstreams_to_measure);
+  if (!profile_filename.empty()) {
+    json_reader_->WriteValueMap(measured_costs, profile_filename);
+  }
+  return measured_costs;
 }
 
 auto QueryManager::GetCurrentLinks(
@@ -909,7 +916,25 @@ void QueryManager::ProcessResults(
   }
 }
 
-void QueryManager::ExecuteAndProcessResults(
+auto QueryManager::GetFinishedResultParameters(
+    const std::map<std::string, std::vector<StreamResultParameters>>&
+        result_parameters,
+    const std::map<int, int>& finished_stream_sizes)
+    -> std::map<std::string, std::vector<StreamResultParameters>> {
+  std::map<std::string, std::vector<StreamResultParameters>>
+      finished_result_parameters;
+  for (const auto& [node_name, result_parameter_vector] : result_parameters) {
+    for (const auto& result_params : result_parameter_vector) {
+      if (finished_stream_sizes.find(result_params.output_id) !=
+          finished_stream_sizes.end()) {
+        finished_result_parameters[node_name].push_back(result_params);
+      }
+    }
+  }
+  return finished_result_parameters;
+}
+
+auto QueryManager::ExecuteAndProcessResults(
     MemoryManagerInterface* memory_manager, FPGAManagerInterface* fpga_manager,
     const DataManagerInterface* data_manager,
     std::unordered_map<std::string, MemoryBlockInterface*>& table_memory_blocks,
@@ -917,7 +942,9 @@ void QueryManager::ExecuteAndProcessResults(
         result_parameters,
     const std::vector<AcceleratedQueryNode>& execution_query_nodes,
     std::map<std::string, TableMetadata>& scheduling_table_data,
-    std::unordered_map<std::string, int>& table_counter, int timeout) {
+    std::unordered_map<std::string, int>& table_counter, int timeout,
+    const std::vector<std::string>& prefetch_bitstreams) -> RunTimes {
+  RunTimes run_times;
   std::map<int, std::vector<double>> read_back_values;
   std::chrono::steady_clock::time_point begin =
       std::chrono::steady_clock::now();
@@ -933,26 +960,67 @@ void QueryManager::ExecuteAndProcessResults(
     std::cout << "INITIALISATION: " << initialisation_sum << std::endl;
   }*/
   Log(LogLevel::kTrace, "Running query!");
-  auto result_sizes =
-      fpga_manager->RunQueryAcceleration(timeout, read_back_values);
+  // Results of each independent pipeline get processed as soon as the
+  // pipeline finishes while the rest of the run keeps streaming.
+  fpga_manager->StartQueryAcceleration();
+  // The next run's modules get configured while this run is streaming. The
+  // loads are done on a separate thread such that they don't delay noticing
+  // the finished pipelines.
+  std::future<void> prefetch;
+  if (!prefetch_bitstreams.empty()) {
+    prefetch = std::async(std::launch::async, [&]() {
+      for (const auto& bitstream : prefetch_bitstreams) {
+        auto load_begin = std::chrono::steady_clock::now();
+        memory_manager->LoadPartialBitstreamWhileStreaming({bitstream});
+        auto load_end = std::chrono::steady_clock::now();
+        run_times.prefetch_times.emplace_back(
+            std::chrono::duration_cast<std::chrono::microseconds>(load_begin -
+                                                                  begin)
+                .count(),
+            std::chrono::duration_cast<std::chrono::microseconds>(load_end -
+                                                                  load_begin)
+                .count());
+      }
+    });
+  }
+  while (fpga_manager->IsQueryAccelerationRunning()) {
+    auto finished_stream_sizes =
+        fpga_manager->WaitForFinishedPipelines(timeout, read_back_values);
+    std::array<int, query_acceleration_constants::kMaxIOStreamCount>
+        result_sizes{};
+    for (const auto& [stream_id, record_count] : finished_stream_sizes) {
+      result_sizes[stream_id] = record_count;
+    }
+    ProcessResults(
+        data_manager, result_sizes,
+        GetFinishedResultParameters(result_parameters, finished_stream_sizes),
+        table_memory_blocks, scheduling_table_data, read_back_values);
+  }
   Log(LogLevel::kTrace, "Query done!");
 
   std::chrono::steady_clock::time_point total_end =
       std::chrono::steady_clock::now();
+  run_times.execution_time =
+      std::chrono::duration_cast<std::chrono::microseconds>(total_end - begin)
+          .count();
+  if (prefetch.valid()) {
+    prefetch.get();
+    long prefetch_time = 0;
+    for (const auto& [load_start, load_time] : run_times.prefetch_times) {
+      prefetch_time += load_time;
+    }
+    Log(LogLevel::kInfo,
+        "Prefetch time = " + std::to_string(prefetch_time) + "[microseconds]");
+  }
   /*std::cout << "TOTAL EXEC:"
             << std::chrono::duration_cast<std::chrono::microseconds>(total_end -
                                                                      begin)
                    .count()
             << std::endl;*/
   Log(LogLevel::kInfo,
-      "Init and run time = " +
-          std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(
-                             total_end - begin)
-                             .count()) +
+      "Init and run time = " + std::to_string(run_times.execution_time) +
           "[microseconds]");
 
-  ProcessResults(data_manager, result_sizes, result_parameters,
-                 table_memory_blocks, scheduling_table_data, read_back_values);
   std::vector<std::string> removable_tables;
   for (const auto& [table_name, counter] : table_counter) {
     if (counter < 0) {
@@ -970,6 +1038,7 @@ void QueryManager::ExecuteAndProcessResults(
     memory_manager->FreeMemoryBlock(table_memory_blocks.at(table_name));
     table_memory_blocks.erase(table_name);
   }
+  return run_times;
 }
 
 void QueryManager::UpdateTableData(
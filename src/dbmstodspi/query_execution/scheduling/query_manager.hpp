@@ -26,9 +26,11 @@ namespace orkhestrafs::dbmstodspi {
 
 class QueryManager : public QueryManagerInterface {
  public:
-  void MeasureBitstreamConfigurationSpeed(
+  auto MeasureBitstreamConfigurationSpeed(
       const std::map<QueryOperationType, OperationPRModules>& hw_library,
-      MemoryManagerInterface* memory_manager) override;
+      MemoryManagerInterface* memory_manager,
+      const std::string& profile_filename)
+      -> std::map<std::string, double> override;
   explicit QueryManager(std::unique_ptr<JSONReaderInterface> json_reader)
       : json_reader_{std::move(json_reader)} {};
   ~QueryManager() override = default;
@@ -54,7 +56,7 @@ class QueryManager : public QueryManagerInterface {
                               Config config) override;
   // auto IsRunValid(std::vector<AcceleratedQueryNode> current_run)
   //    -> bool override;
-  void ExecuteAndProcessResults(
+  auto ExecuteAndProcessResults(
       MemoryManagerInterface* memory_manager,
       FPGAManagerInterface* fpga_manager,
       const DataManagerInterface* data_manager,
@@ -64,7 +66,9 @@ class QueryManager : public QueryManagerInterface {
           result_parameters,
       const std::vector<AcceleratedQueryNode>& execution_query_nodes,
       std::map<std::string, TableMetadata>& scheduling_table_data,
-      std::unordered_map<std::string, int>& table_counter, int timeout) override;
+      std::unordered_map<std::string, int>& table_counter, int timeout,
+      const std::vector<std::string>& prefetch_bitstreams)
+      -> RunTimes override;
   auto ScheduleNextSetOfNodes(
       std::vector<QueryNode*>& query_nodes,
       const std::unordered_set<std::string>& first_node_names,
@@ -152,7 +156,8 @@ class QueryManager : public QueryManagerInterface {
       {"overall_time", 0},     {"run_count", 0},
       {"data_amount", 0},      {"configuration_amount", 0},
       {"schedule_count", 0},   {"plan_count", 0},
-      {"placed_nodes", 0},     {"discarded_placements", 0}};
+      {"placed_nodes", 0},     {"discarded_placements", 0},
+      {"explored_branches", 0}};
 
   void GetRoutingBitstreamsAndPassthroughBitstreams(
       const std::vector<int>& written_frames,
@@ -187,6 +192,11 @@ class QueryManager : public QueryManagerInterface {
           table_memory_blocks,
       std::map<std::string, TableMetadata>& scheduling_table_data,
       const std::map<int, std::vector<double>>& read_back_values);
+  static auto GetFinishedResultParameters(
+      const std::map<std::string, std::vector<StreamResultParameters>>&
+          result_parameters,
+      const std::map<int, int>& finished_stream_sizes)
+      -> std::map<std::string, std::vector<StreamResultParameters>>;
   static void StoreStreamResultParameters(
       std::map<std::string, std::vector<StreamResultParameters>>&
           result_parameters,
@@ -51,6 +51,17 @@ using orkhestrafs::dbmstodspi::NodeSchedulerInterface;
 using orkhestrafs::dbmstodspi::ScheduledModule;
 
 namespace orkhestrafs::dbmstodspi {
+/**
+ * @brief Times of an executed run in microseconds since the run was set up.
+ */
+struct RunTimes {
+  /// Setup and streaming until the last pipeline finished.
+  long execution_time = 0;
+  /// Start and duration of each prefetched bitstream load. The loads overlap
+  /// with the streaming.
+  std::vector<std::pair<long, long>> prefetch_times;
+};
+
 /**
  * @brief Interface to describe a class managing the setup and execution of a
  * query
@@ -60,9 +71,18 @@ class QueryManagerInterface {
   virtual auto GetData() -> std::vector<long> = 0;
   virtual auto GetConfigTime() -> long = 0;
 
-  virtual void MeasureBitstreamConfigurationSpeed(
+  /**
+   * @brief Measure the load times of all PR bitstreams and store them.
+   * @param hw_library Bitstreams of all of the operations.
+   * @param memory_manager Manager to load the bitstreams with.
+   * @param profile_filename JSON file to write the load times to.
+   * @return Measured load times in microseconds.
+   */
+  virtual auto MeasureBitstreamConfigurationSpeed(
       const std::map<QueryOperationType, OperationPRModules>& hw_library,
-      MemoryManagerInterface* memory_manager) = 0;
+      MemoryManagerInterface* memory_manager,
+      const std::string& profile_filename)
+      -> std::map<std::string, double> = 0;
 
   virtual ~QueryManagerInterface() = default;
   /**
@@ -130,8 +150,11 @@ class QueryManagerInterface {
    * @param scheduling_table_data Table sizes data for scheduling.
    * @param reuse_links To find next nodes.
    * @param scheduling_graph To update next nodes.
+   * @param prefetch_bitstreams Bitstreams to load into idle PR regions while
+   * the query is running.
+   * @return Execution and prefetch times of the run.
    */
-  virtual void ExecuteAndProcessResults(
+  virtual auto ExecuteAndProcessResults(
       MemoryManagerInterface* memory_manager,
       FPGAManagerInterface* fpga_manager,
       const DataManagerInterface* data_manager,
@@ -141,7 +164,8 @@ class QueryManagerInterface {
           result_parameters,
       const std::vector<AcceleratedQueryNode>& execution_query_nodes,
       std::map<std::string, TableMetadata>& scheduling_table_data,
-      std::unordered_map<std::string, int>& table_counter, int timeout) = 0;
+      std::unordered_map<std::string, int>& table_counter, int timeout,
+      const std::vector<std::string>& prefetch_bitstreams) -> RunTimes = 0;
 
   /**
    * Method to schedule next set of nodes based on PR graph nodes.
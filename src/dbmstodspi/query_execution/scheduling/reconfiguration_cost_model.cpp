@@ -0,0 +1,141 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "reconfiguration_cost_model.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+using orkhestrafs::dbmstodspi::ReconfigurationCostModel;
+
+ReconfigurationCostModel::ReconfigurationCostModel(
+    const std::map<std::string, double>& measured_costs,
+    std::string resource_string, std::map<char, int> cost_of_columns,
+    double configuration_speed)
+    : costs_{GetReferenceCosts()},
+      resource_string_{std::move(resource_string)},
+      cost_of_columns_{std::move(cost_of_columns)},
+      configuration_speed_{configuration_speed} {
+  for (const auto& [bitstream, cost] : measured_costs) {
+    costs_[bitstream] = cost;
+  }
+}
+
+auto ReconfigurationCostModel::GetBitstreamCost(
+    const std::string& bitstream, const std::string& module_resources) const
+    -> double {
+  auto search = costs_.find(bitstream);
+  if (search != costs_.end()) {
+    return search->second;
+  }
+  return EstimateCost(module_resources);
+}
+
+auto ReconfigurationCostModel::GetRoutingCost(int column) const -> double {
+  auto search = costs_.find(GetRoutingBitstreamName(column));
+  if (search != costs_.end()) {
+    return search->second;
+  }
+  search = costs_.find("RT");
+  if (search != costs_.end()) {
+    return search->second;
+  }
+  return EstimateCost(resource_string_.substr(column, 1));
+}
+
+auto ReconfigurationCostModel::GetTurnaroundCost(int column) const -> double {
+  auto search = costs_.find(GetTurnaroundBitstreamName(column));
+  if (search != costs_.end()) {
+    return search->second;
+  }
+  return GetRoutingCost(column);
+}
+
+auto ReconfigurationCostModel::GetFixedOverhead() const -> double {
+  auto search = costs_.find(kFixedOverheadKey);
+  if (search != costs_.end()) {
+    return search->second;
+  }
+  return 0;
+}
+
+auto ReconfigurationCostModel::GetRoutingBitstreamName(int column)
+    -> std::string {
+  return "RT_" + std::to_string(kFirstColumnFrame - column * kFramesPerColumn) +
+         ".bin";
+}
+
+auto ReconfigurationCostModel::GetTurnaroundBitstreamName(int column)
+    -> std::string {
+  return "TAA_" +
+         std::to_string(kFirstColumnFrame - column * kFramesPerColumn) + ".bin";
+}
+
+auto ReconfigurationCostModel::EstimateCost(
+    const std::string& module_resources) const -> double {
+  if (configuration_speed_ <= 0) {
+    throw std::runtime_error("Configuration speed has to be positive!");
+  }
+  double configuration_data_size = 0;
+  for (const auto& column_type : module_resources) {
+    configuration_data_size += cost_of_columns_.at(column_type);
+  }
+  // Bytes divided by MB/s gives microseconds.
+  return configuration_data_size / configuration_speed_;
+}
+
+auto ReconfigurationCostModel::GetReferenceCosts()
+    -> const std::map<std::string, double>& {
+  // Minimum load times measured on the reference board.
+  static const std::map<std::string, double> reference_costs = {
+      {"binPartial_MergeSort64_7_36.bin", 5530},
+      {"binPartial_MergeSort64_37_66.bin", 5556},
+      {"binPartial_MergeSort32_46_66.bin", 4188},
+      {"binPartial_MergeSort32_16_36.bin", 4109},
+      {"binPartial_MergeSort128_49_96.bin", 8439},
+      {"binPartial_MergeJoin2K_67_96.bin", 5588},
+      {"binPartial_MergeJoin2K_37_66.bin", 5621},
+      {"binPartial_LinearSort512_7_36.bin", 5682},
+      {"binPartial_LinearSort1024_7_48.bin", 7499},
+      {"binPartial_Filter_37_66.bin", 5567},
+      {"binPartial_Filter216_82_96.bin", 2802},
+      {"binPartial_Filter216_52_66.bin", 2831},
+      {"binPartial_DecMult64b_64_84.bin", 4047},
+      {"binPartial_DecMult64b_4_24.bin", 4021},
+      {"binPartial_DecMult64b_34_54.bin", 4033},
+      {"binPartial_LinearSort1024_37_78.bin", 7533},
+      {"binPartial_ConstArith64b_55_66.bin", 2348},
+      {"binPartial_ConstArith64b_25_36.bin", 2295},
+      {"binPartial_AggregateGlobalSum_85_93.bin", 1817},
+      {"binPartial_AggregateGlobalSum_55_63.bin", 1810},
+      {"binPartial_AggregateGlobalSum_25_33.bin", 1730},
+      {"binPartial_Filter_7_36.bin", 5519},
+      {"RT", 659},
+      {"binPartial_LinearSort512_37_66.bin", 5708},
+      {"binPartial_Filter18_25_36.bin", 2394},
+      {"binPartial_Filter18_85_96.bin", 2354},
+      {"binPartial_MergeSort64_67_96.bin", 5518},
+      {"binPartial_MergeJoin2K_7_36.bin", 5623},
+      {"binPartial_MergeSort128_19_66.bin", 8691},
+      {"binPartial_Filter_67_96.bin", 5474},
+      {"binPartial_LinearSort512_67_96.bin", 5657},
+      {"binPartial_Filter18_55_66.bin", 2349},
+      {"binPartial_MergeSort32_76_96.bin", 4107},
+      {"binPartial_Filter216_22_36.bin", 2799},
+      {"binPartial_ConstArith64b_85_96.bin", 2361},
+  };
+  return reference_costs;
+}
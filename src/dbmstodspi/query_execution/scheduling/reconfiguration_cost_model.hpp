@@ -0,0 +1,100 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+#include <map>
+#include <string>
+
+namespace orkhestrafs::dbmstodspi {
+
+/**
+ * @brief Class to estimate how long loading partial bitstreams takes.
+ *
+ * Costs are given in microseconds. Measured costs from a calibration profile
+ * take precedence over the reference costs. Unknown bitstreams are estimated
+ * from the configuration data size of the columns they occupy.
+ */
+class ReconfigurationCostModel {
+ public:
+  /// Profile key for the time spent on each PR loading request.
+  static constexpr char kFixedOverheadKey[] = "FIXED_OVERHEAD";
+
+  /**
+   * @brief Constructor to set the measured costs and the estimation data.
+   * @param measured_costs Calibrated load times of bitstreams.
+   * @param resource_string PR region resources.
+   * @param cost_of_columns Configuration data size of each column type.
+   * @param configuration_speed Configuration speed in MB/s.
+   */
+  ReconfigurationCostModel(const std::map<std::string, double>& measured_costs,
+                           std::string resource_string,
+                           std::map<char, int> cost_of_columns,
+                           double configuration_speed);
+
+  /**
+   * @brief Get the cost of loading a module bitstream.
+   * @param bitstream Bitstream file name.
+   * @param module_resources Resource string of the columns it occupies.
+   * @return Load time in microseconds.
+   */
+  auto GetBitstreamCost(const std::string& bitstream,
+                        const std::string& module_resources) const -> double;
+  /**
+   * @brief Get the cost of loading a routing bitstream into a column.
+   * @param column Column index.
+   * @return Load time in microseconds.
+   */
+  auto GetRoutingCost(int column) const -> double;
+  /**
+   * @brief Get the cost of loading a turnaround bitstream into a column.
+   * @param column Column index.
+   * @return Load time in microseconds.
+   */
+  auto GetTurnaroundCost(int column) const -> double;
+  /**
+   * @brief Get the fixed cost of each PR loading request.
+   * @return Time in microseconds.
+   */
+  auto GetFixedOverhead() const -> double;
+
+  /**
+   * @brief Get the routing bitstream name of the given column.
+   * @param column Column index.
+   * @return Bitstream file name.
+   */
+  static auto GetRoutingBitstreamName(int column) -> std::string;
+  /**
+   * @brief Get the turnaround bitstream name of the given column.
+   * @param column Column index.
+   * @return Bitstream file name.
+   */
+  static auto GetTurnaroundBitstreamName(int column) -> std::string;
+
+ private:
+  // Routing bitstreams are named after their first frame address.
+  static const int kFirstColumnFrame = 95;
+  static const int kFramesPerColumn = 3;
+
+  std::map<std::string, double> costs_;
+  std::string resource_string_;
+  std::map<char, int> cost_of_columns_;
+  double configuration_speed_;
+
+  auto EstimateCost(const std::string& module_resources) const -> double;
+  static auto GetReferenceCosts() -> const std::map<std::string, double>&;
+};
+
+}  // namespace orkhestrafs::dbmstodspi
@@ -0,0 +1,202 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "reconfiguration_planner.hpp"
+
+#include <algorithm>
+
+#include "reconfiguration_cost_model.hpp"
+
+using orkhestrafs::dbmstodspi::ReconfigurationCostModel;
+using orkhestrafs::dbmstodspi::ReconfigurationPlanner;
+
+ReconfigurationPlanner::ReconfigurationPlanner(
+    int column_count,
+    const std::vector<std::string>& combined_routing_bitstreams)
+    : configured_columns_(column_count, ""),
+      combined_routing_bitstreams_{combined_routing_bitstreams.begin(),
+                                   combined_routing_bitstreams.end()} {
+  for (int column_i = 0; column_i < column_count; column_i++) {
+    routing_columns_.insert(
+        {ReconfigurationCostModel::GetRoutingBitstreamName(column_i),
+         column_i});
+    routing_columns_.insert(
+        {ReconfigurationCostModel::GetTurnaroundBitstreamName(column_i),
+         column_i});
+    for (int first_column = 0; first_column < column_i; first_column++) {
+      auto combined_bitstream =
+          GetCombinedRoutingBitstreamName(first_column, column_i);
+      if (combined_routing_bitstreams_.find(combined_bitstream) !=
+          combined_routing_bitstreams_.end()) {
+        combined_routing_columns_.insert(
+            {combined_bitstream, {first_column, column_i}});
+      }
+    }
+  }
+}
+
+void ReconfigurationPlanner::Reset() {
+  for (int column_i = 0; column_i < configured_columns_.size(); column_i++) {
+    configured_columns_[column_i] =
+        ReconfigurationCostModel::GetRoutingBitstreamName(column_i);
+  }
+}
+
+auto ReconfigurationPlanner::GetMinimalLoadSequence(
+    const std::vector<std::string>& required_bitstreams,
+    const std::vector<ScheduledModule>& new_modules)
+    -> std::vector<std::string> {
+  std::vector<std::string> load_sequence;
+  for (const auto& bitstream : required_bitstreams) {
+    auto columns = GetColumns(bitstream, new_modules);
+    if (columns.first == -1) {
+      // Unknown footprint - Nothing can be assumed about the columns anymore.
+      load_sequence.push_back(bitstream);
+      std::fill(configured_columns_.begin(), configured_columns_.end(), "");
+    } else if (IsConfigured(bitstream, columns)) {
+      skipped_load_count_++;
+    } else {
+      load_sequence.push_back(bitstream);
+      for (int column_i = columns.first; column_i < columns.second + 1;
+           column_i++) {
+        configured_columns_[column_i] = bitstream;
+      }
+    }
+  }
+  return MergeAdjacentRoutingLoads(load_sequence);
+}
+
+auto ReconfigurationPlanner::GetSkippedLoadCount() const -> int {
+  return skipped_load_count_;
+}
+
+void ReconfigurationPlanner::InvalidateColumns(std::pair<int, int> columns) {
+  for (int column_i = std::max(columns.first, 0);
+       column_i < std::min(columns.second + 1,
+                           static_cast<int>(configured_columns_.size()));
+       column_i++) {
+    configured_columns_[column_i] = "";
+  }
+}
+
+auto ReconfigurationPlanner::GetBitstreamColumns(
+    const std::string& bitstream,
+    const std::vector<ScheduledModule>& new_modules) const
+    -> std::pair<int, int> {
+  auto search = combined_routing_columns_.find(bitstream);
+  if (search != combined_routing_columns_.end()) {
+    return search->second;
+  }
+  return GetColumns(bitstream, new_modules);
+}
+
+auto ReconfigurationPlanner::GetColumns(
+    const std::string& bitstream,
+    const std::vector<ScheduledModule>& new_modules) const
+    -> std::pair<int, int> {
+  auto search = routing_columns_.find(bitstream);
+  if (search != routing_columns_.end()) {
+    return {search->second, search->second};
+  }
+  for (const auto& module : new_modules) {
+    if (module.bitstream == bitstream && module.position.first >= 0 &&
+        module.position.second < configured_columns_.size()) {
+      return module.position;
+    }
+  }
+  return {-1, -1};
+}
+
+auto ReconfigurationPlanner::IsConfigured(const std::string& bitstream,
+                                          std::pair<int, int> columns) const
+    -> bool {
+  for (int column_i = columns.first; column_i < columns.second + 1;
+       column_i++) {
+    if (configured_columns_.at(column_i) != bitstream) {
+      return false;
+    }
+  }
+  return true;
+}
+
+auto ReconfigurationPlanner::IsRoutingBitstream(
+    const std::string& bitstream) const -> bool {
+  auto search = routing_columns_.find(bitstream);
+  return search != routing_columns_.end() &&
+         bitstream ==
+             ReconfigurationCostModel::GetRoutingBitstreamName(search->second);
+}
+
+auto ReconfigurationPlanner::GetCombinedRoutingBitstreamName(int first_column,
+                                                             int last_column)
+    -> std::string {
+  auto first_bitstream =
+      ReconfigurationCostModel::GetRoutingBitstreamName(first_column);
+  auto last_bitstream =
+      ReconfigurationCostModel::GetRoutingBitstreamName(last_column);
+  // RT_89.bin + RT_95.bin -> RT_89_95.bin
+  return last_bitstream.substr(0, last_bitstream.size() - 4) + "_" +
+         first_bitstream.substr(3);
+}
+
+auto ReconfigurationPlanner::MergeAdjacentRoutingLoads(
+    const std::vector<std::string>& load_sequence) const
+    -> std::vector<std::string> {
+  if (combined_routing_bitstreams_.empty()) {
+    return load_sequence;
+  }
+  std::set<int> routing_loads;
+  for (const auto& bitstream : load_sequence) {
+    if (IsRoutingBitstream(bitstream)) {
+      routing_loads.insert(routing_columns_.at(bitstream));
+    }
+  }
+
+  std::vector<std::string> merged_sequence;
+  std::set<int> merged_columns;
+  for (const auto& bitstream : load_sequence) {
+    if (!IsRoutingBitstream(bitstream)) {
+      merged_sequence.push_back(bitstream);
+      continue;
+    }
+    int first_column = routing_columns_.at(bitstream);
+    if (merged_columns.find(first_column) != merged_columns.end()) {
+      continue;
+    }
+    int last_column = first_column;
+    while (routing_loads.find(last_column + 1) != routing_loads.end()) {
+      last_column++;
+    }
+    // Use the widest combined bitstream starting from this column.
+    std::string bitstream_to_load = bitstream;
+    for (int column_i = last_column; column_i > first_column; column_i--) {
+      auto combined_bitstream =
+          GetCombinedRoutingBitstreamName(first_column, column_i);
+      if (combined_routing_bitstreams_.find(combined_bitstream) !=
+          combined_routing_bitstreams_.end()) {
+        bitstream_to_load = combined_bitstream;
+        for (int merged_i = first_column + 1; merged_i < column_i + 1;
+             merged_i++) {
+          merged_columns.insert(merged_i);
+        }
+        break;
+      }
+    }
+    merged_sequence.push_back(bitstream_to_load);
+  }
+  return merged_sequence;
+}
@@ -0,0 +1,113 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "scheduled_module.hpp"
+
+using orkhestrafs::dbmstodspi::ScheduledModule;
+
+namespace orkhestrafs::dbmstodspi {
+
+/**
+ * @brief Class to reduce the PR bitstreams requested for a configuration
+ * transition to the minimal load sequence.
+ *
+ * The bitstream configured in each PR column is tracked such that bitstreams
+ * which are already configured in all of their columns are skipped. Adjacent
+ * routing columns are loaded with a single combined routing bitstream where
+ * one is available.
+ */
+class ReconfigurationPlanner {
+ public:
+  /**
+   * @brief Constructor to set the PR region size and available combined
+   * bitstreams.
+   * @param column_count How many columns the PR region has.
+   * @param combined_routing_bitstreams Routing bitstreams covering multiple
+   * columns. Named RT_<last_column_frame>_<first_column_frame>.bin
+   */
+  ReconfigurationPlanner(
+      int column_count,
+      const std::vector<std::string>& combined_routing_bitstreams);
+
+  /**
+   * @brief Set every column to routing after the static bitstream is loaded.
+   */
+  void Reset();
+
+  /**
+   * @brief Get the bitstreams which have to be loaded for the transition and
+   * update the configured columns accordingly.
+   * @param required_bitstreams Bitstreams requested in loading order.
+   * @param new_modules Modules which are going to be configured.
+   * @return Minimal sequence of bitstreams to load.
+   */
+  auto GetMinimalLoadSequence(
+      const std::vector<std::string>& required_bitstreams,
+      const std::vector<ScheduledModule>& new_modules)
+      -> std::vector<std::string>;
+
+  /**
+   * @brief Get how many requested bitstream loads have been skipped.
+   * @return Skipped loads count.
+   */
+  auto GetSkippedLoadCount() const -> int;
+
+  /**
+   * @brief Forget what is configured in the given columns such that the next
+   * transition using them reloads them.
+   * @param columns First and last column indexes.
+   */
+  void InvalidateColumns(std::pair<int, int> columns);
+
+  /**
+   * @brief Get the columns a bitstream is loaded into.
+   * @param bitstream Bitstream file name.
+   * @param new_modules Modules the bitstream could belong to.
+   * @return First and last column indexes or -1s if the footprint is unknown.
+   */
+  auto GetBitstreamColumns(const std::string& bitstream,
+                           const std::vector<ScheduledModule>& new_modules)
+      const -> std::pair<int, int>;
+
+ private:
+  std::vector<std::string> configured_columns_;
+  std::map<std::string, int> routing_columns_;
+  std::set<std::string> combined_routing_bitstreams_;
+  std::map<std::string, std::pair<int, int>> combined_routing_columns_;
+  int skipped_load_count_ = 0;
+
+  auto GetColumns(const std::string& bitstream,
+                  const std::vector<ScheduledModule>& new_modules) const
+      -> std::pair<int, int>;
+  auto IsConfigured(const std::string& bitstream,
+                    std::pair<int, int> columns) const -> bool;
+  auto IsRoutingBitstream(const std::string& bitstream) const -> bool;
+  static auto GetCombinedRoutingBitstreamName(int first_column,
+                                              int last_column) -> std::string;
+  auto MergeAdjacentRoutingLoads(
+      const std::vector<std::string>& load_sequence) const
+      -> std::vector<std::string>;
+};
+
+}  // namespace orkhestrafs::dbmstodspi
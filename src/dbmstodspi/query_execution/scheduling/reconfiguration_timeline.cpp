@@ -0,0 +1,322 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "reconfiguration_timeline.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <tuple>
+
+#include "rapidjson/document.h"
+#include "rapidjson/filewritestream.h"
+#include "rapidjson/prettywriter.h"
+
+using orkhestrafs::dbmstodspi::LoadCause;
+using orkhestrafs::dbmstodspi::ReconfigurationTimeline;
+using orkhestrafs::dbmstodspi::TimelineIdleGap;
+using orkhestrafs::dbmstodspi::TimelineLoad;
+using orkhestrafs::dbmstodspi::TimelineRun;
+using orkhestrafs::dbmstodspi::TimelineSummary;
+using rapidjson::Document;
+using rapidjson::FileWriteStream;
+using rapidjson::PrettyWriter;
+using rapidjson::Value;
+
+ReconfigurationTimeline::ReconfigurationTimeline(int column_count)
+    : column_count_{column_count}, column_loads_(column_count, -1) {}
+
+void ReconfigurationTimeline::RecordLoad(const std::string& bitstream,
+                                         std::pair<int, int> columns,
+                                         LoadCause cause, long start_time,
+                                         long duration) {
+  if (columns.first < 0 || columns.second >= column_count_) {
+    columns = {-1, -1};
+  }
+  TimelineLoad load = {bitstream,  columns,  cause,
+                       start_time, duration, static_cast<int>(runs_.size())};
+  loads_.push_back(std::move(load));
+  int load_index = loads_.size() - 1;
+  for (int column_i = 0; column_i < column_count_; column_i++) {
+    if (!IsLoadedInto(loads_.back(), column_i)) {
+      continue;
+    }
+    auto previous_load_index = column_loads_.at(column_i);
+    if (previous_load_index != -1) {
+      auto& previous_load = loads_.at(previous_load_index);
+      if (!previous_load.is_used && previous_load.cause != LoadCause::kStatic) {
+        previous_load.is_wasted = true;
+      }
+    }
+    column_loads_[column_i] = load_index;
+  }
+}
+
+void ReconfigurationTimeline::RecordRun(
+    const std::vector<ScheduledModule>& modules, long start_time,
+    long duration) {
+  runs_.push_back(
+      {static_cast<int>(runs_.size()), modules, start_time, duration});
+  for (int column_i = 0; column_i < GetUsedColumnCount(modules); column_i++) {
+    if (column_loads_.at(column_i) != -1) {
+      loads_.at(column_loads_.at(column_i)).is_used = true;
+    }
+  }
+}
+
+auto ReconfigurationTimeline::GetLoads() const
+    -> const std::vector<TimelineLoad>& {
+  return loads_;
+}
+
+auto ReconfigurationTimeline::GetRuns() const
+    -> const std::vector<TimelineRun>& {
+  return runs_;
+}
+
+auto ReconfigurationTimeline::GetIdleGaps() const
+    -> std::vector<TimelineIdleGap> {
+  std::vector<TimelineIdleGap> idle_gaps;
+  auto total_time = GetTotalTime();
+  for (int column_i = 0; column_i < column_count_; column_i++) {
+    long idle_start = 0;
+    for (const auto& [busy_start, busy_end] : GetBusyIntervals(column_i)) {
+      if (busy_start > idle_start) {
+        idle_gaps.push_back({column_i, idle_start, busy_start - idle_start});
+      }
+      idle_start = std::max(idle_start, busy_end);
+    }
+    if (total_time > idle_start) {
+      idle_gaps.push_back({column_i, idle_start, total_time - idle_start});
+    }
+  }
+  return idle_gaps;
+}
+
+auto ReconfigurationTimeline::GetSummary() const -> TimelineSummary {
+  TimelineSummary summary;
+  summary.total_time = GetTotalTime();
+  int partial_load_count = 0;
+  for (const auto& load : loads_) {
+    summary.load_count++;
+    if (load.cause != LoadCause::kPrefetch) {
+      // Prefetching overlaps with the execution.
+      summary.reconfiguration_time += load.duration;
+    }
+    if (load.cause != LoadCause::kStatic) {
+      partial_load_count++;
+    }
+    if (load.is_wasted) {
+      summary.wasted_load_count++;
+    }
+  }
+  if (partial_load_count != 0) {
+    summary.wasted_reload_ratio =
+        static_cast<double>(summary.wasted_load_count) / partial_load_count;
+  }
+
+  std::vector<long> module_time(column_count_, 0);
+  for (const auto& run : runs_) {
+    summary.execution_time += run.duration;
+    std::vector<bool> is_module_column(column_count_, false);
+    for (const auto& module : run.modules) {
+      for (int column_i = std::max(module.position.first, 0);
+           column_i <= std::min(module.position.second, column_count_ - 1);
+           column_i++) {
+        is_module_column[column_i] = true;
+      }
+    }
+    for (int column_i = 0; column_i < column_count_; column_i++) {
+      if (is_module_column[column_i]) {
+        module_time[column_i] += run.duration;
+      }
+    }
+  }
+  auto busy_time = summary.reconfiguration_time + summary.execution_time;
+  if (busy_time != 0) {
+    summary.reconfiguration_overhead =
+        static_cast<double>(summary.reconfiguration_time) / busy_time;
+  }
+
+  summary.column_idle_time.resize(column_count_, 0);
+  for (const auto& idle_gap : GetIdleGaps()) {
+    summary.column_idle_time[idle_gap.column] += idle_gap.duration;
+  }
+  for (int column_i = 0; column_i < column_count_; column_i++) {
+    summary.column_utilisation.push_back(
+        summary.total_time == 0
+            ? 0
+            : static_cast<double>(module_time[column_i]) / summary.total_time);
+  }
+  return summary;
+}
+
+void ReconfigurationTimeline::WriteCSV(const std::string& filename) const {
+  std::ofstream output_file(filename, std::ios::trunc);
+  if (!output_file) {
+    throw std::runtime_error("Couldn't open: " + filename);
+  }
+  // column, start, type, row
+  std::vector<std::tuple<int, long, int, std::string>> rows;
+  for (const auto& load : loads_) {
+    for (int column_i = 0; column_i < column_count_; column_i++) {
+      if (IsLoadedInto(load, column_i)) {
+        rows.emplace_back(
+            column_i, load.start_time, 0,
+            "load," + std::to_string(load.duration) + "," + load.bitstream +
+                "," + GetCauseName(load.cause) + "," +
+                std::to_string(load.run_index) + "," +
+                (load.is_wasted ? "true" : "false"));
+      }
+    }
+  }
+  for (const auto& run : runs_) {
+    std::vector<std::string> column_labels(GetUsedColumnCount(run.modules),
+                                           "passthrough");
+    for (const auto& module : run.modules) {
+      for (int column_i = std::max(module.position.first, 0);
+           column_i < std::min(module.position.second + 1,
+                               static_cast<int>(column_labels.size()));
+           column_i++) {
+        column_labels[column_i] = module.node_name;
+      }
+    }
+    for (int column_i = 0; column_i < column_labels.size(); column_i++) {
+      auto type =
+          column_labels[column_i] == "passthrough" ? "passthrough" : "module";
+      rows.emplace_back(column_i, run.start_time, 1,
+                        std::string(type) + "," +
+                            std::to_string(run.duration) + "," +
+                            column_labels[column_i] + ",," +
+                            std::to_string(run.run_index) + ",");
+    }
+  }
+  for (const auto& idle_gap : GetIdleGaps()) {
+    rows.emplace_back(idle_gap.column, idle_gap.start_time, 2,
+                      "idle," + std::to_string(idle_gap.duration) + ",,,,");
+  }
+  std::sort(rows.begin(), rows.end());
+
+  output_file << "column,start_us,type,duration_us,label,cause,run,wasted\n";
+  for (const auto& [column, start_time, order, row] : rows) {
+    output_file << column << "," << start_time << "," << row << "\n";
+  }
+}
+
+void ReconfigurationTimeline::WriteSummaryJSON(
+    const std::string& filename) const {
+  auto summary = GetSummary();
+  Document document;
+  document.SetObject();
+  auto& allocator = document.GetAllocator();
+  document.AddMember("total_time_us", summary.total_time, allocator);
+  document.AddMember("reconfiguration_time_us", summary.reconfiguration_time,
+                     allocator);
+  document.AddMember("execution_time_us", summary.execution_time, allocator);
+  document.AddMember("reconfiguration_overhead",
+                     summary.reconfiguration_overhead, allocator);
+  document.AddMember("load_count", summary.load_count, allocator);
+  document.AddMember("wasted_load_count", summary.wasted_load_count,
+                     allocator);
+  document.AddMember("wasted_reload_ratio", summary.wasted_reload_ratio,
+                     allocator);
+  Value column_utilisation(rapidjson::kArrayType);
+  Value column_idle_time(rapidjson::kArrayType);
+  for (int column_i = 0; column_i < column_count_; column_i++) {
+    column_utilisation.PushBack(summary.column_utilisation.at(column_i),
+                                allocator);
+    column_idle_time.PushBack(summary.column_idle_time.at(column_i),
+                              allocator);
+  }
+  document.AddMember("column_utilisation", column_utilisation, allocator);
+  document.AddMember("column_idle_time_us", column_idle_time, allocator);
+
+  FILE* file_pointer = fopen(filename.c_str(), "wb");
+  if (!file_pointer) {
+    throw std::runtime_error("Couldn't open: " + filename);
+  }
+  char write_buffer[8192];
+  FileWriteStream output_stream(file_pointer, write_buffer,
+                                sizeof(write_buffer));
+  PrettyWriter<FileWriteStream> writer(output_stream);
+  document.Accept(writer);
+  bool is_written = ferror(file_pointer) == 0;
+  if (fclose(file_pointer) != 0 || !is_written) {
+    throw std::runtime_error("Couldn't write " + filename);
+  }
+}
+
+auto ReconfigurationTimeline::GetCauseName(LoadCause cause) -> std::string {
+  switch (cause) {
+    case LoadCause::kStatic:
+      return "static";
+    case LoadCause::kRun:
+      return "run";
+    case LoadCause::kPrefetch:
+      return "prefetch";
+    case LoadCause::kManual:
+      return "manual";
+  }
+  throw std::runtime_error("Unknown load cause!");
+}
+
+auto ReconfigurationTimeline::GetUsedColumnCount(
+    const std::vector<ScheduledModule>& modules) const -> int {
+  int used_column_count = 0;
+  for (const auto& module : modules) {
+    used_column_count = std::max(used_column_count, module.position.second + 1);
+  }
+  return std::min(used_column_count, column_count_);
+}
+
+auto ReconfigurationTimeline::IsLoadedInto(const TimelineLoad& load,
+                                           int column) const -> bool {
+  // Unknown footprints are considered to reconfigure everything.
+  return load.columns.first == -1 ||
+         (load.columns.first <= column && column <= load.columns.second);
+}
+
+auto ReconfigurationTimeline::GetBusyIntervals(int column) const
+    -> std::vector<std::pair<long, long>> {
+  std::vector<std::pair<long, long>> busy_intervals;
+  for (const auto& load : loads_) {
+    if (IsLoadedInto(load, column)) {
+      busy_intervals.emplace_back(load.start_time,
+                                  load.start_time + load.duration);
+    }
+  }
+  for (const auto& run : runs_) {
+    if (column < GetUsedColumnCount(run.modules)) {
+      busy_intervals.emplace_back(run.start_time,
+                                  run.start_time + run.duration);
+    }
+  }
+  std::sort(busy_intervals.begin(), busy_intervals.end());
+  return busy_intervals;
+}
+
+auto ReconfigurationTimeline::GetTotalTime() const -> long {
+  long total_time = 0;
+  for (const auto& load : loads_) {
+    total_time = std::max(total_time, load.start_time + load.duration);
+  }
+  for (const auto& run : runs_) {
+    total_time = std::max(total_time, run.start_time + run.duration);
+  }
+  return total_time;
+}
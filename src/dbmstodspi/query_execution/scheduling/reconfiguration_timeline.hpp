@@ -0,0 +1,171 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "scheduled_module.hpp"
+
+using orkhestrafs::dbmstodspi::ScheduledModule;
+
+namespace orkhestrafs::dbmstodspi {
+
+/**
+ * @brief Why a bitstream was loaded.
+ */
+enum class LoadCause { kStatic, kRun, kPrefetch, kManual };
+
+/**
+ * @brief Struct to hold a single bitstream load of the timeline.
+ */
+struct TimelineLoad {
+  std::string bitstream;
+  /// First and last column indexes (inclusive). -1s if unknown.
+  std::pair<int, int> columns;
+  LoadCause cause;
+  /// Times in microseconds since the start of the timeline.
+  long start_time;
+  long duration;
+  /// Run the load was done for.
+  int run_index;
+  /// Used by a run before it got overwritten.
+  bool is_used = false;
+  /// Overwritten before any run used the configured columns.
+  bool is_wasted = false;
+};
+
+/**
+ * @brief Struct to hold a single run of the timeline.
+ */
+struct TimelineRun {
+  int run_index;
+  std::vector<ScheduledModule> modules;
+  /// Times in microseconds since the start of the timeline.
+  long start_time;
+  long duration;
+};
+
+/**
+ * @brief Struct to hold a period where a column wasn't loaded or used.
+ */
+struct TimelineIdleGap {
+  int column;
+  long start_time;
+  long duration;
+};
+
+/**
+ * @brief Metrics derived from the whole timeline.
+ */
+struct TimelineSummary {
+  /// End of the last recorded event in microseconds.
+  long total_time = 0;
+  long reconfiguration_time = 0;
+  long execution_time = 0;
+  /// Share of the reconfiguration and execution time spent reconfiguring.
+  double reconfiguration_overhead = 0;
+  int load_count = 0;
+  int wasted_load_count = 0;
+  /// Share of the partial bitstream loads which were wasted.
+  double wasted_reload_ratio = 0;
+  /// Share of the total time each column was used by a module of a run.
+  std::vector<double> column_utilisation;
+  /// Time each column wasn't loaded or used in microseconds.
+  std::vector<long> column_idle_time;
+};
+
+/**
+ * @brief Class to record every PR load and run to see how each column was
+ * used over a session.
+ *
+ * Runs use every column from the first column up to the last column of
+ * their modules since the data passes through the routing columns. Loads
+ * are wasted if any of their columns is reconfigured before a run uses it.
+ */
+class ReconfigurationTimeline {
+ public:
+  /**
+   * @brief Constructor to set the PR region size.
+   * @param column_count How many columns the PR region has.
+   */
+  explicit ReconfigurationTimeline(int column_count);
+
+  /**
+   * @brief Record a bitstream load.
+   * @param bitstream Loaded bitstream.
+   * @param columns First and last column indexes. -1s if unknown which
+   * means every column is considered to be reconfigured.
+   * @param cause Why the bitstream was loaded.
+   * @param start_time Microseconds since the start of the timeline.
+   * @param duration Load time in microseconds.
+   */
+  void RecordLoad(const std::string& bitstream, std::pair<int, int> columns,
+                  LoadCause cause, long start_time, long duration);
+  /**
+   * @brief Record a run and mark the loads it used.
+   * @param modules Modules used by the run.
+   * @param start_time Microseconds since the start of the timeline.
+   * @param duration Run time in microseconds.
+   */
+  void RecordRun(const std::vector<ScheduledModule>& modules, long start_time,
+                 long duration);
+
+  [[nodiscard]] auto GetLoads() const -> const std::vector<TimelineLoad>&;
+  [[nodiscard]] auto GetRuns() const -> const std::vector<TimelineRun>&;
+  /**
+   * @brief Find the periods where columns weren't loaded or used.
+   * @return Idle gaps ordered by column and start time.
+   */
+  [[nodiscard]] auto GetIdleGaps() const -> std::vector<TimelineIdleGap>;
+  /**
+   * @brief Derive the capacity planning metrics.
+   * @return Summary of the whole timeline.
+   */
+  [[nodiscard]] auto GetSummary() const -> TimelineSummary;
+
+  /**
+   * @brief Write every load, column use and idle gap to a CSV file with one
+   * row per column and interval to be plotted as a Gantt chart.
+   * @param filename Output file.
+   */
+  void WriteCSV(const std::string& filename) const;
+  /**
+   * @brief Write the summary metrics to a JSON file.
+   * @param filename Output file.
+   */
+  void WriteSummaryJSON(const std::string& filename) const;
+
+  static auto GetCauseName(LoadCause cause) -> std::string;
+
+ private:
+  int column_count_;
+  std::vector<TimelineLoad> loads_;
+  std::vector<TimelineRun> runs_;
+  /// Index of the last load of each column. -1 if nothing is recorded.
+  std::vector<int> column_loads_;
+
+  auto GetUsedColumnCount(const std::vector<ScheduledModule>& modules) const
+      -> int;
+  auto IsLoadedInto(const TimelineLoad& load, int column) const -> bool;
+  auto GetBusyIntervals(int column) const
+      -> std::vector<std::pair<long, long>>;
+  auto GetTotalTime() const -> long;
+};
+
+}  // namespace orkhestrafs::dbmstodspi
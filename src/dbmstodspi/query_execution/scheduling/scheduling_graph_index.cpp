@@ -0,0 +1,211 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "scheduling_graph_index.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <set>
+#include <stdexcept>
+
+using orkhestrafs::dbmstodspi::SchedulingGraphIndex;
+
+SchedulingGraphIndex::SchedulingGraphIndex(
+    const std::unordered_map<std::string, SchedulingQueryNode>& graph,
+    const std::unordered_set<std::string>& other_node_names,
+    const std::map<std::string, TableMetadata>& data_tables) {
+  std::set<std::string> sorted_node_names(other_node_names.begin(),
+                                          other_node_names.end());
+  for (const auto& [node_name, node] : graph) {
+    sorted_node_names.insert(node_name);
+    for (const auto& [before_node_name, _] : node.before_nodes) {
+      sorted_node_names.insert(before_node_name);
+    }
+    sorted_node_names.insert(node.after_nodes.begin(), node.after_nodes.end());
+  }
+  // Missing neighbours are marked with empty names.
+  sorted_node_names.erase("");
+
+  for (const auto& node_name : sorted_node_names) {
+    node_ids_.insert({node_name, node_names_.size()});
+    node_keys_.push_back(std::hash<std::string>()(node_name));
+    node_names_.push_back(node_name);
+  }
+  before_node_ids_.resize(node_names_.size());
+  after_node_ids_.resize(node_names_.size());
+  for (const auto& [node_name, node] : graph) {
+    int node_id = node_ids_.at(node_name);
+    for (const auto& [before_node_name, _] : node.before_nodes) {
+      if (!before_node_name.empty()) {
+        before_node_ids_.at(node_id).push_back(node_ids_.at(before_node_name));
+      }
+    }
+    for (const auto& after_node_name : node.after_nodes) {
+      if (!after_node_name.empty()) {
+        after_node_ids_.at(node_id).push_back(node_ids_.at(after_node_name));
+      }
+    }
+  }
+
+  // Nodes can write their results to new output tables during the search.
+  std::set<std::string> sorted_table_names;
+  for (const auto& [table_name, _] : data_tables) {
+    sorted_table_names.insert(table_name);
+  }
+  for (const auto& [_, node] : graph) {
+    sorted_table_names.insert(node.data_tables.begin(), node.data_tables.end());
+    if (node.node_ptr != nullptr) {
+      sorted_table_names.insert(
+          node.node_ptr->given_output_data_definition_files.begin(),
+          node.node_ptr->given_output_data_definition_files.end());
+    }
+  }
+  // Missing inputs are marked with empty names.
+  sorted_table_names.erase("");
+  for (const auto& table_name : sorted_table_names) {
+    table_ids_.insert({table_name, table_names_.size()});
+    table_keys_.push_back(std::hash<std::string>()(table_name));
+    table_names_.push_back(table_name);
+  }
+}
+
+auto SchedulingGraphIndex::GetNodeCount() const -> int {
+  return node_names_.size();
+}
+
+auto SchedulingGraphIndex::GetNodeId(const std::string& node_name) const
+    -> int {
+  auto search = node_ids_.find(node_name);
+  if (search == node_ids_.end()) {
+    throw std::runtime_error(node_name + " isn't in the scheduled graph!");
+  }
+  return search->second;
+}
+
+auto SchedulingGraphIndex::GetNodeName(int node_id) const
+    -> const std::string& {
+  return node_names_.at(node_id);
+}
+
+auto SchedulingGraphIndex::GetNodeKey(int node_id) const -> std::size_t {
+  return node_keys_.at(node_id);
+}
+
+auto SchedulingGraphIndex::GetBeforeNodeIds(int node_id) const
+    -> const std::vector<int>& {
+  return before_node_ids_.at(node_id);
+}
+
+auto SchedulingGraphIndex::GetAfterNodeIds(int node_id) const
+    -> const std::vector<int>& {
+  return after_node_ids_.at(node_id);
+}
+
+auto SchedulingGraphIndex::GetTableCount() const -> int {
+  return table_names_.size();
+}
+
+auto SchedulingGraphIndex::GetTableId(const std::string& table_name) const
+    -> int {
+  auto search = table_ids_.find(table_name);
+  if (search == table_ids_.end()) {
+    throw std::runtime_error(table_name + " isn't in the scheduled tables!");
+  }
+  return search->second;
+}
+
+auto SchedulingGraphIndex::GetTableName(int table_id) const
+    -> const std::string& {
+  return table_names_.at(table_id);
+}
+
+auto SchedulingGraphIndex::GetTableKey(int table_id) const -> std::size_t {
+  return table_keys_.at(table_id);
+}
+
+auto SchedulingGraphIndex::CreateEmptySet() const -> NodeIdSet {
+  return NodeIdSet((node_names_.size() + kBitsPerWord - 1) / kBitsPerWord, 0);
+}
+
+auto SchedulingGraphIndex::CreateSet(
+    const std::unordered_set<std::string>& node_names) const -> NodeIdSet {
+  auto nodes = CreateEmptySet();
+  for (const auto& node_name : node_names) {
+    AddToSet(nodes, GetNodeId(node_name));
+  }
+  return nodes;
+}
+
+auto SchedulingGraphIndex::GetNodeNames(const NodeIdSet& nodes) const
+    -> std::unordered_set<std::string> {
+  std::unordered_set<std::string> node_names;
+  for (const auto& node_id : GetNodeIds(nodes)) {
+    node_names.insert(node_names_.at(node_id));
+  }
+  return node_names;
+}
+
+auto SchedulingGraphIndex::GetNodeIds(const NodeIdSet& nodes)
+    -> std::vector<int> {
+  std::vector<int> node_ids;
+  for (int word_index = 0; word_index < nodes.size(); word_index++) {
+    auto word = nodes.at(word_index);
+    while (word != 0) {
+      node_ids.push_back(word_index * kBitsPerWord + __builtin_ctzll(word));
+      word &= word - 1;
+    }
+  }
+  return node_ids;
+}
+
+auto SchedulingGraphIndex::IsInSet(const NodeIdSet& nodes, int node_id)
+    -> bool {
+  return ((nodes.at(node_id / kBitsPerWord) >> (node_id % kBitsPerWord)) &
+          1U) != 0;
+}
+
+auto SchedulingGraphIndex::AddToSet(NodeIdSet& nodes, int node_id) -> bool {
+  auto& word = nodes.at(node_id / kBitsPerWord);
+  auto bit = uint64_t{1} << (node_id % kBitsPerWord);
+  bool is_added = (word & bit) == 0;
+  word |= bit;
+  return is_added;
+}
+
+auto SchedulingGraphIndex::RemoveFromSet(NodeIdSet& nodes, int node_id)
+    -> bool {
+  auto& word = nodes.at(node_id / kBitsPerWord);
+  auto bit = uint64_t{1} << (node_id % kBitsPerWord);
+  bool is_removed = (word & bit) != 0;
+  word &= ~bit;
+  return is_removed;
+}
+
+auto SchedulingGraphIndex::IsEmpty(const NodeIdSet& nodes) -> bool {
+  return std::all_of(nodes.begin(), nodes.end(),
+                     [](const auto& word) { return word == 0; });
+}
+
+auto SchedulingGraphIndex::IsSubsetOf(const NodeIdSet& subset,
+                                      const NodeIdSet& nodes) -> bool {
+  for (int word_index = 0; word_index < subset.size(); word_index++) {
+    if ((subset.at(word_index) & ~nodes.at(word_index)) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
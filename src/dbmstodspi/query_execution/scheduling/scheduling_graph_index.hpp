@@ -0,0 +1,198 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "scheduling_query_node.hpp"
+#include "table_data.hpp"
+
+using orkhestrafs::core_interfaces::table_data::TableMetadata;
+using orkhestrafs::dbmstodspi::SchedulingQueryNode;
+
+namespace orkhestrafs::dbmstodspi {
+
+/**
+ * @brief Class to compile the node and table names of a scheduled graph into
+ * dense IDs.
+ *
+ * The IDs are given in sorted name order such that sets of node IDs are
+ * always iterated in the same order. Node sets are bitsets which are cheap to
+ * copy, compare and hash compared to sets of node names. Names are only
+ * needed at the boundary of the search where plans are returned. The edges
+ * are compiled into ID lists as well since the search never changes them.
+ *
+ * Tables get IDs for every table the search can read or write such that the
+ * search state can keep the nodes and the table metadata in flat arrays.
+ */
+class SchedulingGraphIndex {
+ public:
+  /// Set of node IDs. Bit i marks the node with ID i.
+  using NodeIdSet = std::vector<uint64_t>;
+
+  /**
+   * @brief Constructor to index the nodes and tables of the given graph.
+   * @param graph Graph of nodes with their neighbours.
+   * @param other_node_names Names of nodes which aren't in the graph anymore.
+   * @param data_tables Tables known before the search.
+   */
+  SchedulingGraphIndex(
+      const std::unordered_map<std::string, SchedulingQueryNode>& graph,
+      const std::unordered_set<std::string>& other_node_names,
+      const std::map<std::string, TableMetadata>& data_tables);
+
+  /**
+   * @brief Get the number of indexed nodes.
+   * @return Node count.
+   */
+  auto GetNodeCount() const -> int;
+  /**
+   * @brief Get the ID of a node.
+   * @param node_name Name of the node.
+   * @return Dense node ID.
+   */
+  auto GetNodeId(const std::string& node_name) const -> int;
+  /**
+   * @brief Get the name of a node.
+   * @param node_id Dense node ID.
+   * @return Name of the node.
+   */
+  auto GetNodeName(int node_id) const -> const std::string&;
+  /**
+   * @brief Get the hash of a node name to build state hashes from.
+   * @param node_id Dense node ID.
+   * @return Hash of the node name.
+   */
+  auto GetNodeKey(int node_id) const -> std::size_t;
+  /**
+   * @brief Get the nodes which have to be processed before the given node.
+   * @param node_id Dense node ID.
+   * @return IDs of the previous nodes.
+   */
+  auto GetBeforeNodeIds(int node_id) const -> const std::vector<int>&;
+  /**
+   * @brief Get the nodes which take the output of the given node.
+   * @param node_id Dense node ID.
+   * @return IDs of the next nodes.
+   */
+  auto GetAfterNodeIds(int node_id) const -> const std::vector<int>&;
+
+  /**
+   * @brief Get the number of indexed tables.
+   * @return Table count.
+   */
+  auto GetTableCount() const -> int;
+  /**
+   * @brief Get the ID of a table.
+   * @param table_name Name of the table.
+   * @return Dense table ID.
+   */
+  auto GetTableId(const std::string& table_name) const -> int;
+  /**
+   * @brief Get the name of a table.
+   * @param table_id Dense table ID.
+   * @return Name of the table.
+   */
+  auto GetTableName(int table_id) const -> const std::string&;
+  /**
+   * @brief Get the hash of a table name to build state hashes from.
+   * @param table_id Dense table ID.
+   * @return Hash of the table name.
+   */
+  auto GetTableKey(int table_id) const -> std::size_t;
+
+  /**
+   * @brief Create an empty set which can hold every indexed node.
+   * @return Empty node set.
+   */
+  auto CreateEmptySet() const -> NodeIdSet;
+  /**
+   * @brief Create a node set from node names.
+   * @param node_names Names of the nodes.
+   * @return Set of node IDs.
+   */
+  auto CreateSet(const std::unordered_set<std::string>& node_names) const
+      -> NodeIdSet;
+  /**
+   * @brief Get the names of the nodes in the given set.
+   * @param nodes Set of node IDs.
+   * @return Set of node names.
+   */
+  auto GetNodeNames(const NodeIdSet& nodes) const
+      -> std::unordered_set<std::string>;
+
+  /**
+   * @brief Get the IDs of the nodes in the given set in ascending order.
+   * @param nodes Set of node IDs.
+   * @return Node IDs.
+   */
+  static auto GetNodeIds(const NodeIdSet& nodes) -> std::vector<int>;
+  /**
+   * @brief Check if a node is in the given set.
+   * @param nodes Set of node IDs.
+   * @param node_id Node ID.
+   * @return Boolean flag noting if the node is in the set.
+   */
+  static auto IsInSet(const NodeIdSet& nodes, int node_id) -> bool;
+  /**
+   * @brief Add a node to the given set.
+   * @param nodes Set of node IDs.
+   * @param node_id Node ID.
+   * @return Boolean flag noting if the node wasn't in the set before.
+   */
+  static auto AddToSet(NodeIdSet& nodes, int node_id) -> bool;
+  /**
+   * @brief Remove a node from the given set.
+   * @param nodes Set of node IDs.
+   * @param node_id Node ID.
+   * @return Boolean flag noting if the node was in the set before.
+   */
+  static auto RemoveFromSet(NodeIdSet& nodes, int node_id) -> bool;
+  /**
+   * @brief Check if the given set is empty.
+   * @param nodes Set of node IDs.
+   * @return Boolean flag noting if there are no nodes in the set.
+   */
+  static auto IsEmpty(const NodeIdSet& nodes) -> bool;
+  /**
+   * @brief Check if all nodes of the first set are in the second set.
+   * @param subset Set of node IDs to check.
+   * @param nodes Set of node IDs to check against.
+   * @return Boolean flag noting if the first set is a subset.
+   */
+  static auto IsSubsetOf(const NodeIdSet& subset, const NodeIdSet& nodes)
+      -> bool;
+
+ private:
+  static const int kBitsPerWord = 64;
+
+  std::vector<std::string> node_names_;
+  std::vector<std::size_t> node_keys_;
+  std::vector<std::vector<int>> before_node_ids_;
+  std::vector<std::vector<int>> after_node_ids_;
+  std::unordered_map<std::string, int> node_ids_;
+  std::vector<std::string> table_names_;
+  std::vector<std::size_t> table_keys_;
+  std::unordered_map<std::string, int> table_ids_;
+};
+
+}  // namespace orkhestrafs::dbmstodspi
@@ -39,5 +39,14 @@ struct SchedulingQueryNode {
   std::vector<std::string> data_tables;
   std::vector<std::vector<std::string>> satisfying_bitstreams;
   QueryNode* node_ptr;
+
+  // For the search state to find changed nodes.
+  auto operator==(const SchedulingQueryNode& rhs) const -> bool {
+    return operation == rhs.operation && capacity == rhs.capacity &&
+           before_nodes == rhs.before_nodes && after_nodes == rhs.after_nodes &&
+           data_tables == rhs.data_tables &&
+           satisfying_bitstreams == rhs.satisfying_bitstreams &&
+           node_ptr == rhs.node_ptr;
+  }
 };
 }  // namespace orkhestrafs::dbmstodspi
\ No newline at end of file
@@ -0,0 +1,503 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "scheduling_search_state.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "module_selection.hpp"
+
+using orkhestrafs::dbmstodspi::hash_combine;
+using orkhestrafs::dbmstodspi::MyHash;
+using orkhestrafs::dbmstodspi::SchedulingGraphIndex;
+using orkhestrafs::dbmstodspi::SchedulingSearchState;
+
+namespace {
+// Spread the combined hashes such that XORing them together doesn't cancel
+// out similar values.
+auto Mix(std::size_t hash) -> std::size_t {
+  hash ^= hash >> 30;
+  hash *= 0xbf58476d1ce4e5b9ULL;
+  hash ^= hash >> 27;
+  hash *= 0x94d049bb133111ebULL;
+  hash ^= hash >> 31;
+  return hash;
+}
+
+auto GetAllNodeNames(
+    const std::vector<const std::unordered_set<std::string>*>& node_sets)
+    -> std::unordered_set<std::string> {
+  std::unordered_set<std::string> node_names;
+  for (const auto* node_set : node_sets) {
+    node_names.insert(node_set->begin(), node_set->end());
+  }
+  return node_names;
+}
+
+auto GetNodesById(const SchedulingGraphIndex& graph_index,
+                  std::unordered_map<std::string, SchedulingQueryNode> graph)
+    -> std::vector<std::optional<SchedulingQueryNode>> {
+  std::vector<std::optional<SchedulingQueryNode>> nodes(
+      graph_index.GetNodeCount());
+  for (auto& [node_name, node] : graph) {
+    nodes.at(graph_index.GetNodeId(node_name)) = std::move(node);
+  }
+  return nodes;
+}
+
+auto GetTablesById(const SchedulingGraphIndex& graph_index,
+                   const std::map<std::string, TableMetadata>& data_tables)
+    -> std::vector<std::optional<TableMetadata>> {
+  std::vector<std::optional<TableMetadata>> tables(
+      graph_index.GetTableCount());
+  for (const auto& [table_name, table] : data_tables) {
+    tables.at(graph_index.GetTableId(table_name)) = table;
+  }
+  return tables;
+}
+}  // namespace
+
+SchedulingSearchState::SchedulingSearchState(
+    std::unordered_set<std::string> available_nodes,
+    std::unordered_set<std::string> processed_nodes,
+    std::unordered_map<std::string, SchedulingQueryNode> graph,
+    std::vector<ScheduledModule> current_run,
+    std::vector<std::vector<ScheduledModule>> current_plan,
+    std::map<std::string, TableMetadata> data_tables,
+    std::unordered_set<std::string> blocked_nodes,
+    std::unordered_set<std::string> next_run_blocked_nodes,
+    int streamed_data_size)
+    : graph_index_{std::make_shared<const SchedulingGraphIndex>(
+          graph,
+          GetAllNodeNames({&available_nodes, &processed_nodes, &blocked_nodes,
+                           &next_run_blocked_nodes}),
+          data_tables)},
+      available_nodes_{graph_index_->CreateSet(available_nodes)},
+      processed_nodes_{graph_index_->CreateSet(processed_nodes)},
+      graph_{GetNodesById(*graph_index_, std::move(graph))},
+      current_run_{std::move(current_run)},
+      current_plan_{std::move(current_plan)},
+      data_tables_{GetTablesById(*graph_index_, data_tables)},
+      blocked_nodes_{graph_index_->CreateSet(blocked_nodes)},
+      next_run_blocked_nodes_{graph_index_->CreateSet(next_run_blocked_nodes)},
+      streamed_data_size_{streamed_data_size},
+      hash_{GetFullHash()} {}
+
+SchedulingSearchState::SchedulingSearchState(
+    const SchedulingSearchState& other)
+    : graph_index_{other.graph_index_},
+      available_nodes_{other.available_nodes_},
+      processed_nodes_{other.processed_nodes_},
+      graph_{other.graph_},
+      current_run_{other.current_run_},
+      current_plan_{other.current_plan_},
+      data_tables_{other.data_tables_},
+      blocked_nodes_{other.blocked_nodes_},
+      next_run_blocked_nodes_{other.next_run_blocked_nodes_},
+      streamed_data_size_{other.streamed_data_size_},
+      hash_{GetFullHash()} {}
+
+auto SchedulingSearchState::GetCheckpoint() const -> int {
+  return change_log_.size();
+}
+
+void SchedulingSearchState::Rollback(int checkpoint) {
+  while (change_log_.size() > checkpoint) {
+    auto& change = change_log_.back();
+    int change_index = change_log_.size() - 1;
+    if (!unhashed_changes_.empty() &&
+        unhashed_changes_.back() == change_index) {
+      unhashed_changes_.pop_back();
+    } else {
+      hash_ ^= GetChangedValuesHash(change);
+    }
+    std::visit([&](auto& typed_change) { Undo(typed_change); }, change);
+    hash_ ^= GetChangedValuesHash(change);
+    change_log_.pop_back();
+  }
+}
+
+auto SchedulingSearchState::GetHash() -> std::size_t {
+  HashSavedChanges();
+  return hash_;
+}
+
+void SchedulingSearchState::SaveNode(int node_id) {
+  SaveChange(NodeChange{node_id, graph_.at(node_id)});
+}
+
+void SchedulingSearchState::SetGraph(
+    const std::unordered_map<std::string, SchedulingQueryNode>& graph) {
+  for (int node_id = 0; node_id < graph_.size(); node_id++) {
+    auto search = graph.find(graph_index_->GetNodeName(node_id));
+    if (search == graph.end()) {
+      RemoveNodeFromGraph(node_id);
+    } else if (!(graph_.at(node_id) == search->second)) {
+      SaveNode(node_id);
+      graph_.at(node_id) = search->second;
+    }
+  }
+}
+
+void SchedulingSearchState::SetTable(int table_id,
+                                     std::optional<TableMetadata> table) {
+  SaveChange(TableChange{table_id, data_tables_.at(table_id)});
+  data_tables_.at(table_id) = std::move(table);
+}
+
+void SchedulingSearchState::SetDataTables(
+    const std::map<std::string, TableMetadata>& data_tables) {
+  auto new_tables = GetTablesById(*graph_index_, data_tables);
+  for (int table_id = 0; table_id < new_tables.size(); table_id++) {
+    if (new_tables.at(table_id) != data_tables_.at(table_id)) {
+      SetTable(table_id, std::move(new_tables.at(table_id)));
+    }
+  }
+}
+
+void SchedulingSearchState::SaveChange(Change change) {
+  // A value saved twice would get XORed out twice. Hash the earlier change
+  // in first as the new change covers the rest of the value's changes.
+  auto overlapping_change = std::remove_if(
+      unhashed_changes_.begin(), unhashed_changes_.end(),
+      [&](int change_index) {
+        if (!IsOverlapping(change_log_.at(change_index), change)) {
+          return false;
+        }
+        hash_ ^= GetChangedValuesHash(change_log_.at(change_index));
+        return true;
+      });
+  unhashed_changes_.erase(overlapping_change, unhashed_changes_.end());
+  change_log_.push_back(std::move(change));
+  hash_ ^= GetChangedValuesHash(change_log_.back());
+  unhashed_changes_.push_back(change_log_.size() - 1);
+}
+
+auto SchedulingSearchState::IsOverlapping(const Change& lhs, const Change& rhs)
+    -> bool {
+  if (const auto* lhs_node = std::get_if<NodeChange>(&lhs)) {
+    const auto* rhs_node = std::get_if<NodeChange>(&rhs);
+    return rhs_node != nullptr && rhs_node->node_id == lhs_node->node_id;
+  }
+  if (const auto* lhs_table = std::get_if<TableChange>(&lhs)) {
+    const auto* rhs_table = std::get_if<TableChange>(&rhs);
+    return rhs_table != nullptr && rhs_table->table_id == lhs_table->table_id;
+  }
+  return false;
+}
+
+void SchedulingSearchState::RemoveNodeFromGraph(int node_id) {
+  HashSavedChanges();
+  auto& node = graph_.at(node_id);
+  if (node) {
+    hash_ ^= GetNodeHash(node_id);
+    change_log_.emplace_back(NodeChange{node_id, std::move(node)});
+    node.reset();
+  }
+}
+
+void SchedulingSearchState::InsertNodeName(NodeSet node_set,
+                                           const std::string& node_name) {
+  InsertNode(node_set, graph_index_->GetNodeId(node_name));
+}
+
+void SchedulingSearchState::EraseNodeName(NodeSet node_set,
+                                          const std::string& node_name) {
+  EraseNode(node_set, graph_index_->GetNodeId(node_name));
+}
+
+void SchedulingSearchState::InsertNode(NodeSet node_set, int node_id) {
+  HashSavedChanges();
+  if (SchedulingGraphIndex::AddToSet(GetMutableNodes(node_set), node_id)) {
+    hash_ ^= GetNodeSetHash(node_set, node_id);
+    change_log_.emplace_back(NodeSetChange{node_set, node_id, true});
+  }
+}
+
+void SchedulingSearchState::EraseNode(NodeSet node_set, int node_id) {
+  HashSavedChanges();
+  if (SchedulingGraphIndex::RemoveFromSet(GetMutableNodes(node_set),
+                                          node_id)) {
+    hash_ ^= GetNodeSetHash(node_set, node_id);
+    change_log_.emplace_back(NodeSetChange{node_set, node_id, false});
+  }
+}
+
+void SchedulingSearchState::InsertModule(
+    int module_index, const ScheduledModule& module_placement) {
+  HashSavedChanges();
+  hash_ ^= GetModuleHash(module_placement);
+  current_run_.insert(current_run_.begin() + module_index, module_placement);
+  change_log_.emplace_back(ModuleChange{module_index});
+}
+
+void SchedulingSearchState::FinishRun() {
+  HashSavedChanges();
+  hash_ ^= GetRunHash();
+  current_plan_.push_back(std::move(current_run_));
+  current_run_.clear();
+  change_log_.emplace_back(FinishedRunChange{});
+  for (const auto& node_id :
+       SchedulingGraphIndex::GetNodeIds(next_run_blocked_nodes_)) {
+    InsertNode(NodeSet::kBlocked, node_id);
+    EraseNode(NodeSet::kNextRunBlocked, node_id);
+  }
+}
+
+void SchedulingSearchState::AddStreamedDataSize(int data_size) {
+  change_log_.emplace_back(StreamedDataSizeChange{streamed_data_size_});
+  streamed_data_size_ += data_size;
+}
+
+auto SchedulingSearchState::GetNodes(NodeSet node_set) const
+    -> const SchedulingGraphIndex::NodeIdSet& {
+  return const_cast<SchedulingSearchState*>(this)->GetMutableNodes(node_set);
+}
+
+auto SchedulingSearchState::GetNodeNames(NodeSet node_set) const
+    -> std::unordered_set<std::string> {
+  return graph_index_->GetNodeNames(GetNodes(node_set));
+}
+
+auto SchedulingSearchState::GetGraphIndex() const
+    -> const SchedulingGraphIndex& {
+  return *graph_index_;
+}
+
+auto SchedulingSearchState::HasNode(int node_id) const -> bool {
+  return graph_.at(node_id).has_value();
+}
+
+auto SchedulingSearchState::GetNode(int node_id) const
+    -> const SchedulingQueryNode& {
+  const auto& node = graph_.at(node_id);
+  if (!node) {
+    throw std::runtime_error(graph_index_->GetNodeName(node_id) +
+                             " isn't in the graph!");
+  }
+  return *node;
+}
+
+auto SchedulingSearchState::GetGraph() const
+    -> std::unordered_map<std::string, SchedulingQueryNode> {
+  std::unordered_map<std::string, SchedulingQueryNode> graph;
+  for (int node_id = 0; node_id < graph_.size(); node_id++) {
+    if (graph_.at(node_id)) {
+      graph.insert({graph_index_->GetNodeName(node_id), *graph_.at(node_id)});
+    }
+  }
+  return graph;
+}
+
+auto SchedulingSearchState::GetTable(int table_id) const
+    -> const std::optional<TableMetadata>& {
+  return data_tables_.at(table_id);
+}
+
+auto SchedulingSearchState::GetDataTables() const
+    -> std::map<std::string, TableMetadata> {
+  std::map<std::string, TableMetadata> data_tables;
+  for (int table_id = 0; table_id < data_tables_.size(); table_id++) {
+    if (data_tables_.at(table_id)) {
+      data_tables.insert({graph_index_->GetTableName(table_id),
+                          *data_tables_.at(table_id)});
+    }
+  }
+  return data_tables;
+}
+
+auto SchedulingSearchState::GetCurrentRun() const
+    -> const std::vector<ScheduledModule>& {
+  return current_run_;
+}
+
+auto SchedulingSearchState::GetCurrentPlan() const
+    -> const std::vector<std::vector<ScheduledModule>>& {
+  return current_plan_;
+}
+
+auto SchedulingSearchState::GetStreamedDataSize() const -> int {
+  return streamed_data_size_;
+}
+
+auto SchedulingSearchState::GetNode(int node_id) -> SchedulingQueryNode& {
+  return const_cast<SchedulingQueryNode&>(
+      static_cast<const SchedulingSearchState*>(this)->GetNode(node_id));
+}
+
+auto SchedulingSearchState::GetMutableNodes(NodeSet node_set)
+    -> SchedulingGraphIndex::NodeIdSet& {
+  switch (node_set) {
+    case NodeSet::kAvailable:
+      return available_nodes_;
+    case NodeSet::kProcessed:
+      return processed_nodes_;
+    case NodeSet::kBlocked:
+      return blocked_nodes_;
+    case NodeSet::kNextRunBlocked:
+      return next_run_blocked_nodes_;
+  }
+  throw std::runtime_error("Unknown node set!");
+}
+
+void SchedulingSearchState::HashSavedChanges() {
+  for (const auto& change_index : unhashed_changes_) {
+    hash_ ^= GetChangedValuesHash(change_log_.at(change_index));
+  }
+  unhashed_changes_.clear();
+}
+
+auto SchedulingSearchState::GetChangedValuesHash(const Change& change) const
+    -> std::size_t {
+  if (const auto* node_change = std::get_if<NodeChange>(&change)) {
+    return GetNodeHash(node_change->node_id);
+  }
+  if (const auto* table_change = std::get_if<TableChange>(&change)) {
+    return GetTableHash(table_change->table_id);
+  }
+  // Other changes update the hash straight away.
+  return 0;
+}
+
+auto SchedulingSearchState::GetFullHash() const -> std::size_t {
+  std::size_t hash = GetGraphHash() ^ GetTablesHash() ^ GetRunHash();
+  for (const auto node_set : {NodeSet::kAvailable, NodeSet::kProcessed,
+                              NodeSet::kBlocked, NodeSet::kNextRunBlocked}) {
+    for (const auto& node_id :
+         SchedulingGraphIndex::GetNodeIds(GetNodes(node_set))) {
+      hash ^= GetNodeSetHash(node_set, node_id);
+    }
+  }
+  return hash;
+}
+
+auto SchedulingSearchState::GetGraphHash() const -> std::size_t {
+  std::size_t hash = 0;
+  for (int node_id = 0; node_id < graph_.size(); node_id++) {
+    hash ^= GetNodeHash(node_id);
+  }
+  return hash;
+}
+
+auto SchedulingSearchState::GetTablesHash() const -> std::size_t {
+  std::size_t hash = 0;
+  for (int table_id = 0; table_id < data_tables_.size(); table_id++) {
+    hash ^= GetTableHash(table_id);
+  }
+  return hash;
+}
+
+auto SchedulingSearchState::GetRunHash() const -> std::size_t {
+  std::size_t hash = 0;
+  for (const auto& module_placement : current_run_) {
+    hash ^= GetModuleHash(module_placement);
+  }
+  return hash;
+}
+
+auto SchedulingSearchState::GetNodeSetHash(NodeSet node_set,
+                                           int node_id) const -> std::size_t {
+  std::size_t hash = static_cast<std::size_t>(node_set);
+  hash_combine(hash, graph_index_->GetNodeKey(node_id));
+  return Mix(hash);
+}
+
+auto SchedulingSearchState::GetNodeHash(int node_id) const -> std::size_t {
+  const auto& node = graph_.at(node_id);
+  if (!node) {
+    return 0;
+  }
+  std::size_t hash = graph_index_->GetNodeKey(node_id);
+  hash_combine(hash, static_cast<int>(node->operation));
+  for (const auto& capacity_value : node->capacity) {
+    hash_combine(hash, capacity_value);
+  }
+  for (const auto& [before_node_name, stream_index] : node->before_nodes) {
+    hash_combine(hash, before_node_name);
+    hash_combine(hash, stream_index);
+  }
+  for (const auto& after_node_name : node->after_nodes) {
+    hash_combine(hash, after_node_name);
+  }
+  for (const auto& table_name : node->data_tables) {
+    hash_combine(hash, table_name);
+  }
+  for (const auto& column_bitstreams : node->satisfying_bitstreams) {
+    hash_combine(hash, column_bitstreams.size());
+    for (const auto& bitstream : column_bitstreams) {
+      hash_combine(hash, bitstream);
+    }
+  }
+  return Mix(hash);
+}
+
+auto SchedulingSearchState::GetTableHash(int table_id) const -> std::size_t {
+  const auto& table = data_tables_.at(table_id);
+  if (!table) {
+    return 0;
+  }
+  std::size_t hash = graph_index_->GetTableKey(table_id);
+  hash_combine(hash, table->record_size);
+  hash_combine(hash, table->record_count);
+  for (const auto& sorted_value : table->sorted_status) {
+    hash_combine(hash, sorted_value);
+  }
+  return Mix(hash);
+}
+
+auto SchedulingSearchState::GetModuleHash(
+    const ScheduledModule& module_placement) -> std::size_t {
+  std::size_t hash = MyHash<ScheduledModule>()(module_placement);
+  hash_combine(hash, module_placement.is_composed);
+  return Mix(hash);
+}
+
+void SchedulingSearchState::Undo(NodeChange& change) {
+  graph_.at(change.node_id) = std::move(change.old_node);
+}
+
+void SchedulingSearchState::Undo(TableChange& change) {
+  data_tables_.at(change.table_id) = std::move(change.old_table);
+}
+
+void SchedulingSearchState::Undo(NodeSetChange& change) {
+  hash_ ^= GetNodeSetHash(change.node_set, change.node_id);
+  if (change.is_inserted) {
+    SchedulingGraphIndex::RemoveFromSet(GetMutableNodes(change.node_set),
+                                        change.node_id);
+  } else {
+    SchedulingGraphIndex::AddToSet(GetMutableNodes(change.node_set),
+                                   change.node_id);
+  }
+}
+
+void SchedulingSearchState::Undo(ModuleChange& change) {
+  hash_ ^= GetModuleHash(current_run_.at(change.module_index));
+  current_run_.erase(current_run_.begin() + change.module_index);
+}
+
+void SchedulingSearchState::Undo(FinishedRunChange& /*change*/) {
+  current_run_ = std::move(current_plan_.back());
+  current_plan_.pop_back();
+  hash_ ^= GetRunHash();
+}
+
+void SchedulingSearchState::Undo(StreamedDataSizeChange& change) {
+  streamed_data_size_ = change.old_data_size;
+}
@@ -0,0 +1,237 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <variant>
+#include <vector>
+
+#include "scheduled_module.hpp"
+#include "scheduling_graph_index.hpp"
+#include "scheduling_query_node.hpp"
+#include "table_data.hpp"
+
+using orkhestrafs::core_interfaces::table_data::TableMetadata;
+using orkhestrafs::dbmstodspi::ScheduledModule;
+using orkhestrafs::dbmstodspi::SchedulingQueryNode;
+
+namespace orkhestrafs::dbmstodspi {
+
+/**
+ * @brief State of a scheduling search branch which is changed in place.
+ *
+ * Every change is logged with the previous value such that the state can be
+ * rolled back to a checkpoint once a decision branch has been searched. This
+ * way a branch only costs as much as it changes instead of a copy of the whole
+ * graph and all of the tables.
+ *
+ * The state also keeps a Zobrist style hash of everything which decides how
+ * the search continues. Each logged change XORs its part of the hash in or
+ * out so equivalent states can be found without comparing them.
+ *
+ * Node sets are kept as bitsets of the node IDs given by a graph index which
+ * is built once and shared with copies of the state. The nodes and tables are
+ * kept in flat arrays indexed by the node and table IDs of the same index.
+ * Maps keyed by name are only built for the drivers and the pre-scheduler.
+ */
+class SchedulingSearchState {
+ public:
+  enum class NodeSet { kAvailable, kProcessed, kBlocked, kNextRunBlocked };
+
+  SchedulingSearchState(
+      std::unordered_set<std::string> available_nodes,
+      std::unordered_set<std::string> processed_nodes,
+      std::unordered_map<std::string, SchedulingQueryNode> graph,
+      std::vector<ScheduledModule> current_run,
+      std::vector<std::vector<ScheduledModule>> current_plan,
+      std::map<std::string, TableMetadata> data_tables,
+      std::unordered_set<std::string> blocked_nodes,
+      std::unordered_set<std::string> next_run_blocked_nodes,
+      int streamed_data_size);
+  /**
+   * @brief Copy the current values without the change log.
+   * @param other State to copy.
+   */
+  SchedulingSearchState(const SchedulingSearchState& other);
+  auto operator=(const SchedulingSearchState&)
+      -> SchedulingSearchState& = delete;
+
+  /**
+   * @brief Get a checkpoint to roll back to.
+   * @return Size of the change log.
+   */
+  [[nodiscard]] auto GetCheckpoint() const -> int;
+  /**
+   * @brief Undo all changes made after the given checkpoint.
+   * @param checkpoint Checkpoint from GetCheckpoint.
+   */
+  void Rollback(int checkpoint);
+
+  /**
+   * @brief Get the hash of the nodes, tables and the current run. The plan
+   * before the current run and the streamed data size aren't included.
+   * @return Hash of the state.
+   */
+  auto GetHash() -> std::size_t;
+
+  /**
+   * @brief Remember the node before it gets changed through GetNode. Saved
+   * values have to be changed before any other method is called.
+   * @param node_id Node to save.
+   */
+  void SaveNode(int node_id);
+  /**
+   * @brief Change the nodes which differ from the given graph.
+   * @param graph All nodes by name. Missing nodes get removed.
+   */
+  void SetGraph(
+      const std::unordered_map<std::string, SchedulingQueryNode>& graph);
+  void RemoveNodeFromGraph(int node_id);
+  /**
+   * @brief Change a table and log the old value.
+   * @param table_id Table to change.
+   * @param table New table. Empty to remove the table.
+   */
+  void SetTable(int table_id, std::optional<TableMetadata> table);
+  /**
+   * @brief Change the tables which differ from the given tables.
+   * @param data_tables All tables by name. Missing tables get removed.
+   */
+  void SetDataTables(const std::map<std::string, TableMetadata>& data_tables);
+
+  void InsertNodeName(NodeSet node_set, const std::string& node_name);
+  void EraseNodeName(NodeSet node_set, const std::string& node_name);
+  void InsertNode(NodeSet node_set, int node_id);
+  void EraseNode(NodeSet node_set, int node_id);
+  /**
+   * @brief Place a module in the current run.
+   * @param module_index Index in the current run.
+   * @param module_placement Module to place.
+   */
+  void InsertModule(int module_index, const ScheduledModule& module_placement);
+  /**
+   * @brief Move the current run to the plan and block the nodes which had to
+   * wait for the next run.
+   */
+  void FinishRun();
+  void AddStreamedDataSize(int data_size);
+
+  [[nodiscard]] auto GetNodes(NodeSet node_set) const
+      -> const SchedulingGraphIndex::NodeIdSet&;
+  /**
+   * @brief Get the names of the nodes in the given set.
+   * @param node_set Set to get the names of.
+   * @return Set of node names.
+   */
+  [[nodiscard]] auto GetNodeNames(NodeSet node_set) const
+      -> std::unordered_set<std::string>;
+  [[nodiscard]] auto GetGraphIndex() const -> const SchedulingGraphIndex&;
+  [[nodiscard]] auto HasNode(int node_id) const -> bool;
+  [[nodiscard]] auto GetNode(int node_id) const -> const SchedulingQueryNode&;
+  /**
+   * @brief Get all nodes by name.
+   * @return Map of node names to the nodes.
+   */
+  [[nodiscard]] auto GetGraph() const
+      -> std::unordered_map<std::string, SchedulingQueryNode>;
+  [[nodiscard]] auto GetTable(int table_id) const
+      -> const std::optional<TableMetadata>&;
+  /**
+   * @brief Get all tables by name.
+   * @return Map of table names to the table metadata.
+   */
+  [[nodiscard]] auto GetDataTables() const
+      -> std::map<std::string, TableMetadata>;
+  [[nodiscard]] auto GetCurrentRun() const
+      -> const std::vector<ScheduledModule>&;
+  [[nodiscard]] auto GetCurrentPlan() const
+      -> const std::vector<std::vector<ScheduledModule>>&;
+  [[nodiscard]] auto GetStreamedDataSize() const -> int;
+
+  // Mutable access is only allowed after the changed values have been saved.
+  auto GetNode(int node_id) -> SchedulingQueryNode&;
+
+ private:
+  struct NodeChange {
+    int node_id;
+    std::optional<SchedulingQueryNode> old_node;
+  };
+  struct TableChange {
+    int table_id;
+    std::optional<TableMetadata> old_table;
+  };
+  struct NodeSetChange {
+    NodeSet node_set;
+    int node_id;
+    bool is_inserted;
+  };
+  struct ModuleChange {
+    int module_index;
+  };
+  struct FinishedRunChange {};
+  struct StreamedDataSizeChange {
+    int old_data_size;
+  };
+  using Change =
+      std::variant<NodeChange, TableChange, NodeSetChange, ModuleChange,
+                   FinishedRunChange, StreamedDataSizeChange>;
+
+  std::shared_ptr<const SchedulingGraphIndex> graph_index_;
+  SchedulingGraphIndex::NodeIdSet available_nodes_;
+  SchedulingGraphIndex::NodeIdSet processed_nodes_;
+  std::vector<std::optional<SchedulingQueryNode>> graph_;
+  std::vector<ScheduledModule> current_run_;
+  std::vector<std::vector<ScheduledModule>> current_plan_;
+  std::vector<std::optional<TableMetadata>> data_tables_;
+  SchedulingGraphIndex::NodeIdSet blocked_nodes_;
+  SchedulingGraphIndex::NodeIdSet next_run_blocked_nodes_;
+  int streamed_data_size_;
+  std::vector<Change> change_log_;
+  std::size_t hash_ = 0;
+  // Saved changes which aren't hashed yet as the values can still change.
+  std::vector<int> unhashed_changes_;
+
+  auto GetMutableNodes(NodeSet node_set) -> SchedulingGraphIndex::NodeIdSet&;
+
+  void SaveChange(Change change);
+  static auto IsOverlapping(const Change& lhs, const Change& rhs) -> bool;
+  void HashSavedChanges();
+  auto GetChangedValuesHash(const Change& change) const -> std::size_t;
+  auto GetFullHash() const -> std::size_t;
+  auto GetGraphHash() const -> std::size_t;
+  auto GetTablesHash() const -> std::size_t;
+  auto GetRunHash() const -> std::size_t;
+  auto GetNodeSetHash(NodeSet node_set, int node_id) const -> std::size_t;
+  auto GetNodeHash(int node_id) const -> std::size_t;
+  auto GetTableHash(int table_id) const -> std::size_t;
+  static auto GetModuleHash(const ScheduledModule& module_placement)
+      -> std::size_t;
+
+  void Undo(NodeChange& change);
+  void Undo(TableChange& change);
+  void Undo(NodeSetChange& change);
+  void Undo(ModuleChange& change);
+  void Undo(FinishedRunChange& change);
+  void Undo(StreamedDataSizeChange& change);
+};
+
+}  // namespace orkhestrafs::dbmstodspi
@@ -32,7 +32,10 @@ class SimplePlanEvaluator : public PlanEvaluatorInterface {
                    const std::map<std::vector<std::vector<ScheduledModule>>,
                                   ExecutionPlanSchedulingData>& plan_metadata,
                    const std::map<char, int>& cost_of_columns,
-                   double streaming_speed, double configuration_speed)
+                   double streaming_speed,
+                   const ReconfigurationCostModel& cost_model,
+                   const std::map<std::string, double>& module_reuse_weights,
+                   const std::set<std::string>& pinned_modules)
       -> std::tuple<std::vector<std::vector<ScheduledModule>>,
                     std::vector<ScheduledModule>, long, long> override;
 };
@@ -0,0 +1,99 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "speculative_configurator.hpp"
+
+#include <algorithm>
+
+using orkhestrafs::dbmstodspi::SpeculativeConfigurator;
+
+auto SpeculativeConfigurator::GetPrefetchableModules(
+    const std::vector<ScheduledModule>& current_config,
+    const std::vector<ScheduledModule>& next_run,
+    const std::vector<std::string>& current_routing)
+    -> std::vector<ScheduledModule> {
+  std::vector<ScheduledModule> prefetchable_modules;
+  int first_idle_column = GetFirstIdleColumn(current_routing);
+  for (const auto& next_module : next_run) {
+    if (next_module.position.first < first_idle_column ||
+        next_module.position.second >= current_routing.size()) {
+      continue;
+    }
+    bool is_configured = std::any_of(
+        current_config.begin(), current_config.end(),
+        [&](const auto& cur_module) {
+          return cur_module.operation_type == next_module.operation_type &&
+                 cur_module.bitstream == next_module.bitstream &&
+                 cur_module.position == next_module.position;
+        });
+    if (!is_configured) {
+      prefetchable_modules.push_back(next_module);
+    }
+  }
+  return prefetchable_modules;
+}
+
+auto SpeculativeConfigurator::ReserveModules(
+    std::vector<ScheduledModule>& current_config,
+    const std::vector<ScheduledModule>& prefetched_modules,
+    std::vector<std::string>& current_routing) -> std::vector<std::string> {
+  std::vector<std::string> required_bitstreams;
+  for (const auto& new_module : prefetched_modules) {
+    // Overwritten modules are removed together with their routing such that
+    // the leftover columns get routed again with the next run.
+    for (const auto& cur_module : current_config) {
+      if (IsOverlapping(cur_module, new_module)) {
+        for (int column_i = cur_module.position.first;
+             column_i < cur_module.position.second + 1; column_i++) {
+          current_routing[column_i] = "";
+        }
+      }
+    }
+    current_config.erase(
+        std::remove_if(current_config.begin(), current_config.end(),
+                       [&](const auto& cur_module) {
+                         return IsOverlapping(cur_module, new_module);
+                       }),
+        current_config.end());
+
+    for (int column_i = new_module.position.first;
+         column_i < new_module.position.second + 1; column_i++) {
+      current_routing[column_i] = new_module.bitstream;
+    }
+    current_config.push_back(new_module);
+    required_bitstreams.push_back(new_module.bitstream);
+  }
+  return required_bitstreams;
+}
+
+auto SpeculativeConfigurator::GetFirstIdleColumn(
+    const std::vector<std::string>& current_routing) -> int {
+  auto turnaround_column =
+      std::find(current_routing.begin(), current_routing.end(), "TAA");
+  if (turnaround_column == current_routing.end()) {
+    // Without a turnaround the data path goes through every column.
+    return current_routing.size();
+  }
+  return std::distance(current_routing.begin(), turnaround_column) + 1;
+}
+
+auto SpeculativeConfigurator::IsOverlapping(
+    const ScheduledModule& first_module, const ScheduledModule& second_module)
+    -> bool {
+  // Assuming inclusive coordinates
+  return first_module.position.first <= second_module.position.second &&
+         second_module.position.first <= first_module.position.second;
+}
@@ -0,0 +1,76 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+#include <string>
+#include <vector>
+
+#include "scheduled_module.hpp"
+
+using orkhestrafs::dbmstodspi::ScheduledModule;
+
+namespace orkhestrafs::dbmstodspi {
+
+/**
+ * @brief Class to find modules of the next run which can be configured while
+ * the current run is still streaming.
+ *
+ * The current run's data path ends at its turnaround column. Every PR column
+ * after that is idle during execution and can be reconfigured with the next
+ * run's modules without disturbing the running streams.
+ */
+class SpeculativeConfigurator {
+ public:
+  /**
+   * @brief Find the next run's modules which fit into the idle columns.
+   * @param current_config Modules currently configured on the FPGA.
+   * @param next_run Modules scheduled for the next run.
+   * @param current_routing Bitstream configured in each PR column.
+   * @return Modules which can be loaded while the current run executes.
+   */
+  static auto GetPrefetchableModules(
+      const std::vector<ScheduledModule>& current_config,
+      const std::vector<ScheduledModule>& next_run,
+      const std::vector<std::string>& current_routing)
+      -> std::vector<ScheduledModule>;
+
+  /**
+   * @brief Mark the given modules as configured such that they don't get
+   * loaded again when the next run is set up.
+   * @param current_config Modules currently configured on the FPGA.
+   * @param prefetched_modules Modules to be loaded speculatively.
+   * @param current_routing Bitstream configured in each PR column.
+   * @return Bitstreams which need to be loaded.
+   */
+  static auto ReserveModules(
+      std::vector<ScheduledModule>& current_config,
+      const std::vector<ScheduledModule>& prefetched_modules,
+      std::vector<std::string>& current_routing) -> std::vector<std::string>;
+
+  /**
+   * @brief Find the first column after the current run's data path.
+   * @param current_routing Bitstream configured in each PR column.
+   * @return Index of the first idle column.
+   */
+  static auto GetFirstIdleColumn(
+      const std::vector<std::string>& current_routing) -> int;
+
+ private:
+  static auto IsOverlapping(const ScheduledModule& first_module,
+                            const ScheduledModule& second_module) -> bool;
+};
+
+}  // namespace orkhestrafs::dbmstodspi
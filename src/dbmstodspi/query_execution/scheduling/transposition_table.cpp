@@ -0,0 +1,58 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "transposition_table.hpp"
+
+#include <utility>
+
+using orkhestrafs::dbmstodspi::TranspositionTable;
+
+auto TranspositionTable::Find(std::size_t state_hash) -> const Entry* {
+  statistics_.lookups++;
+  auto search = entries_.find(state_hash);
+  if (search == entries_.end()) {
+    return nullptr;
+  }
+  statistics_.hits++;
+  return &search->second;
+}
+
+void TranspositionTable::Insert(std::size_t state_hash, Entry entry) {
+  if (entry.found_plans.size() > GetRemainingCapacity()) {
+    statistics_.rejected_states++;
+    return;
+  }
+  int plan_count = entry.found_plans.size();
+  if (entries_.insert({state_hash, std::move(entry)}).second) {
+    stored_plans_ += plan_count;
+    statistics_.stored_states++;
+  }
+}
+
+auto TranspositionTable::GetRemainingCapacity() const -> int {
+  return capacity_ - stored_plans_;
+}
+
+auto TranspositionTable::GetStatistics() const -> Statistics {
+  return statistics_;
+}
+
+void TranspositionTable::Clear() {
+  entries_.clear();
+  stored_plans_ = 0;
+  statistics_ = {};
+}
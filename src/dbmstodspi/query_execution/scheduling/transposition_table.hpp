@@ -0,0 +1,98 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "scheduled_module.hpp"
+#include "scheduling_data.hpp"
+
+using orkhestrafs::dbmstodspi::ScheduledModule;
+using orkhestrafs::dbmstodspi::scheduling_data::ExecutionPlanSchedulingData;
+
+namespace orkhestrafs::dbmstodspi {
+
+/**
+ * @brief Table of fully searched scheduling states.
+ *
+ * Each entry holds every plan found from a state such that the same state
+ * reached through a different placement order doesn't have to be searched
+ * again. The table holds up to the given number of plans and rejects new
+ * entries once it is full.
+ */
+class TranspositionTable {
+ public:
+  /**
+   * @brief Plan found by the search with its data and branch path.
+   */
+  struct FoundPlan {
+    std::vector<std::vector<ScheduledModule>> plan;
+    ExecutionPlanSchedulingData scheduling_data;
+    std::vector<int> branch_path;
+  };
+
+  /**
+   * @brief Plans found after a state.
+   *
+   * Plans are shared between all of the states they were found from. The
+   * state's runs, streamed data size and branch path are stored to take the
+   * continuation after the state out of each plan.
+   */
+  struct Entry {
+    int finished_run_count;
+    int streamed_data_size;
+    int branch_path_length;
+    std::vector<std::shared_ptr<const FoundPlan>> found_plans;
+  };
+
+  struct Statistics {
+    long lookups = 0;
+    long hits = 0;
+    long stored_states = 0;
+    long rejected_states = 0;
+  };
+
+  explicit TranspositionTable(int capacity) : capacity_{capacity} {};
+
+  /**
+   * @brief Find plans found after the given state.
+   * @param state_hash Hash of the state.
+   * @return Pointer to the entry or nullptr if the state hasn't been stored.
+   */
+  auto Find(std::size_t state_hash) -> const Entry*;
+  /**
+   * @brief Store plans for a state if there is enough space left.
+   * @param state_hash Hash of the state.
+   * @param entry All plans found after the state.
+   */
+  void Insert(std::size_t state_hash, Entry entry);
+
+  [[nodiscard]] auto GetRemainingCapacity() const -> int;
+  [[nodiscard]] auto GetStatistics() const -> Statistics;
+  void Clear();
+
+ private:
+  const int capacity_;
+  int stored_plans_ = 0;
+  Statistics statistics_;
+  std::unordered_map<std::size_t, Entry> entries_;
+};
+
+}  // namespace orkhestrafs::dbmstodspi
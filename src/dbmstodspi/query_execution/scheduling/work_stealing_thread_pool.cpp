@@ -0,0 +1,155 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "work_stealing_thread_pool.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+using orkhestrafs::dbmstodspi::WorkStealingThreadPool;
+
+namespace {
+thread_local int current_worker_index = -1;
+}  // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(int thread_count) {
+  if (thread_count < 1) {
+    throw std::runtime_error("Thread pool needs at least one worker!");
+  }
+  queues_.reserve(thread_count);
+  for (int worker_index = 0; worker_index < thread_count; worker_index++) {
+    queues_.push_back(std::make_unique<WorkerQueue>());
+  }
+  workers_.reserve(thread_count);
+  for (int worker_index = 0; worker_index < thread_count; worker_index++) {
+    workers_.emplace_back(&WorkStealingThreadPool::RunWorker, this,
+                          worker_index);
+  }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    is_stopping_ = true;
+  }
+  work_available_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void WorkStealingThreadPool::Submit(Task task) {
+  int queue_index = current_worker_index < 0 ? 0 : current_worker_index;
+  unfinished_tasks_++;
+  {
+    std::lock_guard<std::mutex> lock(queues_.at(queue_index)->mutex);
+    queues_.at(queue_index)->tasks.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    queued_tasks_++;
+  }
+  work_available_.notify_one();
+}
+
+void WorkStealingThreadPool::WaitForAll() {
+  std::unique_lock<std::mutex> lock(state_mutex_);
+  all_done_.wait(lock, [&] { return unfinished_tasks_ == 0; });
+  is_cancelled_ = false;
+  if (first_exception_) {
+    auto exception = first_exception_;
+    first_exception_ = nullptr;
+    std::rethrow_exception(exception);
+  }
+}
+
+auto WorkStealingThreadPool::HasIdleWorkers() const -> bool {
+  return queued_tasks_ < idle_workers_;
+}
+
+auto WorkStealingThreadPool::GetThreadCount() const -> int {
+  return workers_.size();
+}
+
+auto WorkStealingThreadPool::GetWorkerIndex() -> int {
+  return current_worker_index;
+}
+
+void WorkStealingThreadPool::RunWorker(int worker_index) {
+  current_worker_index = worker_index;
+  Task task;
+  while (true) {
+    if (PopOwnTask(worker_index, task) || StealTask(worker_index, task)) {
+      RunTask(task);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(state_mutex_);
+    idle_workers_++;
+    work_available_.wait(lock,
+                         [&] { return is_stopping_ || queued_tasks_ > 0; });
+    idle_workers_--;
+    if (is_stopping_) {
+      return;
+    }
+  }
+}
+
+auto WorkStealingThreadPool::PopOwnTask(int worker_index, Task& task)
+    -> bool {
+  auto& queue = *queues_.at(worker_index);
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.tasks.empty()) {
+    return false;
+  }
+  task = std::move(queue.tasks.back());
+  queue.tasks.pop_back();
+  queued_tasks_--;
+  return true;
+}
+
+auto WorkStealingThreadPool::StealTask(int worker_index, Task& task) -> bool {
+  for (int offset = 1; offset < queues_.size(); offset++) {
+    auto& queue = *queues_.at((worker_index + offset) % queues_.size());
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      queued_tasks_--;
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingThreadPool::RunTask(Task& task) {
+  if (!is_cancelled_) {
+    try {
+      task();
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(state_mutex_);
+      if (!first_exception_) {
+        first_exception_ = std::current_exception();
+      }
+      is_cancelled_ = true;
+    }
+  }
+  task = nullptr;
+  if (--unfinished_tasks_ == 0) {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    all_done_.notify_all();
+  }
+}
@@ -0,0 +1,103 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace orkhestrafs::dbmstodspi {
+
+/**
+ * @brief Fixed size thread pool where each worker has its own task queue.
+ *
+ * Workers take their newest task first and steal the oldest task of another
+ * worker once their own queue is empty. Tasks submitted by a worker are pushed
+ * to that worker's queue such that recursive searches stay local.
+ */
+class WorkStealingThreadPool {
+ public:
+  using Task = std::function<void()>;
+
+  /**
+   * @brief Start the worker threads.
+   * @param thread_count How many workers to start.
+   */
+  explicit WorkStealingThreadPool(int thread_count);
+  ~WorkStealingThreadPool();
+
+  WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+  auto operator=(const WorkStealingThreadPool&)
+      -> WorkStealingThreadPool& = delete;
+
+  /**
+   * @brief Queue a task to the current worker or the first worker if called
+   * from outside of the pool.
+   * @param task Task to execute.
+   */
+  void Submit(Task task);
+  /**
+   * @brief Block until all submitted tasks have finished.
+   *
+   * If a task threw, the tasks still queued are skipped and the first
+   * exception is rethrown.
+   */
+  void WaitForAll();
+  /**
+   * @brief Check if there are workers which wouldn't get a queued task.
+   * @return Boolean flag noting if a new task would be picked up straight
+   * away.
+   */
+  [[nodiscard]] auto HasIdleWorkers() const -> bool;
+  [[nodiscard]] auto GetThreadCount() const -> int;
+  /**
+   * @brief Get the index of the worker running the calling thread.
+   * @return Worker index or -1 if not called from a worker.
+   */
+  static auto GetWorkerIndex() -> int;
+
+ private:
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  std::vector<std::thread> workers_;
+  std::mutex state_mutex_;
+  std::condition_variable work_available_;
+  std::condition_variable all_done_;
+  std::atomic<int> queued_tasks_ = 0;
+  std::atomic<int> unfinished_tasks_ = 0;
+  std::atomic<int> idle_workers_ = 0;
+  std::atomic<bool> is_cancelled_ = false;
+  std::exception_ptr first_exception_;
+  bool is_stopping_ = false;
+
+  void RunWorker(int worker_index);
+  auto PopOwnTask(int worker_index, Task& task) -> bool;
+  auto StealTask(int worker_index, Task& task) -> bool;
+  void RunTask(Task& task);
+};
+
+}  // namespace orkhestrafs::dbmstodspi
@@ -102,6 +102,9 @@ auto InteractiveState::Execute(GraphProcessingFSMInterface* fsm)
         fsm->SetHWPrint(true);
       }
       break;
+    case 10:
+      fsm->VerifyConfiguration();
+      break;
     default:
       std::cout << "Incorrect option" << std::endl;
   }
@@ -218,6 +221,7 @@ void InteractiveState::PrintOptions(GraphProcessingFSMInterface* fsm) {
   } else {
     std::cout << "9: Enable HW print" << std::endl;
   }
+  std::cout << "10: Verify configuration" << std::endl;
   std::cout << "Choose one of the supported options by typing a valid number "
                "and a ';'"
             << std::endl;
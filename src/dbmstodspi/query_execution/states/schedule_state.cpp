@@ -33,6 +33,7 @@ auto ScheduleState::Execute(GraphProcessingFSMInterface* fsm)
   Log(LogLevel::kTrace, "Schedule state");
   fsm->UpdateAvailableNodesGraph();
   if (fsm->IsUnscheduledNodesGraphEmpty()) {
+    fsm->FinishQuery();
     if (fsm->IsInteractive()){
       fsm->PrintExecTime();
       return std::make_unique<InteractiveState>();
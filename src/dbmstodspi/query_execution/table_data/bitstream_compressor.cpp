@@ -0,0 +1,219 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "bitstream_compressor.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+using orkhestrafs::dbmstodspi::BitstreamCompressor;
+
+auto BitstreamCompressor::Compress(std::istream& input, uintmax_t input_size,
+                                   std::ostream& output) -> uintmax_t {
+  if (input_size > std::numeric_limits<uint32_t>::max()) {
+    throw std::runtime_error("Bitstream is too large to compress!");
+  }
+  uintmax_t output_size = 0;
+  WriteWord(output, kMagicWord, output_size);
+  WriteWord(output, input_size, output_size);
+
+  std::vector<uint32_t> literals;
+  literals.reserve(kChunkWords);
+  uint32_t run_word = 0;
+  uint32_t run_length = 0;
+  auto end_run = [&]() {
+    if (run_length >= kMinRunLength) {
+      WriteLiterals(output, literals, output_size);
+      WriteWord(output, kRunFlag | run_length, output_size);
+      WriteWord(output, run_word, output_size);
+    } else {
+      for (uint32_t i = 0; i < run_length; i++) {
+        literals.push_back(run_word);
+        if (literals.size() == kChunkWords) {
+          WriteLiterals(output, literals, output_size);
+        }
+      }
+    }
+    run_length = 0;
+  };
+
+  std::vector<char> chunk(kChunkWords * kWordSize);
+  uintmax_t remaining_bytes = input_size;
+  while (remaining_bytes > 0) {
+    auto chunk_bytes = std::min<uintmax_t>(remaining_bytes, chunk.size());
+    input.read(chunk.data(), chunk_bytes);
+    if (!input) {
+      throw std::runtime_error("Couldn't read the bitstream!");
+    }
+    remaining_bytes -= chunk_bytes;
+    // The last word is padded with zeroes.
+    std::fill(chunk.begin() + chunk_bytes, chunk.end(), 0);
+    for (int offset = 0; offset < chunk_bytes; offset += kWordSize) {
+      auto word = ReadWord(chunk, offset);
+      if (run_length > 0 && word == run_word && run_length < kCountMask) {
+        run_length++;
+      } else {
+        end_run();
+        run_word = word;
+        run_length = 1;
+      }
+    }
+  }
+  end_run();
+  WriteLiterals(output, literals, output_size);
+  if (!output) {
+    throw std::runtime_error("Couldn't write the compressed bitstream!");
+  }
+  return output_size;
+}
+
+auto BitstreamCompressor::Decompress(std::istream& input, std::ostream& output)
+    -> uintmax_t {
+  uint32_t magic_word = 0;
+  uint32_t bitstream_size = 0;
+  if (!ReadWord(input, magic_word) || magic_word != kMagicWord ||
+      !ReadWord(input, bitstream_size)) {
+    throw std::runtime_error("Not a compressed bitstream!");
+  }
+
+  std::vector<char> chunk(kChunkWords * kWordSize);
+  uintmax_t remaining_bytes = bitstream_size;
+  while (remaining_bytes > 0) {
+    uint32_t token = 0;
+    if (!ReadWord(input, token)) {
+      throw std::runtime_error("Compressed bitstream is truncated!");
+    }
+    uintmax_t token_bytes = static_cast<uintmax_t>(token & kCountMask) *
+                            kWordSize;
+    // Only the padding of the last word can be left over.
+    if (token_bytes >= remaining_bytes + kWordSize) {
+      throw std::runtime_error("Compressed bitstream is corrupted!");
+    }
+    token_bytes = std::min(token_bytes, remaining_bytes);
+    remaining_bytes -= token_bytes;
+
+    if ((token & kRunFlag) != 0U) {
+      uint32_t run_word = 0;
+      if (!ReadWord(input, run_word)) {
+        throw std::runtime_error("Compressed bitstream is truncated!");
+      }
+      auto pattern_bytes = std::min<uintmax_t>(token_bytes, chunk.size());
+      for (int offset = 0; offset < pattern_bytes; offset += kWordSize) {
+        WriteWord(chunk, offset, run_word);
+      }
+      while (token_bytes > 0) {
+        auto chunk_bytes = std::min<uintmax_t>(token_bytes, chunk.size());
+        output.write(chunk.data(), chunk_bytes);
+        token_bytes -= chunk_bytes;
+      }
+    } else {
+      // Literal words are copied as they are stored.
+      auto literal_bytes = static_cast<uintmax_t>(token) * kWordSize;
+      while (literal_bytes > 0) {
+        auto chunk_bytes = std::min<uintmax_t>(literal_bytes, chunk.size());
+        input.read(chunk.data(), chunk_bytes);
+        if (!input) {
+          throw std::runtime_error("Compressed bitstream is truncated!");
+        }
+        output.write(chunk.data(), std::min(chunk_bytes, token_bytes));
+        literal_bytes -= chunk_bytes;
+        token_bytes -= std::min(chunk_bytes, token_bytes);
+      }
+    }
+  }
+  if (!output) {
+    throw std::runtime_error("Couldn't write the decompressed bitstream!");
+  }
+  return bitstream_size;
+}
+
+auto BitstreamCompressor::CompressFile(const std::string& input_filename,
+                                       const std::string& output_filename)
+    -> uintmax_t {
+  std::ifstream input_file(input_filename, std::ios::binary | std::ios::ate);
+  if (!input_file) {
+    throw std::runtime_error("Couldn't open " + input_filename);
+  }
+  uintmax_t input_size = input_file.tellg();
+  input_file.seekg(0);
+  std::ofstream output_file(output_filename, std::ios::binary);
+  return Compress(input_file, input_size, output_file);
+}
+
+auto BitstreamCompressor::DecompressFile(const std::string& input_filename,
+                                         const std::string& output_filename)
+    -> uintmax_t {
+  std::ifstream input_file(input_filename, std::ios::binary);
+  if (!input_file) {
+    throw std::runtime_error("Couldn't open " + input_filename);
+  }
+  std::ofstream output_file(output_filename, std::ios::binary);
+  return Decompress(input_file, output_file);
+}
+
+auto BitstreamCompressor::ReadWord(std::istream& input, uint32_t& word)
+    -> bool {
+  std::vector<char> word_bytes(kWordSize);
+  if (!input.read(word_bytes.data(), kWordSize)) {
+    return false;
+  }
+  word = ReadWord(word_bytes, 0);
+  return true;
+}
+
+auto BitstreamCompressor::ReadWord(const std::vector<char>& data, int offset)
+    -> uint32_t {
+  uint32_t word = 0;
+  for (int i = 0; i < kWordSize; i++) {
+    word = (word << 8) | static_cast<uint8_t>(data[offset + i]);
+  }
+  return word;
+}
+
+void BitstreamCompressor::WriteWord(std::vector<char>& data, int offset,
+                                    uint32_t word) {
+  for (int i = kWordSize - 1; i >= 0; i--) {
+    data[offset + i] = static_cast<char>(word & 0xFF);
+    word >>= 8;
+  }
+}
+
+void BitstreamCompressor::WriteWord(std::ostream& output, uint32_t word,
+                                    uintmax_t& output_size) {
+  std::vector<char> word_bytes(kWordSize);
+  WriteWord(word_bytes, 0, word);
+  output.write(word_bytes.data(), kWordSize);
+  output_size += kWordSize;
+}
+
+void BitstreamCompressor::WriteLiterals(std::ostream& output,
+                                        std::vector<uint32_t>& literals,
+                                        uintmax_t& output_size) {
+  if (literals.empty()) {
+    return;
+  }
+  WriteWord(output, literals.size(), output_size);
+  std::vector<char> literal_bytes(literals.size() * kWordSize);
+  for (int i = 0; i < literals.size(); i++) {
+    WriteWord(literal_bytes, i * kWordSize, literals[i]);
+  }
+  output.write(literal_bytes.data(), literal_bytes.size());
+  output_size += literal_bytes.size();
+  literals.clear();
+}
@@ -0,0 +1,96 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace orkhestrafs::dbmstodspi {
+
+/**
+ * @brief Class to compress partial bitstreams for storage.
+ *
+ * Most of the frames in the partial bitstreams are empty so the 32-bit words
+ * are run-length encoded. A header with the original size is followed by
+ * tokens: A run token holds the repeat count and the repeated word. A literal
+ * token holds the count of the words copied after it. Decompression works on
+ * fixed size chunks such that whole bitstreams don't have to be kept in
+ * memory.
+ */
+class BitstreamCompressor {
+ public:
+  /// File extension of the compressed bitstreams.
+  static constexpr char kCompressedExtension[] = ".rle";
+
+  /**
+   * @brief Compress the given bitstream data.
+   * @param input Bitstream data.
+   * @param input_size Bitstream size in bytes.
+   * @param output Stream to write the compressed data to.
+   * @return Compressed size in bytes.
+   */
+  static auto Compress(std::istream& input, uintmax_t input_size,
+                       std::ostream& output) -> uintmax_t;
+  /**
+   * @brief Decompress the given compressed bitstream data.
+   * @param input Compressed data.
+   * @param output Stream to write the bitstream to.
+   * @return Bitstream size in bytes.
+   */
+  static auto Decompress(std::istream& input, std::ostream& output)
+      -> uintmax_t;
+
+  /**
+   * @brief Compress the given bitstream file.
+   * @param input_filename Bitstream file name.
+   * @param output_filename Compressed file name.
+   * @return Compressed size in bytes.
+   */
+  static auto CompressFile(const std::string& input_filename,
+                           const std::string& output_filename) -> uintmax_t;
+  /**
+   * @brief Decompress the given compressed bitstream file.
+   * @param input_filename Compressed file name.
+   * @param output_filename Bitstream file name.
+   * @return Bitstream size in bytes.
+   */
+  static auto DecompressFile(const std::string& input_filename,
+                             const std::string& output_filename) -> uintmax_t;
+
+ private:
+  static const uint32_t kMagicWord = 0x4F524C45;
+  static const int kWordSize = 4;
+  static const uint32_t kRunFlag = 0x80000000;
+  static const uint32_t kCountMask = 0x7FFFFFFF;
+  // Shorter runs are cheaper to store as literals.
+  static const int kMinRunLength = 3;
+  static const int kChunkWords = 16 * 1024;
+
+  static auto ReadWord(std::istream& input, uint32_t& word) -> bool;
+  static auto ReadWord(const std::vector<char>& data, int offset) -> uint32_t;
+  static void WriteWord(std::vector<char>& data, int offset, uint32_t word);
+  static void WriteWord(std::ostream& output, uint32_t word,
+                        uintmax_t& output_size);
+  static void WriteLiterals(std::ostream& output,
+                            std::vector<uint32_t>& literals,
+                            uintmax_t& output_size);
+};
+
+}  // namespace orkhestrafs::dbmstodspi
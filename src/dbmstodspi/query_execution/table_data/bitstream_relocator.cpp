@@ -0,0 +1,311 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "bitstream_relocator.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+
+using orkhestrafs::dbmstodspi::BitstreamRelocator;
+
+namespace {
+const uint32_t kPacketTypeOffset = 29;
+const uint32_t kType1Packet = 1;
+const uint32_t kType2Packet = 2;
+const uint32_t kOpcodeOffset = 27;
+const uint32_t kOpcodeMask = 0x3;
+const uint32_t kWriteOpcode = 2;
+const uint32_t kRegisterOffset = 13;
+const uint32_t kRegisterMask = 0x3FFF;
+const uint32_t kType1WordCountMask = 0x7FF;
+const uint32_t kType2WordCountMask = 0x7FFFFFF;
+const uint32_t kFARRegister = 1;
+const uint32_t kFDRIRegister = 2;
+}  // namespace
+
+auto BitstreamRelocator::Relocate(const std::vector<char>& source_bitstream,
+                                  int column_shift,
+                                  const std::vector<char>& location_template,
+                                  bool is_template_end_aligned)
+    -> std::vector<char> {
+  auto source_layout = GetLayout(source_bitstream);
+  auto template_layout = GetLayout(location_template);
+  if (source_layout.frame_data.size() != template_layout.frame_data.size()) {
+    throw std::runtime_error(
+        "Location template doesn't match the bitstream rows!");
+  }
+
+  auto relocated_bitstream = source_bitstream;
+  for (const auto& offset : source_layout.frame_addresses) {
+    auto frame_address = ReadWord(relocated_bitstream, offset);
+    if (((frame_address >> kFARBlockTypeOffset) & kFARBlockTypeMask) >
+        kMaxFrameBlockType) {
+      // Closing dummy address.
+      continue;
+    }
+    int column = static_cast<int>((frame_address >> kFARColumnOffset) &
+                                  kFARColumnMask) +
+                 column_shift;
+    if (column < 0 || column > kFARColumnMask) {
+      throw std::runtime_error("Bitstream can't be relocated out of the FPGA!");
+    }
+    frame_address &= ~(kFARColumnMask << kFARColumnOffset);
+    frame_address |= static_cast<uint32_t>(column) << kFARColumnOffset;
+    WriteWord(relocated_bitstream, offset, frame_address);
+  }
+
+  for (int block_i = 0; block_i < source_layout.frame_data.size(); block_i++) {
+    auto [data_offset, word_count] = source_layout.frame_data.at(block_i);
+    auto [template_offset, template_word_count] =
+        template_layout.frame_data.at(block_i);
+    int frame_count = word_count / kFrameWords;
+    int template_frame_count = template_word_count / kFrameWords;
+    if (template_frame_count < frame_count) {
+      throw std::runtime_error("Location template doesn't cover the frames!");
+    }
+    int first_template_frame =
+        is_template_end_aligned ? template_frame_count - frame_count : 0;
+    for (int frame_i = 0; frame_i < frame_count; frame_i++) {
+      int clock_words_offset =
+          data_offset + (frame_i * kFrameWords + kClockWordsOffset) * kWordSize;
+      int template_clock_words_offset =
+          template_offset +
+          ((first_template_frame + frame_i) * kFrameWords + kClockWordsOffset) *
+              kWordSize;
+      std::copy_n(location_template.begin() + template_clock_words_offset,
+                  kClockWordCount * kWordSize,
+                  relocated_bitstream.begin() + clock_words_offset);
+    }
+  }
+  return relocated_bitstream;
+}
+
+void BitstreamRelocator::RelocateFile(const BitstreamRelocation& relocation,
+                                      const std::string& output_filename) {
+  auto relocated_bitstream = Relocate(
+      ReadFile(relocation.source_bitstream), relocation.column_shift,
+      ReadFile(relocation.location_template),
+      relocation.is_template_end_aligned);
+  std::ofstream output_file(output_filename, std::ios::binary);
+  output_file.write(relocated_bitstream.data(), relocated_bitstream.size());
+  if (!output_file) {
+    throw std::runtime_error("Couldn't write " + output_filename);
+  }
+}
+
+auto BitstreamRelocator::AddRelocatedBitstreams(
+    std::map<QueryOperationType, OperationPRModules>& hw_library,
+    const std::string& resource_string)
+    -> std::map<std::string, BitstreamRelocation> {
+  // Existing bitstreams as location, length and name.
+  std::vector<std::tuple<int, int, std::string>> location_templates;
+  for (const auto& [operation, operation_modules] : hw_library) {
+    for (const auto& [bitstream, module_data] :
+         operation_modules.bitstream_map) {
+      if (module_data.fitting_locations.size() == 1) {
+        location_templates.emplace_back(module_data.fitting_locations.front(),
+                                        module_data.length, bitstream);
+      }
+    }
+  }
+
+  std::map<std::string, BitstreamRelocation> relocations;
+  for (auto& [operation, operation_modules] : hw_library) {
+    // One source bitstream for each module.
+    std::map<std::string, std::string> module_bitstreams;
+    for (const auto& [bitstream, module_data] :
+         operation_modules.bitstream_map) {
+      std::string module_name;
+      // The columns in the name have to match the library data.
+      if (module_data.fitting_locations.size() == 1 &&
+          GetModuleName(bitstream, module_name) &&
+          GetBitstreamName(module_name, module_data.fitting_locations.front(),
+                           module_data.length) == bitstream) {
+        module_bitstreams.insert({module_name, bitstream});
+      }
+    }
+
+    for (const auto& [module_name, source_bitstream] : module_bitstreams) {
+      auto module_data = operation_modules.bitstream_map.at(source_bitstream);
+      int source_location = module_data.fitting_locations.front();
+      auto footprint =
+          resource_string.substr(source_location, module_data.length);
+      for (int location = 0;
+           location + module_data.length <= resource_string.size();
+           location++) {
+        auto bitstream =
+            GetBitstreamName(module_name, location, module_data.length);
+        if (resource_string.substr(location, module_data.length) !=
+                footprint ||
+            operation_modules.bitstream_map.find(bitstream) !=
+                operation_modules.bitstream_map.end()) {
+          continue;
+        }
+        for (const auto& [template_location, template_length,
+                          template_bitstream] : location_templates) {
+          if (template_length < module_data.length) {
+            continue;
+          }
+          bool is_end_aligned = template_location == location;
+          bool is_start_aligned = template_location + template_length ==
+                                  location + module_data.length;
+          if (is_end_aligned || is_start_aligned) {
+            relocations.insert(
+                {bitstream,
+                 {source_bitstream, template_bitstream,
+                  (source_location - location) * kFARColumnsPerPRColumn,
+                  is_end_aligned}});
+            auto relocated_module_data = module_data;
+            relocated_module_data.fitting_locations = {location};
+            relocated_module_data.compressed_bitstream.clear();
+            operation_modules.bitstream_map.insert(
+                {bitstream, relocated_module_data});
+            if (operation_modules.starting_locations.size() <= location) {
+              operation_modules.starting_locations.resize(location + 1);
+            }
+            operation_modules.starting_locations.at(location).push_back(
+                bitstream);
+            break;
+          }
+        }
+      }
+    }
+  }
+  return relocations;
+}
+
+auto BitstreamRelocator::GetFrameData(const std::vector<char>& bitstream)
+    -> std::vector<char> {
+  std::vector<char> frame_data;
+  for (const auto& [offset, word_count] : GetLayout(bitstream).frame_data) {
+    frame_data.insert(frame_data.end(), bitstream.begin() + offset,
+                      bitstream.begin() + offset + word_count * kWordSize);
+  }
+  return frame_data;
+}
+
+auto BitstreamRelocator::GetLayout(const std::vector<char>& bitstream)
+    -> BitstreamLayout {
+  int offset = 0;
+  while (offset + kWordSize <= bitstream.size() &&
+         ReadWord(bitstream, offset) != kSyncWord) {
+    offset += kWordSize;
+  }
+  if (offset + kWordSize > bitstream.size()) {
+    throw std::runtime_error("Bitstream sync word not found!");
+  }
+  offset += kWordSize;
+
+  BitstreamLayout layout;
+  uint32_t last_register = 0;
+  while (offset + kWordSize <= bitstream.size()) {
+    auto header = ReadWord(bitstream, offset);
+    offset += kWordSize;
+    auto packet_type = header >> kPacketTypeOffset;
+    auto opcode = (header >> kOpcodeOffset) & kOpcodeMask;
+    int word_count = 0;
+    if (packet_type == kType1Packet) {
+      last_register = (header >> kRegisterOffset) & kRegisterMask;
+      word_count = static_cast<int>(header & kType1WordCountMask);
+    } else if (packet_type == kType2Packet) {
+      word_count = static_cast<int>(header & kType2WordCountMask);
+    } else {
+      continue;
+    }
+    if (offset + word_count * kWordSize > bitstream.size()) {
+      throw std::runtime_error("Bitstream packet is truncated!");
+    }
+    if (opcode == kWriteOpcode && last_register == kFARRegister &&
+        word_count == 1) {
+      layout.frame_addresses.push_back(offset);
+    } else if (opcode == kWriteOpcode && last_register == kFDRIRegister &&
+               word_count != 0) {
+      layout.frame_data.emplace_back(offset, word_count);
+    }
+    offset += word_count * kWordSize;
+  }
+  return layout;
+}
+
+auto BitstreamRelocator::ReadWord(const std::vector<char>& bitstream,
+                                  int offset) -> uint32_t {
+  // Configuration words are big endian.
+  uint32_t word = 0;
+  for (int byte_i = 0; byte_i < kWordSize; byte_i++) {
+    word = (word << 8) |
+           static_cast<unsigned char>(bitstream.at(offset + byte_i));
+  }
+  return word;
+}
+
+void BitstreamRelocator::WriteWord(std::vector<char>& bitstream, int offset,
+                                   uint32_t word) {
+  for (int byte_i = kWordSize - 1; byte_i >= 0; byte_i--) {
+    bitstream.at(offset + byte_i) = static_cast<char>(word & 0xFF);
+    word >>= 8;
+  }
+}
+
+auto BitstreamRelocator::ReadFile(const std::string& filename)
+    -> std::vector<char> {
+  std::ifstream input_file(filename, std::ios::binary);
+  if (!input_file) {
+    throw std::runtime_error("Couldn't open " + filename);
+  }
+  return {std::istreambuf_iterator<char>(input_file),
+          std::istreambuf_iterator<char>()};
+}
+
+auto BitstreamRelocator::GetModuleName(const std::string& bitstream,
+                                       std::string& name) -> bool {
+  // Bitstreams are named <module>_<first_column>_<last_column>.bin
+  auto extension_position = bitstream.rfind(".bin");
+  auto last_column_position = bitstream.rfind('_', extension_position);
+  if (extension_position == std::string::npos ||
+      last_column_position == std::string::npos ||
+      last_column_position == 0) {
+    return false;
+  }
+  auto first_column_position = bitstream.rfind('_', last_column_position - 1);
+  if (first_column_position == std::string::npos) {
+    return false;
+  }
+  auto columns =
+      bitstream.substr(first_column_position + 1,
+                       extension_position - first_column_position - 1);
+  columns.erase(last_column_position - first_column_position - 1, 1);
+  if (columns.empty() ||
+      !std::all_of(columns.begin(), columns.end(),
+                   [](unsigned char c) { return std::isdigit(c); })) {
+    return false;
+  }
+  name = bitstream.substr(0, first_column_position);
+  return true;
+}
+
+auto BitstreamRelocator::GetBitstreamName(const std::string& module_name,
+                                          int location, int length)
+    -> std::string {
+  int last_column = kLastPRColumnFrame - location * kFARColumnsPerPRColumn;
+  int first_column = last_column - length * kFARColumnsPerPRColumn + 1;
+  return module_name + "_" + std::to_string(first_column) + "_" +
+         std::to_string(last_column) + ".bin";
+}
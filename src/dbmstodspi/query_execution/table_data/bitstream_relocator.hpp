@@ -0,0 +1,118 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "operation_types.hpp"
+#include "pr_module_data.hpp"
+
+using orkhestrafs::core_interfaces::hw_library::BitstreamRelocation;
+using orkhestrafs::core_interfaces::hw_library::OperationPRModules;
+using orkhestrafs::core_interfaces::operation_types::QueryOperationType;
+
+namespace orkhestrafs::dbmstodspi {
+
+/**
+ * @brief Class to create partial bitstreams for other PR locations by patching
+ * the frame addresses of an existing module bitstream.
+ *
+ * The middle words of each configuration frame hold the clock routing of the
+ * static design. Those depend only on the frame address and are copied from
+ * another bitstream covering the target frames.
+ */
+class BitstreamRelocator {
+ public:
+  /**
+   * @brief Relocate the given bitstream.
+   * @param source_bitstream Bitstream data to relocate.
+   * @param column_shift How many FAR columns to move the bitstream by.
+   * @param location_template Bitstream covering the target frames.
+   * @param is_template_end_aligned If the template ends at the same column as
+   * the target location instead of starting at the same column.
+   * @return Relocated bitstream data.
+   */
+  static auto Relocate(const std::vector<char>& source_bitstream,
+                       int column_shift,
+                       const std::vector<char>& location_template,
+                       bool is_template_end_aligned) -> std::vector<char>;
+
+  /**
+   * @brief Write the relocated bitstream file.
+   * @param relocation Source and template bitstream files with the shift.
+   * @param output_filename Relocated bitstream file name.
+   */
+  static void RelocateFile(const BitstreamRelocation& relocation,
+                           const std::string& output_filename);
+
+  /**
+   * @brief Add relocated bitstreams of every module to all fitting locations
+   * for which a location template exists in the library.
+   * @param hw_library PR module library to extend.
+   * @param resource_string PR region resources.
+   * @return Map of added bitstreams and how to create them.
+   */
+  static auto AddRelocatedBitstreams(
+      std::map<QueryOperationType, OperationPRModules>& hw_library,
+      const std::string& resource_string)
+      -> std::map<std::string, BitstreamRelocation>;
+
+  /**
+   * @brief Get the configuration frame data written by the bitstream.
+   * @param bitstream Bitstream data.
+   * @return Frame data of every FDRI write in bitstream order.
+   */
+  static auto GetFrameData(const std::vector<char>& bitstream)
+      -> std::vector<char>;
+
+ private:
+  static const uint32_t kSyncWord = 0xAA995566;
+  static const int kWordSize = 4;
+  static const int kFrameWords = 93;
+  static const int kClockWordsOffset = 45;
+  static const int kClockWordCount = 3;
+  static const int kFARColumnOffset = 8;
+  static const uint32_t kFARColumnMask = 0x3FF;
+  static const int kFARBlockTypeOffset = 24;
+  static const uint32_t kFARBlockTypeMask = 0x7;
+  static const uint32_t kMaxFrameBlockType = 1;
+  static const int kFARColumnsPerPRColumn = 3;
+  static const int kLastPRColumnFrame = 96;
+
+  // Byte offsets of the FAR values and the frame data with word counts.
+  struct BitstreamLayout {
+    std::vector<int> frame_addresses;
+    std::vector<std::pair<int, int>> frame_data;
+  };
+
+  static auto GetLayout(const std::vector<char>& bitstream) -> BitstreamLayout;
+  static auto ReadWord(const std::vector<char>& bitstream, int offset)
+      -> uint32_t;
+  static void WriteWord(std::vector<char>& bitstream, int offset,
+                        uint32_t word);
+  static auto ReadFile(const std::string& filename) -> std::vector<char>;
+  static auto GetModuleName(const std::string& bitstream, std::string& name)
+      -> bool;
+  static auto GetBitstreamName(const std::string& module_name, int location,
+                               int length) -> std::string;
+};
+
+}  // namespace orkhestrafs::dbmstodspi
@@ -0,0 +1,123 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "bitstream_staging_cache.hpp"
+
+#include <filesystem>
+#include <system_error>
+#include <utility>
+
+#include "logger.hpp"
+
+using orkhestrafs::dbmstodspi::BitstreamCacheStats;
+using orkhestrafs::dbmstodspi::BitstreamStagingCache;
+using orkhestrafs::dbmstodspi::logging::Log;
+using orkhestrafs::dbmstodspi::logging::LogLevel;
+
+BitstreamStagingCache::BitstreamStagingCache(std::string source_directory,
+                                             std::string staging_directory,
+                                             uintmax_t byte_budget)
+    : source_directory_{std::move(source_directory)},
+      staging_directory_{std::move(staging_directory)},
+      byte_budget_{byte_budget} {
+  std::filesystem::create_directories(staging_directory_);
+}
+
+BitstreamStagingCache::~BitstreamStagingCache() {
+  for (const auto& [bitstream, usage_data] : staged_bitstreams_) {
+    std::error_code error;
+    std::filesystem::remove(
+        std::filesystem::path(staging_directory_) / bitstream, error);
+  }
+}
+
+void BitstreamStagingCache::Preload(const std::set<std::string>& bitstreams) {
+  for (const auto& bitstream : bitstreams) {
+    if (!IsStaged(bitstream)) {
+      CopyToStaging(bitstream);
+    }
+  }
+  Log(LogLevel::kDebug, std::to_string(staged_bitstreams_.size()) +
+                            " bitstreams preloaded using " +
+                            std::to_string(stats_.staged_bytes) + " bytes");
+}
+
+auto BitstreamStagingCache::Stage(const std::string& bitstream) -> bool {
+  auto search = staged_bitstreams_.find(bitstream);
+  if (search != staged_bitstreams_.end()) {
+    stats_.hits++;
+    usage_order_.splice(usage_order_.begin(), usage_order_,
+                        search->second.first);
+    return true;
+  }
+  stats_.misses++;
+  CopyToStaging(bitstream);
+  return false;
+}
+
+auto BitstreamStagingCache::IsStaged(const std::string& bitstream) const
+    -> bool {
+  return staged_bitstreams_.find(bitstream) != staged_bitstreams_.end();
+}
+
+auto BitstreamStagingCache::GetStats() const -> BitstreamCacheStats {
+  return stats_;
+}
+
+auto BitstreamStagingCache::GetStagingDirectory() const -> std::string {
+  return staging_directory_;
+}
+
+auto BitstreamStagingCache::CopyToStaging(const std::string& bitstream)
+    -> bool {
+  auto source_path = std::filesystem::path(source_directory_) / bitstream;
+  std::error_code error;
+  auto bitstream_size = std::filesystem::file_size(source_path, error);
+  if (error) {
+    Log(LogLevel::kDebug, "Can't stage missing bitstream: " + bitstream);
+    return false;
+  }
+  if (bitstream_size > byte_budget_) {
+    return false;
+  }
+  while (stats_.staged_bytes + bitstream_size > byte_budget_) {
+    EvictLeastRecentlyUsed();
+  }
+  std::filesystem::copy_file(
+      source_path, std::filesystem::path(staging_directory_) / bitstream,
+      std::filesystem::copy_options::overwrite_existing, error);
+  if (error) {
+    Log(LogLevel::kDebug, "Couldn't stage " + bitstream + ": " +
+                              error.message());
+    return false;
+  }
+  usage_order_.push_front(bitstream);
+  staged_bitstreams_.insert(
+      {bitstream, {usage_order_.begin(), bitstream_size}});
+  stats_.staged_bytes += bitstream_size;
+  return true;
+}
+
+void BitstreamStagingCache::EvictLeastRecentlyUsed() {
+  const auto bitstream = usage_order_.back();
+  usage_order_.pop_back();
+  stats_.staged_bytes -= staged_bitstreams_.at(bitstream).second;
+  staged_bitstreams_.erase(bitstream);
+  stats_.evictions++;
+  std::error_code error;
+  std::filesystem::remove(std::filesystem::path(staging_directory_) / bitstream,
+                          error);
+}
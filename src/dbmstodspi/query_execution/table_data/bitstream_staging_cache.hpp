@@ -0,0 +1,105 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+#include <cstdint>
+#include <list>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace orkhestrafs::dbmstodspi {
+
+/**
+ * @brief Struct to hold the staging cache statistics.
+ */
+struct BitstreamCacheStats {
+  int hits = 0;
+  int misses = 0;
+  int evictions = 0;
+  uintmax_t staged_bytes = 0;
+};
+
+/**
+ * @brief Class to keep copies of the bitstreams in a RAM backed directory
+ * (like tmpfs) such that partial reconfiguration doesn't have to wait for the
+ * board's storage. The least recently used bitstreams get evicted once the
+ * byte budget is exceeded.
+ */
+class BitstreamStagingCache {
+ public:
+  /**
+   * @brief Constructor to setup the directories and the budget.
+   * @param source_directory Where the bitstreams are originally stored.
+   * @param staging_directory RAM backed directory to copy the bitstreams to.
+   * @param byte_budget How many bytes can be staged at once.
+   */
+  BitstreamStagingCache(std::string source_directory,
+                        std::string staging_directory, uintmax_t byte_budget);
+  /**
+   * @brief Remove all of the staged bitstreams.
+   */
+  ~BitstreamStagingCache();
+
+  BitstreamStagingCache(const BitstreamStagingCache&) = delete;
+  auto operator=(const BitstreamStagingCache&)
+      -> BitstreamStagingCache& = delete;
+
+  /**
+   * @brief Stage the given bitstreams without counting hits or misses.
+   * @param bitstreams Bitstream file names.
+   */
+  void Preload(const std::set<std::string>& bitstreams);
+  /**
+   * @brief Make sure the given bitstream is staged before it gets loaded.
+   * @param bitstream Bitstream file name.
+   * @return Boolean noting if the bitstream was already staged.
+   */
+  auto Stage(const std::string& bitstream) -> bool;
+  /**
+   * @brief Check if the bitstream is currently staged.
+   * @param bitstream Bitstream file name.
+   * @return Boolean noting if the bitstream is staged.
+   */
+  auto IsStaged(const std::string& bitstream) const -> bool;
+  /**
+   * @brief Get the staging statistics.
+   * @return Hit, miss and eviction counts and the currently staged bytes.
+   */
+  auto GetStats() const -> BitstreamCacheStats;
+  /**
+   * @brief Get the directory where the bitstreams get staged to.
+   * @return Staging directory path.
+   */
+  auto GetStagingDirectory() const -> std::string;
+
+ private:
+  const std::string source_directory_;
+  const std::string staging_directory_;
+  const uintmax_t byte_budget_;
+  BitstreamCacheStats stats_;
+  /// Most recently used bitstreams are at the front.
+  std::list<std::string> usage_order_;
+  std::unordered_map<std::string,
+                     std::pair<std::list<std::string>::iterator, uintmax_t>>
+      staged_bitstreams_;
+
+  auto CopyToStaging(const std::string& bitstream) -> bool;
+  void EvictLeastRecentlyUsed();
+};
+
+}  // namespace orkhestrafs::dbmstodspi
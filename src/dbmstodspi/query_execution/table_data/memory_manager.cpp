@@ -16,13 +16,17 @@ limitations under the License.
 
 #include "memory_manager.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <limits>
 #include <numeric>
 #include <stdexcept>
 
 #include "logger.hpp"
+#include "reconfiguration_cost_model.hpp"
 
 #ifdef FPGA_AVAILABLE
 #include <cstdlib>
@@ -37,10 +41,22 @@ limitations under the License.
 using orkhestrafs::dbmstodspi::logging::Log;
 using orkhestrafs::dbmstodspi::logging::LogLevel;
 using orkhestrafs::dbmstodspi::MemoryManager;
+using orkhestrafs::dbmstodspi::ReconfigurationCostModel;
 
 auto MemoryManager::GetTime() -> long { return latest_config_time_; }
 
-MemoryManager::~MemoryManager() = default;
+MemoryManager::~MemoryManager() {
+#ifdef FPGA_AVAILABLE
+  if (is_firmware_path_set_) {
+    std::ofstream firmware_path_file(kFirmwarePathFile);
+    firmware_path_file << previous_firmware_path_;
+    firmware_path_file.close();
+    if (!firmware_path_file) {
+      Log(LogLevel::kWarning, "Couldn't restore the firmware path!");
+    }
+  }
+#endif
+}
 
 void MemoryManager::TestConfigurationTimes(
     std::vector<std::string>& bitstream_name, int repetition_count) {
@@ -125,16 +141,38 @@ void MemoryManager::LoadStatic(int clock_speed) {
   loaded_bitstream_ = "static";
 }
 
-// This is a debug method with the FPGA available.
-void MemoryManager::MeasureConfigurationSpeed(
-    const std::set<std::string>& bitstreams_to_measure) {
+auto MemoryManager::MeasureConfigurationSpeed(
+    const std::set<std::string>& bitstreams_to_measure)
+    -> std::map<std::string, double> {
 #ifdef FPGA_AVAILABLE
   std::unordered_map<std::string, std::vector<int>> configuration_times;
   for (const auto& bitstream : bitstreams_to_measure) {
     configuration_times.insert({bitstream, {}});
   }
-  FPGAManager fpga_manager(0);
+  // Measure the fabric and not the storage the bitstreams are read from.
+  for (const auto& bitstream : bitstreams_to_measure) {
+    StageBitstream(bitstream);
+  }
   const int repetition_count = 500;
+  // Every PR loading request opens a new FPGA manager.
+  long min_overhead_microseconds = std::numeric_limits<long>::max();
+  for (int i = 0; i < repetition_count; i++) {
+    std::chrono::steady_clock::time_point begin =
+        std::chrono::steady_clock::now();
+    FPGAManager fpga_manager(0);
+    std::chrono::steady_clock::time_point end =
+        std::chrono::steady_clock::now();
+    min_overhead_microseconds = std::min(
+        min_overhead_microseconds,
+        static_cast<long>(
+            std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+                .count()));
+  }
+  std::map<std::string, double> measured_costs = {
+      {ReconfigurationCostModel::kFixedOverheadKey,
+       min_overhead_microseconds}};
+
+  FPGAManager fpga_manager(0);
   for (int i = 0; i < repetition_count; i++) {
     for (const auto& bitstream : bitstreams_to_measure) {
       std::chrono::steady_clock::time_point begin =
@@ -151,7 +189,12 @@ void MemoryManager::MeasureConfigurationSpeed(
        configuration_times) {
     auto min_config_time_microseconds = *min_element(
         bitstream_config_times.begin(), bitstream_config_times.end());
+    measured_costs.insert({bitstream_name, min_config_time_microseconds});
     std::filesystem::path p{bitstream_name};
+    if (!std::filesystem::exists(p) && bitstream_cache_) {
+      p = std::filesystem::path(bitstream_cache_->GetStagingDirectory()) /
+          bitstream_name;
+    }
     auto size_bytes = std::filesystem::file_size(p);
     // Just to show we are reporting MB/s
     auto configuration_speed =
@@ -167,8 +210,8 @@ void MemoryManager::MeasureConfigurationSpeed(
               << " CONFIG SPEED MB/s: " << std::to_string(configuration_speed)
               << std::endl;
   }
-  std::exit(0);
-
+  RemoveDecompressedBitstreams();
+  return measured_costs;
 #else
   throw std::runtime_error(
       "We can measure bitstream configuration times only with an FPGA!");
@@ -181,6 +224,9 @@ void MemoryManager::LoadPartialBitstream(
   if (loaded_bitstream_ != "static") {
     throw std::runtime_error("Can't load partial bitstreams without static!");
   }
+  for (const auto& name : bitstream_name) {
+    StageBitstream(name);
+  }
 
 #ifdef FPGA_AVAILABLE
   dma_engine.DecoupleFromPRRegion();
@@ -207,6 +253,132 @@ void MemoryManager::LoadPartialBitstream(
   // Don't do anything
   /*throw std::runtime_error("Can't load anything!");*/
 #endif
+  RemoveDecompressedBitstreams();
+}
+
+void MemoryManager::LoadPartialBitstreamWhileStreaming(
+    const std::vector<std::string>& bitstream_name) {
+  if (loaded_bitstream_ != "static") {
+    throw std::runtime_error("Can't load partial bitstreams without static!");
+  }
+  for (const auto& name : bitstream_name) {
+    StageBitstream(name);
+  }
+
+#ifdef FPGA_AVAILABLE
+  // The running streams go through the decoupler so it has to stay open.
+  FPGAManager fpga_manager(0);
+  for (const auto& name : bitstream_name) {
+    Log(LogLevel::kDebug, "Prefetching PR bitstream:" + name);
+    fpga_manager.loadPartial(name);
+  }
+#else
+  for (const auto& name : bitstream_name) {
+    Log(LogLevel::kDebug, "Skipped prefetching PR bitstream:" + name);
+  }
+#endif
+  RemoveDecompressedBitstreams();
+}
+
+void MemoryManager::SetupBitstreamCache(
+    const std::string& staging_directory, uintmax_t byte_budget,
+    const std::set<std::string>& bitstreams_to_preload) {
+  bitstream_cache_ = std::make_unique<BitstreamStagingCache>(
+      std::filesystem::current_path().string(), staging_directory,
+      byte_budget);
+  bitstream_cache_->Preload(bitstreams_to_preload);
+#ifdef FPGA_AVAILABLE
+  // The firmware loader searches the custom path before /lib/firmware. The
+  // previous path is restored when the memory manager is destroyed.
+  if (!is_firmware_path_set_) {
+    std::ifstream previous_path_file(kFirmwarePathFile);
+    std::getline(previous_path_file, previous_firmware_path_);
+  }
+  std::ofstream firmware_path_file(kFirmwarePathFile);
+  firmware_path_file << bitstream_cache_->GetStagingDirectory();
+  firmware_path_file.close();
+  if (!firmware_path_file) {
+    Log(LogLevel::kInfo,
+        "Couldn't set the firmware path! Staged bitstreams won't be used.");
+  } else {
+    is_firmware_path_set_ = true;
+  }
+#endif
+}
+
+void MemoryManager::SetupBitstreamRelocation(
+    std::map<std::string, BitstreamRelocation> bitstream_relocations) {
+  bitstream_relocations_ = std::move(bitstream_relocations);
+}
+
+void MemoryManager::SetupCompressedBitstreams(
+    std::map<std::string, std::string> compressed_bitstreams) {
+  compressed_bitstreams_ = std::move(compressed_bitstreams);
+}
+
+void MemoryManager::StageBitstream(const std::string& bitstream) {
+  auto relocation = bitstream_relocations_.find(bitstream);
+  if (relocation != bitstream_relocations_.end() &&
+      !std::filesystem::exists(bitstream)) {
+    // Relocation reads the uncompressed source and template bitstreams.
+    for (const auto& input_bitstream : {relocation->second.source_bitstream,
+                                        relocation->second.location_template}) {
+      auto compressed = compressed_bitstreams_.find(input_bitstream);
+      if (compressed != compressed_bitstreams_.end() &&
+          !std::filesystem::exists(input_bitstream)) {
+        BitstreamCompressor::DecompressFile(compressed->second,
+                                            input_bitstream);
+        decompressed_bitstreams_.push_back(input_bitstream);
+      }
+    }
+    Log(LogLevel::kDebug, "Relocating " + relocation->second.source_bitstream +
+                              " to " + bitstream);
+    BitstreamRelocator::RelocateFile(relocation->second, bitstream);
+  }
+  auto compressed = compressed_bitstreams_.find(bitstream);
+  if (compressed != compressed_bitstreams_.end()) {
+    DecompressBitstream(bitstream, compressed->second);
+  } else if (bitstream_cache_) {
+    bitstream_cache_->Stage(bitstream);
+    auto stats = bitstream_cache_->GetStats();
+    Log(LogLevel::kDebug,
+        "Bitstream cache hits: " + std::to_string(stats.hits) +
+            "; misses: " + std::to_string(stats.misses) +
+            "; evictions: " + std::to_string(stats.evictions) +
+            "; staged bytes: " + std::to_string(stats.staged_bytes));
+  }
+}
+
+void MemoryManager::DecompressBitstream(
+    const std::string& bitstream, const std::string& compressed_bitstream) {
+  std::filesystem::path compressed_path = compressed_bitstream;
+  std::filesystem::path output_path = bitstream;
+  if (bitstream_cache_) {
+    // Only the compressed copy is kept staged.
+    bitstream_cache_->Stage(compressed_bitstream);
+    std::filesystem::path staging_directory =
+        bitstream_cache_->GetStagingDirectory();
+    if (bitstream_cache_->IsStaged(compressed_bitstream)) {
+      compressed_path = staging_directory / compressed_bitstream;
+    }
+    output_path = staging_directory / bitstream;
+  }
+  if (std::filesystem::exists(output_path)) {
+    return;
+  }
+  auto bitstream_size = BitstreamCompressor::DecompressFile(
+      compressed_path.string(), output_path.string());
+  decompressed_bitstreams_.push_back(output_path.string());
+  Log(LogLevel::kDebug, "Decompressed " + compressed_bitstream + " to " +
+                            std::to_string(bitstream_size) + " bytes");
+}
+
+void MemoryManager::RemoveDecompressedBitstreams() {
+  for (const auto& bitstream : decompressed_bitstreams_) {
+    std::error_code error;
+    std::filesystem::remove(bitstream, error);
+  }
+  decompressed_bitstreams_.clear();
 }
 
 void MemoryManager::LoadBitstreamIfNew(const std::string& bitstream_name,
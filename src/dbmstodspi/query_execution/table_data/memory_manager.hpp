@@ -16,11 +16,15 @@ limitations under the License.
 
 #pragma once
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <stack>
 #include <string>
 #include <vector>
 
+#include "bitstream_compressor.hpp"
+#include "bitstream_relocator.hpp"
+#include "bitstream_staging_cache.hpp"
 #include "memory_block_interface.hpp"
 #include "memory_manager_interface.hpp"
 #ifdef FPGA_AVAILABLE
@@ -47,7 +51,17 @@ class MemoryManager : public MemoryManagerInterface {
 
   std::string loaded_bitstream_;
   int loaded_register_space_size_ = 0;
+  std::unique_ptr<BitstreamStagingCache> bitstream_cache_;
+  std::map<std::string, BitstreamRelocation> bitstream_relocations_;
+  std::map<std::string, std::string> compressed_bitstreams_;
+  // Decompressed bitstreams to remove once they are loaded.
+  std::vector<std::string> decompressed_bitstreams_;
 #ifdef FPGA_AVAILABLE
+  static constexpr char kFirmwarePathFile[] =
+      "/sys/module/firmware_class/parameters/path";
+  // Firmware search path to restore after staging bitstreams.
+  std::string previous_firmware_path_;
+  bool is_firmware_path_set_ = false;
   uint32_t* register_memory_block_;
   UdmaRepo udma_repo_;
   // Store to not delete the instances
@@ -58,8 +72,9 @@ class MemoryManager : public MemoryManagerInterface {
 #endif
  public:
   auto GetTime() -> long override;
-  void MeasureConfigurationSpeed(
-      const std::set<std::string>& bitstreams_to_measure) override;
+  auto MeasureConfigurationSpeed(
+      const std::set<std::string>& bitstreams_to_measure)
+      -> std::map<std::string, double> override;
 
   ~MemoryManager() override;
 
@@ -88,10 +103,37 @@ class MemoryManager : public MemoryManagerInterface {
    */
   void FreeMemoryBlock(MemoryBlockInterface* memory_block_pointer) override;
 
+  /**
+   * @brief Stage the partial bitstreams in a RAM backed firmware directory
+   * before they get loaded.
+   * @param staging_directory RAM backed directory for the bitstreams.
+   * @param byte_budget How many bytes of bitstreams can be staged.
+   * @param bitstreams_to_preload Bitstreams to stage at startup.
+   */
+  void SetupBitstreamCache(const std::string& staging_directory,
+                           uintmax_t byte_budget,
+                           const std::set<std::string>& bitstreams_to_preload);
+  /**
+   * @brief Set which bitstreams are created by relocating other bitstreams
+   * when they are loaded for the first time.
+   * @param bitstream_relocations Map of bitstreams and how to create them.
+   */
+  void SetupBitstreamRelocation(
+      std::map<std::string, BitstreamRelocation> bitstream_relocations);
+  /**
+   * @brief Set which bitstreams are stored compressed. They get decompressed
+   * right before they are loaded.
+   * @param compressed_bitstreams Map of bitstreams and their compressed files.
+   */
+  void SetupCompressedBitstreams(
+      std::map<std::string, std::string> compressed_bitstreams);
+
   // Quick methods to do PR loading.
   void LoadStatic(int clock_speed) override;
   void LoadPartialBitstream(const std::vector<std::string>& bitstream_name,
                             DMAInterface& dma_engine) override;
+  void LoadPartialBitstreamWhileStreaming(
+      const std::vector<std::string>& bitstream_name) override;
 
  private:
   auto AllocateMemoryBlock() -> MemoryBlockInterface* override;
@@ -99,6 +141,10 @@ class MemoryManager : public MemoryManagerInterface {
   static void SetFPGATo300MHz();
   static void SetFPGATo100MHz();
   static void UnSetPCAP();
+  void StageBitstream(const std::string& bitstream);
+  void DecompressBitstream(const std::string& bitstream,
+                           const std::string& compressed_bitstream);
+  void RemoveDecompressedBitstreams();
   void TestConfigurationTimes(std::vector<std::string>& bitstream_name,
                               int repetition_count);
   std::vector<std::string> all_bitstreams_ = {
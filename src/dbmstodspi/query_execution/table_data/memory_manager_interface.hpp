@@ -16,6 +16,7 @@ limitations under the License.
 
 #pragma once
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
@@ -35,8 +36,15 @@ namespace orkhestrafs::dbmstodspi {
 class MemoryManagerInterface {
  public:
   virtual auto GetTime() -> long = 0;
-  virtual void MeasureConfigurationSpeed(
-      const std::set<std::string>& bitstreams_to_measure) = 0;
+  /**
+   * @brief Measure how long loading each bitstream takes.
+   * @param bitstreams_to_measure Bitstreams to load.
+   * @return Minimum load time of each bitstream and the fixed overhead of a
+   * loading request in microseconds.
+   */
+  virtual auto MeasureConfigurationSpeed(
+      const std::set<std::string>& bitstreams_to_measure)
+      -> std::map<std::string, double> = 0;
   virtual ~MemoryManagerInterface() = default;
 
   virtual void LoadBitstreamIfNew(const std::string& bitstream_name,
@@ -50,6 +58,17 @@ class MemoryManagerInterface {
   virtual void LoadPartialBitstream(
       const std::vector<std::string>& bitstream_name,
       DMAInterface& dma_engine) = 0;
+  /**
+   * @brief Load partial bitstreams without decoupling the PR region.
+   *
+   * The decoupler isolates the whole PR region so using it would stop the
+   * running streams. Only valid for columns after the turnaround of the
+   * running query as no stream data goes through them. The caller has to
+   * check that the bitstreams stay in those columns.
+   * @param bitstream_name Bitstreams to load.
+   */
+  virtual void LoadPartialBitstreamWhileStreaming(
+      const std::vector<std::string>& bitstream_name) = 0;
 
  private:
   virtual auto AllocateMemoryBlock() -> MemoryBlockInterface* = 0;
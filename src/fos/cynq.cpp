@@ -12,6 +12,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <filesystem>
 #include <string>
 
@@ -232,7 +233,13 @@ void Shell::install() {
 }
 
 Region::Region()
-    : blockerAddr(0), periphAddr(0), mapped(false), locked(false) {}
+    : blockerAddr(0),
+      periphAddr(0),
+      mapped(false),
+      accel(nullptr),
+      bitstream(nullptr),
+      stub(false),
+      locked(false) {}
 
 Region::Region(std::string name, std::string blankName, long blocker,
                long address)
@@ -241,6 +248,9 @@ Region::Region(std::string name, std::string blankName, long blocker,
       blockerAddr(blocker),
       periphAddr(address),
       mapped(false),
+      accel(nullptr),
+      bitstream(nullptr),
+      stub(false),
       locked(false) {
   blank.install();
   mapDevs();
@@ -326,12 +336,26 @@ void Region::setBlock(bool status) { *blockerRegs = (status ? 1 : 0); }
 
 bool Region::canElideLoad(Bitstream &bs) { return &bs == bitstream; }
 
+bool Region::coversFootprint(Bitstream &bs) {
+  if (bitstream == nullptr) return false;
+  std::vector<std::string> newRegions = bs.stubRegions;
+  newRegions.push_back(bs.mainRegion);
+  std::vector<std::string> oldRegions = bitstream->stubRegions;
+  oldRegions.push_back(bitstream->mainRegion);
+  for (auto &oldRegion : oldRegions)
+    if (std::find(newRegions.begin(), newRegions.end(), oldRegion) ==
+        newRegions.end())
+      return false;
+  return true;
+}
+
 void Region::loadAccel(Accel &acc, Bitstream &bs) {
   if (locked) throw std::runtime_error("loading onto locked accel");
   if (bitstream != &bs) {  // yeet that bitstream
     std::cout << "Loading accelerator manually" << std::endl;
     setBlock(true);
-    fpga0.loadPartial(blank.bitstream);
+    // Blanking is only needed if the old bitstream isn't fully overwritten.
+    if (!coversFootprint(bs)) fpga0.loadPartial(blank.bitstream);
     fpga0.loadPartial(bs.bitstream);
     setBlock(false);
 
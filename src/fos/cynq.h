@@ -113,6 +113,7 @@ public:
 
   void setBlock(bool status);
   bool canElideLoad(Bitstream &bs);
+  bool coversFootprint(Bitstream &bs);
   void loadAccel(Accel &acc, Bitstream &bs);
   void loadStub(Accel &acc, Bitstream &bs);
   void unloadAccel();
@@ -0,0 +1,94 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <map>
+#include <string>
+
+#include "core.hpp"
+#include "rapidjson_reader.hpp"
+
+namespace {
+
+using orkhestrafs::core::Core;
+using orkhestrafs::dbmstodspi::RapidJSONReader;
+
+// Copied from the resources directory by tests/CMakeLists.txt.
+const std::string kResourcesDirectory = "CoreSchedulingTest";
+const std::string kInputFilename = "all_SF001.json";
+const std::string kConfigFilename = "scheduler_benchmark_config.ini";
+
+class CoreSchedulingTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char* directory = getcwd(nullptr, 0);
+    ASSERT_NE(directory, nullptr);
+    test_directory_ = directory;
+    free(directory);
+    ASSERT_EQ(chdir(kResourcesDirectory.c_str()), 0);
+  }
+  void TearDown() override { ASSERT_EQ(chdir(test_directory_.c_str()), 0); }
+
+  // Runs the scheduler benchmark with the given config values and returns the
+  // stats of the plans picked with PlanEvaluator::GetBestPlan.
+  static auto GetBenchmarkStats(
+      const std::map<std::string, std::string>& config_values)
+      -> std::map<std::string, double> {
+    std::ifstream config_file(kConfigFilename);
+    std::string test_config_filename = kConfigFilename + ".test";
+    std::ofstream test_config_file(test_config_filename);
+    std::string line;
+    while (std::getline(config_file, line)) {
+      auto key = line.substr(0, line.find(' '));
+      if (config_values.find(key) == config_values.end()) {
+        test_config_file << line << std::endl;
+      }
+    }
+    for (const auto& [key, value] : config_values) {
+      test_config_file << key << " = " << value << std::endl;
+    }
+    test_config_file.close();
+    Core::Run(kInputFilename, test_config_filename);
+    RapidJSONReader json_reader;
+    return json_reader.ReadValueMap("benchmark_stats.json");
+  }
+
+  std::string test_directory_;
+};
+
+TEST_F(CoreSchedulingTest, BranchAndBoundKeepsBestPlanOfAllSF001) {
+  std::map<std::string, std::string> config_values = {
+      {"BENCHMARK_SCHEDULER", "true"},
+      {"HEURISTIC", "1"},
+      {"SCHEDULER_TRANSPOSITION_TABLE_SIZE", "100000"},
+      {"SCHEDULER_ANYTIME", "false"},
+      {"SCHEDULER_BEAM_WIDTH", "0"},
+      {"SCHEDULER_EXACT_NODE_LIMIT", "0"},
+      {"TIME_LIMIT", "600"},
+      {"SCHEDULER_BRANCH_AND_BOUND", "false"}};
+  auto expected_stats = GetBenchmarkStats(config_values);
+  config_values["SCHEDULER_BRANCH_AND_BOUND"] = "true";
+  auto stats = GetBenchmarkStats(config_values);
+
+  EXPECT_DOUBLE_EQ(stats.at("data_amount"), expected_stats.at("data_amount"));
+  EXPECT_DOUBLE_EQ(stats.at("configuration_amount"),
+                   expected_stats.at("configuration_amount"));
+}
+
+}  // namespace
@@ -30,4 +30,6 @@ class MockFPGADriverFactory : public FPGADriverFactoryInterface {
       std::unique_ptr<orkhestrafs::dbmstodspi::AcceleratorLibraryInterface>,
       CreateAcceleratorLibrary, (MemoryManagerInterface * memory_manager),
       (override));
+  MOCK_METHOD(std::unique_ptr<orkhestrafs::dbmstodspi::ReadbackSourceInterface>,
+              CreateReadbackSource, (), (override));
 };
\ No newline at end of file
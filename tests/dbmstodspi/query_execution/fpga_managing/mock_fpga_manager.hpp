@@ -23,6 +23,8 @@ limitations under the License.
 
 using orkhestrafs::dbmstodspi::AcceleratedQueryNode;
 using orkhestrafs::dbmstodspi::FPGAManagerInterface;
+using orkhestrafs::dbmstodspi::ILA;
+using orkhestrafs::dbmstodspi::PerformanceCounters;
 using orkhestrafs::dbmstodspi::query_acceleration_constants::kMaxIOStreamCount;
 
 class MockFPGAManager : public FPGAManagerInterface {
@@ -38,4 +40,14 @@ class MockFPGAManager : public FPGAManagerInterface {
   MOCK_METHOD(ResultsArray, RunQueryAcceleration,
               (int timeout, ResultsMap& read_back_values),
               (override));
+  MOCK_METHOD(void, StartQueryAcceleration, (), (override));
+  MOCK_METHOD(bool, IsQueryAccelerationRunning, (), (override));
+  MOCK_METHOD((std::map<int, int>), WaitForFinishedPipelines,
+              (int timeout, ResultsMap& read_back_values), (override));
+  MOCK_METHOD(PerformanceCounters, GetLastRunPerformanceCounters, (),
+              (override));
+  MOCK_METHOD(void, CaptureILAOfNextRun,
+              (std::unique_ptr<ILA> ila_module, std::string vcd_filename,
+               int clock_speed),
+              (override));
 };
\ No newline at end of file
@@ -21,11 +21,14 @@ limitations under the License.
 
 #include "mock_acceleration_module.hpp"
 #include "mock_memory_manager.hpp"
+#include "register_access.hpp"
 namespace {
+using orkhestrafs::dbmstodspi::RegisterAccess;
 const int kDefaultValue = -1;
+const int kAddressesPerRegister = RegisterAccess::kAddressesPerRegister;
 
 TEST(AccelerationModuleTest, WriteToModule) {
-  std::vector<uint32_t> memory_pointer(524288, kDefaultValue);
+  std::vector<uint32_t> memory_pointer(64, kDefaultValue);
   MockMemoryManager mock_memory_manager;
   MockAccelerationModule mock_module(&mock_memory_manager, 0);
 
@@ -37,49 +40,125 @@ TEST(AccelerationModuleTest, WriteToModule) {
   mock_module.WriteToModule(0, 0);
   EXPECT_EQ(0, memory_pointer[0]);
 
-  EXPECT_CALL(mock_memory_manager, GetVirtualRegisterAddress(1))
-      .Times(1)
-      .WillOnce(::testing::Return(&memory_pointer[1]));
-
-  EXPECT_EQ(UINT_MAX, memory_pointer[1]);
-  mock_module.WriteToModule(1, 10);
-  EXPECT_EQ(10, memory_pointer[1]);
+  EXPECT_EQ(UINT_MAX, memory_pointer[4 / kAddressesPerRegister]);
+  mock_module.WriteToModule(4, 10);
+  EXPECT_EQ(10, memory_pointer[4 / kAddressesPerRegister]);
 
   MockAccelerationModule second_mock_module(&mock_memory_manager, 1);
 
   EXPECT_CALL(mock_memory_manager, GetVirtualRegisterAddress(1024 * 1024))
-      .Times(2)
-      .WillRepeatedly(::testing::Return(&memory_pointer[2]));
+      .Times(1)
+      .WillOnce(::testing::Return(&memory_pointer[32]));
 
-  EXPECT_EQ(UINT_MAX, memory_pointer[2]);
+  EXPECT_EQ(UINT_MAX, memory_pointer[32]);
   second_mock_module.WriteToModule(0, 1);
-  EXPECT_EQ(1, memory_pointer[2]);
+  EXPECT_EQ(1, memory_pointer[32]);
 
   second_mock_module.WriteToModule(0, 11);
-  EXPECT_EQ(11, memory_pointer[2]);
+  EXPECT_EQ(11, memory_pointer[32]);
 }
 
 TEST(AccelerationModuleTest, ReadFromModule) {
-  std::vector<uint32_t> memory_pointer(524288, kDefaultValue);
+  std::vector<uint32_t> memory_pointer(64, kDefaultValue);
   MockMemoryManager mock_memory_manager;
   MockAccelerationModule mock_module(&mock_memory_manager, 0);
 
-  EXPECT_CALL(mock_memory_manager, GetVirtualRegisterAddress(2))
-      .Times(2)
-      .WillRepeatedly(::testing::Return(&memory_pointer[0]));
+  EXPECT_CALL(mock_memory_manager, GetVirtualRegisterAddress(0))
+      .Times(1)
+      .WillOnce(::testing::Return(&memory_pointer[0]));
 
-  EXPECT_EQ(kDefaultValue, mock_module.ReadFromModule(2));
-  memory_pointer[0] = 100;
-  EXPECT_EQ(100, mock_module.ReadFromModule(2));
+  EXPECT_EQ(kDefaultValue, mock_module.ReadFromModule(8));
+  memory_pointer[8 / kAddressesPerRegister] = 100;
+  EXPECT_EQ(100, mock_module.ReadFromModule(8));
 
   MockAccelerationModule second_mock_module(&mock_memory_manager, 1);
 
-  EXPECT_CALL(mock_memory_manager, GetVirtualRegisterAddress(1024 * 1024 + 2))
+  EXPECT_CALL(mock_memory_manager, GetVirtualRegisterAddress(1024 * 1024))
+      .Times(1)
+      .WillOnce(::testing::Return(&memory_pointer[32]));
+
+  EXPECT_EQ(kDefaultValue, second_mock_module.ReadFromModule(8));
+  memory_pointer[32 + 8 / kAddressesPerRegister] = 101;
+  EXPECT_EQ(101, second_mock_module.ReadFromModule(8));
+}
+
+TEST(AccelerationModuleTest, ResetRegisterBaseResolvesRegistersAgain) {
+  std::vector<uint32_t> old_memory_pointer(16, kDefaultValue);
+  std::vector<uint32_t> new_memory_pointer(16, kDefaultValue);
+  MockMemoryManager mock_memory_manager;
+  MockAccelerationModule mock_module(&mock_memory_manager, 0);
+
+  EXPECT_CALL(mock_memory_manager, GetVirtualRegisterAddress(0))
       .Times(2)
-      .WillRepeatedly(::testing::Return(&memory_pointer[1]));
+      .WillOnce(::testing::Return(&old_memory_pointer[0]))
+      .WillOnce(::testing::Return(&new_memory_pointer[0]));
+
+  mock_module.WriteToModule(4, 1);
+  EXPECT_EQ(1, old_memory_pointer[4 / kAddressesPerRegister]);
+
+  mock_module.ResetRegisterBase();
+  mock_module.WriteToModule(4, 2);
+  EXPECT_EQ(1, old_memory_pointer[4 / kAddressesPerRegister]);
+  EXPECT_EQ(2, new_memory_pointer[4 / kAddressesPerRegister]);
+}
+
+TEST(AccelerationModuleTest, QueuedWritesAreWrittenOnFlush) {
+  std::vector<uint32_t> memory_pointer(64, kDefaultValue);
+  MockMemoryManager mock_memory_manager;
+  MockAccelerationModule mock_module(&mock_memory_manager, 0);
+
+  EXPECT_CALL(mock_memory_manager, GetVirtualRegisterAddress(0))
+      .Times(1)
+      .WillOnce(::testing::Return(&memory_pointer[0]));
+
+  mock_module.QueueWriteToModule(8, 5);
+  mock_module.QueueWriteToModule(4, 6);
+  mock_module.QueueWriteToModule(8, 7);
+  EXPECT_EQ(UINT_MAX, memory_pointer[4 / kAddressesPerRegister]);
+  EXPECT_EQ(UINT_MAX, memory_pointer[8 / kAddressesPerRegister]);
+
+  mock_module.FlushWritesToModule();
+  EXPECT_EQ(6, memory_pointer[4 / kAddressesPerRegister]);
+  EXPECT_EQ(7, memory_pointer[8 / kAddressesPerRegister]);
+
+  // Nothing is left to be written.
+  mock_module.FlushWritesToModule();
+}
+
+TEST(AccelerationModuleTest, FullQueueIsFlushedBeforeMoreWrites) {
+  std::vector<uint32_t> memory_pointer(128, kDefaultValue);
+  MockMemoryManager mock_memory_manager;
+  MockAccelerationModule mock_module(&mock_memory_manager, 0);
+
+  EXPECT_CALL(mock_memory_manager, GetVirtualRegisterAddress(0))
+      .Times(1)
+      .WillOnce(::testing::Return(&memory_pointer[0]));
+
+  for (int register_i = 0; register_i < 64; register_i++) {
+    mock_module.QueueWriteToModule(register_i * kAddressesPerRegister,
+                                   register_i);
+  }
+  EXPECT_EQ(UINT_MAX, memory_pointer[0]);
+
+  mock_module.QueueWriteToModule(64 * kAddressesPerRegister, 64);
+  EXPECT_EQ(0, memory_pointer[0]);
+  EXPECT_EQ(63, memory_pointer[63]);
+  EXPECT_EQ(UINT_MAX, memory_pointer[64]);
+
+  mock_module.FlushWritesToModule();
+  EXPECT_EQ(64, memory_pointer[64]);
+}
+
+TEST(AccelerationModuleTest, ReadFlushesQueuedWrites) {
+  std::vector<uint32_t> memory_pointer(64, kDefaultValue);
+  MockMemoryManager mock_memory_manager;
+  MockAccelerationModule mock_module(&mock_memory_manager, 1);
+
+  EXPECT_CALL(mock_memory_manager, GetVirtualRegisterAddress(1024 * 1024))
+      .Times(1)
+      .WillOnce(::testing::Return(&memory_pointer[0]));
 
-  EXPECT_EQ(kDefaultValue, second_mock_module.ReadFromModule(2));
-  memory_pointer[1] = 101;
-  EXPECT_EQ(101, second_mock_module.ReadFromModule(2));
+  mock_module.QueueWriteToModule(4, 9);
+  EXPECT_EQ(9, mock_module.ReadFromModule(4));
 }
-}  // namespace
\ No newline at end of file
+}  // namespace
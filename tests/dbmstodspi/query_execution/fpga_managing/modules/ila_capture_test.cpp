@@ -0,0 +1,127 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "ila_capture.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "ila.hpp"
+#include "mock_memory_manager.hpp"
+
+namespace {
+
+using orkhestrafs::dbmstodspi::ILA;
+using orkhestrafs::dbmstodspi::ILACapture;
+using orkhestrafs::dbmstodspi::ILACoreCapture;
+using orkhestrafs::dbmstodspi::ILADataTypes;
+using ::testing::_;
+using ::testing::Invoke;
+
+class ILACaptureTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ON_CALL(mock_memory_manager_, GetVirtualRegisterAddress(_))
+        .WillByDefault(Invoke([&](int offset) -> volatile uint32_t* {
+          return &fake_registers_[offset];
+        }));
+  }
+  std::map<int, uint32_t> fake_registers_;
+  ::testing::NiceMock<MockMemoryManager> mock_memory_manager_;
+};
+
+TEST_F(ILACaptureTest, CaptureWindowIsReadFromCorrectAddresses) {
+  const int ila_0_base = 0x10000000;
+  const int ila_2_base = 0x14000000;
+  fake_registers_[ila_0_base + (1 << 11) +
+                  (static_cast<int>(ILADataTypes::kStreamID) << 2)] = 3;
+  fake_registers_[ila_0_base + (2 << 11) +
+                  (static_cast<int>(ILADataTypes::kDataAtPos0) << 2)] = 42;
+  fake_registers_[ila_2_base + (1 << 11) +
+                  (static_cast<int>(ILADataTypes::kIcS) << 2)] = 7;
+  ILA ila_module(&mock_memory_manager_);
+
+  auto window = ila_module.GetCaptureWindow(
+      0, 3, {ILADataTypes::kStreamID, ILADataTypes::kDataAtPos0});
+  ASSERT_EQ(3, window.size());
+  EXPECT_EQ(0, window.at(0).at(0));
+  EXPECT_EQ(3, window.at(1).at(0));
+  EXPECT_EQ(42, window.at(2).at(1));
+
+  auto dma_capture = ILACapture::ReadCoreCapture(ila_module, 2, 2);
+  EXPECT_EQ(2, dma_capture.ila_id);
+  EXPECT_EQ("IC_S", dma_capture.signals.at(0).name);
+  EXPECT_EQ(std::vector<uint32_t>({0, 7}), dma_capture.signals.at(0).values);
+}
+
+TEST_F(ILACaptureTest, AllCoresAreDecoded) {
+  ILA ila_module(&mock_memory_manager_);
+  auto captures = ILACapture::ReadAllCaptures(ila_module, 4);
+  ASSERT_EQ(ILACapture::kILACoreCount, captures.size());
+  for (int ila_id = 0; ila_id < ILACapture::kILACoreCount; ila_id++) {
+    EXPECT_EQ(ila_id, captures.at(ila_id).ila_id);
+    EXPECT_EQ(ILACapture::GetCoreSignals(ila_id).size(),
+              captures.at(ila_id).signals.size());
+    EXPECT_EQ(4, captures.at(ila_id).signals.front().values.size());
+  }
+}
+
+TEST_F(ILACaptureTest, WrongCoreThrows) {
+  ILA ila_module(&mock_memory_manager_);
+  EXPECT_THROW(ILACapture::ReadCoreCapture(ila_module, 3, 1),
+               std::runtime_error);
+  EXPECT_THROW(ila_module.GetCaptureWindow(-1, 1, {ILADataTypes::kType}),
+               std::runtime_error);
+}
+
+TEST(ILACaptureVCDTest, OnlyChangesAreWritten) {
+  std::vector<ILACoreCapture> captures = {
+      {0, {{"STREAMID", {1, 1, 2}}, {"LAST", {0, 1, 1}}}}};
+  std::stringstream output;
+  ILACapture::WriteVCD(captures, 500, output);
+
+  std::string expected_vcd =
+      "$version OrkhestraFPGAStream ILA capture $end\n"
+      "$timescale 1ps $end\n"
+      "$scope module ila_0 $end\n"
+      "$var wire 32 ! STREAMID $end\n"
+      "$var wire 32 \" LAST $end\n"
+      "$upscope $end\n"
+      "$enddefinitions $end\n"
+      "#0\n"
+      "$dumpvars\n"
+      "b1 !\n"
+      "b0 \"\n"
+      "$end\n"
+      "#2000\n"
+      "b1 \"\n"
+      "#4000\n"
+      "b10 !\n"
+      "#6000\n";
+  EXPECT_EQ(expected_vcd, output.str());
+}
+
+TEST(ILACaptureVCDTest, InvalidClockSpeedThrows) {
+  std::stringstream output;
+  EXPECT_THROW(ILACapture::WriteVCD({}, 0, output), std::runtime_error);
+}
+
+}  // namespace
@@ -31,3 +31,12 @@ auto MockAccelerationModule::ReadFromModule(int module_internal_address)
     -> uint32_t {
   return AccelerationModule::ReadFromModule(module_internal_address);
 }
+
+void MockAccelerationModule::QueueWriteToModule(int module_internal_address,
+                                                uint32_t write_data) {
+  AccelerationModule::QueueWriteToModule(module_internal_address, write_data);
+}
+
+void MockAccelerationModule::ResetRegisterBase() {
+  AccelerationModule::ResetRegisterBase();
+}
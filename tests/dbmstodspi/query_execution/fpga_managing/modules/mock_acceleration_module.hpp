@@ -31,4 +31,6 @@ class MockAccelerationModule : public AccelerationModule {
   ~MockAccelerationModule() override;
   void WriteToModule(int module_internal_address, uint32_t write_data);
   auto ReadFromModule(int module_internal_address) -> uint32_t;
+  void QueueWriteToModule(int module_internal_address, uint32_t write_data);
+  void ResetRegisterBase();
 };
\ No newline at end of file
@@ -47,6 +47,8 @@ class MockDMA : public DMAInterface {
               (bool is_input, std::bitset<kMaxIOStreamCount> stream_active),
               (override));
   MOCK_METHOD(bool, IsControllerFinished, (bool is_input), (override));
+  MOCK_METHOD(bool, IsControllerStreamFinished, (bool is_input, int stream_id),
+              (override));
 
   MOCK_METHOD(void, SetRecordSize, (int stream_id, int recordSize), (override));
   MOCK_METHOD(void, SetRecordChunkIDs,
@@ -0,0 +1,183 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "performance_report.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "performance_counter_collector.hpp"
+#include "performance_counters.hpp"
+#include "rapidjson/document.h"
+#include "rapidjson/filereadstream.h"
+namespace {
+
+using orkhestrafs::dbmstodspi::PerformanceCounterCollector;
+using orkhestrafs::dbmstodspi::PerformanceCounters;
+using orkhestrafs::dbmstodspi::PerformanceReport;
+using orkhestrafs::dbmstodspi::StreamPerformanceCounters;
+
+class PerformanceReportTest : public ::testing::Test {
+ protected:
+  const int clock_speed_ = 300;
+  const std::vector<std::string> node_names_ = {"A", "B"};
+
+  // 300 cycles at 300MHz is exactly one microsecond.
+  static auto CreateCounters() -> PerformanceCounters {
+    PerformanceCounters counters;
+    counters.runtime_cycles = 300;
+    counters.valid_read_cycles = 150;
+    counters.valid_write_cycles = 75;
+    counters.input_active_data_cycles = 75;
+    counters.output_active_data_cycles = 30;
+    counters.streams = {{0, true, 10, 100}, {0, false, 5, 100}};
+    return counters;
+  }
+};
+
+TEST_F(PerformanceReportTest, ModelCountsChunksAndMemoryCycles) {
+  std::vector<StreamPerformanceCounters> streams = {{0, true, 18, 100},
+                                                    {1, false, 18, 50}};
+  auto counters = PerformanceCounterCollector::ModelCounters(streams);
+
+  // 18 integers need 2 chunks on the 16 integer wide datapath.
+  EXPECT_EQ(200, counters.input_active_data_cycles);
+  EXPECT_EQ(100, counters.input_active_data_last_cycles);
+  EXPECT_EQ(1, counters.input_active_end_of_stream_cycles);
+  EXPECT_EQ(100, counters.output_active_data_cycles);
+  EXPECT_EQ(50, counters.output_active_data_last_cycles);
+  // 4 integers are moved to/from memory each cycle.
+  EXPECT_EQ(450, counters.valid_read_cycles);
+  EXPECT_EQ(225, counters.valid_write_cycles);
+  EXPECT_EQ(450, counters.runtime_cycles);
+  EXPECT_EQ(streams, counters.streams);
+}
+
+TEST_F(PerformanceReportTest, MetricsAreDerivedFromCounters) {
+  PerformanceReport report;
+  const auto& record =
+      report.AddRun(node_names_, CreateCounters(), clock_speed_);
+
+  EXPECT_EQ(0, record.run_index);
+  EXPECT_EQ(node_names_, record.node_names);
+  EXPECT_DOUBLE_EQ(1e-6, record.runtime_in_seconds);
+  // 1000 integers in one microsecond is 4GB/s.
+  EXPECT_DOUBLE_EQ(4, record.input_bandwidth);
+  EXPECT_DOUBLE_EQ(2, record.output_bandwidth);
+  EXPECT_DOUBLE_EQ(0.5, record.read_stall_ratio);
+  EXPECT_DOUBLE_EQ(0.75, record.write_stall_ratio);
+  EXPECT_DOUBLE_EQ(0.25, record.input_utilisation);
+  EXPECT_DOUBLE_EQ(0.1, record.output_utilisation);
+  EXPECT_EQ((std::vector<double>{4, 2}), record.stream_bandwidths);
+}
+
+TEST_F(PerformanceReportTest, EmptyRunHasNoMetrics) {
+  PerformanceReport report;
+  const auto& record =
+      report.AddRun(node_names_, PerformanceCounters(), clock_speed_);
+
+  EXPECT_DOUBLE_EQ(0, record.input_bandwidth);
+  EXPECT_DOUBLE_EQ(1, record.read_stall_ratio);
+  EXPECT_DOUBLE_EQ(0, record.input_utilisation);
+}
+
+TEST_F(PerformanceReportTest, InvalidClockSpeedThrows) {
+  PerformanceReport report;
+  EXPECT_THROW(report.AddRun(node_names_, CreateCounters(), 0),
+               std::runtime_error);
+}
+
+TEST_F(PerformanceReportTest, CSVHasRowForEachStream) {
+  PerformanceReport report;
+  report.AddRun(node_names_, CreateCounters(), clock_speed_);
+  report.AddRun({"C"}, CreateCounters(), clock_speed_);
+  const std::string filename = "PerformanceReportTest.csv";
+  report.WriteCSV(filename);
+
+  std::ifstream csv_file(filename);
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(csv_file, line)) {
+    lines.push_back(line);
+  }
+  std::remove(filename.c_str());
+
+  ASSERT_EQ(5, lines.size());
+  EXPECT_EQ(0, lines.at(0).rfind("run,nodes,stream_id,is_input", 0));
+  EXPECT_EQ(0, lines.at(1).rfind("0,\"A;B\",0,1,10,100,4,300,", 0));
+  EXPECT_EQ(0, lines.at(4).rfind("1,\"C\",0,0,5,100,2,300,", 0));
+}
+
+TEST_F(PerformanceReportTest, CSVQuotesNodeNames) {
+  PerformanceReport report;
+  report.AddRun({"A,\"B\""}, CreateCounters(), clock_speed_);
+  const std::string filename = "PerformanceReportTest.csv";
+  report.WriteCSV(filename);
+
+  std::ifstream csv_file(filename);
+  std::string line;
+  std::getline(csv_file, line);
+  std::getline(csv_file, line);
+  std::remove(filename.c_str());
+
+  EXPECT_EQ(0, line.rfind("0,\"A,\"\"B\"\"\",0,1,", 0));
+}
+
+TEST_F(PerformanceReportTest, CSVWriteFailureThrows) {
+  PerformanceReport report;
+  report.AddRun(node_names_, CreateCounters(), clock_speed_);
+  // Opening succeeds but every write fails.
+  EXPECT_THROW(report.WriteCSV("/dev/full"),
+               std::runtime_error);
+}
+
+TEST_F(PerformanceReportTest, JSONEscapesNodeNames) {
+  PerformanceReport report;
+  const std::string node_name = "A\"\\B";
+  report.AddRun({node_name}, CreateCounters(), clock_speed_);
+  const std::string filename = "PerformanceReportTest.json";
+  report.WriteJSON(filename);
+
+  FILE* file_pointer = fopen(filename.c_str(), "r");
+  ASSERT_NE(nullptr, file_pointer);
+  char read_buffer[8192];
+  rapidjson::FileReadStream input_stream(file_pointer, read_buffer,
+                                         sizeof(read_buffer));
+  rapidjson::Document document;
+  document.ParseStream(input_stream);
+  fclose(file_pointer);
+  std::remove(filename.c_str());
+
+  ASSERT_FALSE(document.HasParseError());
+  ASSERT_EQ(1, document.Size());
+  EXPECT_EQ(node_name, document[0]["nodes"][0].GetString());
+  EXPECT_EQ(300, document[0]["runtime_cycles"].GetInt());
+  EXPECT_EQ(2, document[0]["streams"].Size());
+}
+
+TEST_F(PerformanceReportTest, JSONWriteFailureThrows) {
+  PerformanceReport report;
+  report.AddRun(node_names_, CreateCounters(), clock_speed_);
+  // Opening succeeds but every write fails.
+  EXPECT_THROW(report.WriteJSON("/dev/full"), std::runtime_error);
+}
+
+}  // namespace
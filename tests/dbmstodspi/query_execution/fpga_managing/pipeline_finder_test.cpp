@@ -0,0 +1,123 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "pipeline_finder.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "accelerated_query_node.hpp"
+#include "pipeline_data.hpp"
+#include "stream_data_parameters.hpp"
+namespace {
+
+using orkhestrafs::dbmstodspi::AcceleratedQueryNode;
+using orkhestrafs::dbmstodspi::PipelineData;
+using orkhestrafs::dbmstodspi::PipelineFinder;
+using orkhestrafs::dbmstodspi::StreamDataParameters;
+
+class PipelineFinderTest : public ::testing::Test {
+ protected:
+  volatile uint32_t any_address_ = 0;
+
+  auto CreateStream(int stream_id, bool is_streamed_from_memory)
+      -> StreamDataParameters {
+    StreamDataParameters stream = {stream_id, 1, 1, {}, {}};
+    if (is_streamed_from_memory) {
+      stream.physical_addresses_map.insert({&any_address_, {-1}});
+    }
+    return stream;
+  }
+
+  static auto CreateNode(std::vector<StreamDataParameters> input_streams,
+                         std::vector<StreamDataParameters> output_streams)
+      -> AcceleratedQueryNode {
+    return {std::move(input_streams),
+            std::move(output_streams),
+            QueryOperationType::kFilter,
+            1,
+            {},
+            {}};
+  }
+};
+
+TEST_F(PipelineFinderTest, SingleNodeIsOnePipeline) {
+  auto pipelines = PipelineFinder::FindPipelines(
+      {CreateNode({CreateStream(0, true)}, {CreateStream(0, true)})});
+
+  PipelineData expected_pipeline;
+  expected_pipeline.input_streams[0] = true;
+  expected_pipeline.output_streams[0] = true;
+  ASSERT_EQ(std::vector<PipelineData>{expected_pipeline}, pipelines);
+}
+
+TEST_F(PipelineFinderTest, ChainedNodesAreOnePipeline) {
+  auto pipelines = PipelineFinder::FindPipelines(
+      {CreateNode({CreateStream(0, true)}, {CreateStream(0, false)}),
+       CreateNode({CreateStream(0, false)}, {CreateStream(0, true)})});
+
+  PipelineData expected_pipeline;
+  expected_pipeline.input_streams[0] = true;
+  expected_pipeline.output_streams[0] = true;
+  ASSERT_EQ(std::vector<PipelineData>{expected_pipeline}, pipelines);
+}
+
+TEST_F(PipelineFinderTest, JoinMergesPipelines) {
+  auto pipelines = PipelineFinder::FindPipelines(
+      {CreateNode({CreateStream(1, true)}, {CreateStream(1, false)}),
+       CreateNode({CreateStream(0, true), CreateStream(1, false)},
+                  {CreateStream(0, true)})});
+
+  PipelineData expected_pipeline;
+  expected_pipeline.input_streams[0] = true;
+  expected_pipeline.input_streams[1] = true;
+  expected_pipeline.output_streams[0] = true;
+  ASSERT_EQ(std::vector<PipelineData>{expected_pipeline}, pipelines);
+}
+
+TEST_F(PipelineFinderTest, DisconnectedNodesAreSeparatePipelines) {
+  auto pipelines = PipelineFinder::FindPipelines(
+      {CreateNode({CreateStream(2, true)}, {CreateStream(2, true)}),
+       CreateNode({CreateStream(0, true)}, {CreateStream(0, false)}),
+       CreateNode({CreateStream(0, false)},
+                  {CreateStream(0, true), CreateStream(1, true)})});
+
+  PipelineData first_expected_pipeline;
+  first_expected_pipeline.input_streams[0] = true;
+  first_expected_pipeline.output_streams[0] = true;
+  first_expected_pipeline.output_streams[1] = true;
+  PipelineData second_expected_pipeline;
+  second_expected_pipeline.input_streams[2] = true;
+  second_expected_pipeline.output_streams[2] = true;
+  ASSERT_EQ((std::vector<PipelineData>{first_expected_pipeline,
+                                       second_expected_pipeline}),
+            pipelines);
+}
+
+TEST_F(PipelineFinderTest, PassthroughStreamsAreIgnored) {
+  auto pipelines = PipelineFinder::FindPipelines(
+      {CreateNode({CreateStream(15, false)}, {CreateStream(15, false)}),
+       CreateNode({CreateStream(0, true)}, {CreateStream(0, true)})});
+
+  PipelineData expected_pipeline;
+  expected_pipeline.input_streams[0] = true;
+  expected_pipeline.output_streams[0] = true;
+  ASSERT_EQ(std::vector<PipelineData>{expected_pipeline}, pipelines);
+}
+
+}  // namespace
@@ -0,0 +1,130 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "dma_crossbar_configuration_cache.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "dma_crossbar_setup.hpp"
+#include "dma_setup_data.hpp"
+#include "stream_parameter_calculator.hpp"
+
+namespace {
+using orkhestrafs::dbmstodspi::DMACrossbarSetup;
+using orkhestrafs::dbmstodspi::DMASetupData;
+using orkhestrafs::dbmstodspi::StreamParameterCalculator;
+
+const int kMaxTestedRecordSize = 64;
+
+auto CreateStreamSetupData(bool is_input_stream, int record_size)
+    -> DMASetupData {
+  DMASetupData stream_setup_data;
+  stream_setup_data.is_input_stream = is_input_stream;
+  stream_setup_data.active_channel_count = -1;
+  stream_setup_data.chunks_per_record =
+      StreamParameterCalculator::CalculateChunksPerRecord(record_size);
+  stream_setup_data.records_per_ddr_burst =
+      StreamParameterCalculator::FindMinViableRecordsPerDDRBurst(record_size);
+  return stream_setup_data;
+}
+
+auto CreateSelections(int record_size) -> std::vector<std::vector<int>> {
+  std::vector<int> linear_selection(record_size);
+  std::iota(linear_selection.begin(), linear_selection.end(), 0);
+  std::vector<int> every_other_column_selection;
+  for (int column_id = 0; column_id < record_size; column_id += 2) {
+    every_other_column_selection.push_back(column_id);
+  }
+  return {linear_selection, every_other_column_selection};
+}
+
+void ExpectSameCrossbarSetupData(const DMASetupData& expected,
+                                 const DMASetupData& actual) {
+  ASSERT_EQ(expected.crossbar_setup_data.size(),
+            actual.crossbar_setup_data.size());
+  for (int chunk_id = 0; chunk_id < expected.crossbar_setup_data.size();
+       chunk_id++) {
+    EXPECT_EQ(expected.crossbar_setup_data.at(chunk_id).chunk_selection,
+              actual.crossbar_setup_data.at(chunk_id).chunk_selection);
+    EXPECT_EQ(expected.crossbar_setup_data.at(chunk_id).position_selection,
+              actual.crossbar_setup_data.at(chunk_id).position_selection);
+  }
+}
+
+void ExpectCachedSetupMatchesComputedSetup(bool is_input_stream) {
+  for (int record_size = 1; record_size <= kMaxTestedRecordSize;
+       record_size++) {
+    for (const auto& selected_columns : CreateSelections(record_size)) {
+      auto computed_data = CreateStreamSetupData(is_input_stream, record_size);
+      try {
+        DMACrossbarSetup::ComputeCrossbarSetupData(computed_data, record_size,
+                                                   selected_columns);
+      } catch (const std::runtime_error&) {
+        auto cached_data = CreateStreamSetupData(is_input_stream, record_size);
+        EXPECT_THROW(DMACrossbarSetup::CalculateCrossbarSetupData(
+                         cached_data, record_size, selected_columns),
+                     std::runtime_error);
+        continue;
+      }
+      // First call fills the cache and the second call reads from it.
+      for (int repeat = 0; repeat < 2; repeat++) {
+        auto cached_data = CreateStreamSetupData(is_input_stream, record_size);
+        DMACrossbarSetup::CalculateCrossbarSetupData(cached_data, record_size,
+                                                     selected_columns);
+        ExpectSameCrossbarSetupData(computed_data, cached_data);
+      }
+    }
+  }
+}
+
+TEST(DMACrossbarConfigurationCacheTest, InputSetupMatchesComputedSetup) {
+  DMACrossbarSetup::GetConfigurationCache().Clear();
+  ExpectCachedSetupMatchesComputedSetup(true);
+}
+
+TEST(DMACrossbarConfigurationCacheTest, OutputSetupMatchesComputedSetup) {
+  DMACrossbarSetup::GetConfigurationCache().Clear();
+  ExpectCachedSetupMatchesComputedSetup(false);
+}
+
+TEST(DMACrossbarConfigurationCacheTest, RepeatedLayoutIsReused) {
+  auto& cache = DMACrossbarSetup::GetConfigurationCache();
+  cache.Clear();
+  const int record_size = 18;
+  const auto selected_columns = CreateSelections(record_size).front();
+
+  for (int repeat = 0; repeat < 3; repeat++) {
+    auto stream_setup_data = CreateStreamSetupData(true, record_size);
+    DMACrossbarSetup::CalculateCrossbarSetupData(stream_setup_data,
+                                                 record_size, selected_columns);
+  }
+  EXPECT_EQ(1, cache.GetSize());
+  EXPECT_EQ(1, cache.GetMissCount());
+  EXPECT_EQ(2, cache.GetHitCount());
+
+  auto output_stream_setup_data = CreateStreamSetupData(false, record_size);
+  DMACrossbarSetup::CalculateCrossbarSetupData(output_stream_setup_data,
+                                               record_size, selected_columns);
+  EXPECT_EQ(2, cache.GetSize());
+  EXPECT_EQ(2, cache.GetMissCount());
+}
+
+}  // namespace
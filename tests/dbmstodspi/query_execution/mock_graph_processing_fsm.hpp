@@ -29,6 +29,7 @@ class MockGraphProcessingFSM : public GraphProcessingFSMInterface {
 
  public:
   MOCK_METHOD(void, SetFinishedFlag, (), (override));
+  MOCK_METHOD(void, FinishQuery, (), (override));
   MOCK_METHOD(bool, IsUnscheduledNodesGraphEmpty, (), (override));
   MOCK_METHOD(void, ScheduleUnscheduledNodes, (), (override));
   MOCK_METHOD(bool, IsARunScheduled, (), (override));
@@ -61,4 +62,5 @@ class MockGraphProcessingFSM : public GraphProcessingFSMInterface {
   MOCK_METHOD(void, LoadBitstream, (ScheduledModule new_module), (override));
   MOCK_METHOD(bool, IsHWPrintEnabled, (), (override));
   MOCK_METHOD(bool, IsSWBackupEnabled, (), (override));
+  MOCK_METHOD(void, VerifyConfiguration, (), (override));
 };
\ No newline at end of file
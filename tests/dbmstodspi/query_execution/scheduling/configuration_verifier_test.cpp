@@ -0,0 +1,165 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "configuration_verifier.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using orkhestrafs::dbmstodspi::ConfigurationVerifier;
+using orkhestrafs::dbmstodspi::ReadbackSourceInterface;
+
+class FakeReadbackSource : public ReadbackSourceInterface {
+ public:
+  FakeReadbackSource(const std::vector<char>& configuration,
+                     const std::map<std::string, std::vector<char>>& frames,
+                     int& read_count)
+      : configuration_{configuration},
+        frames_{frames},
+        read_count_{read_count} {}
+  auto ReadConfiguration() -> std::vector<char> override {
+    read_count_++;
+    return configuration_;
+  }
+  auto ReadBitstreamFrames(const std::string& bitstream)
+      -> std::vector<char> override {
+    auto frames = frames_.find(bitstream);
+    return frames == frames_.end() ? std::vector<char>{} : frames->second;
+  }
+
+ private:
+  const std::vector<char>& configuration_;
+  const std::map<std::string, std::vector<char>>& frames_;
+  int& read_count_;
+};
+
+class ConfigurationVerifierTest : public ::testing::Test {
+ protected:
+  // 2 header bytes followed by 4, 2 and 2 bytes for the columns.
+  std::vector<char> configuration_ = {'h', 'h', 'a', 'a', 'a',
+                                      'a', 'b', 'b', 'c', 'c'};
+  std::map<std::string, std::vector<char>> frames_ = {
+      {"filter.bin", {'a', 'a', 'a', 'a'}},
+      {"join.bin", {'b', 'b', 'c', 'c'}},
+      {"RT_89.bin", {'c', 'c'}}};
+  int read_count_ = 0;
+
+  auto CreateVerifier(int verification_interval)
+      -> std::unique_ptr<ConfigurationVerifier> {
+    return std::make_unique<ConfigurationVerifier>(
+        std::make_unique<FakeReadbackSource>(configuration_, frames_,
+                                             read_count_),
+        "MDB", std::map<char, int>{{'M', 4}, {'D', 2}, {'B', 2}}, 2,
+        verification_interval);
+  }
+};
+
+TEST_F(ConfigurationVerifierTest, ChangedRegionsAreReported) {
+  auto verifier = CreateVerifier(0);
+  verifier->RecordLoad("filter.bin", {0, 0});
+  verifier->RecordLoad("join.bin", {1, 2});
+  ASSERT_TRUE(verifier->Verify().empty());
+
+  configuration_[3] = 'x';
+  std::vector<std::pair<int, int>> expected_regions = {{0, 0}};
+  ASSERT_EQ(verifier->Verify(), expected_regions);
+  ASSERT_EQ(verifier->GetMismatchCount(), 1);
+  // Mismatched regions are forgotten until they are loaded again.
+  ASSERT_TRUE(verifier->Verify().empty());
+  ASSERT_EQ(read_count_, 3);
+}
+
+TEST_F(ConfigurationVerifierTest, FailedLoadIsReportedByFirstReadback) {
+  auto verifier = CreateVerifier(0);
+  frames_["join.bin"] = {'b', 'b', 'c', 'x'};
+  // Frame data which doesn't cover the columns exactly can't be verified.
+  frames_["filter.bin"] = {'x', 'x'};
+  verifier->RecordLoad("join.bin", {1, 2});
+  verifier->RecordLoad("filter.bin", {0, 0});
+  std::vector<std::pair<int, int>> expected_regions = {{1, 2}};
+  ASSERT_EQ(verifier->Verify(), expected_regions);
+  ASSERT_EQ(verifier->FindConfiguredBitstreams({"filter.bin"}, {{0, 0}}),
+            std::vector<bool>{false});
+}
+
+TEST_F(ConfigurationVerifierTest, MatchingReadbackSkipsLoads) {
+  auto verifier = CreateVerifier(0);
+  frames_["filter.bin"] = {'f', 'f', 'f', 'f'};
+  verifier->RecordLoad("join.bin", {1, 2});
+  // Nothing is known to be configured before the first readback.
+  ASSERT_EQ(verifier->FindConfiguredBitstreams({"join.bin"}, {{1, 2}}),
+            std::vector<bool>{false});
+  verifier->Verify();
+  ASSERT_EQ(read_count_, 1);
+
+  // The last readback is used instead of reading back for every load.
+  std::vector<bool> expected_configured = {true, false};
+  ASSERT_EQ(verifier->FindConfiguredBitstreams({"join.bin", "filter.bin"},
+                                               {{1, 2}, {0, 0}}),
+            expected_configured);
+  ASSERT_EQ(verifier->GetSkippedLoadCount(), 1);
+
+  // Regions overwritten by the same sequence can't be skipped.
+  expected_configured = {false, false};
+  ASSERT_EQ(verifier->FindConfiguredBitstreams({"join.bin", "RT_89.bin"},
+                                               {{1, 2}, {2, 2}}),
+            expected_configured);
+
+  // Loaded columns are unknown until they are read back again.
+  verifier->RecordLoad("RT_89.bin", {2, 2});
+  ASSERT_EQ(verifier->FindConfiguredBitstreams({"join.bin"}, {{1, 2}}),
+            std::vector<bool>{false});
+  ASSERT_TRUE(verifier->Verify().empty());
+  ASSERT_EQ(verifier->FindConfiguredBitstreams({"RT_89.bin"}, {{2, 2}}),
+            std::vector<bool>{true});
+  // Unknown footprints make every column unknown.
+  verifier->RecordLoad("unknown.bin", {-1, -1});
+  ASSERT_EQ(verifier->FindConfiguredBitstreams({"RT_89.bin"}, {{2, 2}}),
+            std::vector<bool>{false});
+  ASSERT_EQ(read_count_, 2);
+}
+
+TEST_F(ConfigurationVerifierTest, VerificationIsPeriodic) {
+  auto verifier = CreateVerifier(2);
+  ASSERT_FALSE(verifier->IsVerificationDue());
+  verifier->RecordRun();
+  verifier->RecordRun();
+  ASSERT_TRUE(verifier->IsVerificationDue());
+  // Nothing has to be read back before anything is loaded.
+  ASSERT_TRUE(verifier->Verify().empty());
+  ASSERT_FALSE(verifier->IsVerificationDue());
+  ASSERT_EQ(read_count_, 0);
+
+  ASSERT_FALSE(CreateVerifier(0)->IsVerificationDue());
+}
+
+TEST_F(ConfigurationVerifierTest, ShortReadbackThrows) {
+  auto verifier = CreateVerifier(0);
+  configuration_.resize(9);
+  verifier->RecordLoad("join.bin", {1, 2});
+  ASSERT_THROW(verifier->Verify(), std::runtime_error);
+}
+
+}  // namespace
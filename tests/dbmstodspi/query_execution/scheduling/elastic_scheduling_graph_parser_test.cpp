@@ -0,0 +1,564 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "elastic_scheduling_graph_parser.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <memory>
+#include <set>
+
+#include "fpga_driver_factory.hpp"
+#include "mock_accelerator_library.hpp"
+#include "plan_evaluator.hpp"
+#include "time_limit_execption.hpp"
+
+namespace {
+
+using orkhestrafs::dbmstodspi::ElasticSchedulingGraphParser;
+using orkhestrafs::dbmstodspi::FPGADriverFactory;
+using orkhestrafs::dbmstodspi::PlanCostEstimator;
+using orkhestrafs::dbmstodspi::PlanEvaluator;
+using orkhestrafs::dbmstodspi::ReconfigurationCostModel;
+using orkhestrafs::dbmstodspi::TimeLimitException;
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+class ElasticSchedulingGraphParserTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    OperationPRModules filter_modules;
+    filter_modules.starting_locations = {
+        {"filter_0.bin", "filter_wide_0.bin"},
+        {"filter_1.bin"},
+        {"filter_2.bin"},
+        {"filter_3.bin"}};
+    filter_modules.bitstream_map = {
+        {"filter_0.bin", {{0}, 1, {8}, "M", false}},
+        {"filter_wide_0.bin", {{0}, 2, {16}, "MM", false}},
+        {"filter_1.bin", {{1}, 1, {8}, "M", false}},
+        {"filter_2.bin", {{2}, 1, {8}, "M", false}},
+        {"filter_3.bin", {{3}, 1, {8}, "M", false}}};
+    hw_library_ = {{QueryOperationType::kFilter, filter_modules}};
+
+    // a -> c and an independent b.
+    graph_ = {{"a",
+               {QueryOperationType::kFilter,
+                {1},
+                {},
+                {"c"},
+                {"table_a"},
+                filter_modules.starting_locations,
+                nullptr}},
+              {"b",
+               {QueryOperationType::kFilter,
+                {1},
+                {},
+                {},
+                {"table_b"},
+                filter_modules.starting_locations,
+                nullptr}},
+              {"c",
+               {QueryOperationType::kFilter,
+                {1},
+                {{"a", 0}},
+                {},
+                {"table_a"},
+                filter_modules.starting_locations,
+                nullptr}}};
+    tables_ = {{"table_a", {4, 100, {}}}, {"table_b", {2, 300, {}}}};
+
+    ON_CALL(drivers_, SetMissingFunctionalCapacity(_, _, _, _, _))
+        .WillByDefault(Return(true));
+  }
+
+  auto GetAllPlans(int thread_count, int transposition_table_size = 0,
+                   bool use_branch_and_bound = false,
+                   bool use_anytime_scheduling = false,
+                   bool use_max_runs_cap = false)
+      -> std::set<std::vector<std::vector<ScheduledModule>>> {
+    ElasticSchedulingGraphParser parser(
+        hw_library_, {{{ModuleSelection("ALL_AVAILABLE")}}, {}}, {}, drivers_,
+        use_max_runs_cap, false, false, false, thread_count,
+        transposition_table_size);
+    if (use_branch_and_bound || use_anytime_scheduling) {
+      parser.SetPlanCostEstimator(CreateCostEstimator(), use_branch_and_bound);
+    }
+    parser.SetTimeLimit(std::chrono::system_clock::time_point::max());
+    parser.PlaceNodesRecursively({"a", "b"}, {}, graph_, {}, {}, tables_, {},
+                                 {}, 0);
+    resulting_plans_ = parser.GetResultingPlan();
+    std::set<std::vector<std::vector<ScheduledModule>>> plans;
+    for (const auto& [plan, _] : resulting_plans_) {
+      plans.insert(plan);
+    }
+    table_hits_ = parser.GetTranspositionTableStatistics().hits;
+    pruned_branches_ = parser.GetPrunedBranchCount();
+    if (use_branch_and_bound || use_anytime_scheduling) {
+      best_found_plan_ = parser.GetBestFoundPlan().first;
+      convergence_log_ = parser.GetConvergenceLog();
+    }
+    return plans;
+  }
+
+  // Dynamic programming is used if the beam width is 0.
+  auto GetCostGuidedPlans(int beam_width, bool use_max_runs_cap = false)
+      -> std::set<std::vector<std::vector<ScheduledModule>>> {
+    ElasticSchedulingGraphParser parser(
+        hw_library_, {{{ModuleSelection("ALL_AVAILABLE")}}, {}}, {}, drivers_,
+        use_max_runs_cap, false, false, false);
+    parser.SetPlanCostEstimator(CreateCostEstimator(), false);
+    parser.SetTimeLimit(std::chrono::system_clock::time_point::max());
+    if (beam_width > 0) {
+      parser.PlaceNodesWithBeamSearch(beam_width, {"a", "b"}, {}, graph_, {},
+                                      {}, tables_, {}, {}, 0);
+    } else {
+      parser.PlaceNodesWithDynamicProgramming({"a", "b"}, {}, graph_, {}, {},
+                                              tables_, {}, {}, 0);
+    }
+    resulting_plans_ = parser.GetResultingPlan();
+    std::set<std::vector<std::vector<ScheduledModule>>> plans;
+    for (const auto& [plan, _] : resulting_plans_) {
+      plans.insert(plan);
+    }
+    return plans;
+  }
+
+  auto CreateCostEstimator() -> std::unique_ptr<PlanCostEstimator> {
+    return std::make_unique<PlanCostEstimator>(
+        hw_library_, resource_string_, streaming_speed_, GetCostModel(),
+        std::vector<ScheduledModule>{}, std::map<std::string, double>{},
+        std::set<std::string>{});
+  }
+
+  auto GetCostModel() -> ReconfigurationCostModel {
+    return {{}, resource_string_, cost_of_columns_, 66};
+  }
+
+  // Cost of the plan the plan evaluator chooses from the found plans.
+  auto GetEvaluatedBestPlanCost() -> double {
+    auto [best_plan, last_config, data_amount, configuration_amount] =
+        PlanEvaluator().GetBestPlan(1, {}, resource_string_, 0, 0, 0,
+                                    resulting_plans_, cost_of_columns_,
+                                    streaming_speed_, GetCostModel(), {}, {});
+    return data_amount / streaming_speed_ + configuration_amount;
+  }
+
+  auto GetBestPlanCost() -> double {
+    auto cost_estimator = CreateCostEstimator();
+    std::vector<PlanCostEstimator::ConfiguredRun> configured_runs;
+    double best_plan_cost = std::numeric_limits<double>::max();
+    for (const auto& [plan, scheduling_data] : resulting_plans_) {
+      best_plan_cost = std::min(
+          best_plan_cost,
+          cost_estimator->GetPlanCost(
+              plan, scheduling_data.streamed_data_size, configured_runs));
+    }
+    return best_plan_cost;
+  }
+
+  const std::string resource_string_ = "MMDMDBMMDBMMDMDBMMDBMMDMDBMMDBM";
+  const std::map<char, int> cost_of_columns_ = {
+      {'M', 1000}, {'D', 2000}, {'B', 3000}};
+  const double streaming_speed_ = 4800;
+  std::map<QueryOperationType, OperationPRModules> hw_library_;
+  std::unordered_map<std::string, SchedulingQueryNode> graph_;
+  std::map<std::string, TableMetadata> tables_;
+  NiceMock<MockAcceleratorLibrary> drivers_;
+  long table_hits_ = 0;
+  long pruned_branches_ = 0;
+  std::vector<std::vector<ScheduledModule>> best_found_plan_;
+  std::vector<ElasticSchedulingGraphParser::ConvergencePoint> convergence_log_;
+  std::map<std::vector<std::vector<ScheduledModule>>,
+           ExecutionPlanSchedulingData>
+      resulting_plans_;
+};
+
+TEST_F(ElasticSchedulingGraphParserTest, AllNodesArePlaced) {
+  auto plans = GetAllPlans(1);
+  ASSERT_FALSE(plans.empty());
+  for (const auto& plan : plans) {
+    int placed_modules = 0;
+    for (const auto& run : plan) {
+      placed_modules += run.size();
+    }
+    ASSERT_EQ(placed_modules, 3);
+  }
+}
+
+TEST_F(ElasticSchedulingGraphParserTest, ParallelSearchFindsSamePlans) {
+  auto sequential_plans = GetAllPlans(1);
+  for (int repetition = 0; repetition < 5; repetition++) {
+    ASSERT_EQ(GetAllPlans(4), sequential_plans);
+  }
+}
+
+TEST_F(ElasticSchedulingGraphParserTest, ParallelSearchRefusesRunsCap) {
+  ASSERT_THROW(ElasticSchedulingGraphParser(
+                   hw_library_, {{{ModuleSelection("ALL_AVAILABLE")}}, {}}, {},
+                   drivers_, true, false, false, false, 4),
+               std::runtime_error);
+}
+
+TEST_F(ElasticSchedulingGraphParserTest, ReplayedPlansKeepSchedulingData) {
+  GetAllPlans(1);
+  auto found_plans = resulting_plans_;
+  ElasticSchedulingGraphParser parser(
+      hw_library_, {{{ModuleSelection("ALL_AVAILABLE")}}, {}}, {}, drivers_,
+      false, false, false, false);
+  for (const auto& [plan, scheduling_data] : found_plans) {
+    auto replayed_data =
+        parser.ReplayPlan(plan, {"a", "b"}, {}, graph_, tables_, {});
+    ASSERT_EQ(replayed_data.processed_nodes, scheduling_data.processed_nodes);
+    ASSERT_EQ(replayed_data.data_tables, scheduling_data.data_tables);
+    ASSERT_EQ(replayed_data.streamed_data_size,
+              scheduling_data.streamed_data_size);
+  }
+}
+
+TEST_F(ElasticSchedulingGraphParserTest, ReplayedPlansUseGivenTables) {
+  GetAllPlans(1);
+  auto found_plans = resulting_plans_;
+  tables_.at("table_a").record_count *= 3;
+  tables_.at("table_b").record_count *= 3;
+  ElasticSchedulingGraphParser parser(
+      hw_library_, {{{ModuleSelection("ALL_AVAILABLE")}}, {}}, {}, drivers_,
+      false, false, false, false);
+  for (const auto& [plan, scheduling_data] : found_plans) {
+    ASSERT_EQ(parser.ReplayPlan(plan, {"a", "b"}, {}, graph_, tables_, {})
+                  .streamed_data_size,
+              scheduling_data.streamed_data_size * 3);
+  }
+}
+
+// The big linear sort sorts the whole table such that only its branches skip
+// the merge sort. Skipping mustn't change the shared query nodes.
+TEST_F(ElasticSchedulingGraphParserTest,
+       ParallelSearchWithSortsFindsSamePlans) {
+  OperationPRModules linear_sort_modules;
+  linear_sort_modules.starting_locations = {
+      {"linear_sort_64.bin"}, {"linear_sort_512.bin"}, {}, {}};
+  linear_sort_modules.bitstream_map = {
+      {"linear_sort_64.bin", {{0}, 1, {64}, "M", false}},
+      {"linear_sort_512.bin", {{1}, 1, {512}, "M", false}}};
+  OperationPRModules merge_sort_modules;
+  merge_sort_modules.starting_locations = {
+      {}, {}, {"merge_sort_2.bin"}, {"merge_sort_2.bin"}};
+  merge_sort_modules.bitstream_map = {
+      {"merge_sort_2.bin", {{2, 3}, 1, {2}, "M", false}}};
+  hw_library_.insert({QueryOperationType::kLinearSort, linear_sort_modules});
+  hw_library_.insert({QueryOperationType::kMergeSort, merge_sort_modules});
+  const auto& filter_locations =
+      hw_library_.at(QueryOperationType::kFilter).starting_locations;
+
+  QueryNode filter_node({"merged_a"}, {"result_a"}, QueryOperationType::kFilter,
+                        {nullptr}, {nullptr}, {}, "c", {false});
+  QueryNode merge_node({"sorted_a"}, {"merged_a"},
+                       QueryOperationType::kMergeSort, {&filter_node},
+                       {nullptr}, {}, "m", {false});
+  QueryNode sort_node({"table_a"}, {"sorted_a"},
+                      QueryOperationType::kLinearSort, {&merge_node},
+                      {nullptr}, {}, "a", {false});
+  merge_node.previous_nodes = {&sort_node};
+  filter_node.previous_nodes = {&merge_node};
+  QueryNode independent_node({"table_b"}, {"result_b"},
+                             QueryOperationType::kFilter, {nullptr},
+                             {nullptr}, {}, "b", {false});
+  graph_.at("b").before_nodes = {{"", -1}};
+  graph_.at("b").after_nodes = {""};
+  graph_.at("b").node_ptr = &independent_node;
+  graph_ = {{"a",
+             {QueryOperationType::kLinearSort,
+              {100},
+              {{"", -1}},
+              {"m"},
+              {"table_a"},
+              linear_sort_modules.starting_locations,
+              &sort_node}},
+            {"m",
+             {QueryOperationType::kMergeSort,
+              {},
+              {{"a", 0}},
+              {"c"},
+              {"sorted_a"},
+              merge_sort_modules.starting_locations,
+              &merge_node}},
+            {"b", graph_.at("b")},
+            {"c",
+             {QueryOperationType::kFilter,
+              {1},
+              {{"m", 0}},
+              {""},
+              {"merged_a"},
+              filter_locations,
+              &filter_node}}};
+  tables_.insert({"sorted_a", {4, 0, {}}});
+  tables_.insert({"merged_a", {4, 0, {}}});
+  tables_.insert({"result_a", {4, 0, {}}});
+  tables_.insert({"result_b", {2, 0, {}}});
+  auto drivers = FPGADriverFactory().CreateAcceleratorLibrary(nullptr);
+
+  auto get_plans = [&](int thread_count) {
+    ElasticSchedulingGraphParser parser(
+        hw_library_, {{{ModuleSelection("ALL_AVAILABLE")}}, {}}, {}, *drivers,
+        false, false, false, false, thread_count);
+    parser.SetTimeLimit(std::chrono::system_clock::time_point::max());
+    std::unordered_set<std::string> available_nodes = {"a", "b"};
+    std::unordered_set<std::string> processed_nodes;
+    auto graph = graph_;
+    auto tables = tables_;
+    parser.PreprocessNodes(available_nodes, processed_nodes, graph, tables);
+    parser.PlaceNodesRecursively(available_nodes, processed_nodes, graph, {},
+                                 {}, tables, {}, {}, 0);
+    std::set<std::vector<std::vector<ScheduledModule>>> plans;
+    for (const auto& [plan, scheduling_data] : parser.GetResultingPlan()) {
+      plans.insert(plan);
+    }
+    return plans;
+  };
+
+  auto sequential_plans = get_plans(1);
+  ASSERT_FALSE(sequential_plans.empty());
+  bool is_merge_sort_skipped = false;
+  for (const auto& plan : sequential_plans) {
+    bool is_merge_sort_placed = false;
+    for (const auto& run : plan) {
+      for (const auto& module : run) {
+        is_merge_sort_placed |= module.node_name == "m";
+      }
+    }
+    is_merge_sort_skipped |= !is_merge_sort_placed;
+  }
+  ASSERT_TRUE(is_merge_sort_skipped);
+  for (int repetition = 0; repetition < 5; repetition++) {
+    ASSERT_EQ(get_plans(4), sequential_plans);
+  }
+  ASSERT_EQ(filter_node.given_input_data_definition_files,
+            std::vector<std::string>{"merged_a"});
+}
+
+// Plans are keyed by their start columns. Reused continuations can keep a
+// different plan with the same key than a repeated search would.
+auto HaveSameKeys(
+    const std::set<std::vector<std::vector<ScheduledModule>>>& lhs,
+    const std::set<std::vector<std::vector<ScheduledModule>>>& rhs) -> bool {
+  return !(lhs < rhs) && !(rhs < lhs);
+}
+
+TEST_F(ElasticSchedulingGraphParserTest, TranspositionTableFindsSamePlans) {
+  auto plans = GetAllPlans(1);
+  ASSERT_TRUE(HaveSameKeys(GetAllPlans(1, 10000), plans));
+  ASSERT_GT(table_hits_, 0);
+  ASSERT_TRUE(HaveSameKeys(GetAllPlans(4, 10000), plans));
+  // States which don't fit are searched again.
+  ASSERT_TRUE(HaveSameKeys(GetAllPlans(1, 1), plans));
+}
+
+TEST_F(ElasticSchedulingGraphParserTest,
+       TranspositionTableWithRunsCapFindsSamePlans) {
+  // a -> c -> e and b -> d such that more runs are needed.
+  const auto& filter_locations =
+      hw_library_.at(QueryOperationType::kFilter).starting_locations;
+  graph_.at("b").after_nodes = {"d"};
+  graph_.at("c").after_nodes = {"e"};
+  graph_.insert({"d",
+                 {QueryOperationType::kFilter,
+                  {1},
+                  {{"b", 0}},
+                  {},
+                  {"table_b"},
+                  filter_locations,
+                  nullptr}});
+  graph_.insert({"e",
+                 {QueryOperationType::kFilter,
+                  {1},
+                  {{"c", 0}},
+                  {},
+                  {"table_a"},
+                  filter_locations,
+                  nullptr}});
+  GetAllPlans(1, 0, false, false, true);
+  auto capped_plans = resulting_plans_;
+  GetAllPlans(1, 10000, false, false, true);
+  ASSERT_GT(table_hits_, 0);
+  ASSERT_EQ(resulting_plans_.size(), capped_plans.size());
+  for (const auto& [plan, scheduling_data] : capped_plans) {
+    ASSERT_EQ(resulting_plans_.count(plan), 1);
+    ASSERT_EQ(resulting_plans_.at(plan).processed_nodes,
+              scheduling_data.processed_nodes);
+    ASSERT_EQ(resulting_plans_.at(plan).streamed_data_size,
+              scheduling_data.streamed_data_size);
+  }
+}
+
+TEST_F(ElasticSchedulingGraphParserTest, BranchAndBoundKeepsBestPlanCost) {
+  auto plans = GetAllPlans(1);
+  auto first_found_plans_cost = GetEvaluatedBestPlanCost();
+  // Plans with the same modules are only kept once. With plan costs the
+  // cheaper one is kept instead of the first one.
+  ASSERT_EQ(GetAllPlans(1, 0, false, true).size(), plans.size());
+  ASSERT_EQ(pruned_branches_, 0);
+  auto best_plan_cost = GetEvaluatedBestPlanCost();
+  ASSERT_LE(best_plan_cost, first_found_plans_cost);
+
+  ASSERT_LT(GetAllPlans(1, 0, true).size(), plans.size());
+  ASSERT_GT(pruned_branches_, 0);
+  ASSERT_DOUBLE_EQ(GetEvaluatedBestPlanCost(), best_plan_cost);
+  GetAllPlans(4, 10000, true);
+  ASSERT_DOUBLE_EQ(GetEvaluatedBestPlanCost(), best_plan_cost);
+}
+
+TEST_F(ElasticSchedulingGraphParserTest, AnytimeSearchKeepsCheapestPlan) {
+  auto plans = GetAllPlans(1, 0, false, true);
+  ASSERT_EQ(pruned_branches_, 0);
+  auto best_plan_cost = GetBestPlanCost();
+  ASSERT_NE(plans.find(best_found_plan_), plans.end());
+  ASSERT_FALSE(convergence_log_.empty());
+  ASSERT_DOUBLE_EQ(convergence_log_.back().cost, best_plan_cost);
+  for (int point_index = 1; point_index < convergence_log_.size();
+       point_index++) {
+    ASSERT_LT(convergence_log_.at(point_index).cost,
+              convergence_log_.at(point_index - 1).cost);
+    ASSERT_GE(convergence_log_.at(point_index).time,
+              convergence_log_.at(point_index - 1).time);
+  }
+
+  auto cost_estimator = CreateCostEstimator();
+  std::vector<PlanCostEstimator::ConfiguredRun> configured_runs;
+  ASSERT_DOUBLE_EQ(
+      cost_estimator->GetPlanCost(
+          best_found_plan_,
+          resulting_plans_.at(best_found_plan_).streamed_data_size,
+          configured_runs),
+      best_plan_cost);
+  GetAllPlans(4, 0, true, true);
+  ASSERT_DOUBLE_EQ(convergence_log_.back().cost, best_plan_cost);
+}
+
+TEST_F(ElasticSchedulingGraphParserTest, GreedySearchFindsOnePlan) {
+  auto plans = GetAllPlans(1);
+  auto best_plan_cost = GetBestPlanCost();
+  auto greedy_plans = GetCostGuidedPlans(1);
+  ASSERT_EQ(greedy_plans.size(), 1);
+  ASSERT_NE(plans.find(*greedy_plans.begin()), plans.end());
+  ASSERT_GE(GetBestPlanCost(), best_plan_cost);
+}
+
+TEST_F(ElasticSchedulingGraphParserTest, WideBeamSearchFindsBestPlanCost) {
+  GetAllPlans(1);
+  auto best_plan_cost = GetBestPlanCost();
+  GetCostGuidedPlans(1);
+  auto greedy_plan_cost = GetBestPlanCost();
+  GetCostGuidedPlans(1000);
+  ASSERT_DOUBLE_EQ(GetBestPlanCost(), best_plan_cost);
+  ASSERT_LE(GetBestPlanCost(), greedy_plan_cost);
+}
+
+TEST_F(ElasticSchedulingGraphParserTest,
+       DynamicProgrammingFindsCheapestPlan) {
+  auto plans = GetAllPlans(1);
+  auto best_plan_cost = GetBestPlanCost();
+  auto exact_plans = GetCostGuidedPlans(0);
+  ASSERT_EQ(exact_plans.size(), 1);
+  ASSERT_NE(plans.find(*exact_plans.begin()), plans.end());
+  ASSERT_DOUBLE_EQ(GetBestPlanCost(), best_plan_cost);
+}
+
+TEST_F(ElasticSchedulingGraphParserTest,
+       DynamicProgrammingWithRunsCapFindsCheapestPlanWithFewestRuns) {
+  auto plans = GetAllPlans(1, 0, false, false, true);
+  auto min_runs = std::min_element(plans.begin(), plans.end(),
+                                   [](const auto& lhs, const auto& rhs) {
+                                     return lhs.size() < rhs.size();
+                                   })
+                      ->size();
+  for (auto it = resulting_plans_.begin(); it != resulting_plans_.end();) {
+    it = it->first.size() == min_runs ? std::next(it)
+                                      : resulting_plans_.erase(it);
+  }
+  auto best_plan_cost = GetBestPlanCost();
+
+  auto exact_plans = GetCostGuidedPlans(0, true);
+  ASSERT_EQ(exact_plans.size(), 1);
+  ASSERT_EQ(exact_plans.begin()->size(), min_runs);
+  ASSERT_DOUBLE_EQ(GetBestPlanCost(), best_plan_cost);
+}
+
+TEST_F(ElasticSchedulingGraphParserTest,
+       ExpiredTimeLimitFallsBackToGreedyPlan) {
+  auto greedy_plans = GetCostGuidedPlans(1);
+  ElasticSchedulingGraphParser parser(
+      hw_library_, {{{ModuleSelection("ALL_AVAILABLE")}}, {}}, {}, drivers_,
+      false, false, false, false);
+  parser.SetPlanCostEstimator(CreateCostEstimator(), false);
+  parser.SetTimeLimit(std::chrono::system_clock::time_point::min(), true);
+
+  ASSERT_THROW(parser.PlaceNodesRecursively({"a", "b"}, {}, graph_, {}, {},
+                                            tables_, {}, {}, 0),
+               TimeLimitException);
+  ASSERT_TRUE(parser.GetTimeoutStatus());
+  ASSERT_FALSE(parser.HasFoundPlan());
+  ASSERT_FALSE(parser.IsGreedyFallbackUsed());
+  parser.PlaceNodesGreedilyAfterTimeout({"a", "b"}, {}, graph_, tables_, {});
+  ASSERT_TRUE(parser.HasFoundPlan());
+  ASSERT_TRUE(parser.IsGreedyFallbackUsed());
+  std::set<std::vector<std::vector<ScheduledModule>>> plans;
+  for (const auto& [plan, _] : parser.GetResultingPlan()) {
+    plans.insert(plan);
+  }
+  ASSERT_EQ(plans, greedy_plans);
+}
+
+TEST_F(ElasticSchedulingGraphParserTest,
+       ExpiredTimeLimitStopsAfterFirstPlanByDefault) {
+  ElasticSchedulingGraphParser parser(
+      hw_library_, {{{ModuleSelection("ALL_AVAILABLE")}}, {}}, {}, drivers_,
+      false, false, false, false);
+  parser.SetTimeLimit(std::chrono::system_clock::time_point::min());
+
+  ASSERT_THROW(parser.PlaceNodesRecursively({"a", "b"}, {}, graph_, {}, {},
+                                            tables_, {}, {}, 0),
+               TimeLimitException);
+  ASSERT_TRUE(parser.GetTimeoutStatus());
+  ASSERT_TRUE(parser.HasFoundPlan());
+  ASSERT_FALSE(parser.IsGreedyFallbackUsed());
+  ASSERT_EQ(parser.GetResultingPlan().size(), 1);
+}
+
+TEST_F(ElasticSchedulingGraphParserTest,
+       BeamSearchFinishesGreedilyAfterTimeLimit) {
+  auto greedy_plans = GetCostGuidedPlans(1);
+  ElasticSchedulingGraphParser parser(
+      hw_library_, {{{ModuleSelection("ALL_AVAILABLE")}}, {}}, {}, drivers_,
+      false, false, false, false);
+  parser.SetPlanCostEstimator(CreateCostEstimator(), false);
+  parser.SetTimeLimit(std::chrono::system_clock::time_point::min());
+
+  parser.PlaceNodesWithBeamSearch(1000, {"a", "b"}, {}, graph_, {}, {},
+                                  tables_, {}, {}, 0);
+  ASSERT_TRUE(parser.GetTimeoutStatus());
+  std::set<std::vector<std::vector<ScheduledModule>>> plans;
+  for (const auto& [plan, _] : parser.GetResultingPlan()) {
+    plans.insert(plan);
+  }
+  ASSERT_EQ(plans, greedy_plans);
+}
+
+}  // namespace
@@ -0,0 +1,120 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "hw_library_index.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace {
+
+using orkhestrafs::core_interfaces::hw_library::PRModuleData;
+using orkhestrafs::dbmstodspi::HWLibraryIndex;
+
+class HWLibraryIndexTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    OperationPRModules filter_modules;
+    filter_modules.starting_locations = {
+        {"filter_small_0.bin", "filter_large_0.bin"},
+        {},
+        {"filter_small_2.bin"}};
+    filter_modules.bitstream_map = {
+        {"filter_small_0.bin", {{0}, 1, {8, 2}, "M", false}},
+        {"filter_large_0.bin", {{0}, 2, {32, 4}, "MM", false}},
+        {"filter_small_2.bin", {{2}, 1, {8, 2}, "M", false}}};
+    OperationPRModules join_modules;
+    join_modules.starting_locations = {{}, {"join_1.bin"}, {}};
+    join_modules.bitstream_map = {{"join_1.bin", {{1}, 2, {}, "MM", false}}};
+    hw_library_ = {{QueryOperationType::kFilter, filter_modules},
+                   {QueryOperationType::kJoin, join_modules}};
+  }
+  std::map<QueryOperationType, OperationPRModules> hw_library_;
+};
+
+TEST_F(HWLibraryIndexTest, ModulesKeepLibraryOrder) {
+  HWLibraryIndex index(hw_library_);
+  auto large_filter =
+      index.GetModuleId(QueryOperationType::kFilter, 0, "filter_large_0.bin");
+  ASSERT_EQ(index.GetModuleId(QueryOperationType::kFilter, 0, 1),
+            large_filter);
+  ASSERT_EQ(index.GetModule(large_filter).location_index, 1);
+  ASSERT_EQ(index.GetModule(large_filter).end, 1);
+  ASSERT_THROW(
+      index.GetModuleId(QueryOperationType::kFilter, 2, "filter_large_0.bin"),
+      std::runtime_error);
+}
+
+TEST_F(HWLibraryIndexTest, BitstreamIdsDontDependOnTheColumn) {
+  hw_library_.at(QueryOperationType::kFilter)
+      .starting_locations.at(2)
+      .push_back("filter_small_0.bin");
+  HWLibraryIndex index(hw_library_);
+  auto small_filter =
+      index.GetModuleId(QueryOperationType::kFilter, 0, "filter_small_0.bin");
+  ASSERT_NE(
+      index.GetModuleId(QueryOperationType::kFilter, 2, "filter_small_0.bin"),
+      small_filter);
+  ASSERT_EQ(
+      index.GetBitstreamId(QueryOperationType::kFilter, "filter_small_0.bin"),
+      small_filter);
+  ASSERT_THROW(
+      index.GetBitstreamId(QueryOperationType::kJoin, "filter_small_0.bin"),
+      std::runtime_error);
+}
+
+TEST_F(HWLibraryIndexTest, OverlappingFootprintsAreFound) {
+  HWLibraryIndex index(hw_library_);
+  auto overlapping_modules =
+      index.GetOverlappingModules(QueryOperationType::kFilter, 1, 1);
+  ASSERT_FALSE(HWLibraryIndex::IsInSet(
+      overlapping_modules,
+      index.GetModuleId(QueryOperationType::kFilter, 0, "filter_small_0.bin")));
+  ASSERT_TRUE(HWLibraryIndex::IsInSet(
+      overlapping_modules,
+      index.GetModuleId(QueryOperationType::kFilter, 0, "filter_large_0.bin")));
+  ASSERT_FALSE(HWLibraryIndex::IsInSet(
+      overlapping_modules,
+      index.GetModuleId(QueryOperationType::kFilter, 2, "filter_small_2.bin")));
+  ASSERT_TRUE(HWLibraryIndex::IsEmpty(
+      index.GetOverlappingModules(QueryOperationType::kJoin, 0, 0)));
+}
+
+TEST_F(HWLibraryIndexTest, FittingModulesMeetAllCapacityValues) {
+  HWLibraryIndex index(hw_library_);
+  std::vector<std::vector<std::string>> expected_locations = {
+      {"filter_large_0.bin"}, {}, {}};
+  ASSERT_EQ(index.GetBitstreamLocations(
+                QueryOperationType::kFilter,
+                index.GetFittingModules(QueryOperationType::kFilter, {16, 1})),
+            expected_locations);
+  expected_locations = {{"filter_small_0.bin", "filter_large_0.bin"},
+                        {},
+                        {"filter_small_2.bin"}};
+  ASSERT_EQ(index.GetBitstreamLocations(
+                QueryOperationType::kFilter,
+                index.GetFittingModules(QueryOperationType::kFilter, {8, 2})),
+            expected_locations);
+  ASSERT_TRUE(HWLibraryIndex::IsEmpty(
+      index.GetFittingModules(QueryOperationType::kFilter, {8, 5})));
+  ASSERT_TRUE(index.IsFittingAt(QueryOperationType::kFilter, 0, {32, 4}));
+  ASSERT_FALSE(index.IsFittingAt(QueryOperationType::kFilter, 2, {32, 4}));
+  // Modules without capacity values fit any requirements.
+  ASSERT_TRUE(index.IsFittingAt(QueryOperationType::kJoin, 1, {}));
+}
+
+}  // namespace
@@ -47,6 +47,11 @@ class MockNodeScheduler : public NodeSchedulerInterface {
 
  public:
   MOCK_METHOD(long, GetTime, (), (override));
+  MOCK_METHOD(void, SetModuleReuseWeights,
+              ((std::map<std::string, double>)module_reuse_weights),
+              (override));
+  MOCK_METHOD(void, SetPinnedModules,
+              ((std::set<std::string>)pinned_modules), (override));
   MOCK_METHOD(
       ResultingPlanQueue, GetNextSetOfRuns,
       (std::vector<QueryNode*> & query_nodes,
@@ -20,6 +20,7 @@ limitations under the License.
 #include "query_manager_interface.hpp"
 
 using orkhestrafs::dbmstodspi::QueryManagerInterface;
+using orkhestrafs::dbmstodspi::RunTimes;
 
 class MockQueryManager : public QueryManagerInterface {
  private:
@@ -47,9 +48,11 @@ class MockQueryManager : public QueryManagerInterface {
  public:
   MOCK_METHOD(std::vector<long>, GetData, (), (override));
   MOCK_METHOD(long, GetConfigTime, (), (override));
-  MOCK_METHOD(void, MeasureBitstreamConfigurationSpeed,
+  MOCK_METHOD((std::map<std::string, double>),
+              MeasureBitstreamConfigurationSpeed,
               (const HWLibrary& hw_library,
-               orkhestrafs::dbmstodspi::MemoryManagerInterface* memory_manager),
+               orkhestrafs::dbmstodspi::MemoryManagerInterface* memory_manager,
+               const std::string& profile_filename),
               (override));
   MOCK_METHOD(ReuseLinks, GetCurrentLinks,
               (std::queue<ReuseLinks> & all_reuse_links), (override));
@@ -68,7 +71,7 @@ class MockQueryManager : public QueryManagerInterface {
               (override));
   /*MOCK_METHOD(bool, IsRunValid, (std::vector<AcceleratedQueryNode>
      current_run), (override));*/
-  MOCK_METHOD(void, ExecuteAndProcessResults,
+  MOCK_METHOD(RunTimes, ExecuteAndProcessResults,
               (MemoryManagerInterface * memory_manager,
                FPGAManagerInterface* fpga_manager,
                const DataManagerInterface* data_manager,
@@ -76,7 +79,8 @@ class MockQueryManager : public QueryManagerInterface {
                const MappedResultParameters& result_parameters,
                const std::vector<AcceleratedQueryNode>& execution_query_nodes,
                TableMap& scheduling_table_data, Counter& table_counter,
-               int timeout),
+               int timeout,
+               const std::vector<std::string>& prefetch_bitstreams),
               (override));
   MOCK_METHOD(
       (std::queue<std::pair<std::vector<ScheduledModule>, QueryNodeVector>>),
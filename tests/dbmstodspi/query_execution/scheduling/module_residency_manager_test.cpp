@@ -0,0 +1,95 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "module_residency_manager.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace {
+
+using orkhestrafs::dbmstodspi::ModuleResidencyManager;
+
+class ModuleResidencyManagerTest : public ::testing::Test {
+ protected:
+  const std::string resource_string_ = "MMDMDBMMDBMMDMDBMMDBMMDMDBMMDBM";
+  const std::map<char, int> cost_of_columns_ = {
+      {'M', 1000}, {'D', 2000}, {'B', 3000}};
+  ScheduledModule filter_ = {
+      "filter", QueryOperationType::kFilter, "filter.bin", {0, 1}, false};
+  ScheduledModule join_ = {
+      "join", QueryOperationType::kJoin, "join.bin", {2, 5}, false};
+};
+
+TEST_F(ModuleResidencyManagerTest, ReuseWeightsFollowQueryFrequency) {
+  ModuleResidencyManager residency_manager(resource_string_, cost_of_columns_,
+                                           {});
+  ASSERT_TRUE(residency_manager.GetReuseWeights().empty());
+
+  residency_manager.RecordRun({filter_, join_}, {});
+  residency_manager.FinishQuery();
+  residency_manager.RecordRun({filter_}, {});
+  residency_manager.FinishQuery();
+
+  std::map<std::string, double> expected_weights = {{"filter.bin", 1.0},
+                                                    {"join.bin", 0.5}};
+  ASSERT_EQ(residency_manager.GetReuseWeights(), expected_weights);
+  ASSERT_EQ(residency_manager.GetStats().query_count, 2);
+}
+
+TEST_F(ModuleResidencyManagerTest, PinnedModulesHaveFullWeight) {
+  ModuleResidencyManager residency_manager(resource_string_, cost_of_columns_,
+                                           {"join.bin"});
+  residency_manager.RecordRun({filter_}, {});
+  residency_manager.FinishQuery();
+  residency_manager.RecordRun({join_}, {});
+  residency_manager.FinishQuery();
+  residency_manager.Pin("sort.bin");
+
+  ASSERT_TRUE(residency_manager.IsPinned("join.bin"));
+  std::set<std::string> expected_pinned_modules = {"join.bin", "sort.bin"};
+  ASSERT_EQ(residency_manager.GetPinnedModules(), expected_pinned_modules);
+  auto weights = residency_manager.GetReuseWeights();
+  ASSERT_EQ(weights.at("join.bin"), 1.0);
+  ASSERT_EQ(weights.at("sort.bin"), 1.0);
+  ASSERT_EQ(weights.at("filter.bin"), 0.5);
+
+  residency_manager.Unpin("join.bin");
+  ASSERT_FALSE(residency_manager.IsPinned("join.bin"));
+  ASSERT_EQ(residency_manager.GetReuseWeights().at("join.bin"), 0.5);
+}
+
+TEST_F(ModuleResidencyManagerTest, ConfiguredModulesCountAsSavedBytes) {
+  ModuleResidencyManager residency_manager(resource_string_, cost_of_columns_,
+                                           {});
+  residency_manager.RecordRun({filter_, join_}, {});
+  residency_manager.FinishQuery();
+  ScheduledModule moved_join = join_;
+  moved_join.position = {6, 9};
+  residency_manager.RecordRun({filter_, moved_join}, {filter_, join_});
+  residency_manager.FinishQuery();
+  // Nothing was recorded for this query.
+  residency_manager.FinishQuery();
+
+  auto stats = residency_manager.GetStats();
+  // filter: MM = 2000, join: DMDB = 8000, moved join: MMDB = 7000.
+  ASSERT_EQ(stats.loaded_bytes, 2000 + 8000 + 7000);
+  ASSERT_EQ(stats.saved_bytes, 2000);
+  ASSERT_EQ(stats.query_count, 2);
+}
+
+}  // namespace
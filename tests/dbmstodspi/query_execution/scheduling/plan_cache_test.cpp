@@ -0,0 +1,213 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "plan_cache.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <set>
+
+namespace {
+
+using orkhestrafs::dbmstodspi::PlanCache;
+
+const std::string kFilename = "plan_cache_test.txt";
+const std::string kResourceString = "MMDM";
+
+class PlanCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::remove(kFilename.c_str());
+    OperationPRModules filter_modules;
+    filter_modules.starting_locations = {{"filter_0.bin"}, {"filter_1.bin"}};
+    filter_modules.bitstream_map = {
+        {"filter_0.bin", {{0}, 1, {8}, "M", false}},
+        {"filter_1.bin", {{1}, 1, {8}, "M", false}}};
+    config_.pr_hw_library = {{QueryOperationType::kFilter, filter_modules}};
+    config_.resource_string = kResourceString;
+    graph_ = {{"a",
+               {QueryOperationType::kFilter,
+                {1},
+                {},
+                {"b"},
+                {"table_a"},
+                filter_modules.starting_locations,
+                nullptr}},
+              {"b",
+               {QueryOperationType::kFilter,
+                {1},
+                {{"a", 0}},
+                {},
+                {""},
+                filter_modules.starting_locations,
+                nullptr}}};
+    tables_ = {{"table_a", {4, 1000, {}}}};
+    plan_ = {{{"a", QueryOperationType::kFilter, "filter_0.bin", {0, 0}, false},
+              {"b", QueryOperationType::kFilter, "filter_1.bin", {1, 1},
+               false}}};
+  }
+  void TearDown() override { std::remove(kFilename.c_str()); }
+
+  auto GetKey(const std::map<std::string, TableMetadata>& tables,
+              const std::vector<ScheduledModule>& current_configuration = {},
+              const std::map<std::string, double>& module_reuse_weights = {},
+              const std::set<std::string>& pinned_modules = {})
+      -> PlanCache::Key {
+    return PlanCache::GetKey({"a"}, {}, {}, graph_, tables,
+                             current_configuration, module_reuse_weights,
+                             pinned_modules);
+  }
+
+  Config config_;
+  std::unordered_map<std::string, SchedulingQueryNode> graph_;
+  std::map<std::string, TableMetadata> tables_;
+  std::vector<std::vector<ScheduledModule>> plan_;
+};
+
+TEST_F(PlanCacheTest, SimilarTableSizesShareKey) {
+  auto key = GetKey(tables_).key;
+  ASSERT_EQ(GetKey({{"table_a", {4, 1010, {}}}}).key, key);
+  ASSERT_NE(GetKey({{"table_a", {4, 5000, {}}}}).key, key);
+  ASSERT_NE(GetKey({{"table_a", {4, 1000, {0, 999, 1000, 1}}}}).key, key);
+  ASSERT_NE(GetKey(tables_, plan_.front()).key, key);
+  ASSERT_NE(GetKey(tables_, {}, {{"filter_0.bin", 2}}).key, key);
+  ASSERT_NE(GetKey(tables_, {}, {}, {"filter_0.bin"}).key, key);
+}
+
+TEST_F(PlanCacheTest, RenamedGraphSharesPlan) {
+  auto sorted_tables = tables_;
+  sorted_tables.at("table_a").sorted_status = {0, 999, 1000, 1};
+  PlanCache plan_cache(kFilename, config_);
+  plan_cache.Insert(GetKey(tables_), plan_, sorted_tables, tables_);
+
+  auto node_b = graph_.at("b");
+  node_b.before_nodes = {{"x", 0}};
+  auto node_a = graph_.at("a");
+  node_a.after_nodes = {"y"};
+  node_a.data_tables = {"table_x"};
+  std::map<std::string, TableMetadata> renamed_tables = {
+      {"table_x", tables_.at("table_a")}};
+  auto renamed_key = PlanCache::GetKey({"x"}, {}, {},
+                                       {{"x", node_a}, {"y", node_b}},
+                                       renamed_tables, {}, {}, {});
+  ASSERT_EQ(renamed_key.key, GetKey(tables_).key);
+
+  auto cached_plan = plan_cache.Find(renamed_key, renamed_tables);
+  ASSERT_TRUE(cached_plan.has_value());
+  auto renamed_plan = plan_;
+  renamed_plan.front().at(0).node_name = "x";
+  renamed_plan.front().at(1).node_name = "y";
+  ASSERT_EQ(cached_plan->plan, renamed_plan);
+  ASSERT_EQ(cached_plan->input_tables, renamed_tables);
+}
+
+TEST_F(PlanCacheTest, InsertedPlansAreAppended) {
+  auto count_plans_in_file = []() {
+    std::ifstream input_file(kFilename);
+    std::string line;
+    int plan_count = 0;
+    while (std::getline(input_file, line)) {
+      plan_count += static_cast<int>(line.rfind("plan ", 0) == 0);
+    }
+    return plan_count;
+  };
+  std::map<std::string, TableMetadata> large_tables = {
+      {"table_a", {4, 5000, {}}}};
+  auto swapped_plan = plan_;
+  std::swap(swapped_plan.front().at(0).position,
+            swapped_plan.front().at(1).position);
+  {
+    PlanCache plan_cache(kFilename, config_);
+    plan_cache.Insert(GetKey(tables_), plan_, tables_, tables_);
+    plan_cache.Insert(GetKey(large_tables), plan_, large_tables,
+                      large_tables);
+    plan_cache.Insert(GetKey(tables_), swapped_plan, tables_, tables_);
+  }
+  ASSERT_EQ(count_plans_in_file(), 3);
+
+  // Replaced plans are dropped from the file when it's loaded.
+  PlanCache plan_cache(kFilename, config_);
+  ASSERT_EQ(plan_cache.GetPlanCount(), 2);
+  ASSERT_EQ(count_plans_in_file(), 2);
+  ASSERT_EQ(plan_cache.Find(GetKey(tables_), tables_)->plan, swapped_plan);
+}
+
+TEST_F(PlanCacheTest, PlansArePersisted) {
+  PlanCache(kFilename, config_).Insert(GetKey(tables_), plan_, tables_,
+                                       tables_);
+
+  PlanCache plan_cache(kFilename, config_);
+  ASSERT_EQ(plan_cache.GetPlanCount(), 1);
+  auto cached_plan =
+      plan_cache.Find(GetKey(tables_), {{"table_a", {4, 1010, {}}}});
+  ASSERT_TRUE(cached_plan.has_value());
+  ASSERT_EQ(cached_plan->plan, plan_);
+}
+
+TEST_F(PlanCacheTest, ChangedLibraryDropsPlans) {
+  PlanCache(kFilename, config_).Insert(GetKey(tables_), plan_, tables_,
+                                       tables_);
+
+  auto changed_config = config_;
+  changed_config.resource_string = "MMDB";
+  ASSERT_EQ(PlanCache(kFilename, changed_config).GetPlanCount(), 0);
+  changed_config = config_;
+  changed_config.pr_hw_library.at(QueryOperationType::kFilter)
+      .bitstream_map.at("filter_1.bin")
+      .capacity = {16};
+  ASSERT_EQ(PlanCache(kFilename, changed_config).GetPlanCount(), 0);
+  ASSERT_EQ(PlanCache(kFilename, config_).GetPlanCount(), 1);
+}
+
+TEST_F(PlanCacheTest, ChangedCostModelDropsPlans) {
+  PlanCache(kFilename, config_).Insert(GetKey(tables_), plan_, tables_,
+                                       tables_);
+
+  auto changed_config = config_;
+  changed_config.configuration_speed *= 2;
+  ASSERT_EQ(PlanCache(kFilename, changed_config).GetPlanCount(), 0);
+  changed_config = config_;
+  changed_config.streaming_speed *= 2;
+  ASSERT_EQ(PlanCache(kFilename, changed_config).GetPlanCount(), 0);
+  changed_config = config_;
+  changed_config.reconfiguration_costs = {{"filter_0.bin", 10}};
+  ASSERT_EQ(PlanCache(kFilename, changed_config).GetPlanCount(), 0);
+  changed_config = config_;
+  changed_config.scheduler_beam_width = 1;
+  ASSERT_EQ(PlanCache(kFilename, changed_config).GetPlanCount(), 0);
+  changed_config = config_;
+  changed_config.heuristic_choice = 1;
+  ASSERT_EQ(PlanCache(kFilename, changed_config).GetPlanCount(), 0);
+  ASSERT_EQ(PlanCache(kFilename, config_).GetPlanCount(), 1);
+}
+
+TEST_F(PlanCacheTest, ChangedTablesMustMatchExactly) {
+  auto sorted_tables = tables_;
+  sorted_tables.at("table_a").sorted_status = {0, 999, 1000, 1};
+  PlanCache plan_cache(kFilename, config_);
+  plan_cache.Insert(GetKey(tables_), plan_, sorted_tables, tables_);
+
+  ASSERT_TRUE(plan_cache.Find(GetKey(tables_), tables_).has_value());
+  ASSERT_FALSE(
+      plan_cache.Find(GetKey(tables_), {{"table_a", {4, 1010, {}}}})
+          .has_value());
+}
+
+}  // namespace
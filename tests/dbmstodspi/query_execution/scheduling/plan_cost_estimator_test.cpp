@@ -0,0 +1,146 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+
+#include "plan_cost_estimator.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "plan_evaluator.hpp"
+
+namespace {
+
+using orkhestrafs::dbmstodspi::PlanCostEstimator;
+using orkhestrafs::dbmstodspi::PlanEvaluator;
+using orkhestrafs::dbmstodspi::ReconfigurationCostModel;
+using orkhestrafs::dbmstodspi::SchedulingSearchState;
+
+class PlanCostEstimatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    OperationPRModules filter_modules;
+    filter_modules.starting_locations = {{"narrow.bin"}, {"wide.bin"}};
+    filter_modules.bitstream_map = {
+        {"narrow.bin", {{0}, 4, {8}, "MMDM", false}},
+        {"wide.bin", {{1}, 5, {16}, "MDMDB", false}}};
+    hw_library_ = {{QueryOperationType::kFilter, filter_modules}};
+    graph_ = {{"a",
+               {QueryOperationType::kFilter,
+                {1},
+                {},
+                {},
+                {"table_a"},
+                filter_modules.starting_locations,
+                nullptr}},
+              {"b",
+               {QueryOperationType::kFilter,
+                {1},
+                {},
+                {},
+                {"table_b"},
+                filter_modules.starting_locations,
+                nullptr}}};
+    tables_ = {{"table_a", {4, 100, {}}}, {"table_b", {2, 300, {}}}};
+  }
+
+  auto CreateEstimator(const std::map<std::string, double>& reuse_weights)
+      -> PlanCostEstimator {
+    return {hw_library_, resource_string_, streaming_speed_, cost_model_,
+            {},          reuse_weights,    {}};
+  }
+
+  auto GetEvaluatorCost(const std::vector<std::vector<ScheduledModule>>& plan,
+                        long streamed_data_size,
+                        const std::map<std::string, double>& reuse_weights)
+      -> double {
+    auto [best_plan, last_config, data_amount, configuration_amount] =
+        PlanEvaluator().GetBestPlan(
+            1, {}, resource_string_, 0, 0, 0,
+            {{plan, {{}, {}, static_cast<int>(streamed_data_size)}}},
+            cost_of_columns_, streaming_speed_, cost_model_, reuse_weights,
+            {});
+    return data_amount / streaming_speed_ +
+           (configuration_amount -
+            PlanEvaluator::FindExpectedReuseSavings(
+                last_config, resource_string_, cost_model_, reuse_weights));
+  }
+
+  const std::string resource_string_ = "MMDMDBMMDBMMDMDBMMDBMMDMDBMMDBM";
+  const std::map<char, int> cost_of_columns_ = {
+      {'M', 1000}, {'D', 2000}, {'B', 3000}};
+  const double streaming_speed_ = 4800;
+  const ReconfigurationCostModel cost_model_ = {{}, resource_string_,
+                                                cost_of_columns_, 66};
+  ScheduledModule narrow_a_ = {
+      "a", QueryOperationType::kFilter, "narrow.bin", {0, 3}, false};
+  ScheduledModule wide_b_ = {
+      "b", QueryOperationType::kFilter, "wide.bin", {1, 5}, false};
+  std::map<QueryOperationType, OperationPRModules> hw_library_;
+  std::unordered_map<std::string, SchedulingQueryNode> graph_;
+  std::map<std::string, TableMetadata> tables_;
+};
+
+TEST_F(PlanCostEstimatorTest, PlanCostMatchesPlanEvaluator) {
+  std::map<std::string, double> reuse_weights = {{"wide.bin", 0.5}};
+  auto estimator = CreateEstimator(reuse_weights);
+  std::vector<PlanCostEstimator::ConfiguredRun> configured_runs;
+  for (const auto& plan :
+       std::vector<std::vector<std::vector<ScheduledModule>>>{
+           {{narrow_a_}, {wide_b_}},
+           {{narrow_a_}},
+           {{wide_b_}, {narrow_a_}},
+           {{narrow_a_}, {wide_b_}}}) {
+    ASSERT_DOUBLE_EQ(estimator.GetPlanCost(plan, 4000, configured_runs),
+                     GetEvaluatorCost(plan, 4000, reuse_weights));
+  }
+}
+
+TEST_F(PlanCostEstimatorTest, PinnedEvictionsAreCountedSeparately) {
+  PlanCostEstimator estimator(hw_library_, resource_string_, streaming_speed_,
+                              cost_model_, {wide_b_}, {}, {"wide.bin"});
+  std::vector<PlanCostEstimator::ConfiguredRun> configured_runs;
+  ASSERT_EQ(estimator.GetPinnedEvictionCount({{narrow_a_}}, configured_runs),
+            1);
+  ASSERT_EQ(estimator.GetPinnedEvictionCount({{wide_b_}}, configured_runs), 0);
+  // The cost doesn't include the eviction.
+  ASSERT_LT(estimator.GetPlanCost({{narrow_a_}}, 0, configured_runs),
+            estimator.GetPlanCost({{narrow_a_}, {wide_b_}}, 0,
+                                  configured_runs));
+}
+
+TEST_F(PlanCostEstimatorTest, LowerBoundDoesNotExceedPlanCost) {
+  auto estimator = CreateEstimator({{"wide.bin", 0.5}});
+  std::vector<PlanCostEstimator::ConfiguredRun> configured_runs;
+  SchedulingSearchState state({"a", "b"}, {}, graph_, {}, {}, tables_, {}, {},
+                              0);
+  auto lower_bound = estimator.GetLowerBound(state, configured_runs);
+  // Both tables have to be streamed.
+  for (const auto& plan :
+       std::vector<std::vector<std::vector<ScheduledModule>>>{
+           {{narrow_a_}, {wide_b_}}, {{wide_b_}, {narrow_a_}}}) {
+    ASSERT_LE(lower_bound, estimator.GetPlanCost(plan, 4000, configured_runs));
+    ASSERT_LE(lower_bound, GetEvaluatorCost(plan, 4000, {{"wide.bin", 0.5}}));
+  }
+
+  SchedulingSearchState blocked_state({"a", "b"}, {}, graph_, {}, {}, tables_,
+                                      {"b"}, {}, 0);
+  ASSERT_LT(estimator.GetLowerBound(blocked_state, configured_runs),
+            lower_bound);
+}
+
+}  // namespace
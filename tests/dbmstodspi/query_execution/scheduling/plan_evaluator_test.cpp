@@ -0,0 +1,89 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "plan_evaluator.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace {
+
+using orkhestrafs::dbmstodspi::PlanEvaluator;
+using orkhestrafs::dbmstodspi::ReconfigurationCostModel;
+
+class PlanEvaluatorTest : public ::testing::Test {
+ protected:
+  const std::string resource_string_ = "MMDMDBMMDBMMDMDBMMDBMMDMDBMMDBM";
+  const std::map<char, int> cost_of_columns_ = {
+      {'M', 1000}, {'D', 2000}, {'B', 3000}};
+  const double streaming_speed_ = 4800;
+  const double configuration_speed_ = 66;
+  std::vector<std::vector<ScheduledModule>> narrow_plan_ = {
+      {{"filter", QueryOperationType::kFilter, "narrow.bin", {0, 3}, false}}};
+  std::vector<std::vector<ScheduledModule>> wide_plan_ = {
+      {{"filter", QueryOperationType::kFilter, "wide.bin", {1, 5}, false}}};
+  std::map<std::vector<std::vector<ScheduledModule>>,
+           ExecutionPlanSchedulingData>
+      plans_ = {{narrow_plan_, {{}, {}, 1000}}, {wide_plan_, {{}, {}, 1000}}};
+
+  auto GetBestPlan(const std::map<std::string, double>& measured_costs,
+                   const std::map<std::string, double>& reuse_weights = {},
+                   const std::vector<ScheduledModule>& last_configuration = {},
+                   const std::set<std::string>& pinned_modules = {})
+      -> std::vector<std::vector<ScheduledModule>> {
+    ReconfigurationCostModel cost_model(measured_costs, resource_string_,
+                                        cost_of_columns_, configuration_speed_);
+    PlanEvaluator plan_evaluator;
+    return std::get<0>(plan_evaluator.GetBestPlan(
+        1, last_configuration, resource_string_, 0, 0, 0, plans_,
+        cost_of_columns_, streaming_speed_, cost_model, reuse_weights,
+        pinned_modules));
+  }
+};
+
+TEST_F(PlanEvaluatorTest, FewerColumnsChosenWithoutMeasurements) {
+  ASSERT_EQ(GetBestPlan({}), narrow_plan_);
+}
+
+TEST_F(PlanEvaluatorTest, MeasuredCostsChangeChosenPlan) {
+  ASSERT_EQ(GetBestPlan({{"narrow.bin", 10000}, {"wide.bin", 10}}),
+            wide_plan_);
+}
+
+TEST_F(PlanEvaluatorTest, FrequentlyReusedModuleKeptConfigured) {
+  ASSERT_EQ(GetBestPlan({}, {{"wide.bin", 1.0}}), wide_plan_);
+}
+
+TEST_F(PlanEvaluatorTest, PinnedModuleNotEvicted) {
+  std::map<std::string, double> measured_costs = {{"narrow.bin", 10000},
+                                                  {"wide.bin", 10}};
+  std::vector<ScheduledModule> last_configuration = {
+      {"join", QueryOperationType::kJoin, "join.bin", {4, 6}, false}};
+  ASSERT_EQ(GetBestPlan(measured_costs, {}, last_configuration), wide_plan_);
+  ASSERT_EQ(GetBestPlan(measured_costs, {}, last_configuration, {"join.bin"}),
+            narrow_plan_);
+}
+
+TEST_F(PlanEvaluatorTest, CheapestPlanChosenIfEveryPlanEvictsPinnedModule) {
+  std::map<std::string, double> measured_costs = {{"narrow.bin", 10000},
+                                                  {"wide.bin", 10}};
+  std::vector<ScheduledModule> last_configuration = {
+      {"join", QueryOperationType::kJoin, "join.bin", {2, 3}, false}};
+  ASSERT_EQ(GetBestPlan(measured_costs, {}, last_configuration, {"join.bin"}),
+            wide_plan_);
+}
+
+}  // namespace
@@ -257,4 +257,39 @@ TEST_F(QueryManagerTest, DISABLED_ExecuteAndProcessResultsCallsFPGAManager) {
       output_stream_sizes, result_parameters, execution_query_nodes);*/
 }
 
+TEST_F(QueryManagerTest, ExecuteAndProcessResultsPrefetchesWhileStreaming) {
+  MockFPGAManager mock_fpga_manager;
+  MockMemoryManager mock_memory_manager;
+  MockDataManager mock_data_manager;
+  std::vector<std::string> prefetch_bitstreams = {"join.bin"};
+
+  // The prefetch thread and the wait for the pipelines aren't ordered.
+  testing::Sequence prefetch_sequence;
+  testing::Sequence wait_sequence;
+  EXPECT_CALL(mock_fpga_manager, SetupQueryAcceleration(testing::_))
+      .Times(1)
+      .InSequence(prefetch_sequence, wait_sequence);
+  EXPECT_CALL(mock_fpga_manager, StartQueryAcceleration())
+      .Times(1)
+      .InSequence(prefetch_sequence, wait_sequence);
+  EXPECT_CALL(mock_memory_manager,
+              LoadPartialBitstreamWhileStreaming(prefetch_bitstreams))
+      .Times(1)
+      .InSequence(prefetch_sequence);
+  EXPECT_CALL(mock_fpga_manager, IsQueryAccelerationRunning())
+      .InSequence(wait_sequence)
+      .WillOnce(testing::Return(false));
+
+  std::unordered_map<std::string, MemoryBlockInterface*> table_memory_blocks;
+  std::map<std::string, std::vector<StreamResultParameters>> result_parameters;
+  std::map<std::string, TableMetadata> scheduling_table_data;
+  std::unordered_map<std::string, int> table_counter;
+  QueryManager query_manager_under_test(nullptr);
+  auto run_times = query_manager_under_test.ExecuteAndProcessResults(
+      &mock_memory_manager, &mock_fpga_manager, &mock_data_manager,
+      table_memory_blocks, result_parameters, {}, scheduling_table_data,
+      table_counter, 1, prefetch_bitstreams);
+  ASSERT_EQ(1, run_times.prefetch_times.size());
+}
+
 }  // namespace
\ No newline at end of file
@@ -0,0 +1,75 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "reconfiguration_cost_model.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace {
+
+using orkhestrafs::dbmstodspi::ReconfigurationCostModel;
+
+class ReconfigurationCostModelTest : public ::testing::Test {
+ protected:
+  const std::string resource_string_ = "MMDMDBMMDBMMDMDBMMDBMMDMDBMMDBM";
+  const std::map<char, int> cost_of_columns_ = {
+      {'M', 1000}, {'D', 2000}, {'B', 3000}};
+  const double configuration_speed_ = 10;
+  const std::string reference_bitstream_ = "binPartial_Filter_37_66.bin";
+  const double reference_cost_ = 5567;
+};
+
+TEST_F(ReconfigurationCostModelTest, MeasuredCostsOverrideReferenceCosts) {
+  ReconfigurationCostModel cost_model({{reference_bitstream_, 42}},
+                                      resource_string_, cost_of_columns_,
+                                      configuration_speed_);
+  ASSERT_EQ(cost_model.GetBitstreamCost(reference_bitstream_, "MMD"), 42);
+}
+
+TEST_F(ReconfigurationCostModelTest, ReferenceCostsUsedWithoutProfile) {
+  ReconfigurationCostModel cost_model({}, resource_string_, cost_of_columns_,
+                                      configuration_speed_);
+  ASSERT_EQ(cost_model.GetBitstreamCost(reference_bitstream_, "MMD"),
+            reference_cost_);
+  ASSERT_EQ(cost_model.GetFixedOverhead(), 0);
+}
+
+TEST_F(ReconfigurationCostModelTest, UnknownBitstreamsAreEstimated) {
+  ReconfigurationCostModel cost_model({}, resource_string_, cost_of_columns_,
+                                      configuration_speed_);
+  ASSERT_EQ(cost_model.GetBitstreamCost("unknown.bin", "MMDB"), 700);
+}
+
+TEST_F(ReconfigurationCostModelTest, RoutingCostsArePerColumn) {
+  ReconfigurationCostModel cost_model(
+      {{"RT_95.bin", 10},
+       {"RT_92.bin", 20},
+       {"TAA_92.bin", 30},
+       {ReconfigurationCostModel::kFixedOverheadKey, 5}},
+      resource_string_, cost_of_columns_, configuration_speed_);
+  ASSERT_EQ(ReconfigurationCostModel::GetRoutingBitstreamName(1), "RT_92.bin");
+  ASSERT_EQ(ReconfigurationCostModel::GetTurnaroundBitstreamName(30),
+            "TAA_5.bin");
+  ASSERT_EQ(cost_model.GetRoutingCost(0), 10);
+  ASSERT_EQ(cost_model.GetRoutingCost(1), 20);
+  ASSERT_EQ(cost_model.GetTurnaroundCost(1), 30);
+  // Unmeasured turnarounds cost as much as the routing in the same column.
+  ASSERT_EQ(cost_model.GetTurnaroundCost(0), 10);
+  ASSERT_EQ(cost_model.GetFixedOverhead(), 5);
+}
+
+}  // namespace
@@ -0,0 +1,142 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "reconfiguration_planner.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "mock_accelerator_library.hpp"
+#include "mock_dma.hpp"
+#include "mock_memory_manager.hpp"
+#include "query_manager.hpp"
+
+namespace {
+
+using orkhestrafs::dbmstodspi::QueryManager;
+using orkhestrafs::dbmstodspi::ReconfigurationPlanner;
+
+class ReconfigurationPlannerTest : public ::testing::Test {
+ protected:
+  const int column_count_ = 31;
+  ScheduledModule filter_ = {
+      "filter", QueryOperationType::kFilter, "filter.bin", {1, 1}, false};
+  ScheduledModule join_ = {
+      "join", QueryOperationType::kJoin, "join.bin", {0, 2}, false};
+};
+
+TEST_F(ReconfigurationPlannerTest, UnchangedRoutingIsSkipped) {
+  ReconfigurationPlanner planner(column_count_, {});
+  planner.Reset();
+  std::vector<std::string> expected_sequence = {"filter.bin", "TAA_89.bin"};
+  ASSERT_EQ(planner.GetMinimalLoadSequence(
+                {"filter.bin", "RT_95.bin", "TAA_89.bin"}, {filter_}),
+            expected_sequence);
+  ASSERT_EQ(planner.GetSkippedLoadCount(), 1);
+}
+
+TEST_F(ReconfigurationPlannerTest, ConfiguredModulesAreSkipped) {
+  ReconfigurationPlanner planner(column_count_, {});
+  planner.Reset();
+  planner.GetMinimalLoadSequence({"join.bin", "TAA_86.bin"}, {join_});
+  ASSERT_TRUE(
+      planner.GetMinimalLoadSequence({"join.bin", "TAA_86.bin"}, {join_})
+          .empty());
+
+  // Partially overwritten modules have to be loaded again.
+  planner.GetMinimalLoadSequence({"filter.bin"}, {filter_});
+  std::vector<std::string> expected_sequence = {"join.bin"};
+  ASSERT_EQ(planner.GetMinimalLoadSequence({"join.bin"}, {join_}),
+            expected_sequence);
+}
+
+TEST_F(ReconfigurationPlannerTest, AdjacentRoutingColumnsAreMerged) {
+  ReconfigurationPlanner planner(column_count_, {"RT_89_95.bin"});
+  planner.Reset();
+  planner.GetMinimalLoadSequence({"join.bin"}, {join_});
+  ScheduledModule sort = {
+      "sort", QueryOperationType::kMergeSort, "sort.bin", {3, 4}, false};
+  std::vector<std::string> expected_sequence = {"sort.bin", "RT_89_95.bin",
+                                                "TAA_80.bin"};
+  ASSERT_EQ(planner.GetMinimalLoadSequence(
+                {"sort.bin", "RT_95.bin", "RT_92.bin", "RT_89.bin",
+                 "TAA_80.bin"},
+                {sort}),
+            expected_sequence);
+}
+
+TEST_F(ReconfigurationPlannerTest, InvalidatedColumnsAreReloaded) {
+  ReconfigurationPlanner planner(column_count_, {});
+  planner.Reset();
+  planner.GetMinimalLoadSequence({"join.bin", "RT_86.bin"}, {join_});
+  planner.InvalidateColumns({2, 2});
+  std::vector<std::string> expected_sequence = {"join.bin"};
+  ASSERT_EQ(planner.GetMinimalLoadSequence({"join.bin", "RT_86.bin"}, {join_}),
+            expected_sequence);
+}
+
+TEST_F(ReconfigurationPlannerTest, BitstreamColumnsAreFound) {
+  ReconfigurationPlanner planner(column_count_, {"RT_89_95.bin"});
+  ASSERT_EQ(planner.GetBitstreamColumns("RT_89_95.bin", {}),
+            std::make_pair(0, 2));
+  ASSERT_EQ(planner.GetBitstreamColumns("TAA_89.bin", {}),
+            std::make_pair(2, 2));
+  ASSERT_EQ(planner.GetBitstreamColumns("filter.bin", {filter_}),
+            std::make_pair(1, 1));
+  ASSERT_EQ(planner.GetBitstreamColumns("filter.bin", {}),
+            std::make_pair(-1, -1));
+}
+
+TEST_F(ReconfigurationPlannerTest, UnknownBitstreamsInvalidateColumns) {
+  ReconfigurationPlanner planner(column_count_, {});
+  planner.Reset();
+  planner.GetMinimalLoadSequence({"binPartial_Static1_0_96.bin"}, {});
+  std::vector<std::string> expected_sequence = {"RT_95.bin"};
+  ASSERT_EQ(planner.GetMinimalLoadSequence({"RT_95.bin"}, {}),
+            expected_sequence);
+}
+
+TEST_F(ReconfigurationPlannerTest, LoadSequenceRecordedByMemoryManager) {
+  MockMemoryManager mock_memory_manager;
+  MockAcceleratorLibrary mock_accelerator_library;
+  std::vector<std::vector<std::string>> recorded_loads;
+  EXPECT_CALL(mock_accelerator_library, GetDMAModule())
+      .WillRepeatedly(
+          testing::Invoke([]() { return std::make_unique<MockDMA>(); }));
+  EXPECT_CALL(mock_memory_manager, LoadPartialBitstream(testing::_, testing::_))
+      .WillRepeatedly(testing::Invoke(
+          [&](const std::vector<std::string>& bitstreams, DMAInterface&) {
+            recorded_loads.push_back(bitstreams);
+          }));
+
+  ReconfigurationPlanner planner(column_count_, {});
+  planner.Reset();
+  QueryManager query_manager(nullptr);
+  for (int transition_i = 0; transition_i < 2; transition_i++) {
+    query_manager.LoadPRBitstreams(
+        &mock_memory_manager,
+        planner.GetMinimalLoadSequence(
+            {"filter.bin", "RT_95.bin", "TAA_89.bin"}, {filter_}),
+        mock_accelerator_library);
+  }
+
+  std::vector<std::vector<std::string>> expected_loads = {
+      {"filter.bin", "TAA_89.bin"}};
+  ASSERT_EQ(recorded_loads, expected_loads);
+}
+
+}  // namespace
@@ -0,0 +1,128 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "reconfiguration_timeline.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using orkhestrafs::dbmstodspi::LoadCause;
+using orkhestrafs::dbmstodspi::ReconfigurationTimeline;
+
+class ReconfigurationTimelineTest : public ::testing::Test {
+ protected:
+  const int column_count_ = 4;
+  ScheduledModule filter_ = {
+      "filter", QueryOperationType::kFilter, "filter.bin", {1, 1}, false};
+  ScheduledModule join_ = {
+      "join", QueryOperationType::kJoin, "join.bin", {2, 3}, false};
+  ScheduledModule sort_ = {
+      "sort", QueryOperationType::kMergeSort, "sort.bin", {2, 3}, false};
+
+  // The join is overwritten by the sort before any run uses it.
+  void RecordSession(ReconfigurationTimeline& timeline) {
+    timeline.RecordLoad("static", {0, 3}, LoadCause::kStatic, 0, 10);
+    timeline.RecordLoad("filter.bin", {1, 1}, LoadCause::kRun, 10, 5);
+    timeline.RecordLoad("join.bin", {2, 3}, LoadCause::kRun, 15, 5);
+    timeline.RecordRun({filter_}, 20, 20);
+    timeline.RecordLoad("sort.bin", {2, 3}, LoadCause::kRun, 40, 10);
+    timeline.RecordRun({sort_}, 50, 50);
+  }
+};
+
+TEST_F(ReconfigurationTimelineTest, OverwrittenUnusedLoadsAreWasted) {
+  ReconfigurationTimeline timeline(column_count_);
+  RecordSession(timeline);
+  const auto& loads = timeline.GetLoads();
+  ASSERT_EQ(loads.size(), 4);
+  EXPECT_FALSE(loads.at(0).is_wasted);
+  EXPECT_FALSE(loads.at(1).is_wasted);
+  EXPECT_TRUE(loads.at(1).is_used);
+  EXPECT_TRUE(loads.at(2).is_wasted);
+  EXPECT_FALSE(loads.at(3).is_wasted);
+  EXPECT_EQ(loads.at(3).run_index, 1);
+
+  // Unknown footprints reconfigure every column.
+  timeline.RecordLoad("unknown.bin", {-1, -1}, LoadCause::kManual, 100, 1);
+  EXPECT_FALSE(timeline.GetLoads().at(3).is_wasted);
+  timeline.RecordLoad("filter.bin", {1, 1}, LoadCause::kManual, 101, 1);
+  EXPECT_TRUE(timeline.GetLoads().at(4).is_wasted);
+}
+
+TEST_F(ReconfigurationTimelineTest, SummaryMetricsAreDerived) {
+  ReconfigurationTimeline timeline(column_count_);
+  RecordSession(timeline);
+  auto summary = timeline.GetSummary();
+  EXPECT_EQ(summary.total_time, 100);
+  EXPECT_EQ(summary.reconfiguration_time, 30);
+  EXPECT_EQ(summary.execution_time, 70);
+  EXPECT_DOUBLE_EQ(summary.reconfiguration_overhead, 0.3);
+  EXPECT_EQ(summary.load_count, 4);
+  EXPECT_EQ(summary.wasted_load_count, 1);
+  EXPECT_DOUBLE_EQ(summary.wasted_reload_ratio, 1.0 / 3);
+  std::vector<double> expected_utilisation = {0, 0.2, 0.5, 0.5};
+  EXPECT_EQ(summary.column_utilisation, expected_utilisation);
+  // The first column is passed through by the runs.
+  std::vector<long> expected_idle_time = {20, 15, 25, 25};
+  EXPECT_EQ(summary.column_idle_time, expected_idle_time);
+
+  auto idle_gaps = timeline.GetIdleGaps();
+  ASSERT_EQ(idle_gaps.size(), 8);
+  EXPECT_EQ(idle_gaps.at(0).column, 0);
+  EXPECT_EQ(idle_gaps.at(0).start_time, 10);
+  EXPECT_EQ(idle_gaps.at(0).duration, 10);
+}
+
+TEST_F(ReconfigurationTimelineTest, TimelineIsWrittenPerColumn) {
+  ReconfigurationTimeline timeline(column_count_);
+  RecordSession(timeline);
+  const std::string filename = "reconfiguration_timeline_test.csv";
+  timeline.WriteCSV(filename);
+
+  std::ifstream input_file(filename);
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(input_file, line)) {
+    lines.push_back(line);
+  }
+  input_file.close();
+  std::remove(filename.c_str());
+
+  ASSERT_FALSE(lines.empty());
+  EXPECT_EQ(lines.front(),
+            "column,start_us,type,duration_us,label,cause,run,wasted");
+  EXPECT_THAT(lines, testing::Contains("2,15,load,5,join.bin,run,0,true"));
+  EXPECT_THAT(lines, testing::Contains("0,20,passthrough,20,passthrough,,0,"));
+  EXPECT_THAT(lines, testing::Contains("1,20,module,20,filter,,0,"));
+  EXPECT_THAT(lines, testing::Contains("3,10,idle,5,,,,"));
+}
+
+TEST_F(ReconfigurationTimelineTest, SummaryWriteFailureThrows) {
+  ReconfigurationTimeline timeline(column_count_);
+  RecordSession(timeline);
+  // Opening succeeds but every write fails.
+  EXPECT_THROW(timeline.WriteSummaryJSON("/dev/full"), std::runtime_error);
+}
+
+}  // namespace
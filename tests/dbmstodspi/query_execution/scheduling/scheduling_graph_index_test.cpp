@@ -0,0 +1,97 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "scheduling_graph_index.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+using orkhestrafs::dbmstodspi::SchedulingGraphIndex;
+
+class SchedulingGraphIndexTest : public ::testing::Test {
+ protected:
+  // b -> c <- a and a processed node which isn't in the graph anymore.
+  SchedulingGraphIndex index_{
+      {{"c", {QueryOperationType::kJoin, {}, {{"b", 0}, {"a", 1}}, {""},
+              {"", ""}, {}, nullptr}},
+       {"b", {QueryOperationType::kFilter, {}, {}, {"c"}, {"table_b"}, {},
+              nullptr}},
+       {"a", {QueryOperationType::kFilter, {}, {}, {"c"}, {"table_a"}, {},
+              nullptr}}},
+      {"processed"},
+      {{"table_c", {1, 10, {}}}}};
+};
+
+TEST_F(SchedulingGraphIndexTest, NodesAreIndexedInNameOrder) {
+  ASSERT_EQ(index_.GetNodeCount(), 4);
+  ASSERT_EQ(index_.GetNodeName(0), "a");
+  ASSERT_EQ(index_.GetNodeName(1), "b");
+  ASSERT_EQ(index_.GetNodeName(2), "c");
+  ASSERT_EQ(index_.GetNodeId("processed"), 3);
+  ASSERT_THROW(index_.GetNodeId("missing"), std::runtime_error);
+}
+
+TEST_F(SchedulingGraphIndexTest, TablesAreIndexedInNameOrder) {
+  ASSERT_EQ(index_.GetTableCount(), 3);
+  ASSERT_EQ(index_.GetTableName(0), "table_a");
+  ASSERT_EQ(index_.GetTableId("table_c"), 2);
+  ASSERT_NE(index_.GetTableKey(0), index_.GetTableKey(1));
+  ASSERT_THROW(index_.GetTableId(""), std::runtime_error);
+}
+
+TEST_F(SchedulingGraphIndexTest, EdgesUseNodeIds) {
+  ASSERT_EQ(index_.GetBeforeNodeIds(index_.GetNodeId("c")),
+            std::vector<int>({1, 0}));
+  ASSERT_TRUE(index_.GetAfterNodeIds(index_.GetNodeId("c")).empty());
+  ASSERT_EQ(index_.GetAfterNodeIds(index_.GetNodeId("a")),
+            std::vector<int>({2}));
+}
+
+TEST_F(SchedulingGraphIndexTest, NodeSetsMatchNodeNames) {
+  auto nodes = index_.CreateSet({"c", "a"});
+  ASSERT_EQ(SchedulingGraphIndex::GetNodeIds(nodes), std::vector<int>({0, 2}));
+  ASSERT_EQ(index_.GetNodeNames(nodes),
+            std::unordered_set<std::string>({"a", "c"}));
+  ASSERT_FALSE(SchedulingGraphIndex::AddToSet(nodes, 0));
+  ASSERT_TRUE(SchedulingGraphIndex::AddToSet(nodes, 3));
+  ASSERT_TRUE(SchedulingGraphIndex::IsInSet(nodes, 3));
+  ASSERT_TRUE(SchedulingGraphIndex::RemoveFromSet(nodes, 2));
+  ASSERT_FALSE(SchedulingGraphIndex::RemoveFromSet(nodes, 2));
+  ASSERT_EQ(index_.GetNodeNames(nodes),
+            std::unordered_set<std::string>({"a", "processed"}));
+}
+
+TEST_F(SchedulingGraphIndexTest, SubsetsAreFound) {
+  auto empty_set = index_.CreateEmptySet();
+  auto nodes = index_.CreateSet({"a", "b"});
+  ASSERT_TRUE(SchedulingGraphIndex::IsEmpty(empty_set));
+  ASSERT_FALSE(SchedulingGraphIndex::IsEmpty(nodes));
+  ASSERT_TRUE(SchedulingGraphIndex::IsSubsetOf(empty_set, nodes));
+  ASSERT_TRUE(
+      SchedulingGraphIndex::IsSubsetOf(index_.CreateSet({"b"}), nodes));
+  ASSERT_FALSE(
+      SchedulingGraphIndex::IsSubsetOf(index_.CreateSet({"b", "c"}), nodes));
+}
+
+}  // namespace
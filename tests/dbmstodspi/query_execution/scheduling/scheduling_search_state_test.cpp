@@ -0,0 +1,178 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "scheduling_search_state.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <string>
+#include <unordered_set>
+
+namespace {
+
+using orkhestrafs::dbmstodspi::SchedulingQueryNode;
+using orkhestrafs::dbmstodspi::SchedulingSearchState;
+using NodeSet = SchedulingSearchState::NodeSet;
+
+class SchedulingSearchStateTest : public ::testing::Test {
+ protected:
+  SchedulingSearchState state_{
+      {"a"},
+      {},
+      {{"a", {QueryOperationType::kFilter, {4}, {}, {"b"}, {"table_a"}, {},
+              nullptr}},
+       {"b", {QueryOperationType::kAggregationSum, {1}, {{"a", 0}}, {""},
+              {"table_b"}, {}, nullptr}}},
+      {},
+      {},
+      {{"table_a", {1, 100, {}}}, {"table_b", {1, 100, {}}}},
+      {},
+      {"b"},
+      0};
+  ScheduledModule placed_module_ = {"a", QueryOperationType::kFilter,
+                                    "filter_0", {0, 1}, false};
+  int node_a_ = state_.GetGraphIndex().GetNodeId("a");
+  int node_b_ = state_.GetGraphIndex().GetNodeId("b");
+};
+
+TEST_F(SchedulingSearchStateTest, RollbackRestoresLoggedChanges) {
+  auto checkpoint = state_.GetCheckpoint();
+  state_.AddStreamedDataSize(400);
+  state_.InsertModule(0, placed_module_);
+  state_.SaveNode(node_a_);
+  state_.GetNode(node_a_).capacity = {2};
+  state_.SetTable(state_.GetGraphIndex().GetTableId("table_a"),
+                  TableMetadata{1, 50, {}});
+  state_.EraseNodeName(NodeSet::kAvailable, "a");
+  state_.InsertNodeName(NodeSet::kProcessed, "a");
+  state_.RemoveNodeFromGraph(node_a_);
+  state_.FinishRun();
+
+  ASSERT_EQ(state_.GetStreamedDataSize(), 400);
+  ASSERT_TRUE(state_.GetCurrentRun().empty());
+  ASSERT_EQ(state_.GetCurrentPlan().size(), 1);
+  ASSERT_FALSE(state_.HasNode(node_a_));
+  ASSERT_EQ(state_.GetNodeNames(NodeSet::kBlocked),
+            std::unordered_set<std::string>({"b"}));
+  ASSERT_TRUE(state_.GetNodeNames(NodeSet::kNextRunBlocked).empty());
+
+  state_.Rollback(checkpoint);
+  ASSERT_EQ(state_.GetStreamedDataSize(), 0);
+  ASSERT_TRUE(state_.GetCurrentRun().empty());
+  ASSERT_TRUE(state_.GetCurrentPlan().empty());
+  ASSERT_EQ(state_.GetNode(node_a_).capacity, std::vector<int>({4}));
+  ASSERT_EQ(state_.GetDataTables().at("table_a").record_count, 100);
+  ASSERT_EQ(state_.GetNodeNames(NodeSet::kAvailable),
+            std::unordered_set<std::string>({"a"}));
+  ASSERT_TRUE(state_.GetNodeNames(NodeSet::kProcessed).empty());
+  ASSERT_TRUE(state_.GetNodeNames(NodeSet::kBlocked).empty());
+  ASSERT_EQ(state_.GetNodeNames(NodeSet::kNextRunBlocked),
+            std::unordered_set<std::string>({"b"}));
+}
+
+TEST_F(SchedulingSearchStateTest, RollbackStopsAtCheckpoint) {
+  state_.InsertModule(0, placed_module_);
+  auto checkpoint = state_.GetCheckpoint();
+  state_.FinishRun();
+  state_.RemoveNodeFromGraph(node_b_);
+  state_.SetTable(state_.GetGraphIndex().GetTableId("table_b"), std::nullopt);
+  state_.InsertNodeName(NodeSet::kProcessed, "b");
+
+  state_.Rollback(checkpoint);
+  ASSERT_EQ(state_.GetCurrentRun(),
+            std::vector<ScheduledModule>({placed_module_}));
+  ASSERT_TRUE(state_.HasNode(node_b_));
+  ASSERT_EQ(state_.GetDataTables().count("table_b"), 1);
+  ASSERT_TRUE(state_.GetNodeNames(NodeSet::kProcessed).empty());
+}
+
+TEST_F(SchedulingSearchStateTest, CopyHasNoChangesToRollBack) {
+  state_.InsertModule(0, placed_module_);
+  SchedulingSearchState branch_state(state_);
+  branch_state.Rollback(0);
+  ASSERT_EQ(branch_state.GetCurrentRun().size(), 1);
+  ASSERT_EQ(branch_state.GetCheckpoint(), 0);
+}
+
+TEST_F(SchedulingSearchStateTest, RollbackRestoresHash) {
+  auto initial_hash = state_.GetHash();
+  auto checkpoint = state_.GetCheckpoint();
+  state_.InsertModule(0, placed_module_);
+  state_.SaveNode(node_a_);
+  state_.GetNode(node_a_).capacity = {2};
+  state_.SetTable(state_.GetGraphIndex().GetTableId("table_b"),
+                  TableMetadata{1, 10, {}});
+  state_.InsertNodeName(NodeSet::kProcessed, "a");
+  state_.EraseNodeName(NodeSet::kAvailable, "a");
+  auto changed_hash = state_.GetHash();
+  state_.FinishRun();
+  ASSERT_NE(state_.GetHash(), changed_hash);
+  ASSERT_NE(changed_hash, initial_hash);
+
+  state_.Rollback(checkpoint);
+  ASSERT_EQ(state_.GetHash(), initial_hash);
+}
+
+TEST_F(SchedulingSearchStateTest, EqualStatesHaveEqualHashes) {
+  SchedulingSearchState other_state(state_);
+  ASSERT_EQ(other_state.GetHash(), state_.GetHash());
+
+  state_.InsertNodeName(NodeSet::kProcessed, "a");
+  state_.SaveNode(node_b_);
+  state_.GetNode(node_b_).capacity = {0};
+  other_state.SaveNode(node_b_);
+  other_state.GetNode(node_b_).capacity = {0};
+  other_state.InsertNodeName(NodeSet::kProcessed, "a");
+  ASSERT_EQ(other_state.GetHash(), state_.GetHash());
+  // The hash is kept up to date and not recalculated for copies.
+  ASSERT_EQ(SchedulingSearchState(state_).GetHash(), state_.GetHash());
+}
+
+TEST_F(SchedulingSearchStateTest, SavingValuesAgainKeepsHash) {
+  auto initial_hash = state_.GetHash();
+  state_.SaveNode(node_a_);
+  state_.GetNode(node_a_).capacity = {2};
+  state_.SaveNode(node_a_);
+  state_.GetNode(node_a_).capacity = {3};
+  state_.SetTable(state_.GetGraphIndex().GetTableId("table_b"),
+                  TableMetadata{1, 10, {}});
+  state_.SetTable(state_.GetGraphIndex().GetTableId("table_b"),
+                  TableMetadata{1, 20, {}});
+  ASSERT_EQ(SchedulingSearchState(state_).GetHash(), state_.GetHash());
+
+  state_.Rollback(0);
+  ASSERT_EQ(state_.GetHash(), initial_hash);
+}
+
+TEST_F(SchedulingSearchStateTest, SetGraphChangesDifferentNodes) {
+  auto initial_hash = state_.GetHash();
+  auto graph = state_.GetGraph();
+  graph.at("b").capacity = {0};
+  graph.erase("a");
+  state_.SetGraph(graph);
+  ASSERT_FALSE(state_.HasNode(node_a_));
+  ASSERT_EQ(state_.GetNode(node_b_).capacity, std::vector<int>({0}));
+  ASSERT_EQ(SchedulingSearchState(state_).GetHash(), state_.GetHash());
+
+  state_.Rollback(0);
+  ASSERT_EQ(state_.GetGraph().size(), 2);
+  ASSERT_EQ(state_.GetHash(), initial_hash);
+}
+
+}  // namespace
@@ -0,0 +1,131 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "speculative_configurator.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "query_manager.hpp"
+
+namespace {
+
+using orkhestrafs::dbmstodspi::QueryManager;
+using orkhestrafs::dbmstodspi::SpeculativeConfigurator;
+
+class SpeculativeConfiguratorTest : public ::testing::Test {
+ protected:
+  const int column_count_ = 31;
+  std::vector<std::string> current_routing_ =
+      std::vector<std::string>(column_count_, "");
+  std::vector<ScheduledModule> current_configuration_;
+  ScheduledModule filter_module_ = {
+      "filter", QueryOperationType::kFilter, "filter.bin", {0, 3}, false};
+  ScheduledModule join_module_ = {
+      "join", QueryOperationType::kJoin, "join.bin", {6, 9}, false};
+  QueryManager query_manager_ = QueryManager(nullptr);
+
+  void ConfigureFirstRun() {
+    query_manager_.GetPRBitstreamsToLoadWithPassthroughModules(
+        current_configuration_, {filter_module_}, current_routing_);
+  }
+};
+
+TEST_F(SpeculativeConfiguratorTest, ModulesAfterTurnaroundArePrefetched) {
+  ConfigureFirstRun();
+  auto prefetched_modules = SpeculativeConfigurator::GetPrefetchableModules(
+      current_configuration_, {filter_module_, join_module_},
+      current_routing_);
+  ASSERT_EQ(prefetched_modules, std::vector<ScheduledModule>{join_module_});
+}
+
+TEST_F(SpeculativeConfiguratorTest, ModulesInDataPathAreNotPrefetched) {
+  ConfigureFirstRun();
+  // Column 4 holds the turnaround of the running query.
+  ScheduledModule overlapping_module = {
+      "join", QueryOperationType::kJoin, "join_4.bin", {4, 7}, false};
+  ASSERT_TRUE(SpeculativeConfigurator::GetPrefetchableModules(
+                  current_configuration_, {overlapping_module},
+                  current_routing_)
+                  .empty());
+}
+
+TEST_F(SpeculativeConfiguratorTest, NothingIsPrefetchedWithoutTurnaround) {
+  current_routing_ = std::vector<std::string>(column_count_, "RT");
+  ASSERT_TRUE(SpeculativeConfigurator::GetPrefetchableModules(
+                  current_configuration_, {join_module_}, current_routing_)
+                  .empty());
+}
+
+TEST_F(SpeculativeConfiguratorTest, IdleColumnsStartAfterTurnaround) {
+  ConfigureFirstRun();
+  ASSERT_EQ(SpeculativeConfigurator::GetFirstIdleColumn(current_routing_), 5);
+  current_routing_ = std::vector<std::string>(column_count_, "RT");
+  ASSERT_EQ(SpeculativeConfigurator::GetFirstIdleColumn(current_routing_),
+            column_count_);
+}
+
+TEST_F(SpeculativeConfiguratorTest, PrefetchedModulesAreNotLoadedAgain) {
+  ConfigureFirstRun();
+  std::vector<ScheduledModule> next_run = {filter_module_, join_module_};
+  auto prefetch_bitstreams = SpeculativeConfigurator::ReserveModules(
+      current_configuration_,
+      SpeculativeConfigurator::GetPrefetchableModules(
+          current_configuration_, next_run, current_routing_),
+      current_routing_);
+  ASSERT_EQ(prefetch_bitstreams, std::vector<std::string>{"join.bin"});
+
+  auto [bitstreams_to_load, passthrough_modules] =
+      query_manager_.GetPRBitstreamsToLoadWithPassthroughModules(
+          current_configuration_, next_run, current_routing_);
+
+  ASSERT_EQ(std::count(bitstreams_to_load.begin(), bitstreams_to_load.end(),
+                       "join.bin"),
+            0);
+  ASSERT_EQ(std::count(bitstreams_to_load.begin(), bitstreams_to_load.end(),
+                       "filter.bin"),
+            0);
+  std::vector<std::pair<QueryOperationType, bool>> expected_modules = {
+      {QueryOperationType::kFilter, false}, {QueryOperationType::kJoin, false}};
+  ASSERT_EQ(passthrough_modules, expected_modules);
+}
+
+TEST_F(SpeculativeConfiguratorTest, OverwrittenIdleModulesAreRemoved) {
+  ConfigureFirstRun();
+  ScheduledModule idle_module = {
+      "sum", QueryOperationType::kAggregationSum, "sum.bin", {8, 12}, false};
+  current_configuration_.push_back(idle_module);
+  for (int column_i = 8; column_i < 13; column_i++) {
+    current_routing_[column_i] = "sum.bin";
+  }
+
+  SpeculativeConfigurator::ReserveModules(current_configuration_,
+                                          {join_module_}, current_routing_);
+
+  ASSERT_EQ(std::count(current_configuration_.begin(),
+                       current_configuration_.end(), idle_module),
+            0);
+  for (int column_i = 6; column_i < 10; column_i++) {
+    ASSERT_EQ(current_routing_[column_i], "join.bin");
+  }
+  for (int column_i = 10; column_i < 13; column_i++) {
+    ASSERT_EQ(current_routing_[column_i], "");
+  }
+}
+
+}  // namespace
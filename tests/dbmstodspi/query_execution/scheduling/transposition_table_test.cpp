@@ -0,0 +1,71 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "transposition_table.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+using orkhestrafs::dbmstodspi::TranspositionTable;
+using Entry = TranspositionTable::Entry;
+using FoundPlan = TranspositionTable::FoundPlan;
+
+auto CreateEntry(int plan_count) -> Entry {
+  Entry entry = {0, 0, 0, {}};
+  for (int plan_index = 0; plan_index < plan_count; plan_index++) {
+    entry.found_plans.push_back(std::make_shared<const FoundPlan>(
+        FoundPlan{{}, {{}, {}, plan_index * 10}, {}}));
+  }
+  return entry;
+}
+
+TEST(TranspositionTableTest, StoredStatesAreFound) {
+  TranspositionTable table(4);
+  ASSERT_EQ(table.Find(1), nullptr);
+  table.Insert(1, CreateEntry(2));
+
+  const auto* entry = table.Find(1);
+  ASSERT_NE(entry, nullptr);
+  ASSERT_EQ(entry->found_plans.size(), 2);
+  ASSERT_EQ(entry->found_plans.at(1)->scheduling_data.streamed_data_size, 10);
+  ASSERT_EQ(table.GetRemainingCapacity(), 2);
+
+  auto statistics = table.GetStatistics();
+  ASSERT_EQ(statistics.lookups, 2);
+  ASSERT_EQ(statistics.hits, 1);
+  ASSERT_EQ(statistics.stored_states, 1);
+}
+
+TEST(TranspositionTableTest, StatesOverCapacityAreRejected) {
+  TranspositionTable table(2);
+  table.Insert(1, CreateEntry(3));
+  ASSERT_EQ(table.Find(1), nullptr);
+  ASSERT_EQ(table.GetStatistics().rejected_states, 1);
+  table.Insert(2, CreateEntry(2));
+  ASSERT_EQ(table.GetRemainingCapacity(), 0);
+
+  table.Clear();
+  ASSERT_EQ(table.GetRemainingCapacity(), 2);
+  ASSERT_EQ(table.Find(2), nullptr);
+}
+
+}  // namespace
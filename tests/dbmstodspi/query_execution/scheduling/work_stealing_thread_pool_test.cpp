@@ -0,0 +1,59 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "work_stealing_thread_pool.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+
+namespace {
+
+using orkhestrafs::dbmstodspi::WorkStealingThreadPool;
+
+TEST(WorkStealingThreadPoolTest, NestedTasksAreAllExecuted) {
+  WorkStealingThreadPool thread_pool(4);
+  std::atomic<int> executed_tasks = 0;
+  std::function<void(int)> spawn_tasks = [&](int depth) {
+    executed_tasks++;
+    ASSERT_GE(WorkStealingThreadPool::GetWorkerIndex(), 0);
+    if (depth < 8) {
+      thread_pool.Submit([&, depth] { spawn_tasks(depth + 1); });
+      thread_pool.Submit([&, depth] { spawn_tasks(depth + 1); });
+    }
+  };
+  thread_pool.Submit([&] { spawn_tasks(0); });
+  thread_pool.WaitForAll();
+  ASSERT_EQ(executed_tasks, 511);
+  ASSERT_EQ(WorkStealingThreadPool::GetWorkerIndex(), -1);
+}
+
+TEST(WorkStealingThreadPoolTest, FirstExceptionIsRethrown) {
+  WorkStealingThreadPool thread_pool(2);
+  thread_pool.Submit([] { throw std::runtime_error("Task failed"); });
+  ASSERT_THROW(thread_pool.WaitForAll(), std::runtime_error);
+
+  std::atomic<int> executed_tasks = 0;
+  thread_pool.Submit([&] { executed_tasks++; });
+  thread_pool.WaitForAll();
+  ASSERT_EQ(executed_tasks, 1);
+}
+
+}  // namespace
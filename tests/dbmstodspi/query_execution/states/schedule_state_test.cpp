@@ -36,6 +36,7 @@ class ScheduleStateTest : public ::testing::Test {
 TEST_F(ScheduleStateTest, ExecuteStopsFSM) {
   EXPECT_CALL(mock_fsm_, IsUnscheduledNodesGraphEmpty())
       .WillOnce(testing::Return(true));
+  EXPECT_CALL(mock_fsm_, FinishQuery()).Times(1);
   EXPECT_CALL(mock_fsm_, SetFinishedFlag()).Times(1);
   EXPECT_CALL(mock_fsm_, ScheduleUnscheduledNodes()).Times(0);
 
@@ -46,6 +47,7 @@ TEST_F(ScheduleStateTest, ExecuteStopsFSM) {
 TEST_F(ScheduleStateTest, ExecuteSetupsNodes) {
   EXPECT_CALL(mock_fsm_, IsUnscheduledNodesGraphEmpty())
       .WillOnce(testing::Return(false));
+  EXPECT_CALL(mock_fsm_, FinishQuery()).Times(0);
   EXPECT_CALL(mock_fsm_, SetFinishedFlag()).Times(0);
   EXPECT_CALL(mock_fsm_, ScheduleUnscheduledNodes()).Times(1);
 
@@ -0,0 +1,87 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "bitstream_compressor.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace {
+
+using orkhestrafs::dbmstodspi::BitstreamCompressor;
+
+auto ReadBitstream(const std::string& filename) -> std::string {
+  std::ifstream input_file(filename, std::ios::binary);
+  return {std::istreambuf_iterator<char>(input_file),
+          std::istreambuf_iterator<char>()};
+}
+
+auto CompressAndDecompress(const std::string& data, std::string& compressed)
+    -> std::string {
+  std::istringstream input(data);
+  std::ostringstream compressed_output;
+  auto compressed_size =
+      BitstreamCompressor::Compress(input, data.size(), compressed_output);
+  EXPECT_EQ(compressed_size, compressed_output.str().size());
+  compressed = compressed_output.str();
+  std::istringstream compressed_input(compressed);
+  std::ostringstream output;
+  EXPECT_EQ(BitstreamCompressor::Decompress(compressed_input, output),
+            data.size());
+  return output.str();
+}
+
+TEST(BitstreamCompressorTest, PartialBitstreamIsRestored) {
+  auto bitstream = ReadBitstream("binPartial_Filter_7_36.bin");
+  ASSERT_FALSE(bitstream.empty());
+  std::string compressed;
+  ASSERT_EQ(CompressAndDecompress(bitstream, compressed), bitstream);
+  // Empty frames make up most of the bitstream.
+  ASSERT_LT(compressed.size(), bitstream.size() / 2);
+}
+
+TEST(BitstreamCompressorTest, RunsAndLiteralsAreRestored) {
+  std::string data(100, '\0');
+  data += "literal data";
+  data += std::string(64, '\x55');
+  // Size isn't a multiple of the word size.
+  data += "end";
+  std::string compressed;
+  ASSERT_EQ(CompressAndDecompress(data, compressed), data);
+  ASSERT_LT(compressed.size(), data.size());
+  ASSERT_EQ(CompressAndDecompress("", compressed), "");
+}
+
+TEST(BitstreamCompressorTest, InvalidDataThrows) {
+  std::ostringstream output;
+  std::istringstream raw_input(ReadBitstream("binPartial_Filter_7_36.bin"));
+  ASSERT_THROW(BitstreamCompressor::Decompress(raw_input, output),
+               std::runtime_error);
+
+  std::string compressed;
+  CompressAndDecompress(std::string(100, '\0') + "literal data", compressed);
+  std::istringstream truncated_input(
+      compressed.substr(0, compressed.size() - 4));
+  ASSERT_THROW(BitstreamCompressor::Decompress(truncated_input, output),
+               std::runtime_error);
+}
+
+}  // namespace
@@ -0,0 +1,120 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "bitstream_relocator.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+using orkhestrafs::core_interfaces::hw_library::PRModuleData;
+using orkhestrafs::dbmstodspi::BitstreamRelocator;
+
+auto ReadBitstream(const std::string& filename) -> std::vector<char> {
+  std::ifstream input_file(filename, std::ios::binary);
+  return {std::istreambuf_iterator<char>(input_file),
+          std::istreambuf_iterator<char>()};
+}
+
+TEST(BitstreamRelocatorTest, RelocatedFilterMatchesPrebuiltBitstream) {
+  auto source = ReadBitstream("binPartial_Filter_7_36.bin");
+  auto expected = ReadBitstream("binPartial_Filter_37_66.bin");
+  ASSERT_FALSE(source.empty());
+  ASSERT_NE(source, expected);
+
+  // Templates starting or ending at the same column as the target location.
+  ASSERT_EQ(BitstreamRelocator::Relocate(
+                source, 30,
+                ReadBitstream("binPartial_LinearSort1024_37_78.bin"), false),
+            expected);
+  ASSERT_EQ(
+      BitstreamRelocator::Relocate(
+          source, 30, ReadBitstream("binPartial_MergeSort128_19_66.bin"), true),
+      expected);
+}
+
+TEST(BitstreamRelocatorTest, RelocatedModulesMatchPrebuiltBitstreams) {
+  ASSERT_EQ(
+      BitstreamRelocator::Relocate(
+          ReadBitstream("binPartial_MergeJoin2K_67_96.bin"), -60,
+          ReadBitstream("binPartial_Filter_7_36.bin"), false),
+      ReadBitstream("binPartial_MergeJoin2K_7_36.bin"));
+  ASSERT_EQ(BitstreamRelocator::Relocate(
+                ReadBitstream("binPartial_rgb2bw_31_36.bin"), 60,
+                ReadBitstream("binPartial_MergeSort128_49_96.bin"), true),
+            ReadBitstream("binPartial_rgb2bw_91_96.bin"));
+}
+
+TEST(BitstreamRelocatorTest, RelocatedFrameDataHasTheSameSize) {
+  auto source = ReadBitstream("binPartial_Filter_7_36.bin");
+  auto frame_data = BitstreamRelocator::GetFrameData(source);
+  ASSERT_FALSE(frame_data.empty());
+  ASSERT_LT(frame_data.size(), source.size());
+  ASSERT_EQ(frame_data.size() % 4, 0);
+  ASSERT_EQ(BitstreamRelocator::GetFrameData(
+                ReadBitstream("binPartial_Filter_37_66.bin"))
+                .size(),
+            frame_data.size());
+}
+
+TEST(BitstreamRelocatorTest, InvalidBitstreamThrows) {
+  std::vector<char> invalid_bitstream(64, 0);
+  ASSERT_THROW(BitstreamRelocator::Relocate(invalid_bitstream, 3,
+                                            invalid_bitstream, false),
+               std::runtime_error);
+}
+
+TEST(BitstreamRelocatorTest, LibraryExtendedWithTemplatedLocations) {
+  std::string resource_string = "MMDMDBMMDBMMDMDBMMDBMMDMDBMMDBM";
+  std::map<QueryOperationType, OperationPRModules> hw_library;
+  hw_library[QueryOperationType::kFilter].starting_locations.resize(31);
+  hw_library[QueryOperationType::kFilter].starting_locations[20] = {
+      "binPartial_Filter_7_36.bin"};
+  hw_library[QueryOperationType::kFilter].bitstream_map = {
+      {"binPartial_Filter_7_36.bin", {{20}, 10, {32, 4}, "MMDMDBMMDB", false}}};
+  hw_library[QueryOperationType::kLinearSort].starting_locations.resize(31);
+  hw_library[QueryOperationType::kLinearSort].starting_locations[6] = {
+      "binPartial_LinearSort1024_37_78.bin"};
+  hw_library[QueryOperationType::kLinearSort].bitstream_map = {
+      {"binPartial_LinearSort1024_37_78.bin",
+       {{6}, 14, {1024}, "MMDBMMDMDBMMDB", false}}};
+
+  auto relocations = BitstreamRelocator::AddRelocatedBitstreams(
+      hw_library, resource_string);
+
+  ASSERT_EQ(relocations.size(), 1);
+  const auto& relocation = relocations.at("binPartial_Filter_37_66.bin");
+  ASSERT_EQ(relocation.source_bitstream, "binPartial_Filter_7_36.bin");
+  ASSERT_EQ(relocation.location_template,
+            "binPartial_LinearSort1024_37_78.bin");
+  ASSERT_EQ(relocation.column_shift, 30);
+  ASSERT_FALSE(relocation.is_template_end_aligned);
+  const auto& filter_modules = hw_library.at(QueryOperationType::kFilter);
+  std::vector<int> expected_locations = {10};
+  ASSERT_EQ(filter_modules.bitstream_map.at("binPartial_Filter_37_66.bin")
+                .fitting_locations,
+            expected_locations);
+  std::vector<std::string> expected_bitstreams = {
+      "binPartial_Filter_37_66.bin"};
+  ASSERT_EQ(filter_modules.starting_locations.at(10), expected_bitstreams);
+}
+
+}  // namespace
@@ -0,0 +1,128 @@
+/*
+Copyright 2022 University of Manchester
+
+Licensed under the Apache License, Version 2.0(the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http:  // www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "bitstream_staging_cache.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace {
+
+using orkhestrafs::dbmstodspi::BitstreamStagingCache;
+
+class BitstreamStagingCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    test_directory_ = std::filesystem::temp_directory_path() /
+                      ("bitstream_staging_cache_test_" +
+                       std::string(::testing::UnitTest::GetInstance()
+                                       ->current_test_info()
+                                       ->name()));
+    source_directory_ = test_directory_ / "source";
+    staging_directory_ = test_directory_ / "staging";
+    std::filesystem::create_directories(source_directory_);
+    CreateBitstream("TAA_2.bin", 100);
+    CreateBitstream("TAA_5.bin", 100);
+    CreateBitstream("RT_2.bin", 50);
+  }
+  void TearDown() override { std::filesystem::remove_all(test_directory_); }
+
+  void CreateBitstream(const std::string& name, int size) {
+    std::ofstream bitstream_file(source_directory_ / name, std::ios::binary);
+    bitstream_file << std::string(size, 'x');
+  }
+  auto IsFileStaged(const std::string& name) -> bool {
+    return std::filesystem::exists(staging_directory_ / name);
+  }
+
+  std::filesystem::path test_directory_;
+  std::filesystem::path source_directory_;
+  std::filesystem::path staging_directory_;
+};
+
+TEST_F(BitstreamStagingCacheTest, StagedBitstreamsAreHits) {
+  BitstreamStagingCache cache(source_directory_.string(),
+                              staging_directory_.string(), 1000);
+  EXPECT_FALSE(cache.Stage("TAA_2.bin"));
+  EXPECT_TRUE(cache.Stage("TAA_2.bin"));
+  EXPECT_TRUE(IsFileStaged("TAA_2.bin"));
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(1, stats.hits);
+  EXPECT_EQ(1, stats.misses);
+  EXPECT_EQ(0, stats.evictions);
+  EXPECT_EQ(100, stats.staged_bytes);
+}
+
+TEST_F(BitstreamStagingCacheTest, PreloadDoesntCountMisses) {
+  BitstreamStagingCache cache(source_directory_.string(),
+                              staging_directory_.string(), 1000);
+  cache.Preload({"TAA_2.bin", "TAA_5.bin", "RT_2.bin"});
+  EXPECT_TRUE(cache.Stage("TAA_5.bin"));
+  EXPECT_TRUE(cache.Stage("RT_2.bin"));
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(2, stats.hits);
+  EXPECT_EQ(0, stats.misses);
+  EXPECT_EQ(250, stats.staged_bytes);
+}
+
+TEST_F(BitstreamStagingCacheTest, LeastRecentlyUsedIsEvicted) {
+  BitstreamStagingCache cache(source_directory_.string(),
+                              staging_directory_.string(), 200);
+  cache.Stage("TAA_2.bin");
+  cache.Stage("TAA_5.bin");
+  // TAA_5 becomes the least recently used one.
+  cache.Stage("TAA_2.bin");
+  cache.Stage("RT_2.bin");
+
+  EXPECT_TRUE(cache.IsStaged("TAA_2.bin"));
+  EXPECT_FALSE(cache.IsStaged("TAA_5.bin"));
+  EXPECT_TRUE(cache.IsStaged("RT_2.bin"));
+  EXPECT_FALSE(IsFileStaged("TAA_5.bin"));
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(1, stats.evictions);
+  EXPECT_EQ(150, stats.staged_bytes);
+}
+
+TEST_F(BitstreamStagingCacheTest, BitstreamsOverBudgetAreNotStaged) {
+  BitstreamStagingCache cache(source_directory_.string(),
+                              staging_directory_.string(), 60);
+  cache.Stage("RT_2.bin");
+  EXPECT_FALSE(cache.Stage("TAA_2.bin"));
+  EXPECT_FALSE(cache.IsStaged("TAA_2.bin"));
+  EXPECT_TRUE(cache.IsStaged("RT_2.bin"));
+  EXPECT_FALSE(cache.Stage("missing.bin"));
+  EXPECT_EQ(3, cache.GetStats().misses);
+}
+
+TEST_F(BitstreamStagingCacheTest, StagedFilesAreRemovedAtDestruction) {
+  {
+    BitstreamStagingCache cache(source_directory_.string(),
+                                staging_directory_.string(), 1000);
+    cache.Stage("TAA_2.bin");
+    EXPECT_TRUE(IsFileStaged("TAA_2.bin"));
+  }
+  EXPECT_FALSE(IsFileStaged("TAA_2.bin"));
+  EXPECT_TRUE(std::filesystem::exists(source_directory_ / "TAA_2.bin"));
+}
+
+}  // namespace
@@ -41,7 +41,9 @@ class MockMemoryManager : public MemoryManagerInterface {
               (const std::vector<std::string>& bitstream_name,
                DMAInterface& dma_engine),
               (override));
-  MOCK_METHOD(void, MeasureConfigurationSpeed,
+  MOCK_METHOD(void, LoadPartialBitstreamWhileStreaming,
+              (const std::vector<std::string>& bitstream_name), (override));
+  MOCK_METHOD((std::map<std::string, double>), MeasureConfigurationSpeed,
               (const std::set<std::string>& bitstreams_to_measure), (override));
 
  private: